@@ -0,0 +1,107 @@
+/**
+ * PhantomVault Benchmark Data Implementation
+ */
+
+#include "bench_data.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+#include <unistd.h>
+#endif
+
+namespace phantomvault {
+namespace bench {
+
+namespace {
+
+const char* const kVocabulary[] = {
+    "the ", "vault ", "folder ", "profile ", "return ", "const ", "struct ", "value ", "error ", "config ",
+    "include ", "static ", "photo ", "message ", "subject: ", "from: ", "{\"id\": ", "\"name\": ", "0, ", "\n",
+    "    ", "std::string ", "if (", ") {\n", "}\n", "// ", "<div>", "</div>", "2024-03-18 ", "INFO ",
+    "lorem ", "ipsum "
+};
+
+constexpr size_t kVocabularySize = sizeof(kVocabulary) / sizeof(kVocabulary[0]);
+
+} // anonymous namespace
+
+std::vector<uint8_t> randomData(size_t size, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<uint8_t> data(size);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word = rng();
+        for (size_t b = 0; b < 8; ++b) {
+            data[i + b] = static_cast<uint8_t>(word >> (8 * b));
+        }
+    }
+    for (; i < size; ++i) {
+        data[i] = static_cast<uint8_t>(rng());
+    }
+    return data;
+}
+
+std::vector<uint8_t> compressibleData(size_t size, double compressibility, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<size_t> run_length(16, 256);
+    compressibility = std::clamp(compressibility, 0.0, 1.0);
+
+    std::vector<uint8_t> data;
+    data.reserve(size);
+    while (data.size() < size) {
+        size_t run = std::min(run_length(rng), size - data.size());
+        if (coin(rng) < compressibility) {
+            while (run > 0) {
+                const char* word = kVocabulary[rng() % kVocabularySize];
+                for (; *word && run > 0; ++word, --run) {
+                    data.push_back(static_cast<uint8_t>(*word));
+                }
+            }
+        } else {
+            for (; run > 0; --run) {
+                data.push_back(static_cast<uint8_t>(rng()));
+            }
+        }
+    }
+    return data;
+}
+
+std::string typedText(size_t size, uint64_t seed) {
+    static const char* const kWords[] = {
+        "hello", "meeting", "tomorrow", "T+Secret123", "the", "Report2024", "password", "P+Vault#42", "ok", "lunch"
+    };
+    std::mt19937_64 rng(seed);
+    std::string text;
+    text.reserve(size + 16);
+    while (text.size() < size) {
+        text += kWords[rng() % (sizeof(kWords) / sizeof(kWords[0]))];
+        text += ' ';
+    }
+    text.resize(size);
+    return text;
+}
+
+ScratchDirectory::ScratchDirectory(const std::string& name) {
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    std::string owner = std::to_string(getpid());
+#else
+    std::string owner = std::to_string(std::random_device{}());
+#endif
+    std::filesystem::path path = std::filesystem::temp_directory_path() / ("phantomvault-bench-" + owner + "-" + name);
+    std::error_code ec;
+    std::filesystem::remove_all(path, ec);
+    std::filesystem::create_directories(path, ec);
+    path_ = path.string();
+}
+
+ScratchDirectory::~ScratchDirectory() {
+    std::error_code ec;
+    std::filesystem::remove_all(path_, ec);
+}
+
+} // namespace bench
+} // namespace phantomvault
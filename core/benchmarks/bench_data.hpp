@@ -0,0 +1,50 @@
+/**
+ * PhantomVault Benchmark Data
+ *
+ * Deterministic payloads: the same seed always gives the same bytes, so runs
+ * on different commits measure identical inputs.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace phantomvault {
+namespace bench {
+
+// Incompressible bytes
+std::vector<uint8_t> randomData(size_t size, uint64_t seed);
+
+/**
+ * compressibility (0.0-1.0) is the fraction of bytes taken from a small
+ * vocabulary of words; the rest is random. 0.5 compresses roughly 2:1.
+ */
+std::vector<uint8_t> compressibleData(size_t size, double compressibility, uint64_t seed);
+
+// Keyboard-like text: words and spaces with the odd T+/P+ pattern
+std::string typedText(size_t size, uint64_t seed);
+
+/**
+ * Per-process directory under the system temp directory, removed with
+ * everything in it on destruction
+ */
+class ScratchDirectory {
+public:
+    explicit ScratchDirectory(const std::string& name);
+    ~ScratchDirectory();
+
+    ScratchDirectory(const ScratchDirectory&) = delete;
+    ScratchDirectory& operator=(const ScratchDirectory&) = delete;
+
+    const std::string& path() const { return path_; }
+    std::string path(const std::string& child) const { return path_ + "/" + child; }
+
+private:
+    std::string path_;
+};
+
+} // namespace bench
+} // namespace phantomvault
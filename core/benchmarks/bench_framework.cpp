@@ -0,0 +1,407 @@
+/**
+ * PhantomVault Benchmark Framework Implementation
+ */
+
+#include "bench_framework.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace phantomvault {
+namespace bench {
+
+namespace {
+
+constexpr uint64_t kMaxIterations = 1000000000ULL;
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+std::string currentDate() {
+    std::time_t now = std::time(nullptr);
+    std::tm utc{};
+#ifdef PLATFORM_WINDOWS
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return text;
+}
+
+} // anonymous namespace
+
+void printResult(const BenchmarkResult& result) {
+    std::cout << std::left << std::setw(44) << result.name << std::right;
+    if (!result.error.empty()) {
+        std::cout << "  ERROR: " << result.error << std::endl;
+        return;
+    }
+
+    double cv = result.meanNs > 0 ? result.stddevNs / result.meanNs * 100.0 : 0.0;
+    std::cout << std::setw(12) << formatDuration(result.medianNs)
+              << "  ±" << std::setw(5) << std::fixed << std::setprecision(1) << cv << "%"
+              << std::setw(12) << result.iterations << " x" << result.repetitions;
+    if (result.bytesPerSecond > 0) {
+        std::cout << "  " << formatRate(result.bytesPerSecond, "B/s");
+    }
+    if (result.itemsPerSecond > 0) {
+        std::cout << "  " << formatRate(result.itemsPerSecond, "items/s");
+    }
+    for (const auto& counter : result.counters) {
+        std::cout << "  " << counter.first << "=" << counter.second;
+    }
+    std::cout << std::defaultfloat << std::endl;
+}
+
+void summarize(BenchmarkResult& result, const std::vector<double>& samplesNs) {
+    if (samplesNs.empty()) {
+        return;
+    }
+    result.medianNs = median(samplesNs);
+    result.minNs = *std::min_element(samplesNs.begin(), samplesNs.end());
+    result.maxNs = *std::max_element(samplesNs.begin(), samplesNs.end());
+
+    double sum = 0;
+    for (double value : samplesNs) {
+        sum += value;
+    }
+    result.meanNs = sum / samplesNs.size();
+    double squares = 0;
+    for (double value : samplesNs) {
+        squares += (value - result.meanNs) * (value - result.meanNs);
+    }
+    result.stddevNs = samplesNs.size() > 1 ? std::sqrt(squares / (samplesNs.size() - 1)) : 0.0;
+}
+
+// State
+State::State(int64_t range, uint64_t iterations) : range_(range), iterations_(iterations) {}
+
+bool State::Iterator::operator!=(const Iterator&) const {
+    if (remaining_ != 0 && !state_->hasError()) {
+        return true;
+    }
+    state_->finish();
+    return false;
+}
+
+State::Iterator State::begin() {
+    resumeTiming();
+    return Iterator(this, iterations_);
+}
+
+State::Iterator State::end() {
+    return Iterator(this, 0);
+}
+
+void State::pauseTiming() {
+    if (running_) {
+        elapsed_ += std::chrono::steady_clock::now() - started_;
+        running_ = false;
+    }
+}
+
+void State::resumeTiming() {
+    if (!running_) {
+        running_ = true;
+        started_ = std::chrono::steady_clock::now();
+    }
+}
+
+void State::finish() {
+    pauseTiming();
+}
+
+void State::setCounter(const std::string& name, double value) {
+    for (auto& counter : counters_) {
+        if (counter.first == name) {
+            counter.second = value;
+            return;
+        }
+    }
+    counters_.emplace_back(name, value);
+}
+
+void State::skipWithError(const std::string& error) {
+    error_ = error;
+}
+
+// BenchmarkRunner
+BenchmarkDefinition& BenchmarkRunner::add(const std::string& name, BenchmarkFunction function) {
+    definitions_.emplace_back();
+    definitions_.back().name = name;
+    definitions_.back().function = std::move(function);
+    return definitions_.back();
+}
+
+std::vector<BenchmarkResult> BenchmarkRunner::run(const RunnerOptions& options) {
+    std::vector<BenchmarkResult> results;
+
+    for (const auto& definition : definitions_) {
+        std::vector<int64_t> ranges = definition.ranges.empty() ? std::vector<int64_t>{0} : definition.ranges;
+        for (int64_t range : ranges) {
+            std::string name = definition.ranges.empty() ? definition.name
+                                                         : definition.name + "/" + std::to_string(range);
+            if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+                continue;
+            }
+            if (options.listOnly) {
+                std::cout << name << std::endl;
+                continue;
+            }
+
+            BenchmarkResult result = runOne(definition, range, options);
+            result.name = name;
+            printResult(result);
+            results.push_back(std::move(result));
+        }
+    }
+
+    if (!options.jsonPath.empty() && !options.listOnly) {
+        if (writeJson(results, options.jsonPath)) {
+            std::cout << "Results written to " << options.jsonPath << std::endl;
+        } else {
+            std::cerr << "Failed to write results: " << options.jsonPath << std::endl;
+        }
+    }
+    return results;
+}
+
+BenchmarkResult BenchmarkRunner::runOne(const BenchmarkDefinition& definition, int64_t range,
+                                        const RunnerOptions& options) {
+    BenchmarkResult result;
+    auto min_time = std::chrono::duration<double>(options.minTimeSeconds);
+
+    // Calibration doubles as the warmup run and is never reported
+    uint64_t iterations = definition.fixedIterations ? definition.fixedIterations : 1;
+    for (;;) {
+        State state(range, iterations);
+        definition.function(state);
+        if (state.hasError()) {
+            result.error = state.error_;
+            return result;
+        }
+        if (definition.fixedIterations || state.elapsed_ >= min_time || iterations >= kMaxIterations) {
+            break;
+        }
+        double elapsed = std::max(1e-9, std::chrono::duration<double>(state.elapsed_).count());
+        double scaled = iterations * options.minTimeSeconds * 1.4 / elapsed;
+        iterations = std::min<uint64_t>(kMaxIterations,
+                                        std::max<uint64_t>(iterations + 1,
+                                                           std::min<double>(scaled, iterations * 10.0)));
+    }
+
+    int repetitions = std::max(1, definition.repetitions ? definition.repetitions : options.repetitions);
+    std::vector<double> per_iteration;
+    double bytes_per_iteration = 0;
+    double items_per_iteration = 0;
+    for (int repetition = 0; repetition < repetitions; ++repetition) {
+        State state(range, iterations);
+        definition.function(state);
+        if (state.hasError()) {
+            result.error = state.error_;
+            return result;
+        }
+        per_iteration.push_back(static_cast<double>(state.elapsed_.count()) / iterations);
+        bytes_per_iteration = static_cast<double>(state.bytes_) / iterations;
+        items_per_iteration = static_cast<double>(state.items_) / iterations;
+        result.counters = state.counters_;
+    }
+
+    result.iterations = iterations;
+    result.repetitions = repetitions;
+    summarize(result, per_iteration);
+
+    if (result.medianNs > 0) {
+        result.bytesPerSecond = bytes_per_iteration * 1e9 / result.medianNs;
+        result.itemsPerSecond = items_per_iteration * 1e9 / result.medianNs;
+    }
+    return result;
+}
+
+bool BenchmarkRunner::writeJson(const std::vector<BenchmarkResult>& results, const std::string& path) {
+    json benchmarks = json::array();
+    for (const auto& result : results) {
+        json entry = {
+            {"name", result.name},
+            {"iterations", result.iterations},
+            {"repetitions", result.repetitions},
+            {"median_ns", result.medianNs},
+            {"mean_ns", result.meanNs},
+            {"stddev_ns", result.stddevNs},
+            {"min_ns", result.minNs},
+            {"max_ns", result.maxNs}
+        };
+        if (result.bytesPerSecond > 0) {
+            entry["bytes_per_second"] = result.bytesPerSecond;
+        }
+        if (result.itemsPerSecond > 0) {
+            entry["items_per_second"] = result.itemsPerSecond;
+        }
+        for (const auto& counter : result.counters) {
+            entry["counters"][counter.first] = counter.second;
+        }
+        if (!result.error.empty()) {
+            entry["error"] = result.error;
+        }
+        benchmarks.push_back(entry);
+    }
+
+    json document = {
+        {"context", {
+            {"date", currentDate()},
+            {"cpus", std::thread::hardware_concurrency()},
+#ifdef NDEBUG
+            {"build", "release"}
+#else
+            {"build", "debug"}
+#endif
+        }},
+        {"benchmarks", benchmarks}
+    };
+
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << document.dump(2) << std::endl;
+    return static_cast<bool>(file);
+}
+
+int BenchmarkRunner::compare(const std::string& baselinePath, const std::string& currentPath, double threshold) {
+    struct Timing {
+        double median;
+        double stddev;
+    };
+
+    auto load = [](const std::string& path, std::map<std::string, Timing>& timings) {
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "Cannot read " << path << std::endl;
+            return false;
+        }
+        try {
+            json document = json::parse(file);
+            for (const auto& entry : document.at("benchmarks")) {
+                if (!entry.contains("error")) {
+                    timings[entry.at("name").get<std::string>()] = {entry.at("median_ns").get<double>(),
+                                                                    entry.value("stddev_ns", 0.0)};
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Cannot parse " << path << ": " << e.what() << std::endl;
+            return false;
+        }
+        return true;
+    };
+
+    std::map<std::string, Timing> baseline;
+    std::map<std::string, Timing> current;
+    if (!load(baselinePath, baseline) || !load(currentPath, current)) {
+        return -1;
+    }
+
+    int regressions = 0;
+    std::cout << std::left << std::setw(44) << "Benchmark" << std::right << std::setw(12) << "Baseline"
+              << std::setw(12) << "Current" << std::setw(10) << "Change" << std::endl;
+    for (const auto& [name, now] : current) {
+        auto before = baseline.find(name);
+        if (before == baseline.end()) {
+            std::cout << std::left << std::setw(44) << name << std::right << std::setw(12) << "-"
+                      << std::setw(12) << formatDuration(now.median) << "       new" << std::endl;
+            continue;
+        }
+
+        double change = before->second.median > 0 ? now.median / before->second.median - 1.0 : 0.0;
+        double noise = 2.0 * std::max(before->second.stddev, now.stddev);
+        bool regressed = change > threshold && now.median - before->second.median > noise;
+        bool improved = change < -threshold && before->second.median - now.median > noise;
+        regressions += regressed ? 1 : 0;
+
+        std::cout << std::left << std::setw(44) << name << std::right
+                  << std::setw(12) << formatDuration(before->second.median)
+                  << std::setw(12) << formatDuration(now.median)
+                  << std::setw(9) << std::showpos << std::fixed << std::setprecision(1) << change * 100.0 << "%"
+                  << std::noshowpos << std::defaultfloat
+                  << (regressed ? "  REGRESSION" : improved ? "  improved" : "") << std::endl;
+    }
+    for (const auto& [name, timing] : baseline) {
+        if (current.find(name) == current.end()) {
+            std::cout << std::left << std::setw(44) << name << std::right
+                      << std::setw(12) << formatDuration(timing.median) << std::setw(12) << "-" << "   missing" << std::endl;
+        }
+    }
+
+    std::cout << regressions << " regression(s) over " << threshold * 100.0 << "%" << std::endl;
+    return regressions;
+}
+
+std::string formatDuration(double nanos) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(nanos < 10.0 ? 2 : 1);
+    if (nanos < 1e3) {
+        out << nanos << " ns";
+    } else if (nanos < 1e6) {
+        out << nanos / 1e3 << " us";
+    } else if (nanos < 1e9) {
+        out << nanos / 1e6 << " ms";
+    } else {
+        out << nanos / 1e9 << " s";
+    }
+    return out.str();
+}
+
+size_t peakRssKB() {
+#ifdef PLATFORM_LINUX
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return static_cast<size_t>(std::strtoull(line.c_str() + 6, nullptr, 10));
+        }
+    }
+#endif
+    return 0;
+}
+
+bool resetPeakRss() {
+#ifdef PLATFORM_LINUX
+    // Writing 5 to clear_refs resets VmHWM (Linux 4.0+)
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+    clear_refs.flush();
+    return static_cast<bool>(clear_refs);
+#else
+    return false;
+#endif
+}
+
+std::string formatRate(double perSecond, const char* unit) {
+    static const char* kPrefixes[] = {"", "k", "M", "G", "T"};
+    size_t prefix = 0;
+    while (perSecond >= 1000.0 && prefix + 1 < sizeof(kPrefixes) / sizeof(kPrefixes[0])) {
+        perSecond /= 1000.0;
+        ++prefix;
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << perSecond << " " << kPrefixes[prefix] << unit;
+    return out.str();
+}
+
+} // namespace bench
+} // namespace phantomvault
@@ -0,0 +1,181 @@
+/**
+ * PhantomVault Benchmark Framework
+ *
+ * Small Google Benchmark-style harness: a benchmark body loops over a State,
+ * the runner calibrates the iteration count against a minimum time, throws
+ * away a warmup run, repeats the measurement and reports median, mean,
+ * standard deviation and throughput. Results can be written as JSON and two
+ * result files compared to flag regressions.
+ *
+ * Usage:
+ *   static void encrypt(State& state) {
+ *       auto data = makeData(state.range());
+ *       for (auto _ : state) { doNotOptimize(engine.encryptData(data, key, iv)); }
+ *       state.setBytesProcessed(state.iterations() * data.size());
+ *   }
+ *   runner.add("aes/encrypt", encrypt).args({4096, 1 << 20});
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace phantomvault {
+namespace bench {
+
+class State {
+public:
+    State(int64_t range, uint64_t iterations);
+
+    // Range-for over the timed iterations; timing starts at the first one
+    class Iterator {
+    public:
+        // Marked unused so "for (auto _ : state)" does not warn about _
+#if defined(__GNUC__) || defined(__clang__)
+        struct __attribute__((unused)) Value {};
+#else
+        struct Value {};
+#endif
+
+        Iterator(State* state, uint64_t remaining) : state_(state), remaining_(remaining) {}
+        bool operator!=(const Iterator&) const;
+        Iterator& operator++() { --remaining_; return *this; }
+        Value operator*() const { return Value(); }
+
+    private:
+        State* state_;
+        uint64_t remaining_;
+    };
+
+    Iterator begin();
+    Iterator end();
+
+    int64_t range() const { return range_; }
+    uint64_t iterations() const { return iterations_; }
+
+    // Keep per-iteration setup out of the measurement
+    void pauseTiming();
+    void resumeTiming();
+
+    void setBytesProcessed(uint64_t bytes) { bytes_ = bytes; }
+    void setItemsProcessed(uint64_t items) { items_ = items; }
+
+    // Records a named value (peak RSS, file count...) alongside the timing
+    void setCounter(const std::string& name, double value);
+
+    void skipWithError(const std::string& error);
+    bool hasError() const { return !error_.empty(); }
+
+private:
+    friend class BenchmarkRunner;
+
+    void finish();
+
+    int64_t range_;
+    uint64_t iterations_;
+    uint64_t bytes_ = 0;
+    uint64_t items_ = 0;
+    bool running_ = false;
+    std::chrono::steady_clock::time_point started_;
+    std::chrono::nanoseconds elapsed_{0};
+    std::vector<std::pair<std::string, double>> counters_;
+    std::string error_;
+};
+
+using BenchmarkFunction = std::function<void(State&)>;
+
+// Keeps a computed value alive without costing a store
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+struct BenchmarkDefinition {
+    std::string name;
+    BenchmarkFunction function;
+    std::vector<int64_t> ranges;
+    uint64_t fixedIterations = 0;       // 0 = calibrate against the minimum time
+    int repetitions = 0;                // 0 = the runner default
+
+    BenchmarkDefinition& args(std::vector<int64_t> values) { ranges = std::move(values); return *this; }
+    BenchmarkDefinition& iterations(uint64_t count) { fixedIterations = count; return *this; }
+    BenchmarkDefinition& repeat(int count) { repetitions = count; return *this; }
+};
+
+/**
+ * One benchmark at one range: statistics over the repetitions, per iteration
+ */
+struct BenchmarkResult {
+    std::string name;
+    uint64_t iterations = 0;
+    int repetitions = 0;
+    double medianNs = 0;
+    double meanNs = 0;
+    double stddevNs = 0;
+    double minNs = 0;
+    double maxNs = 0;
+    double bytesPerSecond = 0;
+    double itemsPerSecond = 0;
+    std::vector<std::pair<std::string, double>> counters;
+    std::string error;
+};
+
+struct RunnerOptions {
+    std::string filter;                 // substring of the full name
+    int repetitions = 5;
+    double minTimeSeconds = 0.1;
+    std::string jsonPath;
+    bool listOnly = false;
+};
+
+class BenchmarkRunner {
+public:
+    BenchmarkDefinition& add(const std::string& name, BenchmarkFunction function);
+
+    std::vector<BenchmarkResult> run(const RunnerOptions& options);
+
+    static bool writeJson(const std::vector<BenchmarkResult>& results, const std::string& path);
+
+    /**
+     * Compares two JSON result files by median time. A benchmark regresses
+     * when it slowed down by more than threshold (0.05 = 5%) and by more than
+     * twice the larger standard deviation. Returns the number of regressions,
+     * or -1 if a file cannot be read.
+     */
+    static int compare(const std::string& baselinePath, const std::string& currentPath, double threshold);
+
+private:
+    BenchmarkResult runOne(const BenchmarkDefinition& definition, int64_t range,
+                           const RunnerOptions& options);
+
+    std::deque<BenchmarkDefinition> definitions_;     // stable references for add().args()
+};
+
+// Fills median, mean, standard deviation, min and max from per-iteration samples
+void summarize(BenchmarkResult& result, const std::vector<double>& samplesNs);
+
+// One line of the console report
+void printResult(const BenchmarkResult& result);
+
+// Formatting helpers shared by the console report and comparisons
+std::string formatDuration(double nanos);
+std::string formatRate(double perSecond, const char* unit);
+
+// Peak resident set size of this process in KB (VmHWM); 0 where unsupported
+size_t peakRssKB();
+
+// Restarts peak RSS tracking from the current RSS, where the kernel allows it
+bool resetPeakRss();
+
+} // namespace bench
+} // namespace phantomvault
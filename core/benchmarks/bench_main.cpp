@@ -0,0 +1,152 @@
+/**
+ * PhantomVault Benchmark Suite
+ *
+ * Runs the micro- and macrobenchmarks or replays a workload profile,
+ * optionally writing JSON results, or compares two result files and exits
+ * non-zero on regressions.
+ */
+
+#include "bench_framework.hpp"
+#include "bench_replay.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace phantomvault::bench;
+
+namespace phantomvault {
+namespace bench {
+void registerMicroBenchmarks(BenchmarkRunner& runner);
+void registerMacroBenchmarks(BenchmarkRunner& runner);
+}
+}
+
+namespace {
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options]" << std::endl;
+    std::cout << "       " << program_name << " --replay=PROFILE [--cycles=3] [--edit=0.1] [--scale=1.0] [--json=PATH]" << std::endl;
+    std::cout << "       " << program_name << " --compare BASELINE.json CURRENT.json [--threshold=0.05]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --filter=TEXT          Run benchmarks whose name contains TEXT (e.g. vault/, aes/)" << std::endl;
+    std::cout << "  --repetitions=N        Measured repetitions per benchmark (default 5)" << std::endl;
+    std::cout << "  --min-time=SECONDS     Minimum time per repetition when calibrating (default 0.1)" << std::endl;
+    std::cout << "  --json=PATH            Write results as JSON" << std::endl;
+    std::cout << "  --list                 List benchmark names and replay profiles and exit" << std::endl;
+    std::cout << "  --replay=PROFILE       Lock/unlock/edit/relock cycles on a workload profile, or 'all'" << std::endl;
+    std::cout << "  --cycles=N             Replay cycles (default 3)" << std::endl;
+    std::cout << "  --edit=FRACTION        Share of files edited while unlocked (default 0.1)" << std::endl;
+    std::cout << "  --scale=FACTOR         Multiply the profile's file count (default 1.0)" << std::endl;
+    std::cout << "  --compare A B          Compare two JSON results; exit 1 on regressions" << std::endl;
+    std::cout << "  --threshold=FRACTION   Slowdown that counts as a regression (default 0.05)" << std::endl;
+    std::cout << "  -h, --help             Show this help message" << std::endl;
+}
+
+bool readOption(const std::string& arg, const std::string& name, std::string& value) {
+    if (arg.compare(0, name.size() + 1, name + "=") == 0) {
+        value = arg.substr(name.size() + 1);
+        return true;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    RunnerOptions options;
+    std::string baseline;
+    std::string current;
+    double threshold = 0.05;
+    std::string replay;
+    ReplayOptions replay_options;
+    double scale = 1.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value;
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--list") {
+            options.listOnly = true;
+        } else if (arg == "--compare" && i + 2 < argc) {
+            baseline = argv[++i];
+            current = argv[++i];
+        } else if (readOption(arg, "--filter", value)) {
+            options.filter = value;
+        } else if (readOption(arg, "--repetitions", value)) {
+            options.repetitions = std::max(1, std::atoi(value.c_str()));
+        } else if (readOption(arg, "--min-time", value)) {
+            options.minTimeSeconds = std::max(0.0, std::atof(value.c_str()));
+        } else if (readOption(arg, "--json", value)) {
+            options.jsonPath = value;
+        } else if (readOption(arg, "--replay", value)) {
+            replay = value;
+        } else if (readOption(arg, "--cycles", value)) {
+            replay_options.cycles = std::max(1, std::atoi(value.c_str()));
+        } else if (readOption(arg, "--edit", value)) {
+            replay_options.editFraction = std::clamp(std::atof(value.c_str()), 0.0, 1.0);
+        } else if (readOption(arg, "--scale", value)) {
+            scale = std::max(0.0, std::atof(value.c_str()));
+        } else if (readOption(arg, "--threshold", value)) {
+            threshold = std::max(0.0, std::atof(value.c_str()));
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (!baseline.empty()) {
+        int regressions = BenchmarkRunner::compare(baseline, current, threshold);
+        return regressions < 0 ? 2 : (regressions > 0 ? 1 : 0);
+    }
+
+    if (!replay.empty()) {
+        std::vector<BenchmarkResult> results;
+        for (const auto& profile : workloadProfiles()) {
+            if (replay == "all" || replay == profile.name) {
+                auto phases = replayWorkload(scaledWorkload(profile, scale), replay_options);
+                results.insert(results.end(), phases.begin(), phases.end());
+            }
+        }
+        if (results.empty()) {
+            std::cerr << "Unknown workload profile: " << replay << " (see --list)" << std::endl;
+            return 2;
+        }
+        if (!options.jsonPath.empty()) {
+            if (!BenchmarkRunner::writeJson(results, options.jsonPath)) {
+                std::cerr << "Failed to write results: " << options.jsonPath << std::endl;
+                return 1;
+            }
+            std::cout << "Results written to " << options.jsonPath << std::endl;
+        }
+        for (const auto& result : results) {
+            if (!result.error.empty()) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    BenchmarkRunner runner;
+    registerMicroBenchmarks(runner);
+    registerMacroBenchmarks(runner);
+
+    auto results = runner.run(options);
+    if (options.listOnly) {
+        for (const auto& profile : workloadProfiles()) {
+            std::cout << "--replay=" << profile.name << std::endl;
+        }
+    }
+    for (const auto& result : results) {
+        if (!result.error.empty()) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * PhantomVault Workload Replay Implementation
+ */
+
+#include "bench_replay.hpp"
+#include "bench_data.hpp"
+#include "../include/folder_security_manager.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+
+namespace phantomvault {
+namespace bench {
+
+namespace {
+
+enum Phase { GENERATE, LOCK, UNLOCK, EDIT, RELOCK, PHASE_COUNT };
+
+const char* const kPhaseNames[PHASE_COUNT] = {"generate", "lock", "unlock", "edit", "relock"};
+
+struct PhaseSamples {
+    std::vector<double> nanos;
+    size_t peakRssKB = 0;
+    uint64_t bytes = 0;                 // per cycle, from the last cycle
+    uint64_t items = 0;
+    std::string error;
+};
+
+// Times one phase; the body returns an error message, empty on success
+void runPhase(PhaseSamples& samples, const std::function<std::string()>& body) {
+    resetPeakRss();
+    auto start = std::chrono::steady_clock::now();
+    std::string error = body();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    samples.peakRssKB = std::max(samples.peakRssKB, peakRssKB());
+    if (!error.empty()) {
+        samples.error = error;
+        return;
+    }
+    samples.nanos.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
+
+} // anonymous namespace
+
+std::vector<BenchmarkResult> replayWorkload(const WorkloadProfile& profile, const ReplayOptions& options) {
+    ScratchDirectory scratch("replay-" + profile.name);
+    FolderSecurityManager manager;
+    PhaseSamples phases[PHASE_COUNT];
+
+    if (!manager.initialize(scratch.path("data"))) {
+        phases[GENERATE].error = "Folder security manager initialization failed: " + manager.getLastError();
+    }
+
+    for (int cycle = 0; cycle < options.cycles && phases[GENERATE].error.empty(); ++cycle) {
+        std::string profile_id = "replay-" + std::to_string(cycle);
+        std::string folder = scratch.path(profile.name + "-" + std::to_string(cycle));
+        WorkloadManifest manifest;
+
+        runPhase(phases[GENERATE], [&]() {
+            manifest = generateWorkload(profile, folder);
+            return manifest.files.empty() ? std::string("Workload generated no files") : std::string();
+        });
+        phases[GENERATE].bytes = phases[LOCK].bytes = phases[UNLOCK].bytes = manifest.totalBytes;
+        phases[GENERATE].items = phases[LOCK].items = phases[UNLOCK].items = manifest.files.size();
+        if (!phases[GENERATE].error.empty()) {
+            break;
+        }
+
+        runPhase(phases[LOCK], [&]() {
+            auto result = manager.lockFolder(profile_id, folder, options.masterKey);
+            return result.success ? std::string() : "Lock failed: " + result.error;
+        });
+        if (!phases[LOCK].error.empty()) {
+            break;
+        }
+
+        runPhase(phases[UNLOCK], [&]() {
+            auto result = manager.unlockFoldersTemporary(profile_id, options.masterKey);
+            return result.success && result.failedCount == 0 ? std::string() : "Temporary unlock failed: " + result.error;
+        });
+        if (!phases[UNLOCK].error.empty()) {
+            break;
+        }
+
+        runPhase(phases[EDIT], [&]() {
+            phases[EDIT].bytes = editWorkload(manifest, folder, options.editFraction, profile.seed + cycle);
+            phases[EDIT].items = static_cast<uint64_t>(options.editFraction * manifest.files.size());
+            return std::string();
+        });
+
+        runPhase(phases[RELOCK], [&]() {
+            return manager.lockTemporaryFolders(profile_id) ? std::string() : "Relock failed: " + manager.getLastError();
+        });
+        if (!phases[RELOCK].error.empty()) {
+            break;
+        }
+        phases[RELOCK].items = manifest.files.size();
+    }
+
+    std::vector<BenchmarkResult> results;
+    std::string failure;
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        const PhaseSamples& samples = phases[phase];
+        BenchmarkResult result;
+        result.name = "replay/" + profile.name + "/" + kPhaseNames[phase];
+        if (failure.empty()) {
+            failure = samples.error;
+        }
+
+        if (!failure.empty()) {
+            result.error = failure;
+        } else {
+            result.iterations = 1;
+            result.repetitions = static_cast<int>(samples.nanos.size());
+            summarize(result, samples.nanos);
+            if (result.medianNs > 0) {
+                result.bytesPerSecond = samples.bytes * 1e9 / result.medianNs;
+                result.itemsPerSecond = samples.items * 1e9 / result.medianNs;
+            }
+            result.counters.emplace_back("peak_rss_kb", static_cast<double>(samples.peakRssKB));
+        }
+        printResult(result);
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+} // namespace bench
+} // namespace phantomvault
@@ -0,0 +1,34 @@
+/**
+ * PhantomVault Workload Replay
+ *
+ * Drives FolderSecurityManager through the cycle a user actually runs:
+ * lock a folder, unlock it temporarily, edit a share of its files, relock.
+ * Every cycle starts from the same generated tree under a fresh profile, so
+ * cycles are independent samples. Each phase is reported as its own result
+ * ("replay/<profile>/<phase>") with the median over cycles and the peak RSS
+ * reached during that phase, in the same JSON format as the benchmarks so
+ * --compare works on replays too.
+ */
+
+#pragma once
+
+#include "bench_framework.hpp"
+#include "bench_workload.hpp"
+
+#include <string>
+#include <vector>
+
+namespace phantomvault {
+namespace bench {
+
+struct ReplayOptions {
+    int cycles = 3;
+    double editFraction = 0.1;          // of the tree's files edited while unlocked
+    std::string masterKey = "replay master key";
+};
+
+// Phases in order: generate (setup, not part of the vault), lock, unlock, edit, relock
+std::vector<BenchmarkResult> replayWorkload(const WorkloadProfile& profile, const ReplayOptions& options);
+
+} // namespace bench
+} // namespace phantomvault
@@ -0,0 +1,235 @@
+/**
+ * PhantomVault Benchmark Workloads Implementation
+ */
+
+#include "bench_workload.hpp"
+#include "bench_data.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
+
+namespace fs = std::filesystem;
+
+namespace phantomvault {
+namespace bench {
+
+namespace {
+
+// One XTS data unit per file: edits must not grow a file past this
+constexpr uint64_t kMaxVaultFileSize = 16ULL << 20;
+
+std::vector<WorkloadProfile> builtInProfiles() {
+    std::vector<WorkloadProfile> profiles;
+
+    // Many small, very compressible files in a deep tree, a few symlinks
+    WorkloadProfile source;
+    source.name = "source_tree";
+    source.extension = ".cpp";
+    source.fileCount = 1500;
+    source.medianFileSize = 6 << 10;
+    source.sizeSigma = 1.2;
+    source.minFileSize = 64;
+    source.maxFileSize = 512 << 10;
+    source.maxDepth = 5;
+    source.directoryFanout = 4;
+    source.compressibility = 0.85;
+    source.symlinkFraction = 0.01;
+    source.seed = 101;
+    profiles.push_back(source);
+
+    // Already-compressed media in year/month folders, albums hard-link duplicates
+    WorkloadProfile photos;
+    photos.name = "photo_library";
+    photos.extension = ".jpg";
+    photos.fileCount = 80;
+    photos.medianFileSize = 3 << 20;
+    photos.sizeSigma = 0.4;
+    photos.minFileSize = 512 << 10;
+    photos.maxFileSize = 12 << 20;
+    photos.maxDepth = 2;
+    photos.directoryFanout = 6;
+    photos.compressibility = 0.02;
+    photos.hardlinkFraction = 0.03;
+    photos.seed = 202;
+    profiles.push_back(photos);
+
+    // A few large, partly sparse disk images; one XTS data unit caps a file at 16 MB
+    WorkloadProfile images;
+    images.name = "vm_images";
+    images.extension = ".qcow2";
+    images.fileCount = 3;
+    images.medianFileSize = 14 << 20;
+    images.sizeSigma = 0.05;
+    images.minFileSize = 8 << 20;
+    images.maxFileSize = 15 << 20;
+    images.maxDepth = 1;
+    images.directoryFanout = 1;
+    images.compressibility = 0.6;
+    images.seed = 303;
+    profiles.push_back(images);
+
+    // Maildir: thousands of small messages, copies between folders as hard links
+    WorkloadProfile mail;
+    mail.name = "mail_store";
+    mail.extension = ".eml";
+    mail.fileCount = 2000;
+    mail.medianFileSize = 8 << 10;
+    mail.sizeSigma = 1.0;
+    mail.minFileSize = 1 << 10;
+    mail.maxFileSize = 2 << 20;
+    mail.maxDepth = 2;
+    mail.directoryFanout = 8;
+    mail.compressibility = 0.7;
+    mail.hardlinkFraction = 0.05;
+    mail.seed = 404;
+    profiles.push_back(mail);
+
+    return profiles;
+}
+
+size_t drawFileSize(const WorkloadProfile& profile, std::mt19937_64& rng) {
+    double size = static_cast<double>(profile.medianFileSize);
+    if (profile.sizeSigma > 0.0) {
+        std::lognormal_distribution<double> distribution(std::log(size), profile.sizeSigma);
+        size = distribution(rng);
+    }
+    return std::clamp(static_cast<size_t>(size), profile.minFileSize,
+                      std::max(profile.minFileSize, profile.maxFileSize));
+}
+
+// Relative directory for the next entry: a random depth, then a random branch per level
+fs::path drawDirectory(const WorkloadProfile& profile, std::mt19937_64& rng) {
+    fs::path directory;
+    unsigned depth = profile.maxDepth ? static_cast<unsigned>(rng() % (profile.maxDepth + 1)) : 0;
+    for (unsigned level = 0; level < depth; ++level) {
+        unsigned branch = static_cast<unsigned>(rng() % std::max(1u, profile.directoryFanout));
+        directory /= "d" + std::to_string(level) + "_" + std::to_string(branch);
+    }
+    return directory;
+}
+
+bool writeFile(const fs::path& path, const std::vector<uint8_t>& data) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+} // anonymous namespace
+
+const std::vector<WorkloadProfile>& workloadProfiles() {
+    static const std::vector<WorkloadProfile> profiles = builtInProfiles();
+    return profiles;
+}
+
+const WorkloadProfile* findWorkloadProfile(const std::string& name) {
+    for (const auto& profile : workloadProfiles()) {
+        if (profile.name == name) {
+            return &profile;
+        }
+    }
+    return nullptr;
+}
+
+WorkloadProfile scaledWorkload(const WorkloadProfile& profile, double factor) {
+    WorkloadProfile scaled = profile;
+    scaled.fileCount = std::max<size_t>(1, static_cast<size_t>(std::llround(profile.fileCount * factor)));
+    return scaled;
+}
+
+WorkloadManifest generateWorkload(const WorkloadProfile& profile, const std::string& root) {
+    WorkloadManifest manifest;
+    std::mt19937_64 rng(profile.seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::set<fs::path> directories;
+
+    fs::create_directories(root);
+    for (size_t i = 0; i < profile.fileCount; ++i) {
+        fs::path directory = drawDirectory(profile, rng);
+        if (!directory.empty() && directories.insert(directory).second) {
+            fs::create_directories(fs::path(root) / directory);
+        }
+
+        double kind = coin(rng);
+        if (!manifest.files.empty() && kind < profile.hardlinkFraction + profile.symlinkFraction) {
+            const std::string& target = manifest.files[rng() % manifest.files.size()];
+            fs::path link = directory / ("link" + std::to_string(i) + profile.extension);
+            std::error_code ec;
+            if (kind < profile.hardlinkFraction) {
+                fs::create_hard_link(fs::path(root) / target, fs::path(root) / link, ec);
+                manifest.hardlinks += ec ? 0 : 1;
+            } else {
+                fs::path relative = fs::path(target).lexically_relative(directory);
+                fs::create_symlink(relative, fs::path(root) / link, ec);
+                manifest.symlinks += ec ? 0 : 1;
+            }
+            // Filesystems without links get nothing rather than a different tree
+            continue;
+        }
+
+        fs::path file = directory / ("file" + std::to_string(i) + profile.extension);
+        auto data = compressibleData(drawFileSize(profile, rng), profile.compressibility, profile.seed * 1000003 + i);
+        if (writeFile(fs::path(root) / file, data)) {
+            manifest.files.push_back(file.generic_string());
+            manifest.totalBytes += data.size();
+        }
+    }
+    manifest.directories = directories.size();
+    return manifest;
+}
+
+uint64_t editWorkload(const WorkloadManifest& manifest, const std::string& root, double fraction, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<size_t> order(manifest.files.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    size_t count = static_cast<size_t>(std::llround(std::clamp(fraction, 0.0, 1.0) * order.size()));
+
+    uint64_t written = 0;
+    for (size_t i = 0; i < count; ++i) {
+        // Partial Fisher-Yates: the first count entries become a seeded sample
+        std::swap(order[i], order[i + rng() % (order.size() - i)]);
+        fs::path path = fs::path(root) / manifest.files[order[i]];
+
+        std::error_code ec;
+        uint64_t size = fs::file_size(path, ec);
+        if (ec) {
+            continue;
+        }
+
+        unsigned kind = static_cast<unsigned>(rng() % 10);
+        if (kind < 7 && size > 0) {
+            // Overwrite up to 4 KB in place
+            uint64_t offset = rng() % size;
+            auto data = compressibleData(static_cast<size_t>(std::min<uint64_t>(4096, size - offset)), 0.7, rng());
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(static_cast<std::streamoff>(offset));
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            written += data.size();
+        } else if (kind < 9) {
+            // Append up to 16 KB
+            uint64_t length = std::min<uint64_t>(1024 + rng() % (15 << 10), kMaxVaultFileSize - std::min(size, kMaxVaultFileSize));
+            if (length == 0) {
+                continue;
+            }
+            auto data = compressibleData(static_cast<size_t>(length), 0.7, rng());
+            std::ofstream file(path, std::ios::binary | std::ios::app);
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            written += data.size();
+        } else {
+            // Rewrite the whole file at roughly its old size
+            uint64_t length = std::min<uint64_t>(size / 2 + rng() % (size + 1), kMaxVaultFileSize);
+            auto data = compressibleData(static_cast<size_t>(length), 0.7, rng());
+            writeFile(path, data);
+            written += data.size();
+        }
+    }
+    return written;
+}
+
+} // namespace bench
+} // namespace phantomvault
@@ -0,0 +1,75 @@
+/**
+ * PhantomVault Benchmark Workloads
+ *
+ * Deterministic folder trees shaped like real user data: a source checkout,
+ * a photo library, VM images and a maildir store. A profile fixes the file
+ * count, the log-normal file-size distribution, the directory shape, how well
+ * the contents compress and how many entries are hard or symbolic links; the
+ * seed fixes everything else, so two runs build byte-identical trees.
+ *
+ * Links always point at a file generated earlier in the same tree and
+ * symlinks are relative, so nothing outside the root is ever reachable.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace phantomvault {
+namespace bench {
+
+struct WorkloadProfile {
+    std::string name;
+    std::string extension;              // appended to generated file names
+    size_t fileCount = 0;
+
+    // Log-normal around the median; sigma 0 gives every file the median size
+    size_t medianFileSize = 0;
+    double sizeSigma = 0.0;
+    size_t minFileSize = 0;
+    size_t maxFileSize = 0;
+
+    unsigned maxDepth = 1;              // directory levels below the root
+    unsigned directoryFanout = 1;       // subdirectories per directory
+    double compressibility = 0.5;       // see compressibleData()
+    double hardlinkFraction = 0.0;      // of entries that hard-link an earlier file
+    double symlinkFraction = 0.0;       // of entries that symlink an earlier file
+    uint64_t seed = 1;
+};
+
+/**
+ * What generateWorkload() built; files are relative paths of the regular
+ * files it wrote, links excluded
+ */
+struct WorkloadManifest {
+    std::vector<std::string> files;
+    size_t directories = 0;
+    size_t hardlinks = 0;
+    size_t symlinks = 0;
+    uint64_t totalBytes = 0;
+};
+
+// The built-in profiles: source_tree, photo_library, vm_images, mail_store
+const std::vector<WorkloadProfile>& workloadProfiles();
+
+// nullptr if no built-in profile has this name
+const WorkloadProfile* findWorkloadProfile(const std::string& name);
+
+// Same profile with the file count multiplied by factor (at least one file)
+WorkloadProfile scaledWorkload(const WorkloadProfile& profile, double factor);
+
+// Builds the tree under root, which must not exist yet or be empty
+WorkloadManifest generateWorkload(const WorkloadProfile& profile, const std::string& root);
+
+/**
+ * Edits fraction (0.0-1.0) of the manifest's files in place the way an
+ * editor or mail client would: most get a region overwritten, some are
+ * appended to, some truncated and rewritten. Returns the bytes written.
+ */
+uint64_t editWorkload(const WorkloadManifest& manifest, const std::string& root, double fraction, uint64_t seed);
+
+} // namespace bench
+} // namespace phantomvault
@@ -0,0 +1,161 @@
+/**
+ * PhantomVault Macrobenchmarks
+ *
+ * Whole-folder lock and unlock through ProfileVault on synthetic trees:
+ * many tiny files (per-file overhead), a few huge files (streaming
+ * throughput) and a mixed tree. The range is the number of files. Tree
+ * creation and cleanup are not timed; bytes processed are the tree's
+ * plaintext size and peak_rss_kb the process peak during the operation.
+ */
+
+#include "bench_framework.hpp"
+#include "bench_data.hpp"
+#include "../include/profile_vault.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace phantomvault {
+namespace bench {
+
+namespace {
+
+const std::string kMasterKey = "benchmark master key";
+
+enum class TreeShape {
+    TINY_FILES,     // 256 B - 4 KB, 16 per directory
+    HUGE_FILES,     // 12 MB each; one XTS data unit caps a file at 16 MB
+    MIXED           // log-uniform 1 KB - 8 MB
+};
+
+size_t fileSize(TreeShape shape, std::mt19937_64& rng) {
+    switch (shape) {
+        case TreeShape::TINY_FILES:
+            return std::uniform_int_distribution<size_t>(256, 4096)(rng);
+        case TreeShape::HUGE_FILES:
+            return 12u << 20;
+        case TreeShape::MIXED:
+        default:
+            return static_cast<size_t>(std::exp2(std::uniform_real_distribution<double>(10.0, 23.0)(rng)));
+    }
+}
+
+// Returns the bytes written
+uint64_t buildTree(const std::string& root, TreeShape shape, size_t files, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    uint64_t total = 0;
+    for (size_t i = 0; i < files; ++i) {
+        fs::path directory = fs::path(root) / ("dir" + std::to_string(i / 16));
+        fs::create_directories(directory);
+        auto data = compressibleData(fileSize(shape, rng), 0.5, seed + i);
+        std::ofstream file(directory / ("file" + std::to_string(i) + ".dat"), std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        total += data.size();
+    }
+    return total;
+}
+
+void benchVaultLock(State& state, TreeShape shape) {
+    ScratchDirectory scratch("lock");
+    ::PhantomVault::ProfileVault vault("bench", scratch.path("vault"));
+    if (!vault.initialize()) {
+        state.skipWithError("Vault initialization failed: " + vault.getLastError());
+        return;
+    }
+
+    uint64_t bytes = 0;
+    size_t peak_kb = 0;
+    size_t round = 0;
+    for (auto _ : state) {
+        state.pauseTiming();
+        std::string folder = scratch.path("tree" + std::to_string(round++));
+        bytes += buildTree(folder, shape, static_cast<size_t>(state.range()), 42);
+        resetPeakRss();
+        state.resumeTiming();
+
+        auto result = vault.lockFolder(folder, kMasterKey);
+
+        state.pauseTiming();
+        peak_kb = std::max(peak_kb, peakRssKB());
+        if (!result.success) {
+            state.skipWithError("Lock failed: " + result.error_details + " (" + vault.getLastError() + ")");
+        }
+        vault.unlockFolder(folder, kMasterKey, ::PhantomVault::UnlockMode::PERMANENT);
+        std::error_code ec;
+        fs::remove_all(folder, ec);
+        state.resumeTiming();
+    }
+    state.setBytesProcessed(bytes);
+    state.setItemsProcessed(state.iterations() * static_cast<uint64_t>(state.range()));
+    state.setCounter("peak_rss_kb", static_cast<double>(peak_kb));
+}
+
+void benchVaultUnlock(State& state, TreeShape shape) {
+    ScratchDirectory scratch("unlock");
+    ::PhantomVault::ProfileVault vault("bench", scratch.path("vault"));
+    if (!vault.initialize()) {
+        state.skipWithError("Vault initialization failed: " + vault.getLastError());
+        return;
+    }
+
+    uint64_t bytes = 0;
+    size_t peak_kb = 0;
+    size_t round = 0;
+    for (auto _ : state) {
+        state.pauseTiming();
+        std::string folder = scratch.path("tree" + std::to_string(round++));
+        bytes += buildTree(folder, shape, static_cast<size_t>(state.range()), 42);
+        auto locked = vault.lockFolder(folder, kMasterKey);
+        if (!locked.success) {
+            state.skipWithError("Lock failed: " + locked.error_details + " (" + vault.getLastError() + ")");
+            break;
+        }
+        resetPeakRss();
+        state.resumeTiming();
+
+        auto result = vault.unlockFolder(folder, kMasterKey, ::PhantomVault::UnlockMode::PERMANENT);
+
+        state.pauseTiming();
+        peak_kb = std::max(peak_kb, peakRssKB());
+        if (!result.success) {
+            state.skipWithError("Unlock failed: " + result.error_details);
+        }
+        std::error_code ec;
+        fs::remove_all(folder, ec);
+        state.resumeTiming();
+    }
+    state.setBytesProcessed(bytes);
+    state.setItemsProcessed(state.iterations() * static_cast<uint64_t>(state.range()));
+    state.setCounter("peak_rss_kb", static_cast<double>(peak_kb));
+}
+
+} // anonymous namespace
+
+void registerMacroBenchmarks(BenchmarkRunner& runner) {
+    const struct {
+        const char* name;
+        TreeShape shape;
+        int64_t files;
+    } kTrees[] = {
+        {"tiny_files", TreeShape::TINY_FILES, 200},
+        {"huge_files", TreeShape::HUGE_FILES, 4},
+        {"mixed", TreeShape::MIXED, 40},
+    };
+
+    for (const auto& tree : kTrees) {
+        TreeShape shape = tree.shape;
+        runner.add(std::string("vault/lock/") + tree.name, [shape](State& state) { benchVaultLock(state, shape); })
+            .args({tree.files}).iterations(1).repeat(3);
+        runner.add(std::string("vault/unlock/") + tree.name, [shape](State& state) { benchVaultUnlock(state, shape); })
+            .args({tree.files}).iterations(1).repeat(3);
+    }
+}
+
+} // namespace bench
+} // namespace phantomvault
@@ -0,0 +1,391 @@
+/**
+ * PhantomVault Microbenchmarks
+ *
+ * The building blocks of a lock or unlock, one at a time: key derivation,
+ * AES, zstd, checksums, metadata records, the password pattern matcher and
+ * an IPC round trip over loopback, plus allocator contention and the secure
+ * wipe and compare kernels. Ranges are payload sizes in bytes unless noted
+ * otherwise.
+ */
+
+#include "bench_framework.hpp"
+#include "bench_data.hpp"
+#include "../include/encryption_engine.hpp"
+#include "../include/checksum_engine.hpp"
+#include "../include/password_pattern_matcher.hpp"
+#include "../include/ipc_server.hpp"
+#include "../include/memory_manager.hpp"
+#include "../include/secure_memory.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+using PhantomVault::EncryptionEngine;
+
+namespace phantomvault {
+namespace bench {
+
+namespace {
+
+EncryptionEngine& engine() {
+    static EncryptionEngine instance;
+    return instance;
+}
+
+// Range is the Argon2id memory cost in KiB
+void benchKeyDerivation(State& state) {
+    EncryptionEngine::KeyDerivationConfig config;
+    config.memory_cost = static_cast<uint32_t>(state.range());
+    std::vector<uint8_t> salt(32, 0x5a);
+    for (auto _ : state) {
+        auto key = engine().deriveKey("benchmark password", salt, config);
+        if (key.empty()) {
+            state.skipWithError(engine().getLastError());
+        }
+        doNotOptimize(key);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+void benchAesEncrypt(State& state) {
+    auto data = randomData(static_cast<size_t>(state.range()), 1);
+    auto key = randomData(EncryptionEngine::AES_KEY_SIZE, 11);     // XTS rejects equal key halves
+    std::vector<uint8_t> iv(EncryptionEngine::AES_BLOCK_SIZE, 0x22);
+    for (auto _ : state) {
+        auto encrypted = engine().encryptData(data, key, iv);
+        if (encrypted.empty()) {
+            state.skipWithError(engine().getLastError());
+        }
+        doNotOptimize(encrypted);
+    }
+    state.setBytesProcessed(state.iterations() * data.size());
+}
+
+void benchAesDecrypt(State& state) {
+    auto data = randomData(static_cast<size_t>(state.range()), 2);
+    auto key = randomData(EncryptionEngine::AES_KEY_SIZE, 11);     // XTS rejects equal key halves
+    std::vector<uint8_t> iv(EncryptionEngine::AES_BLOCK_SIZE, 0x22);
+    auto encrypted = engine().encryptData(data, key, iv);
+    for (auto _ : state) {
+        auto decrypted = engine().decryptData(encrypted, key, iv);
+        if (decrypted.size() != data.size()) {
+            state.skipWithError(engine().getLastError());
+        }
+        doNotOptimize(decrypted);
+    }
+    state.setBytesProcessed(state.iterations() * data.size());
+}
+
+void benchZstdCompress(State& state) {
+    auto data = compressibleData(static_cast<size_t>(state.range()), 0.5, 3);
+    size_t compressed_size = 0;
+    for (auto _ : state) {
+        auto compressed = engine().compressData(data);
+        compressed_size = compressed.size();
+        doNotOptimize(compressed);
+    }
+    state.setBytesProcessed(state.iterations() * data.size());
+    state.setCounter("ratio", compressed_size ? static_cast<double>(data.size()) / compressed_size : 0.0);
+}
+
+void benchZstdDecompress(State& state) {
+    auto data = compressibleData(static_cast<size_t>(state.range()), 0.5, 4);
+    auto compressed = engine().compressData(data);
+    for (auto _ : state) {
+        auto restored = engine().decompressData(compressed, data.size());
+        if (restored.size() != data.size()) {
+            state.skipWithError(engine().getLastError());
+        }
+        doNotOptimize(restored);
+    }
+    state.setBytesProcessed(state.iterations() * data.size());
+}
+
+void benchChecksum(State& state, ChecksumAlgorithm algorithm) {
+    static ChecksumEngine checksums;
+    auto data = randomData(static_cast<size_t>(state.range()), 5);
+    for (auto _ : state) {
+        auto digest = checksums.hashBuffer(data.data(), data.size(), algorithm);
+        doNotOptimize(digest);
+    }
+    state.setBytesProcessed(state.iterations() * data.size());
+}
+
+// The per-file record ProfileVault writes, built and parsed back
+json metadataRecord(const std::vector<uint8_t>& payload) {
+    json record;
+    record["encrypted_data"] = payload;
+    record["iv"] = std::vector<uint8_t>(16, 0x22);
+    record["salt"] = std::vector<uint8_t>(32, 0x5a);
+    record["algorithm"] = "AES-256-XTS";
+    record["compression_algorithm"] = "zstd";
+    record["original_size"] = payload.size();
+    record["metadata"] = {
+        {"original_path", "/home/user/Documents/project/notes/meeting-2024-03-18.md"},
+        {"original_permissions", "644"},
+        {"original_size", payload.size()},
+        {"created_timestamp", 1710763200},
+        {"modified_timestamp", 1710766800},
+        {"accessed_timestamp", 1710770400},
+        {"checksum", std::string(64, 'a')},
+        {"checksum_algorithm", "blake3"}
+    };
+    return record;
+}
+
+void benchMetadataSerialize(State& state) {
+    auto payload = randomData(static_cast<size_t>(state.range()), 6);
+    for (auto _ : state) {
+        std::string text = metadataRecord(payload).dump();
+        doNotOptimize(text);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+void benchMetadataParse(State& state) {
+    std::string text = metadataRecord(randomData(static_cast<size_t>(state.range()), 7)).dump();
+    for (auto _ : state) {
+        json parsed = json::parse(text);
+        doNotOptimize(parsed);
+    }
+    state.setBytesProcessed(state.iterations() * text.size());
+}
+
+// Typed text with a pattern every few words; range is the text length
+void benchPatternMatcher(State& state) {
+    std::string text = typedText(static_cast<size_t>(state.range()), 8);
+    PasswordPatternMatcher matcher;
+    size_t matches = 0;
+    for (auto _ : state) {
+        PatternMatch match;
+        for (char c : text) {
+            matches += matcher.feed(c, match) ? 1 : 0;
+        }
+        matches += matcher.finish(match) ? 1 : 0;
+    }
+    doNotOptimize(matches);
+    state.setBytesProcessed(state.iterations() * text.size());
+}
+
+/**
+ * Range is the thread count. Every thread keeps a window of live blocks of
+ * 16 B - 2 KB and replaces one per step, so caches, batch exchange with the
+ * central lists and slab growth all show up; malloc runs the same pattern.
+ */
+template <typename Allocate, typename Deallocate>
+void allocatorContention(State& state, Allocate allocate, Deallocate deallocate) {
+    constexpr size_t kPairsPerThread = 20000;
+    constexpr size_t kWindow = 64;
+    const int threads = static_cast<int>(state.range());
+    for (auto _ : state) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&allocate, &deallocate, t]() {
+                void* live[kWindow] = {};
+                size_t sizes[kWindow] = {};
+                for (size_t i = 0; i < kPairsPerThread; ++i) {
+                    size_t slot = i % kWindow;
+                    if (live[slot]) {
+                        deallocate(live[slot], sizes[slot]);
+                    }
+                    sizes[slot] = 16u << ((i * 7 + static_cast<size_t>(t)) % 8);
+                    live[slot] = allocate(sizes[slot]);
+                    doNotOptimize(live[slot]);
+                }
+                for (size_t slot = 0; slot < kWindow; ++slot) {
+                    deallocate(live[slot], sizes[slot]);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    state.setItemsProcessed(state.iterations() * threads * kPairsPerThread);
+}
+
+void benchPoolContention(State& state) {
+    auto& manager = MemoryManager::getInstance();
+    manager.setMemoryLimit(SIZE_MAX);
+    allocatorContention(state,
+                        [&manager](size_t size) { return manager.allocate(size); },
+                        [&manager](void* ptr, size_t size) { manager.deallocate(ptr, size); });
+}
+
+void benchMallocContention(State& state) {
+    allocatorContention(state,
+                        [](size_t size) { return std::malloc(size); },
+                        [](void* ptr, size_t) { std::free(ptr); });
+}
+
+// Pins one wipe/compare kernel for a benchmark and restores the previous one
+class KernelPin {
+public:
+    explicit KernelPin(SecureMemoryKernel kernel) : previous_(activeSecureMemoryKernel()) {
+        setSecureMemoryKernel(kernel);
+    }
+    ~KernelPin() { setSecureMemoryKernel(previous_); }
+
+private:
+    SecureMemoryKernel previous_;
+};
+
+void benchSecureZero(State& state, SecureMemoryKernel kernel) {
+    KernelPin pin(kernel);
+    std::vector<uint8_t> buffer(static_cast<size_t>(state.range()), 0x5a);
+    for (auto _ : state) {
+        secureZero(buffer.data(), buffer.size());
+        doNotOptimize(buffer.data());
+    }
+    state.setBytesProcessed(state.iterations() * buffer.size());
+}
+
+// The classic portable wipe, one volatile byte store at a time, for reference
+void benchVolatileWipe(State& state) {
+    std::vector<uint8_t> buffer(static_cast<size_t>(state.range()), 0x5a);
+    for (auto _ : state) {
+        volatile uint8_t* bytes = buffer.data();
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            bytes[i] = 0;
+        }
+        doNotOptimize(buffer.data());
+    }
+    state.setBytesProcessed(state.iterations() * buffer.size());
+}
+
+// Equal buffers: the whole length is compared, as it is on every call
+void benchConstantTimeEqual(State& state, SecureMemoryKernel kernel) {
+    KernelPin pin(kernel);
+    auto a = randomData(static_cast<size_t>(state.range()), 9);
+    auto b = a;
+    for (auto _ : state) {
+        bool equal = constantTimeEqual(a.data(), b.data(), a.size());
+        doNotOptimize(equal);
+    }
+    state.setBytesProcessed(state.iterations() * a.size());
+}
+
+// memcmp is not constant-time; it is here as the speed to aim for
+void benchMemcmp(State& state) {
+    auto a = randomData(static_cast<size_t>(state.range()), 9);
+    auto b = a;
+    for (auto _ : state) {
+        int order = std::memcmp(a.data(), b.data(), a.size());
+        doNotOptimize(order);
+    }
+    state.setBytesProcessed(state.iterations() * a.size());
+}
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+// One server for the whole run; ports are tried until one is free
+int ipcPort() {
+    static std::unique_ptr<IPCServer> server;
+    static int port = 0;
+    if (!server) {
+        for (int candidate = 18700; candidate < 18750; ++candidate) {
+            auto instance = std::make_unique<IPCServer>();
+            if (instance->initialize(candidate) && instance->start()) {
+                server = std::move(instance);
+                port = candidate;
+                break;
+            }
+        }
+    }
+    return port;
+}
+
+void benchIpcRoundTrip(State& state) {
+    int port = ipcPort();
+    if (port == 0) {
+        state.skipWithError("No free port for the IPC server");
+        return;
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    const std::string request = "GET /health HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+
+    for (auto _ : state) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            state.skipWithError("Failed to connect to the IPC server");
+            break;
+        }
+        send(fd, request.data(), request.size(), 0);
+        char buffer[4096];
+        size_t received = 0;
+        for (ssize_t n; (n = recv(fd, buffer, sizeof(buffer), 0)) > 0;) {
+            received += static_cast<size_t>(n);
+        }
+        close(fd);
+        if (received == 0) {
+            state.skipWithError("Empty IPC response");
+        }
+    }
+    state.setItemsProcessed(state.iterations());
+}
+#endif
+
+} // anonymous namespace
+
+void registerMicroBenchmarks(BenchmarkRunner& runner) {
+    runner.add("kdf/argon2id", benchKeyDerivation).args({8192, 65536}).repeat(3);
+
+    runner.add("aes/encrypt", benchAesEncrypt).args({4096, 65536, 1 << 20});
+    runner.add("aes/decrypt", benchAesDecrypt).args({4096, 65536, 1 << 20});
+
+    runner.add("zstd/compress", benchZstdCompress).args({65536, 1 << 20});
+    runner.add("zstd/decompress", benchZstdDecompress).args({65536, 1 << 20});
+
+    runner.add("checksum/sha256", [](State& state) { benchChecksum(state, ChecksumAlgorithm::SHA256); })
+        .args({4096, 1 << 20});
+    runner.add("checksum/blake3", [](State& state) { benchChecksum(state, ChecksumAlgorithm::BLAKE3); })
+        .args({4096, 1 << 20});
+
+    runner.add("metadata/serialize", benchMetadataSerialize).args({256, 16384});
+    runner.add("metadata/parse", benchMetadataParse).args({256, 16384});
+
+    runner.add("matcher/feed", benchPatternMatcher).args({4096});
+
+    runner.add("memory/pool_contention", benchPoolContention).args({1, 2, 4, 8, 16, 32});
+    runner.add("memory/malloc_contention", benchMallocContention).args({1, 2, 4, 8, 16, 32});
+
+    for (SecureMemoryKernel kernel : {SecureMemoryKernel::PORTABLE, SecureMemoryKernel::SSE2,
+                                      SecureMemoryKernel::AVX2, SecureMemoryKernel::NEON}) {
+        if (!isSecureMemoryKernelSupported(kernel)) {
+            continue;
+        }
+        std::string name = secureMemoryKernelName(kernel);
+        runner.add("wipe/secure_zero/" + name, [kernel](State& state) { benchSecureZero(state, kernel); })
+            .args({64, 4096, 1 << 20});
+        runner.add("compare/constant_time/" + name, [kernel](State& state) { benchConstantTimeEqual(state, kernel); })
+            .args({64, 4096, 1 << 20});
+    }
+    runner.add("wipe/volatile_bytes", benchVolatileWipe).args({64, 4096, 1 << 20});
+    runner.add("compare/memcmp", benchMemcmp).args({64, 4096, 1 << 20});
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    runner.add("ipc/round_trip", benchIpcRoundTrip);
+#endif
+}
+
+} // namespace bench
+} // namespace phantomvault
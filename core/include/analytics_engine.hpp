@@ -13,6 +13,7 @@
 #include <functional>
 #include <chrono>
 #include <map>
+#include "event_queue.hpp"
 
 namespace phantomvault {
 
@@ -83,6 +84,7 @@ struct AnalyticsQuery {
     std::vector<SecurityLevel> securityLevels;
     std::string profileId; // Empty for all profiles
     size_t maxResults = 1000;
+    bool includeEvents = true; // Raw events are only needed for drill-down views
 };
 
 /**
@@ -138,6 +140,12 @@ public:
     void setEventCallback(std::function<void(const AnalyticsEvent&)> callback);
     void setSecurityAlertCallback(std::function<void(const AnalyticsEvent&)> callback);
     
+    // Ingestion queue (events are buffered and applied by a writer thread)
+    void setOverflowPolicy(OverflowPolicy policy);
+    void setOverflowSampleRate(uint32_t oneInN);                     // SAMPLE keeps 1 in N under pressure
+    void setOverflowBlockTimeout(std::chrono::milliseconds timeout); // How long BLOCK waits for room
+    EventQueueStats getIngestionStats() const;
+    
     // Error handling
     std::string getLastError() const;
 
@@ -0,0 +1,79 @@
+/**
+ * PhantomVault Audit Chain
+ *
+ * Append-only, hash-chained record stream backing the security log. Every
+ * record carries the hash of its predecessor, and every checkpointInterval
+ * records a Merkle checkpoint (chain head, byte offset, root over the
+ * interval's records) is appended to a sidecar file. Verification resumes
+ * from the last verified position or checkpoint, so its cost scales with
+ * newly written data rather than total log size.
+ *
+ * Rotation seals the active segment with a final checkpoint and compresses it
+ * with zstd; the chain continues into the next segment.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace phantomvault {
+
+class AuditChain {
+public:
+    struct Config {
+        size_t checkpointInterval = 1024;   // records per Merkle checkpoint
+        int compressionLevel = 3;           // zstd level for sealed segments
+    };
+
+    struct VerifyResult {
+        bool valid = false;
+        uint64_t recordsVerified = 0;
+        uint64_t bytesRead = 0;
+        std::string error;
+    };
+
+    AuditChain();
+    explicit AuditChain(const Config& config);
+    ~AuditChain();
+
+    /**
+     * Open (or create) the active segment at logPath and recover the chain
+     * head from the last checkpoint. Returns false if the data written since
+     * that checkpoint fails verification; the chain is then re-anchored at
+     * the end of the file so logging can continue.
+     */
+    bool open(const std::string& logPath);
+    void close();
+
+    /**
+     * Append serialized JSON objects as chained records
+     */
+    bool append(const std::vector<std::string>& records);
+
+    // Verify records written since the last successful verification
+    VerifyResult verifyIncremental();
+
+    // Verify the whole active segment and its checkpoint file from scratch
+    VerifyResult verifyFull() const;
+
+    /**
+     * Seal the active segment, compress it to "<logPath>.<ms>.zst" and start
+     * a new segment. Returns the compressed path, or empty on failure.
+     */
+    std::string sealAndRotate();
+
+    uint64_t getRecordCount() const;
+    uint64_t getSegmentSize() const;
+    std::string getHeadHash() const;
+    std::string getLastError() const;
+
+private:
+    class Implementation;
+    std::unique_ptr<Implementation> pimpl;
+};
+
+} // namespace phantomvault
@@ -0,0 +1,74 @@
+/**
+ * PhantomVault Checksum Engine
+ *
+ * Pluggable content hashing for file checksums. BLAKE3 is the default: chunks
+ * are compressed eight at a time with AVX2 where the CPU has it, and large
+ * inputs are split into subtrees hashed on several threads. SHA-256 goes
+ * through OpenSSL (SHA-NI where available) and remains for records written
+ * before the algorithm was stored alongside the checksum.
+ *
+ * Files are mapped or read in large blocks with pread(); batches of small
+ * files are hashed in parallel, one file per worker at a time.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace phantomvault {
+
+enum class ChecksumAlgorithm {
+    SHA256,
+    BLAKE3
+};
+
+// Stable id stored next to a checksum ("sha256", "blake3")
+const char* checksumAlgorithmName(ChecksumAlgorithm algorithm);
+std::optional<ChecksumAlgorithm> parseChecksumAlgorithm(const std::string& name);
+
+/**
+ * Incremental hasher for one message
+ */
+class Hasher {
+public:
+    virtual ~Hasher() = default;
+    virtual void update(const void* data, size_t size) = 0;
+    virtual std::vector<uint8_t> finish() = 0;     // 32-byte digest
+};
+
+class ChecksumEngine {
+public:
+    static constexpr ChecksumAlgorithm kDefaultAlgorithm = ChecksumAlgorithm::BLAKE3;
+
+    explicit ChecksumEngine(size_t threads = 0);    // 0 = hardware concurrency, capped at 8
+    ~ChecksumEngine();
+
+    ChecksumEngine(const ChecksumEngine&) = delete;
+    ChecksumEngine& operator=(const ChecksumEngine&) = delete;
+
+    static std::unique_ptr<Hasher> createHasher(ChecksumAlgorithm algorithm);
+
+    // Hex digests; empty string on failure
+    std::string hashBuffer(const void* data, size_t size, ChecksumAlgorithm algorithm = kDefaultAlgorithm) const;
+    std::string hashFile(const std::string& path, ChecksumAlgorithm algorithm = kDefaultAlgorithm) const;
+
+    // One digest per path, in order; empty entries for files that could not be read
+    std::vector<std::string> hashFiles(const std::vector<std::string>& paths,
+                                       ChecksumAlgorithm algorithm = kDefaultAlgorithm) const;
+
+    // True when BLAKE3 uses the AVX2 kernel on this CPU
+    static bool simdAvailable();
+
+    std::string getLastError() const;
+
+private:
+    class Implementation;
+    std::unique_ptr<Implementation> pimpl;
+};
+
+} // namespace phantomvault
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <chrono>
 #include <memory_resource>
+#include "secure_arena.hpp"
 
 // Forward declarations
 struct evp_cipher_ctx_st;
@@ -33,6 +34,8 @@ public:
         std::vector<uint8_t> salt;
         std::string algorithm;
         std::string compression_algorithm;
+        std::string checksum;               // of the plaintext that was encrypted
+        std::string checksum_algorithm;
         size_t original_size;
         size_t compressed_size;
         bool success;
@@ -51,7 +54,8 @@ public:
         int64_t created_timestamp;
         int64_t modified_timestamp;
         int64_t accessed_timestamp;
-        std::string checksum_sha256;
+        std::string checksum;
+        std::string checksum_algorithm;     // "blake3", or "sha256" for older records
     };
 
     /**
@@ -72,6 +76,7 @@ public:
     static constexpr size_t AES_BLOCK_SIZE = 16;
     static constexpr size_t AES_KEY_SIZE = 64;  // 512 bits for XTS mode (2 x 256-bit keys)
     static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;  // 1MB chunks
+    static constexpr size_t MAX_FILE_SIZE = 16 * 1024 * 1024;  // one XTS data unit per file
 
     EncryptionEngine();
     ~EncryptionEngine();
@@ -123,6 +128,21 @@ public:
                                     size_t original_size,
                                     const KeyDerivationConfig& config = KeyDerivationConfig());
 
+    /**
+     * @brief Decrypt file with compression support into a caller-owned buffer
+     * @param output Receives the plaintext; allocate it from a SecureArena
+     *               scope to keep it out of swap and core dumps
+     * @return true on success; output is left empty on failure
+     */
+    bool decryptFile(const std::vector<uint8_t>& encrypted_data,
+                     const std::string& password,
+                     const std::vector<uint8_t>& iv,
+                     const std::vector<uint8_t>& salt,
+                     const std::string& compression_algorithm,
+                     size_t original_size,
+                     phantomvault::SecureBuffer& output,
+                     const KeyDerivationConfig& config = KeyDerivationConfig());
+
     /**
      * @brief Encrypt data in memory using AES-256-CBC
      * @param data Data to encrypt
@@ -199,18 +219,36 @@ public:
     // File utilities
 
     /**
-     * @brief Calculate SHA-256 checksum of file
+     * @brief Calculate checksum of file with the default algorithm (BLAKE3)
      * @param file_path Path to file
-     * @return Hex-encoded SHA-256 hash, empty string on failure
+     * @return Hex-encoded hash, empty string on failure
      */
     std::string calculateFileChecksum(const std::string& file_path);
 
+    /**
+     * @brief Calculate checksum of file
+     * @param file_path Path to file
+     * @param algorithm Checksum algorithm id ("blake3", "sha256")
+     * @return Hex-encoded hash, empty string on failure
+     */
+    std::string calculateFileChecksum(const std::string& file_path, const std::string& algorithm);
+
+    /**
+     * @brief Calculate checksum of a buffer
+     * @param data Data to hash
+     * @param algorithm Checksum algorithm id ("blake3", "sha256")
+     * @return Hex-encoded hash, empty string on failure
+     */
+    std::string calculateChecksum(const std::vector<uint8_t>& data, const std::string& algorithm);
+    std::string calculateChecksum(const uint8_t* data, size_t size, const std::string& algorithm);
+
     /**
      * @brief Get file metadata (size, timestamps, permissions)
      * @param file_path Path to file
+     * @param with_checksum Also hash the file contents
      * @return FileMetadata structure
      */
-    FileMetadata getFileMetadata(const std::string& file_path);
+    FileMetadata getFileMetadata(const std::string& file_path, bool with_checksum = true);
 
     /**
      * @brief Securely wipe memory containing sensitive data
@@ -269,10 +307,20 @@ public:
     std::chrono::nanoseconds getLastOperationTime() const;
     double getThroughputMBps() const;
     
-    // Memory pool allocation for zero-overhead operations
+    /**
+     * Per-file keys, plaintext and compressed plaintext always come from a
+     * SecureArena: the calling thread's 1 MB arena by default, or with
+     * pooling enabled a dedicated arena owned by this engine that holds a
+     * MAX_FILE_SIZE file and its compressed copy at once, so no file needs
+     * an overflow mapping. A pooled engine must not be shared across threads.
+     */
     void enableMemoryPooling();
     void disableMemoryPooling();
     size_t getMemoryPoolSize() const;
+    
+    // The arena the engine's file operations use; callers that keep
+    // decrypted output should allocate and scope it from the same arena
+    phantomvault::SecureArena& scratchArena();
 
 private:
     // OpenSSL context management (must be first for proper initialization order)
@@ -288,7 +336,17 @@ private:
     mutable std::chrono::nanoseconds last_operation_time_;
     mutable double last_throughput_mbps_;
     bool memory_pooling_enabled_;
-    std::unique_ptr<std::pmr::memory_resource> memory_pool_;
+    std::unique_ptr<phantomvault::SecureArena> memory_pool_;
+
+    // Raw-buffer cores shared by the vector API and the secure arena paths
+    bool deriveKeyInto(const std::string& password, const std::vector<uint8_t>& salt,
+                       const KeyDerivationConfig& config, uint8_t* key);
+    bool encryptBytes(const uint8_t* data, size_t size, const uint8_t* key, size_t key_size,
+                      const std::vector<uint8_t>& iv, std::vector<uint8_t>& output);
+    bool decryptBytes(const uint8_t* data, size_t size, const uint8_t* key, size_t key_size,
+                      const std::vector<uint8_t>& iv, uint8_t* output, size_t& output_size);
+    size_t compressBytes(const uint8_t* data, size_t size, uint8_t* output, size_t capacity, int compression_level);
+    bool decompressBytes(const uint8_t* data, size_t size, uint8_t* output, size_t original_size);
 
     // Internal encryption/decryption helpers
     bool encryptChunk(const uint8_t* input, size_t input_len,
@@ -300,7 +358,7 @@ private:
                      std::vector<uint8_t>& output);
     
     // SIMD-optimized encryption helper
-    bool encryptDataSIMD(const std::vector<uint8_t>& data, 
+    bool encryptDataSIMD(const uint8_t* data, size_t size,
                         std::vector<uint8_t>& encrypted_data,
                         EVP_CIPHER_CTX* ctx, int& len, int& total_len);
 
@@ -6,6 +6,7 @@
 #include <memory>
 #include <functional>
 #include <map>
+#include "event_queue.hpp"
 
 namespace phantomvault {
 
@@ -121,6 +122,9 @@ public:
     bool restoreFileFromBackup(const std::string& filePath, const std::string& backupPath);
     void cleanupBackups(const std::string& profileId, std::chrono::hours maxAge = std::chrono::hours(24));
     
+    // Caps the bytes per second backup and restore copies move (0 = unlimited, the default)
+    void setBackupIOLimit(size_t max_bytes_per_second);
+    
     // Audit trail
     std::vector<SecurityEvent> getSecurityEvents(const std::string& profileId = "",
                                                 SecurityEventType type = SecurityEventType::AUTHENTICATION_FAILURE,
@@ -138,6 +142,12 @@ public:
     void setSecurityAlertCallback(std::function<void(const SecurityEvent&)> callback);
     void setCriticalErrorCallback(std::function<void(const SecurityEvent&)> callback);
     
+    // Ingestion queue (events are buffered and persisted by a writer thread)
+    void setOverflowPolicy(OverflowPolicy policy);
+    void setOverflowSampleRate(uint32_t oneInN);                     // SAMPLE keeps 1 in N under pressure
+    void setOverflowBlockTimeout(std::chrono::milliseconds timeout); // How long BLOCK waits for room
+    EventQueueStats getIngestionStats() const;
+    
     // Statistics
     size_t getEventCount(SecurityEventType type = SecurityEventType::AUTHENTICATION_FAILURE) const;
     std::map<SecurityEventType, size_t> getEventStatistics() const;
@@ -0,0 +1,328 @@
+/**
+ * PhantomVault Event Queue
+ *
+ * Bounded lock-free multi-producer queue used to hand events from hot paths
+ * (keyboard thread, vault workers, IPC handlers) to a dedicated writer thread.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace phantomvault {
+
+/**
+ * What a producer does when the queue is full
+ */
+enum class OverflowPolicy {
+    DROP_OLDEST,  // Evict the oldest queued event to make room
+    BLOCK,        // Wait for the writer to free a slot, up to the block timeout
+    SAMPLE        // Under pressure keep only 1 in N events, drop when full
+};
+
+/**
+ * Ingestion counters exposed by engines that own an event queue
+ */
+struct EventQueueStats {
+    uint64_t enqueued = 0;
+    uint64_t droppedOldest = 0;
+    uint64_t droppedNewest = 0;
+    uint64_t sampledOut = 0;
+    uint64_t blockedWaits = 0;
+    size_t pending = 0;
+    size_t capacity = 0;
+};
+
+/**
+ * Bounded queue with per-slot sequence numbers (Vyukov design).
+ *
+ * Producers never take a lock. tryPop is safe from any thread, which is what
+ * lets DROP_OLDEST evict from the producer side, but events are applied by a
+ * single consumer. Readers that need to observe everything logged before them
+ * call waitForConsumer instead of draining themselves.
+ */
+template<typename T>
+class BoundedEventQueue {
+public:
+    explicit BoundedEventQueue(size_t capacity = 4096, OverflowPolicy policy = OverflowPolicy::DROP_OLDEST)
+        : capacity_(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity))
+        , mask_(capacity_ - 1)
+        , buffer_(new Cell[capacity_])
+        , policy_(policy)
+    {
+        for (size_t i = 0; i < capacity_; ++i) {
+            buffer_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedEventQueue(const BoundedEventQueue&) = delete;
+    BoundedEventQueue& operator=(const BoundedEventQueue&) = delete;
+
+    void setPolicy(OverflowPolicy policy) { policy_.store(policy, std::memory_order_relaxed); }
+    OverflowPolicy getPolicy() const { return policy_.load(std::memory_order_relaxed); }
+    void setSampleRate(uint32_t oneInN) { sample_rate_.store(oneInN == 0 ? 1 : oneInN, std::memory_order_relaxed); }
+    void setBlockTimeout(std::chrono::milliseconds timeout) { block_timeout_ms_.store(timeout.count(), std::memory_order_relaxed); }
+
+    /**
+     * Enqueue according to the overflow policy. Returns false if the event was
+     * discarded (full under SAMPLE, sampled out, or still full when BLOCK's
+     * timeout expired).
+     */
+    bool push(T&& item) {
+        bool accepted = false;
+
+        switch (policy_.load(std::memory_order_relaxed)) {
+            case OverflowPolicy::DROP_OLDEST:
+                for (int attempt = 0; attempt < 64 && !accepted; ++attempt) {
+                    if (tryPush(item)) {
+                        accepted = true;
+                    } else {
+                        T victim;
+                        if (tryPop(victim)) {
+                            dropped_oldest_.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                }
+                break;
+
+            case OverflowPolicy::BLOCK: {
+                // Bounded so a stalled or stopped writer cannot hang producers
+                auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(block_timeout_ms_.load(std::memory_order_relaxed));
+                for (int spins = 0; !(accepted = tryPush(item)); ++spins) {
+                    blocked_waits_.fetch_add(1, std::memory_order_relaxed);
+                    notifyConsumer();
+                    if (std::chrono::steady_clock::now() >= deadline) {
+                        break;
+                    }
+                    if (spins < 64) {
+                        std::this_thread::yield();
+                    } else {
+                        std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    }
+                }
+                break;
+            }
+
+            case OverflowPolicy::SAMPLE:
+                if (sizeApprox() >= capacity_ - capacity_ / 4) {
+                    uint32_t rate = sample_rate_.load(std::memory_order_relaxed);
+                    if (sample_counter_.fetch_add(1, std::memory_order_relaxed) % rate != 0) {
+                        sampled_out_.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                }
+                accepted = tryPush(item);
+                break;
+        }
+
+        if (!accepted) {
+            dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        enqueued_.fetch_add(1, std::memory_order_relaxed);
+
+        // Pairs with the fence in waitForItems so a sleeping writer is never missed
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumer_waiting_.load(std::memory_order_relaxed)) {
+            notifyConsumer();
+        }
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &buffer_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(cell->data);
+        cell->data = T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Move up to maxItems queued events into out. Returns the number moved.
+     */
+    size_t drain(std::vector<T>& out, size_t maxItems = SIZE_MAX) {
+        size_t count = 0;
+        T item;
+        while (count < maxItems && tryPop(item)) {
+            out.push_back(std::move(item));
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * Block the consumer until events arrive, the timeout expires, or wake() is called.
+     */
+    void waitForItems(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        consumer_waiting_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sizeApprox() == 0 && !wake_requested_) {
+            wake_cv_.wait_for(lock, timeout);
+        }
+        wake_requested_ = false;
+        consumer_waiting_.store(false, std::memory_order_relaxed);
+    }
+
+    /**
+     * Block the consumer until events arrive or wake() is called. For writers
+     * that have nothing periodic to do, so an idle queue costs no wakeups.
+     */
+    void waitForItems() {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        consumer_waiting_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wake_cv_.wait(lock, [this]() { return sizeApprox() > 0 || wake_requested_; });
+        wake_requested_ = false;
+        consumer_waiting_.store(false, std::memory_order_relaxed);
+    }
+
+    void wake() {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_requested_ = true;
+        wake_cv_.notify_all();
+    }
+
+    /**
+     * Reader side of the flush barrier. Wakes the consumer and waits until it
+     * completes a drain pass that started after this call, so every event
+     * pushed before the call has been applied. Returns false on timeout.
+     */
+    bool waitForConsumer(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        uint64_t ticket = ++flush_requested_;
+        wake_requested_ = true;
+        wake_cv_.notify_all();
+        return flush_cv_.wait_for(lock, timeout, [&]() { return flush_completed_ >= ticket; });
+    }
+
+    /**
+     * Consumer side of the flush barrier: call beginConsumerPass before
+     * draining and hand its result to endConsumerPass once the pass is applied.
+     */
+    uint64_t beginConsumerPass() {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        return flush_requested_;
+    }
+
+    void endConsumerPass(uint64_t ticket) {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        if (ticket > flush_completed_) {
+            flush_completed_ = ticket;
+        }
+        flush_cv_.notify_all();
+    }
+
+    size_t sizeApprox() const {
+        size_t enq = enqueue_pos_.load(std::memory_order_relaxed);
+        size_t deq = dequeue_pos_.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    EventQueueStats getStats() const {
+        EventQueueStats stats;
+        stats.enqueued = enqueued_.load(std::memory_order_relaxed);
+        stats.droppedOldest = dropped_oldest_.load(std::memory_order_relaxed);
+        stats.droppedNewest = dropped_newest_.load(std::memory_order_relaxed);
+        stats.sampledOut = sampled_out_.load(std::memory_order_relaxed);
+        stats.blockedWaits = blocked_waits_.load(std::memory_order_relaxed);
+        stats.pending = sizeApprox();
+        stats.capacity = capacity_;
+        return stats;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    bool tryPush(T& item) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &buffer_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    void notifyConsumer() {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_cv_.notify_one();
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> buffer_;
+    std::atomic<OverflowPolicy> policy_;
+    std::atomic<uint32_t> sample_rate_{8};
+    std::atomic<int64_t> block_timeout_ms_{100};
+
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<size_t> dequeue_pos_{0};
+
+    alignas(64) std::atomic<uint64_t> enqueued_{0};
+    std::atomic<uint64_t> dropped_oldest_{0};
+    std::atomic<uint64_t> dropped_newest_{0};
+    std::atomic<uint64_t> sampled_out_{0};
+    std::atomic<uint64_t> blocked_waits_{0};
+    std::atomic<uint64_t> sample_counter_{0};
+
+    alignas(64) std::atomic<bool> consumer_waiting_{false};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    bool wake_requested_ = false;
+    std::condition_variable flush_cv_;
+    uint64_t flush_requested_ = 0;
+    uint64_t flush_completed_ = 0;
+};
+
+} // namespace phantomvault
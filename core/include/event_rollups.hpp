@@ -0,0 +1,196 @@
+/**
+ * PhantomVault Event Rollups
+ *
+ * Pre-aggregated analytics event counts at minute, hour and day resolution,
+ * owned by AnalyticsEngine and persisted alongside its statistics.
+ */
+
+#pragma once
+
+#include "analytics_engine.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace phantomvault {
+
+/**
+ * Every recorded event bumps one counter per tier, keyed by bucket start,
+ * profile and event type. Range queries walk the coarsest buckets that fit
+ * inside the range, so a report over months touches a few hundred buckets
+ * instead of every raw event.
+ *
+ * Not thread-safe; AnalyticsEngine guards it with its events mutex.
+ */
+class EventRollups {
+public:
+    static constexpr size_t kTypeCount = static_cast<size_t>(EventType::SYSTEM_ERROR) + 1;
+
+    using TypeCounts = std::array<uint64_t, kTypeCount>;
+
+    struct Tier {
+        const char* name;
+        int64_t width;      // bucket width in seconds
+        int64_t retention;  // how long buckets are kept, in seconds
+        std::map<int64_t, std::map<std::string, TypeCounts>> buckets;
+    };
+
+    static int64_t toEpochSeconds(std::chrono::system_clock::time_point tp) {
+        return std::chrono::duration_cast<std::chrono::seconds>(tp.time_since_epoch()).count();
+    }
+
+    static int64_t floorTo(int64_t value, int64_t width) {
+        int64_t q = value / width;
+        if (value % width != 0 && value < 0) {
+            --q;
+        }
+        return q * width;
+    }
+
+    EventRollups()
+        : tiers_{{
+            {"day", 86400, 730LL * 86400, {}},
+            {"hour", 3600, 90LL * 86400, {}},
+            {"minute", 60, 48LL * 3600, {}}
+        }}
+    {}
+
+    void record(EventType type, const std::string& profileId, std::chrono::system_clock::time_point timestamp) {
+        int64_t ts = toEpochSeconds(timestamp);
+        size_t typeIndex = static_cast<size_t>(type);
+        for (auto& tier : tiers_) {
+            auto& counts = tier.buckets[floorTo(ts, tier.width)][profileId];
+            counts[typeIndex]++;
+        }
+    }
+
+    /**
+     * Sum counts per profile over [start, end). Boundaries are resolved at the
+     * finest tier that still holds data for that point in time.
+     */
+    std::map<std::string, TypeCounts> aggregate(int64_t start, int64_t end, int64_t now) const {
+        std::map<std::string, TypeCounts> result;
+
+        int64_t oldest = oldestBucketStart();
+        if (oldest == INT64_MAX) {
+            return result;
+        }
+        int64_t t = floorTo(std::max(start, oldest), tiers_.back().width);
+
+        while (t < end) {
+            const Tier* chosen = nullptr;
+            // Coarsest tier whose bucket starting at t lies fully inside the range
+            for (const auto& tier : tiers_) {
+                if (t % tier.width == 0 && t + tier.width <= end && t >= now - tier.retention) {
+                    chosen = &tier;
+                    break;
+                }
+            }
+            int64_t bucketStart = t;
+            if (!chosen) {
+                // Range edge: use the finest tier still retaining this point
+                for (auto it = tiers_.rbegin(); it != tiers_.rend(); ++it) {
+                    if (t >= now - it->retention) {
+                        chosen = &*it;
+                        break;
+                    }
+                }
+                if (!chosen) {
+                    chosen = &tiers_.front();
+                }
+                bucketStart = floorTo(t, chosen->width);
+            }
+
+            auto bucket = chosen->buckets.find(bucketStart);
+            if (bucket != chosen->buckets.end()) {
+                for (const auto& [profileId, counts] : bucket->second) {
+                    auto& target = result.try_emplace(profileId, TypeCounts{}).first->second;
+                    for (size_t i = 0; i < kTypeCount; ++i) {
+                        target[i] += counts[i];
+                    }
+                }
+            }
+            t = bucketStart + chosen->width;
+        }
+
+        return result;
+    }
+
+    void prune(int64_t now) {
+        for (auto& tier : tiers_) {
+            auto cutoff = tier.buckets.lower_bound(floorTo(now - tier.retention, tier.width));
+            tier.buckets.erase(tier.buckets.begin(), cutoff);
+        }
+    }
+
+    void removeProfile(const std::string& profileId) {
+        for (auto& tier : tiers_) {
+            for (auto it = tier.buckets.begin(); it != tier.buckets.end();) {
+                it->second.erase(profileId);
+                it = it->second.empty() ? tier.buckets.erase(it) : std::next(it);
+            }
+        }
+    }
+
+    void clear() {
+        for (auto& tier : tiers_) {
+            tier.buckets.clear();
+        }
+    }
+
+    const std::array<Tier, 3>& tiers() const { return tiers_; }
+
+    nlohmann::json toJson() const {
+        nlohmann::json data = nlohmann::json::object();
+        for (const auto& tier : tiers_) {
+            nlohmann::json rows = nlohmann::json::array();
+            for (const auto& [bucketStart, profiles] : tier.buckets) {
+                for (const auto& [profileId, counts] : profiles) {
+                    rows.push_back({bucketStart, profileId, counts});
+                }
+            }
+            data[tier.name] = std::move(rows);
+        }
+        return data;
+    }
+
+    void fromJson(const nlohmann::json& data) {
+        for (auto& tier : tiers_) {
+            tier.buckets.clear();
+            if (!data.contains(tier.name)) {
+                continue;
+            }
+            for (const auto& row : data[tier.name]) {
+                if (!row.is_array() || row.size() != 3) {
+                    continue;
+                }
+                auto& counts = tier.buckets[row[0].get<int64_t>()][row[1].get<std::string>()];
+                counts.fill(0);
+                for (size_t i = 0; i < std::min(row[2].size(), kTypeCount); ++i) {
+                    counts[i] = row[2][i].get<uint64_t>();
+                }
+            }
+        }
+    }
+
+private:
+    std::array<Tier, 3> tiers_; // ordered coarsest to finest
+
+    int64_t oldestBucketStart() const {
+        int64_t oldest = INT64_MAX;
+        for (const auto& tier : tiers_) {
+            if (!tier.buckets.empty()) {
+                oldest = std::min(oldest, tier.buckets.begin()->first);
+            }
+        }
+        return oldest;
+    }
+};
+
+} // namespace phantomvault
@@ -0,0 +1,92 @@
+/**
+ * PhantomVault Folder Index
+ *
+ * Persistent open-addressing hash table from obfuscated folder identifier to
+ * packed FolderMetadata records. The whole index is a single file that is
+ * memory-mapped for lookups, so a lookup costs one hash, a short probe and a
+ * record decode regardless of how many folders the vault holds.
+ *
+ * File layout: header | slot table | packed records. New records are appended
+ * in place; replaced and erased records become dead bytes until compact().
+ * The header carries the vault generation it reflects; a mismatch means the
+ * index is stale and must be rebuilt.
+ */
+
+#pragma once
+
+#include "vault_handler.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace phantomvault {
+
+class FolderIndex {
+public:
+    /**
+     * Identity of the metadata file a record was built from, used to skip
+     * unchanged files during incremental rebuilds
+     */
+    struct SourceStamp {
+        int64_t modifiedNs = 0;
+        uint64_t size = 0;
+
+        bool operator==(const SourceStamp& other) const {
+            return modifiedNs == other.modifiedNs && size == other.size;
+        }
+    };
+
+    struct Entry {
+        std::string identifier;
+        FolderMetadata metadata;
+        SourceStamp stamp;
+    };
+
+    FolderIndex();
+    ~FolderIndex();
+
+    FolderIndex(const FolderIndex&) = delete;
+    FolderIndex& operator=(const FolderIndex&) = delete;
+
+    /**
+     * Map an existing index file. Returns false if it is missing, corrupt, or
+     * was interrupted mid-update; the caller then rebuilds it.
+     */
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const;
+
+    uint64_t getGeneration() const;
+    size_t size() const;
+    size_t getMappedBytes() const;
+    size_t getDeadBytes() const;
+
+    std::optional<FolderMetadata> lookup(const std::string& identifier) const;
+    std::optional<SourceStamp> lookupStamp(const std::string& identifier) const;
+    bool contains(const std::string& identifier) const;
+    void forEachIdentifier(const std::function<void(const std::string&)>& callback) const;
+
+    // In-place updates; each one stamps the index with the new vault generation
+    bool put(const std::string& identifier, const FolderMetadata& metadata,
+             const SourceStamp& stamp, uint64_t generation);
+    bool erase(const std::string& identifier, uint64_t generation);
+
+    // Write a fresh file (temp + rename) holding exactly these entries
+    bool rewrite(const std::string& path, const std::vector<Entry>& entries, uint64_t generation);
+
+    // Drop dead record bytes and tombstones, shrinking the slot table if oversized
+    bool compact();
+
+    std::string getLastError() const;
+
+private:
+    class Implementation;
+    std::unique_ptr<Implementation> pimpl;
+};
+
+} // namespace phantomvault
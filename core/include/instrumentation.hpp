@@ -0,0 +1,165 @@
+/**
+ * PhantomVault Instrumentation
+ *
+ * Per-operation latency histograms for the lock, unlock and authentication
+ * paths. Histograms are log-linear (16 linear buckets per power of two of
+ * nanoseconds, so any value is within 6.25% of its bucket) and recorded into
+ * thread-local shards: a sample is two clock reads and three uncontended
+ * stores, cheap enough to leave on in production. Readers merge the shards
+ * of live threads with those folded in when threads exited.
+ *
+ * Usage: { ScopedSpan span(Operation::KDF); deriveKey(...); }
+ *
+ * TraceRecorder adds an opt-in timeline for offline profiling: while it
+ * records, every ScopedSpan and TraceSpan also lands as a complete event in
+ * a fixed per-thread buffer, dumped as Chrome trace JSON that
+ * chrome://tracing and ui.perfetto.dev open directly. Event names are static
+ * labels; paths and other vault data never enter a trace.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace phantomvault {
+
+enum class Operation : uint8_t {
+    KDF,                // password and key derivation
+    READ,               // file and record reads
+    COMPRESS,           // compression and decompression
+    ENCRYPT,            // AES-256-XTS encryption and decryption
+    WRITE,              // vault records and restored files
+    WIPE,               // secure deletion
+    METADATA_COMMIT,    // vault and folder metadata saves
+    IPC_HANDLER,        // one HTTP request, routing included
+    COUNT
+};
+
+constexpr size_t kOperationCount = static_cast<size_t>(Operation::COUNT);
+
+// Stable label used in metric output ("kdf", "read", ...)
+const char* operationName(Operation operation);
+
+/**
+ * Plain histogram value; also the merged view of all shards
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 4;
+    static constexpr unsigned kMaxExponent = 40;        // ~18 minutes; longer samples share the top bucket
+    static constexpr size_t kBucketCount = (kMaxExponent - kSubBucketBits + 2) << kSubBucketBits;
+
+    static size_t bucketFor(uint64_t nanos);
+    static uint64_t bucketLowerBound(size_t bucket);
+    static uint64_t bucketUpperBound(size_t bucket);    // exclusive
+
+    static LatencyHistogram fromCounts(const std::array<uint64_t, kBucketCount>& buckets, uint64_t count, uint64_t sumNanos);
+
+    void record(uint64_t nanos);
+    void merge(const LatencyHistogram& other);
+    void clear();
+
+    uint64_t count() const { return count_; }
+    uint64_t sumNanos() const { return sum_; }
+    uint64_t bucketCount(size_t bucket) const { return buckets_[bucket]; }
+
+    // Upper bound of the bucket holding the q-th quantile (0.0-1.0), in ns
+    uint64_t percentile(double q) const;
+
+private:
+    std::array<uint64_t, kBucketCount> buckets_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+};
+
+class Instrumentation {
+public:
+    static void record(Operation operation, std::chrono::nanoseconds elapsed);
+
+    static LatencyHistogram snapshot(Operation operation);
+
+    // All histograms in the Prometheus text exposition format
+    static std::string prometheusText();
+
+    // On by default; spans cost one relaxed load while disabled
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    // Zeroes every histogram, including those of exited threads
+    static void reset();
+};
+
+/**
+ * Records the time from construction to destruction under one operation
+ */
+class ScopedSpan {
+public:
+    explicit ScopedSpan(Operation operation);
+    ~ScopedSpan();
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+private:
+    Operation operation_;
+    bool active_;
+    bool tracing_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+class TraceRecorder {
+public:
+    static constexpr size_t kDefaultEventsPerThread = 32768;   // 1 MB per recording thread
+
+    /**
+     * Begin a new session, discarding the previous one. Each thread gets a
+     * buffer of eventsPerThread events the first time it records; once it
+     * is full, that thread's further events are dropped and counted.
+     */
+    static void start(size_t eventsPerThread = kDefaultEventsPerThread);
+
+    // Stop recording; the session stays readable until the next start()
+    static void stop();
+    static bool isRecording();
+
+    // name and category must outlive the session; string literals only
+    static void record(const char* name, const char* category,
+                       std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    static size_t eventCount();
+    static uint64_t droppedCount();
+
+    // Session as Chrome trace JSON; safe while recording
+    static std::string chromeTraceJson();
+    static bool writeChromeTrace(const std::string& path);
+
+    /**
+     * SIGUSR2 toggles recording: the first signal starts a session, the next
+     * stops it and writes <directory>/trace-<ms since epoch>.json. POSIX only.
+     */
+    static bool installSignalHandler(const std::string& directory);
+};
+
+/**
+ * Trace-only span for stages that have no latency histogram of their own
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, const char* category = "vault");
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    const char* category_;
+    bool active_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace phantomvault
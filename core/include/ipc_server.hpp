@@ -19,6 +19,7 @@ class ProfileManager;
 class FolderSecurityManager;
 class KeyboardSequenceDetector;
 class AnalyticsEngine;
+class PerformanceMonitor;
 
 /**
  * HTTP request structure
@@ -68,6 +69,7 @@ public:
     void setFolderSecurityManager(FolderSecurityManager* manager);
     void setKeyboardSequenceDetector(KeyboardSequenceDetector* detector);
     void setAnalyticsEngine(AnalyticsEngine* engine);
+    void setPerformanceMonitor(PerformanceMonitor* monitor);
     
     // Route registration
     void registerRoute(const std::string& method, const std::string& path, RequestHandler handler);
@@ -10,39 +10,25 @@
 #include <memory>
 #include <vector>
 #include <unordered_map>
-#include <mutex>
 #include <atomic>
 #include <cstddef>
 
 namespace phantomvault {
 
 /**
- * Memory pool for fixed-size allocations
- */
-template<size_t BlockSize, size_t PoolSize = 1024>
-class MemoryPool {
-public:
-    MemoryPool();
-    ~MemoryPool();
-
-    void* allocate();
-    void deallocate(void* ptr);
-    
-    size_t getUsedBlocks() const { return used_blocks_; }
-    size_t getTotalBlocks() const { return PoolSize; }
-    size_t getMemoryUsage() const { return PoolSize * BlockSize; }
-
-private:
-    alignas(std::max_align_t) char pool_[PoolSize * BlockSize];
-    std::vector<void*> free_blocks_;
-    std::atomic<size_t> used_blocks_;
-    std::mutex mutex_;
-    
-    void initializeFreeList();
-};
-
-/**
- * Smart memory manager with multiple pools
+ * Smart memory manager with size-class pools
+ *
+ * Requests up to 2 KB come from eight power-of-two size classes (16 B - 2 KB).
+ * Every thread caches free blocks per class, so most allocate/deallocate
+ * pairs touch no shared state; caches trade batches of blocks with a
+ * lock-free central list per class, which grows one 64 KB slab at a time.
+ * The block is found from the size passed to deallocate(), so callers must
+ * pass the size they allocated (PoolAllocator and MemoryGuard do). Larger
+ * requests go to malloc.
+ *
+ * Statistics are per-thread counters summed on read. The memory limit is
+ * checked against a shared total each thread updates in 64 KB steps, so it
+ * may be overshot by up to 64 KB per thread.
  */
 class MemoryManager {
 public:
@@ -65,32 +51,18 @@ public:
     MemoryStats getStats() const;
     void resetStats();
     
-    // Memory optimization
+    // Memory optimization: returns the calling thread's cached blocks to the shared pools
     void compactPools();
     void setMemoryLimit(size_t limitBytes);
     bool isMemoryLimitExceeded() const;
 
+    static constexpr size_t kMaxPooledSize = 2048;
+
 private:
     MemoryManager();
     ~MemoryManager();
     
-    // Different sized pools for common allocations
-    std::unique_ptr<MemoryPool<32>> small_pool_;      // 32 bytes
-    std::unique_ptr<MemoryPool<128>> medium_pool_;    // 128 bytes
-    std::unique_ptr<MemoryPool<512>> large_pool_;     // 512 bytes
-    std::unique_ptr<MemoryPool<2048>> xlarge_pool_;   // 2KB
-    
-    mutable std::mutex stats_mutex_;
-    MemoryStats stats_;
     std::atomic<size_t> memory_limit_;
-    
-    // Track allocations for proper deallocation
-    std::unordered_map<void*, size_t> allocation_sizes_;
-    std::mutex allocation_mutex_;
-    
-    void* allocateFromPool(size_t size);
-    void* allocateFromSystem(size_t size);
-    void updateStats(size_t size, bool allocating);
 };
 
 /**
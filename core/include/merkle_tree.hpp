@@ -0,0 +1,80 @@
+/**
+ * PhantomVault Merkle Tree
+ *
+ * Content-hash tree over the encrypted objects of one vaulted folder, both
+ * packed segment objects and standalone .enc files. Every leaf is the SHA-256
+ * of an object's ciphertext, so the tree can be checked without the master
+ * key: a full scrub rehashes every object in parallel, in on-disk order, and
+ * a spot-check rehashes a random sample. The root is kept in the folder's
+ * metadata; the leaves live next to the objects in integrity.mtree.
+ *
+ * Leaf = H(0x00 || kind || id || 0x00 || H(ciphertext)), where kind is 'p' for
+ * a packed object and 'f' for a standalone file; node = H(0x01 || left || right).
+ * An odd node at the end of a level is carried up unchanged.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace phantomvault {
+
+class MerkleTree {
+public:
+    static constexpr const char* kFileName = "integrity.mtree";
+
+    struct VerifyOptions {
+        size_t threads = 0;             // 0 = hardware concurrency, capped at 8
+        double sampleRate = 1.0;        // below 1.0, check a random subset of this fraction
+        uint64_t seed = 0;              // sample seed; 0 = random
+    };
+
+    struct VerifyResult {
+        bool success = false;
+        bool rootMatches = false;                   // leaves hash to the recorded root
+        size_t objectsTotal = 0;
+        size_t objectsChecked = 0;
+        uint64_t bytesChecked = 0;
+        std::vector<std::string> corruptObjects;    // content differs from its leaf
+        std::vector<std::string> missingObjects;    // leaf with no object behind it
+        std::vector<std::string> unexpectedObjects; // object with no leaf (full scrubs only)
+        std::chrono::milliseconds duration{0};
+    };
+
+    MerkleTree();
+    ~MerkleTree();
+
+    MerkleTree(const MerkleTree&) = delete;
+    MerkleTree& operator=(const MerkleTree&) = delete;
+
+    /**
+     * Hash every object in vaultFolder and rebuild the tree. Objects whose
+     * location and size are unchanged since the tree was last built or loaded
+     * keep their leaf without being reread.
+     */
+    bool build(const std::string& vaultFolder, size_t threads = 0);
+
+    // Rehash just these objects and the nodes above them; ids no longer present are dropped
+    bool update(const std::string& vaultFolder, const std::vector<std::string>& objectIds);
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    VerifyResult verify(const std::string& vaultFolder) const;
+    VerifyResult verify(const std::string& vaultFolder, const VerifyOptions& options) const;
+
+    std::string getRootHex() const;
+    size_t getLeafCount() const;
+    std::string getLastError() const;
+
+private:
+    class Implementation;
+    std::unique_ptr<Implementation> pimpl;
+};
+
+} // namespace phantomvault
@@ -0,0 +1,83 @@
+/**
+ * PhantomVault Metrics History
+ *
+ * Fixed-size ring of compact performance samples, one per history interval,
+ * so the last 24 hours fit in a few hundred kilobytes. A single writer (the
+ * performance monitor) appends; any number of readers take snapshots without
+ * locks, each slot carrying a sequence number that tells a torn or
+ * overwritten read from a valid one.
+ *
+ * The ring can live in a memory-mapped file, which keeps the history across
+ * restarts; flush() pushes it to disk. File layout: a header with magic,
+ * version, record size, capacity and the append count, then the slots.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace phantomvault {
+
+/**
+ * One history interval. CPU figures are in hundredths of a percent.
+ */
+struct MetricsSample {
+    uint64_t timestampMs = 0;       // end of the interval, ms since the Unix epoch
+    uint16_t cpuAverage = 0;
+    uint16_t cpuPeak = 0;
+    uint16_t cpuUser = 0;
+    uint16_t cpuSystem = 0;
+    uint32_t memoryKB = 0;          // at the end of the interval
+    uint8_t batteryLevel = 100;
+    uint8_t flags = 0;              // kOnBattery | kCharging
+    uint16_t sampleCount = 0;       // monitor samples folded into this record
+
+    static constexpr uint8_t kOnBattery = 1;
+    static constexpr uint8_t kCharging = 2;
+};
+
+static_assert(sizeof(MetricsSample) == 24, "MetricsSample is stored verbatim in history files");
+
+class MetricsHistory {
+public:
+    static constexpr size_t kDefaultCapacity = 8640;   // 24 h of 10 s records
+
+    explicit MetricsHistory(size_t capacity = kDefaultCapacity);
+    ~MetricsHistory();
+
+    MetricsHistory(const MetricsHistory&) = delete;
+    MetricsHistory& operator=(const MetricsHistory&) = delete;
+
+    /**
+     * Move the ring into a file mapping. A file written with the same layout
+     * is reused with its records; anything else is replaced. Not safe while
+     * other threads append or read.
+     */
+    bool open(const std::string& path);
+
+    // Single writer
+    void append(const MetricsSample& sample);
+
+    // Records newer than since, oldest first
+    std::vector<MetricsSample> snapshot(std::chrono::system_clock::time_point since = {}) const;
+
+    // Write dirty pages of a file-backed ring; no-op in memory
+    bool flush();
+
+    size_t size() const;
+    size_t capacity() const;
+    bool isPersistent() const;
+    std::string getLastError() const;
+
+private:
+    class Implementation;
+    std::unique_ptr<Implementation> pimpl;
+};
+
+} // namespace phantomvault
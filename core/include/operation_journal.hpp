@@ -0,0 +1,100 @@
+/**
+ * PhantomVault Operation Journal
+ *
+ * Write-ahead intent log for vault lock/unlock operations. An operation is
+ * journaled before it touches any file, its per-file progress is appended in
+ * group-committed checkpoints, and the journal is removed once the operation
+ * has fully completed. After a crash the journal says exactly which files
+ * are already durable, so the operation resumes from there instead of being
+ * repaired from backups.
+ *
+ * Layout: one <operation id>.wal file per in-flight operation, one JSON
+ * record per line. A record is only relied upon once a checkpoint has synced
+ * it, and the files it lists were synced before it was written.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace phantomvault {
+
+class OperationJournal {
+public:
+    enum class OperationType {
+        LOCK,
+        UNLOCK
+    };
+
+    struct Operation {
+        std::string id;
+        OperationType type = OperationType::LOCK;
+        std::string folderPath;
+        std::string vaultLocation;
+        std::string mode;                               // operation-specific, e.g. the unlock mode
+        std::string phase;                              // last phase reached
+        std::unordered_set<std::string> completedFiles; // durable as of the last checkpoint
+        uint64_t completedBytes = 0;
+        std::chrono::system_clock::time_point startedAt;
+    };
+
+    struct Config {
+        size_t checkpointFiles = 256;                   // checkpoint after this many files...
+        uint64_t checkpointBytes = 64 * 1024 * 1024;    // ...or this many bytes, whichever first
+        size_t perFileSyncLimit = 32;                   // above this, sync the whole filesystem once
+    };
+
+    OperationJournal();
+    explicit OperationJournal(const Config& config);
+    ~OperationJournal();
+
+    OperationJournal(const OperationJournal&) = delete;
+    OperationJournal& operator=(const OperationJournal&) = delete;
+
+    bool initialize(const std::string& directory);
+
+    /**
+     * Start journaling an operation, or continue one loaded from disk. A new
+     * operation's begin record is synced before this returns.
+     */
+    bool begin(const Operation& operation);
+
+    /**
+     * Note a finished file. syncPath is the file whose contents must reach
+     * disk before the record does; empty when the caller syncs it itself.
+     */
+    void recordFile(const std::string& relativePath, uint64_t bytes, const std::string& syncPath = "");
+    bool shouldCheckpoint() const;
+
+    // Sync the recorded files, then append and sync the record listing them
+    bool checkpoint();
+
+    // Checkpoint, then record that the operation reached phase
+    bool markPhase(const std::string& phase);
+
+    // The operation finished; drop its journal
+    bool complete();
+
+    // Abandon the operation without completing it; the journal stays for a later resume
+    void release();
+
+    bool isActive() const;
+    std::optional<Operation> load(const std::string& id) const;
+    std::vector<Operation> listPending() const;
+    bool discard(const std::string& id);
+
+    std::string getLastError() const;
+
+private:
+    class Implementation;
+    std::unique_ptr<Implementation> pimpl;
+};
+
+} // namespace phantomvault
@@ -0,0 +1,75 @@
+/**
+ * PhantomVault Password Pattern Matcher
+ *
+ * Incremental DFA over typed characters that recognizes unlock tokens:
+ * "T+<password>" (temporary), "P+<password>" (permanent) and bare words of
+ * six or more password characters mixing at least two character classes.
+ * Tokens are separated by whitespace; a token is reported the moment the
+ * character that ends it is fed.
+ *
+ * Each character costs one table lookup and one array store. The token lives
+ * in a fixed buffer, so feeding never allocates.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace phantomvault {
+
+enum class PatternKind {
+    TEMPORARY,   // T+ prefix
+    PERMANENT,   // P+ prefix
+    DEFAULT      // bare password word
+};
+
+/**
+ * A recognized token. password points into the matcher's buffer and is
+ * valid until the next call on the matcher.
+ */
+struct PatternMatch {
+    PatternKind kind = PatternKind::DEFAULT;
+    std::string_view password;
+};
+
+class PasswordPatternMatcher {
+public:
+    static constexpr size_t kMaxTokenLength = 128;
+    static constexpr size_t kMinWordLength = 6;
+
+    PasswordPatternMatcher();
+    ~PasswordPatternMatcher();
+
+    PasswordPatternMatcher(const PasswordPatternMatcher&) = delete;
+    PasswordPatternMatcher& operator=(const PasswordPatternMatcher&) = delete;
+
+    // True when c ended a token that is a pattern; match is filled in
+    bool feed(char c, PatternMatch& match);
+
+    // Ends the current token as if whitespace had been typed
+    bool finish(PatternMatch& match);
+
+    // Drops the last character of the current token
+    void backspace();
+
+    // Discards the current token and wipes the buffer
+    void reset();
+
+    size_t tokenLength() const { return length_; }
+
+private:
+    bool endToken(PatternMatch& match);
+    void wipe();
+
+    std::array<char, kMaxTokenLength> token_;
+    std::array<uint8_t, kMaxTokenLength + 1> states_;      // state after each prefix, for backspace
+    std::array<uint8_t, kMaxTokenLength + 1> classes_;     // character classes seen, as a bit mask
+    size_t length_;
+    size_t overflow_;           // characters past kMaxTokenLength; such a token is dropped
+    bool pending_wipe_;         // last token is still in the buffer for the caller's match
+};
+
+} // namespace phantomvault
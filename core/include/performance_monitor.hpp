@@ -3,14 +3,21 @@
  * 
  * Monitors system performance, CPU usage, and battery impact.
  * Provides adaptive performance tuning and resource management.
+ *
+ * On Linux the /proc and sysfs files are opened once and re-read with
+ * pread() into fixed buffers, so a sample neither opens files nor allocates.
+ * Samples are folded into a MetricsHistory ring that survives restarts.
  */
 
 #pragma once
 
+#include "metrics_history.hpp"
 #include <chrono>
 #include <atomic>
 #include <memory>
 #include <functional>
+#include <string>
+#include <cstdint>
 #include <thread>
 #include <vector>
 
@@ -73,8 +80,8 @@ public:
     PerformanceMonitor();
     ~PerformanceMonitor();
 
-    // Lifecycle
-    bool initialize();
+    // Lifecycle. The sample history is kept in dataPath/metrics/history.bin.
+    bool initialize(const std::string& dataPath = "");
     bool start();
     void stop();
     bool isRunning() const;
@@ -84,6 +91,9 @@ public:
     CPUStats getCPUStats() const;
     BatteryInfo getBatteryInfo() const;
     
+    // One record per 10 s interval, oldest first, up to the last 24 h
+    std::vector<MetricsSample> getHistory(std::chrono::seconds window = std::chrono::hours(24)) const;
+    
     // Performance optimization
     void setPerformanceMode(PerformanceMode mode);
     PerformanceMode getPerformanceMode() const;
@@ -125,33 +135,59 @@ private:
 
 /**
  * Adaptive scheduler for background tasks
+ *
+ * Hierarchical timer wheel (4 levels x 64 slots, 10 ms ticks) driven by one
+ * thread that sleeps until the next occupied slot, plus a small worker pool
+ * that runs due tasks highest priority first. Deadlines of long intervals are
+ * rounded so unrelated timers expire on the same wakeup. Periodic tasks are
+ * re-armed after each run, so a task never overlaps itself.
+ *
+ * With battery- or CPU-aware scheduling on, tasks of priority <= 0 run at
+ * twice their interval while on battery or while CPU usage is above the
+ * monitor's limit.
  */
 class AdaptiveScheduler {
 public:
-    AdaptiveScheduler(PerformanceMonitor* monitor);
+    explicit AdaptiveScheduler(PerformanceMonitor* monitor, size_t workers = 1);
     ~AdaptiveScheduler();
     
+    AdaptiveScheduler(const AdaptiveScheduler&) = delete;
+    AdaptiveScheduler& operator=(const AdaptiveScheduler&) = delete;
+    
+    // Process-wide scheduler shared by the service's background loops
+    static AdaptiveScheduler& getInstance();
+    
     // Task scheduling
     using Task = std::function<void()>;
     using TaskId = uint64_t;
     
+    // Periodic tasks first run one interval from now, or after firstRunDelay
     TaskId scheduleTask(Task task, std::chrono::milliseconds interval, 
                        int priority = 0);
+    TaskId scheduleTask(Task task, std::chrono::milliseconds interval,
+                       std::chrono::milliseconds firstRunDelay, int priority = 0);
     TaskId scheduleDelayedTask(Task task, std::chrono::milliseconds delay,
                               int priority = 0);
     
+    // Cancelling waits for a run in progress, unless called from that run
     bool cancelTask(TaskId taskId);
     void pauseTask(TaskId taskId);
     void resumeTask(TaskId taskId);
+    bool rescheduleTask(TaskId taskId, std::chrono::milliseconds interval);
     
     // Adaptive behavior
+    void setPerformanceMonitor(PerformanceMonitor* monitor);
     void setAdaptiveMode(bool enabled);
     void setBatteryAwareScheduling(bool enabled);
     void setCPUAwareScheduling(bool enabled);
     
+    // Stops the wheel and workers; pending tasks are dropped
+    void shutdown();
+    
     // Statistics
     size_t getActiveTaskCount() const;
     size_t getCompletedTaskCount() const;
+    size_t getWakeupCount() const;      // wheel thread wakeups since construction
 
 private:
     class Implementation;
@@ -166,24 +202,53 @@ public:
     ResourceLimiter();
     ~ResourceLimiter();
     
-    // Memory limiting
+    // Memory limiting (0 = unlimited). Usage is the process RSS, or the
+    // cgroup's memory.current once attached. Enforcing flushes the calling
+    // thread's MemoryManager cache back to the shared pools and, on glibc,
+    // releases free malloc heap pages; pool slabs stay mapped.
     void setMemoryLimit(size_t limitKB);
     bool checkMemoryLimit() const;
     void enforceMemoryLimit();
     
-    // CPU limiting
+    // CPU limiting in percent of one core (token bucket over process CPU
+    // time; 0 = unlimited). enforceCPULimit() sleeps off any overdraft.
     void setCPULimit(double maxPercent);
     bool checkCPULimit() const;
     void enforceCPULimit();
     
-    // I/O limiting
+    // I/O limiting (token bucket; 0 = unlimited). Callers record bytes as they
+    // move them and call enforceIOLimit() to sleep off any overdraft.
     void setIOLimit(size_t maxBytesPerSecond);
     bool checkIOLimit(size_t bytesUsed) const;
+    void recordIO(size_t bytes);
     void enforceIOLimit();
     
-    // Network limiting
+    // Network limiting (token bucket; 0 = unlimited)
     void setNetworkLimit(size_t maxBytesPerSecond);
     bool checkNetworkLimit(size_t bytesUsed) const;
+    void recordNetwork(size_t bytes);
+    
+    // cgroup v2 (Linux). Moves the process into a leaf of its own cgroup and
+    // enables the cpu, io and memory controllers there, so the kernel enforces
+    // the limits even for I/O that bypasses the buckets. Only possible when the
+    // current cgroup is delegated to us and holds no other processes (e.g. a
+    // systemd service with Delegate=yes). Once attached, setCPULimit() and
+    // setMemoryLimit() are also written to cpu.max and memory.high.
+    bool attachToCgroup(const std::string& leafName = "phantomvault");
+    bool isCgroupAttached() const;
+    std::string getCgroupPath() const;
+    
+    // Relative share under contention (1-10000, kernel default 100)
+    bool setCgroupWeights(uint32_t cpuWeight, uint32_t ioWeight);
+    
+    // io.max for the disk holding path (0 = unlimited)
+    bool setDeviceIOLimit(const std::string& path, size_t readBytesPerSecond, size_t writeBytesPerSecond);
+    
+    // Lowest CPU and idle I/O priority for the calling thread; for background
+    // work that should only use what the desktop leaves idle
+    static void demoteCurrentThread();
+    
+    std::string getLastError() const;
 
 private:
     class Implementation;
@@ -3,6 +3,10 @@
 #include "encryption_engine.hpp"
 #include "error_handler.hpp"
 #include "vault_handler.hpp"
+#include "segment_store.hpp"
+#include "operation_journal.hpp"
+#include "merkle_tree.hpp"
+#include "performance_monitor.hpp"
 #include <string>
 #include <vector>
 #include <memory>
@@ -30,6 +34,7 @@ struct LockedFolderInfo {
     size_t file_count;
     size_t total_size;
     bool is_temporarily_unlocked;
+    std::string integrity_root;     // Merkle root over the encrypted objects; empty for legacy entries
     
     LockedFolderInfo() : file_count(0), total_size(0), is_temporarily_unlocked(false) {}
 };
@@ -69,6 +74,10 @@ public:
     VaultOperationResult lockFolder(const std::string& folder_path, const std::string& master_key);
     VaultOperationResult unlockFolder(const std::string& folder_path, const std::string& master_key, UnlockMode mode);
     
+    // Lock/unlock operations cut short by a crash; they resume from their last checkpoint
+    std::vector<std::string> getInterruptedOperations() const;
+    VaultOperationResult resumeInterruptedOperations(const std::string& master_key);
+    
     // Folder management
     std::vector<LockedFolderInfo> getLockedFolders() const;
     std::optional<LockedFolderInfo> getFolderInfo(const std::string& folder_path) const;
@@ -79,10 +88,19 @@ public:
     bool isValidMasterKey(const std::string& master_key) const;
     bool validateVaultIntegrity() const;
     
+    // Check a folder's encrypted objects against its Merkle tree, no key needed.
+    // A sample_rate below 1.0 spot-checks a random subset of the objects.
+    VaultOperationResult verifyFolderContents(const std::string& folder_path, double sample_rate = 1.0) const;
+    
     // Temporary unlock management
     VaultOperationResult relockTemporaryFolders();
     std::vector<std::string> getTemporarilyUnlockedFolders() const;
     
+    // Caps the bytes per second moved by background work: resuming interrupted
+    // operations, re-locking and the error handler's backup copies (0 = unlimited).
+    // Lock and unlock requests run unthrottled.
+    void setBackgroundIOLimit(size_t max_bytes_per_second);
+    
     // Vault maintenance
     bool cleanupCorruptedEntries();
     size_t getVaultSize() const;
@@ -102,17 +120,32 @@ private:
     std::unique_ptr<EncryptionEngine> encryption_engine_;
     std::unique_ptr<phantomvault::ErrorHandler> error_handler_;
     std::unique_ptr<phantomvault::VaultHandler> vault_handler_;
+    std::unique_ptr<phantomvault::OperationJournal> journal_;
+    std::unique_ptr<phantomvault::ResourceLimiter> io_limiter_;
+    
+    static constexpr size_t kDefaultBackgroundIOLimit = 32 * 1024 * 1024;  // 32 MB/s
+    static constexpr size_t kRelockIOCharge = 4096;  // metadata commit per re-locked folder
+    
+    // Journaled lock/unlock, used for new operations and to resume interrupted ones
+    VaultOperationResult runLock(const phantomvault::OperationJournal::Operation& operation, const std::string& master_key);
+    VaultOperationResult runUnlock(const phantomvault::OperationJournal::Operation& operation, const std::string& master_key);
     
-    // Internal folder operations
-    VaultOperationResult encryptAndStoreFolder(const std::string& folder_path, const std::string& master_key);
+    // Internal folder operations. Files the operation already completed are skipped.
+    VaultOperationResult encryptAndStoreFolder(const std::string& folder_path, const std::string& master_key,
+                                               const phantomvault::OperationJournal::Operation& operation);
     VaultOperationResult decryptAndRestoreFolder(const std::string& vault_location, 
                                                 const std::string& original_path, 
                                                 const std::string& master_key,
-                                                UnlockMode mode);
+                                                UnlockMode mode,
+                                                const phantomvault::OperationJournal::Operation& operation);
     
-    // File processing
-    bool encryptFile(const std::string& file_path, const std::string& vault_file_path, const std::string& master_key);
+    // File processing. Small encrypted files go into the folder's segment store
+    // under object_id; larger ones are written standalone to vault_file_path.
+    bool encryptFile(const std::string& file_path, const std::string& vault_file_path, const std::string& master_key,
+                     phantomvault::SegmentStore* pack = nullptr, const std::string& object_id = "");
     bool decryptFile(const std::string& vault_file_path, const std::string& output_path, const std::string& master_key);
+    bool decryptRecord(const std::string& record, const std::string& output_path, const std::string& master_key);
+    void throttleIO(size_t bytes);
     
     // Metadata management
     bool saveVaultMetadata();
@@ -134,6 +167,9 @@ private:
     // Security utilities
     std::string hashFolderPath(const std::string& folder_path) const;
     bool verifyFolderIntegrity(const std::string& vault_location) const;
+    phantomvault::MerkleTree::VerifyResult verifyFolderTree(const LockedFolderInfo& info,
+                                                            const phantomvault::MerkleTree::VerifyOptions& options) const;
+    bool buildFolderTree(const std::string& vault_folder_path, LockedFolderInfo& info);
     
     // File system operations
     bool hideOriginalFolder(const std::string& folder_path);
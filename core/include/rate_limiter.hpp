@@ -0,0 +1,60 @@
+/**
+ * PhantomVault Rate Limiter
+ *
+ * Sharded sliding-window rate limiter for authentication attempts.
+ * Identifiers hash to independent shards so concurrent attempts against
+ * different identifiers never contend, and each shard keeps a bounded LRU
+ * table so floods of one-off identifiers cannot grow memory without limit.
+ */
+
+#pragma once
+
+#include "error_handler.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace phantomvault {
+
+class RateLimiter {
+public:
+    struct Config {
+        size_t shardCount = 64;                              // rounded up to a power of two
+        size_t maxEntriesPerShard = 2048;                    // LRU bound per shard
+        std::chrono::seconds blockDuration = std::chrono::hours(1);
+    };
+
+    struct Stats {
+        size_t trackedIdentifiers = 0;
+        size_t blockedIdentifiers = 0;
+        uint64_t evictions = 0;
+        size_t approximateMemoryBytes = 0;
+    };
+
+    RateLimiter();
+    explicit RateLimiter(const Config& config);
+    ~RateLimiter();
+
+    /**
+     * Record an attempt for identifier. Returns false when the estimated number
+     * of attempts in the trailing window exceeds maxAttempts, or while blocked.
+     */
+    bool allow(const std::string& identifier, int maxAttempts, std::chrono::seconds window);
+
+    void reset(const std::string& identifier);
+    RateLimitInfo getInfo(const std::string& identifier) const;
+
+    // Drop entries whose windows and blocks have fully expired
+    size_t sweepExpired();
+    void clear();
+
+    Stats getStats() const;
+
+private:
+    class Implementation;
+    std::unique_ptr<Implementation> pimpl;
+};
+
+} // namespace phantomvault
@@ -0,0 +1,104 @@
+/**
+ * PhantomVault Secure Arena
+ *
+ * A std::pmr memory resource for keys and plaintext. The arena is one
+ * mapping bracketed by inaccessible guard pages, locked into RAM where the
+ * memlock limit allows and excluded from core dumps. Allocation bumps a
+ * pointer; nothing is freed individually. A Scope marks the current top and
+ * on exit zeroes everything allocated since in one pass, so a whole lock or
+ * unlock of a file costs one bulk wipe instead of one wipe loop per buffer.
+ *
+ * Requests that do not fit get a guarded, locked mapping of their own, wiped
+ * and unmapped as soon as they are deallocated.
+ *
+ * Usage:
+ *   SecureArena& arena = SecureArena::forThread();
+ *   SecureArena::Scope scope(arena);
+ *   SecureBuffer plaintext(size, &arena);
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "secure_memory.hpp"
+
+namespace phantomvault {
+
+using SecureBuffer = std::pmr::vector<uint8_t>;
+
+class SecureArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kDefaultCapacity = 1024 * 1024;
+
+    explicit SecureArena(size_t capacity = kDefaultCapacity);
+    ~SecureArena() override;
+
+    SecureArena(const SecureArena&) = delete;
+    SecureArena& operator=(const SecureArena&) = delete;
+
+    // The calling thread's arena, created on first use
+    static SecureArena& forThread();
+
+    // Zero everything handed out and start over; outstanding buffers become invalid
+    void reset();
+
+    size_t capacity() const { return capacity_; }
+    size_t used() const { return used_; }
+    size_t overflowBytes() const { return overflow_bytes_; }
+
+    // False when the memlock limit refused the arena; it is still never dumped
+    bool isLocked() const { return locked_; }
+
+    /**
+     * Everything allocated from the arena during the scope's lifetime is
+     * zeroed and reclaimed when it ends. Scopes nest; buffers must not
+     * outlive the scope they were allocated in.
+     */
+    class Scope {
+    public:
+        explicit Scope(SecureArena& arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        SecureArena& arena_;
+        size_t mark_;
+        size_t overflow_mark_;
+        size_t outer_floor_;
+    };
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    struct Region {
+        uint8_t* base = nullptr;        // first guard page
+        size_t mappedSize = 0;          // guard pages included
+        uint8_t* data = nullptr;
+        size_t size = 0;
+        bool locked = false;
+    };
+
+    static Region mapRegion(size_t size);
+    static void unmapRegion(Region& region);
+
+    void rewind(size_t mark, size_t overflowMark);
+
+    Region arena_;
+    size_t capacity_;
+    size_t used_ = 0;
+    size_t floor_ = 0;                  // mark of the innermost open scope
+    bool locked_ = false;
+    std::vector<Region> overflow_;
+    size_t overflow_bytes_ = 0;
+};
+
+} // namespace phantomvault
@@ -0,0 +1,44 @@
+/**
+ * PhantomVault Secure Memory Kernels
+ *
+ * Zeroing and comparison for keys and plaintext. Both run once per buffer of
+ * every file, so each has SSE2, AVX2 and NEON kernels next to a portable one;
+ * the widest the CPU supports is picked on first use.
+ *
+ * secureZero is explicit_bzero: one zeroing pass followed by a compiler
+ * barrier that treats the buffer as read, so the stores cannot be dropped as
+ * dead even right before the memory is freed. constantTimeEqual has no
+ * branch or early exit that depends on the data; its running time depends
+ * only on the size.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace phantomvault {
+
+enum class SecureMemoryKernel {
+    PORTABLE,
+    SSE2,
+    AVX2,
+    NEON
+};
+
+const char* secureMemoryKernelName(SecureMemoryKernel kernel);
+
+// Kernel the calls below currently run on
+SecureMemoryKernel activeSecureMemoryKernel();
+
+bool isSecureMemoryKernelSupported(SecureMemoryKernel kernel);
+
+// Pins a kernel, for tests and benchmarks; returns false if the CPU lacks it
+bool setSecureMemoryKernel(SecureMemoryKernel kernel);
+
+// Zeroes memory in a way the compiler may not remove as a dead store
+void secureZero(void* data, size_t size);
+
+// True when both buffers hold the same size bytes, in data-independent time
+bool constantTimeEqual(const void* a, const void* b, size_t size);
+
+} // namespace phantomvault
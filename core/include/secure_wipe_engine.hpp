@@ -0,0 +1,81 @@
+/**
+ * PhantomVault Secure Wipe Engine
+ *
+ * Overwrites files in place with large blocks of AES-CTR keystream, across
+ * several files in parallel, under an optional I/O budget. On solid-state
+ * storage, where the FTL remaps writes and extra passes never reach the old
+ * cells, the AUTO policy writes a single pass and then discards the blocks
+ * (FALLOC_FL_PUNCH_HOLE for files, BLKDISCARD for block devices).
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace phantomvault {
+
+/**
+ * Pass policy for overwriting file contents
+ */
+enum class WipePolicy {
+    AUTO,           // one pass + discard on SSDs, three passes on rotational media
+    SINGLE_PASS,    // one keystream pass
+    THREE_PASS,     // three independent keystream passes
+    DISCARD_ONLY    // discard without overwriting; for ciphertext only
+};
+
+struct WipeConfig {
+    WipePolicy policy = WipePolicy::AUTO;
+    size_t threads = 0;                     // 0 = hardware concurrency, capped at 8
+    size_t blockSize = 1024 * 1024;         // bytes per write
+    size_t ioLimitBytesPerSecond = 0;       // 0 = unthrottled
+    bool removeAfterWipe = false;
+};
+
+struct WipeResult {
+    bool success = false;
+    size_t filesWiped = 0;
+    size_t filesFailed = 0;
+    uint64_t bytesOverwritten = 0;
+    uint64_t bytesDiscarded = 0;
+    std::chrono::milliseconds duration{0};
+    std::vector<std::string> failedPaths;
+};
+
+class SecureWipeEngine {
+public:
+    struct StorageInfo {
+        bool rotational = true;
+        bool supportsDiscard = false;
+    };
+
+    SecureWipeEngine();
+    explicit SecureWipeEngine(const WipeConfig& config);
+    ~SecureWipeEngine();
+
+    void setConfig(const WipeConfig& config);
+    WipeConfig getConfig() const;
+    void setIOLimit(size_t maxBytesPerSecond);
+
+    WipeResult wipeFile(const std::string& path);
+    WipeResult wipeFiles(const std::vector<std::string>& paths);
+
+    // Wipe every regular file below path; the directory tree itself is left in place
+    WipeResult wipeDirectory(const std::string& path);
+
+    // Storage characteristics of the device backing path (cached per device)
+    StorageInfo probeStorage(const std::string& path) const;
+
+    std::string getLastError() const;
+
+private:
+    class Implementation;
+    std::unique_ptr<Implementation> pimpl;
+};
+
+} // namespace phantomvault
@@ -0,0 +1,107 @@
+/**
+ * PhantomVault Security Event Store
+ *
+ * Append-only, indexed storage for security events. Events live in
+ * fixed-capacity chunks that never move once written, so readers can take a
+ * cheap snapshot (shared ownership of the chunks) and walk it without holding
+ * any lock while new events keep arriving.
+ */
+
+#pragma once
+
+#include "error_handler.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace phantomvault {
+
+class SecurityEventStore {
+public:
+    static constexpr size_t kChunkCapacity = 4096;
+    static constexpr size_t kEventTypeCount = static_cast<size_t>(SecurityEventType::SYSTEM_COMPROMISE) + 1;
+
+    struct Chunk {
+        uint64_t baseSequence = 0;
+        std::vector<SecurityEvent> events; // reserved to kChunkCapacity, never reallocates
+
+        // Arrival order is not timestamp order, so range scans stop on these bounds
+        std::chrono::system_clock::time_point maxTimestamp = std::chrono::system_clock::time_point::min();
+        std::chrono::system_clock::time_point maxTimestampSoFar = std::chrono::system_clock::time_point::min(); // this and all earlier chunks
+    };
+
+    /**
+     * Immutable view of the events present when the snapshot was taken
+     */
+    class Snapshot {
+    public:
+        size_t size() const { return total_; }
+
+        template<typename Func>
+        void forEach(Func&& func) const {
+            for (size_t c = 0; c < chunks_.size(); ++c) {
+                size_t count = (c + 1 == chunks_.size()) ? last_count_ : chunks_[c]->events.size();
+                const SecurityEvent* events = chunks_[c]->events.data();
+                for (size_t i = 0; i < count; ++i) {
+                    func(events[i]);
+                }
+            }
+        }
+
+    private:
+        friend class SecurityEventStore;
+        std::vector<std::shared_ptr<const Chunk>> chunks_;
+        size_t last_count_ = 0;
+        size_t total_ = 0;
+    };
+
+    SecurityEventStore() = default;
+
+    void append(const std::vector<SecurityEvent>& events);
+
+    /**
+     * Events of the given type (optionally for one profile) at or after since,
+     * in chronological order. Walks only the matching index, newest first,
+     * until every earlier chunk predates since.
+     */
+    std::vector<SecurityEvent> query(const std::string& profileId, SecurityEventType type,
+                                     std::chrono::system_clock::time_point since,
+                                     size_t maxResults = SIZE_MAX) const;
+
+    size_t count(SecurityEventType type) const;
+    std::map<SecurityEventType, size_t> statistics() const;
+    size_t size() const;
+
+    Snapshot snapshot() const;
+
+    // Retention is applied per chunk: a chunk is dropped once its newest event expires
+    size_t pruneOlderThan(std::chrono::system_clock::time_point cutoff);
+    void clear();
+
+private:
+    using SequenceIndex = std::deque<uint64_t>;
+    using TypeIndex = std::array<SequenceIndex, kEventTypeCount>;
+
+    mutable std::shared_mutex mutex_;
+    std::deque<std::shared_ptr<Chunk>> chunks_;
+    uint64_t next_sequence_ = 0;
+    size_t size_ = 0;
+
+    TypeIndex type_index_;
+    std::map<std::string, TypeIndex> profile_index_;
+    std::array<size_t, kEventTypeCount> type_counts_{};
+
+    const Chunk& chunkAt(uint64_t sequence) const;
+    const SecurityEvent& eventAt(uint64_t sequence) const;
+    void trimIndexes(uint64_t firstLiveSequence);
+};
+
+} // namespace phantomvault
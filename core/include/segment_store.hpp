@@ -0,0 +1,99 @@
+/**
+ * PhantomVault Segment Store
+ *
+ * Pack-file layout for small encrypted objects. Instead of one file per
+ * vaulted file, objects are appended to a few large segment files and located
+ * through a single index of (object id, segment, offset, length). Locking a
+ * folder of tiny files then costs a handful of sequential writes rather than
+ * an open/write/chmod/close per file, and the vault directory stays small
+ * enough that scans over it are cheap.
+ *
+ * Directory layout: segment_<n>.pack | objects.idx. The index is written last
+ * (temp + rename) on commit, so a store without an index was never completed.
+ * It also records a random generation drawn by create(), which tells a store
+ * apart from an earlier one that left the same names, offsets and lengths.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace phantomvault {
+
+class SegmentStore {
+public:
+    struct Config {
+        size_t maxObjectSize = 256 * 1024;          // larger objects stay standalone files
+        size_t segmentSize = 64 * 1024 * 1024;      // start a new segment past this size
+    };
+
+    struct ObjectLocation {
+        uint32_t segment = 0;
+        uint64_t offset = 0;
+        uint64_t length = 0;
+    };
+
+    SegmentStore();
+    explicit SegmentStore(const Config& config);
+    ~SegmentStore();
+
+    SegmentStore(const SegmentStore&) = delete;
+    SegmentStore& operator=(const SegmentStore&) = delete;
+
+    // True if directory holds a committed store
+    static bool exists(const std::string& directory);
+
+    // File holding a segment, for readers that fetch object bytes themselves
+    static std::string segmentPath(const std::string& directory, uint32_t segment);
+
+    /**
+     * Start a new, empty store in directory, discarding any previous one.
+     * Objects become visible to open() only after commit().
+     */
+    bool create(const std::string& directory);
+
+    // Load the index of a committed store for reading
+    bool open(const std::string& directory);
+    void close();
+
+    // Whether an object of this size belongs in the pack or in its own file
+    bool accepts(size_t size) const;
+
+    bool append(const std::string& objectId, const std::string& data);
+
+    /**
+     * Reopen a store for further appends after an interrupted write. Objects
+     * covered by the last commit or checkpoint are kept; anything appended
+     * after it is dropped. Behaves like create() if no index was ever written.
+     */
+    bool resume(const std::string& directory);
+
+    // Sync and publish the index for everything appended so far, staying open for writing
+    bool checkpoint();
+
+    // Flush and sync the segments, then publish the index atomically
+    bool commit();
+
+    std::optional<std::string> read(const std::string& objectId) const;
+
+    // Visits objects in the order they were first appended, i.e. sequential on disk
+    void forEachObject(const std::function<void(const std::string&, const ObjectLocation&)>& callback) const;
+
+    size_t getObjectCount() const;
+    uint64_t getStoredBytes() const;
+
+    // Drawn by create() and kept across resume(); 0 for stores written before it was recorded
+    uint64_t getGeneration() const;
+    std::string getLastError() const;
+
+private:
+    class Implementation;
+    std::unique_ptr<Implementation> pimpl;
+};
+
+} // namespace phantomvault
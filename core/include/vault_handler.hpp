@@ -1,5 +1,6 @@
 #pragma once
 
+#include "secure_wipe_engine.hpp"
 #include <string>
 #include <vector>
 #include <memory>
@@ -79,6 +80,9 @@ struct CleanupResult {
     std::string error_details;
     size_t folders_cleaned = 0;
     size_t bytes_freed = 0;
+    size_t objects_reclaimed = 0;
+    size_t files_repacked = 0;
+    std::chrono::milliseconds duration{0};
 };
 
 /**
@@ -115,11 +119,14 @@ public:
     CleanupResult secureDeleteFromVault(const std::string& vault_id, const std::string& folder_identifier);
     CleanupResult cleanupVault(const std::string& vault_id);
     bool secureWipeVaultData(const std::string& vault_path);
+    void setWipeConfig(const WipeConfig& config);
     
     // Vault integrity and maintenance
     bool validateVaultIntegrity(const std::string& vault_id);
     bool repairVaultStructure(const std::string& vault_id);
     bool compactVault(const std::string& vault_id);
+    void setCompactionIOLimit(size_t max_bytes_per_second);
+    void waitForBackgroundTasks();  // deferred decoys and metadata checkpoints from hideFolder
     
     // Complete folder obfuscation (OSINT-resistant)
     std::string generateObfuscatedIdentifier(const std::string& folder_path, const std::string& vault_id);
@@ -0,0 +1,33 @@
+#!/bin/bash
+# Benchmark Regression Check
+# Compares a benchmark run against a baseline; exits 1 when any benchmark's
+# median slowed down by more than the threshold (and beyond its noise).
+#
+# Usage: compare-benchmarks.sh BASELINE.json [CURRENT.json] [THRESHOLD]
+#   Without CURRENT.json, runs phantomvault-bench first and compares that run.
+#   THRESHOLD is a fraction, default 0.05 (5%).
+
+set -e
+
+BENCH_BIN="${BENCH_BIN:-./core/build/benchmarks/phantomvault-bench}"
+BASELINE="$1"
+CURRENT="$2"
+THRESHOLD="${3:-0.05}"
+
+if [[ -z "$BASELINE" ]]; then
+    echo "Usage: $0 BASELINE.json [CURRENT.json] [THRESHOLD]"
+    exit 2
+fi
+
+if [[ ! -x "$BENCH_BIN" ]]; then
+    echo "Benchmark binary not found: $BENCH_BIN"
+    echo "Build it with: cmake -S core -B core/build -DBUILD_BENCHMARKS=ON && cmake --build core/build --target phantomvault-bench"
+    exit 2
+fi
+
+if [[ -z "$CURRENT" ]]; then
+    CURRENT="bench-$(date +%Y%m%d-%H%M%S).json"
+    "$BENCH_BIN" --json="$CURRENT"
+fi
+
+"$BENCH_BIN" --compare "$BASELINE" "$CURRENT" --threshold="$THRESHOLD"
@@ -6,6 +6,9 @@
  */
 
 #include "analytics_engine.hpp"
+#include "event_queue.hpp"
+#include "event_rollups.hpp"
+#include "performance_monitor.hpp"
 #include <iostream>
 #include <fstream>
 #include <filesystem>
@@ -16,6 +19,7 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <ctime>
 #include <nlohmann/json.hpp>
 
 #ifdef PLATFORM_LINUX
@@ -46,12 +50,14 @@ public:
         , statistics_()
         , last_error_()
         , events_mutex_()
-        , cleanup_thread_()
+        , cleanup_task_(0)
         , service_start_time_(std::chrono::system_clock::now())
+        , ingest_queue_(kIngestQueueCapacity)
     {}
     
     ~Implementation() {
         stop();
+        drainRemainingEvents();
     }
     
     bool initialize(const std::string& dataPath) {
@@ -98,11 +104,16 @@ public:
             
             running_ = true;
             
+            // Start writer thread before anything is logged
+            writer_running_ = true;
+            writer_thread_ = std::thread(&Implementation::writerLoop, this);
+            
             // Log service start event
             logEvent(EventType::SERVICE_STARTED, SecurityLevel::INFO, "", "PhantomVault service started", {});
             
-            // Start cleanup thread
-            cleanup_thread_ = std::thread(&Implementation::cleanupLoop, this);
+            // Hourly expiry and save on the shared background scheduler
+            cleanup_task_ = AdaptiveScheduler::getInstance().scheduleTask(
+                [this]() { runCleanup(); }, std::chrono::hours(1), -1);
             
             std::cout << "[AnalyticsEngine] Started analytics collection" << std::endl;
             return true;
@@ -122,17 +133,25 @@ public:
         // Log service stop event
         logEvent(EventType::SERVICE_STOPPED, SecurityLevel::INFO, "", "PhantomVault service stopped", {});
         
-        // Update uptime
-        auto now = std::chrono::system_clock::now();
-        statistics_.totalUptime += std::chrono::duration_cast<std::chrono::duration<double>>(now - service_start_time_);
-        
         running_ = false;
         
-        if (cleanup_thread_.joinable()) {
-            cleanup_thread_.join();
+        if (cleanup_task_) {
+            AdaptiveScheduler::getInstance().cancelTask(cleanup_task_);
+            cleanup_task_ = 0;
+        }
+        
+        // Writer drains whatever is still queued before exiting
+        writer_running_ = false;
+        ingest_queue_.wake();
+        if (writer_thread_.joinable()) {
+            writer_thread_.join();
         }
+        drainRemainingEvents();
         
-        // Save data before shutdown
+        // Update uptime and save data before shutdown
+        std::lock_guard<std::mutex> lock(events_mutex_);
+        auto now = std::chrono::system_clock::now();
+        statistics_.totalUptime += std::chrono::duration_cast<std::chrono::duration<double>>(now - service_start_time_);
         saveData();
         
         std::cout << "[AnalyticsEngine] Stopped analytics collection" << std::endl;
@@ -149,40 +168,179 @@ public:
         }
         
         try {
-            std::lock_guard<std::mutex> lock(events_mutex_);
-            
+            // Hot path: capture the event and hand it to the writer thread.
+            // Id assignment, statistics, callbacks and persistence happen there.
             AnalyticsEvent event;
-            event.id = generateEventId();
             event.type = type;
             event.level = level;
             event.profileId = profileId;
             event.description = description;
             event.metadata = metadata;
             event.timestamp = std::chrono::system_clock::now();
-            event.source = "PhantomVault";
             
-            events_.push_back(event);
+            ingest_queue_.push(std::move(event));
             
-            // Update statistics
-            updateStatistics(event);
-            
-            // Trigger callbacks
-            if (event_callback_) {
-                event_callback_(event);
+        } catch (const std::exception& e) {
+            last_error_ = "Failed to log event: " + std::string(e.what());
+        }
+    }
+    
+    void enableDataCollection(bool enabled) {
+        data_collection_enabled_ = enabled;
+    }
+    
+    bool isDataCollectionEnabled() const {
+        return data_collection_enabled_;
+    }
+    
+    void setEventCallback(std::function<void(const AnalyticsEvent&)> callback) {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        event_callback_ = std::move(callback);
+    }
+    
+    void setSecurityAlertCallback(std::function<void(const AnalyticsEvent&)> callback) {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        security_alert_callback_ = std::move(callback);
+    }
+    
+    void setOverflowPolicy(OverflowPolicy policy) {
+        ingest_queue_.setPolicy(policy);
+    }
+    
+    void setOverflowSampleRate(uint32_t oneInN) {
+        ingest_queue_.setSampleRate(oneInN);
+    }
+    
+    void setOverflowBlockTimeout(std::chrono::milliseconds timeout) {
+        ingest_queue_.setBlockTimeout(timeout);
+    }
+    
+    EventQueueStats getIngestionStats() const {
+        return ingest_queue_.getStats();
+    }
+    
+    UsageStatistics getUsageStatistics() const {
+        awaitWriter();
+        std::lock_guard<std::mutex> lock(events_mutex_);
+        return statistics_;
+    }
+    
+    UsageStatistics getProfileStatistics(const std::string& profileId) const {
+        awaitWriter();
+        std::lock_guard<std::mutex> lock(events_mutex_);
+        auto it = profile_statistics_.find(profileId);
+        return it != profile_statistics_.end() ? it->second : UsageStatistics{};
+    }
+    
+    std::vector<AnalyticsEvent> queryEvents(const AnalyticsQuery& query) const {
+        awaitWriter();
+        std::lock_guard<std::mutex> lock(events_mutex_);
+        
+        auto endTime = query.endTime == std::chrono::system_clock::time_point{}
+            ? std::chrono::system_clock::time_point::max() : query.endTime;
+        
+        // events_ is kept sorted by timestamp, so the range is found by bisection
+        auto first = std::lower_bound(events_.begin(), events_.end(), query.startTime,
+            [](const AnalyticsEvent& e, const std::chrono::system_clock::time_point& t) { return e.timestamp < t; });
+        
+        std::vector<AnalyticsEvent> results;
+        for (auto it = first; it != events_.end() && it->timestamp < endTime; ++it) {
+            if (results.size() >= query.maxResults) {
+                break;
             }
-            
-            if (level == SecurityLevel::CRITICAL && security_alert_callback_) {
-                security_alert_callback_(event);
+            if (matchesQuery(*it, query)) {
+                results.push_back(*it);
             }
+        }
+        return results;
+    }
+    
+    AnalyticsReport generateReport(const AnalyticsQuery& query) const {
+        AnalyticsReport report;
+        
+        auto now = std::chrono::system_clock::now();
+        int64_t start = EventRollups::toEpochSeconds(query.startTime);
+        int64_t end = query.endTime == std::chrono::system_clock::time_point{}
+            ? EventRollups::toEpochSeconds(now) + 1 : EventRollups::toEpochSeconds(query.endTime);
+        
+        awaitWriter();
+        {
+            std::lock_guard<std::mutex> lock(events_mutex_);
+            report.statistics = query.profileId.empty() ? statistics_ : lookupProfileStatistics(query.profileId);
             
-            // Periodic save
-            if (events_.size() % 100 == 0) {
-                saveData();
+            auto perProfile = rollups_.aggregate(start, end, EventRollups::toEpochSeconds(now));
+            for (const auto& [profileId, counts] : perProfile) {
+                if (!query.profileId.empty() && profileId != query.profileId) {
+                    continue;
+                }
+                size_t profileTotal = 0;
+                for (size_t i = 0; i < EventRollups::kTypeCount; ++i) {
+                    auto type = static_cast<EventType>(i);
+                    if (counts[i] == 0 || !typeSelected(type, query)) {
+                        continue;
+                    }
+                    report.eventCounts[type] += counts[i];
+                    profileTotal += counts[i];
+                }
+                if (!profileId.empty() && profileTotal > 0) {
+                    report.profileActivity[profileId] += profileTotal;
+                }
             }
-            
-        } catch (const std::exception& e) {
-            last_error_ = "Failed to log event: " + std::string(e.what());
         }
+        
+        if (query.includeEvents) {
+            report.events = queryEvents(query);
+        }
+        
+        std::time_t generated = std::chrono::system_clock::to_time_t(now);
+        std::tm tm_buf{};
+        #ifdef PLATFORM_WINDOWS
+        gmtime_s(&tm_buf, &generated);
+        #else
+        gmtime_r(&generated, &tm_buf);
+        #endif
+        std::ostringstream oss;
+        oss << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S");
+        report.generatedAt = oss.str();
+        
+        return report;
+    }
+    
+    void setRetentionPolicy(std::chrono::hours retentionPeriod) {
+        std::lock_guard<std::mutex> lock(events_mutex_);
+        retention_period_ = retentionPeriod;
+    }
+    
+    void cleanupOldData() {
+        awaitWriter();
+        std::lock_guard<std::mutex> lock(events_mutex_);
+        auto now = std::chrono::system_clock::now();
+        auto cutoff = now - retention_period_;
+        auto first = std::lower_bound(events_.begin(), events_.end(), cutoff,
+            [](const AnalyticsEvent& e, const std::chrono::system_clock::time_point& t) { return e.timestamp < t; });
+        events_.erase(events_.begin(), first);
+        rollups_.prune(EventRollups::toEpochSeconds(now));
+    }
+    
+    void clearAllData() {
+        awaitWriter();
+        std::lock_guard<std::mutex> lock(events_mutex_);
+        events_.clear();
+        rollups_.clear();
+        profile_statistics_.clear();
+        statistics_ = UsageStatistics{};
+        statistics_.firstUse = std::chrono::system_clock::now();
+        saveData();
+    }
+    
+    void clearProfileData(const std::string& profileId) {
+        awaitWriter();
+        std::lock_guard<std::mutex> lock(events_mutex_);
+        events_.erase(std::remove_if(events_.begin(), events_.end(),
+            [&profileId](const AnalyticsEvent& e) { return e.profileId == profileId; }), events_.end());
+        rollups_.removeProfile(profileId);
+        profile_statistics_.erase(profileId);
+        saveData();
     }
     
     std::string getLastError() const {
@@ -197,16 +355,121 @@ private:
     
     std::vector<AnalyticsEvent> events_;
     UsageStatistics statistics_;
+    std::map<std::string, UsageStatistics> profile_statistics_;
+    EventRollups rollups_;
     mutable std::string last_error_;
     mutable std::mutex events_mutex_;
     
-    std::thread cleanup_thread_;
+    AdaptiveScheduler::TaskId cleanup_task_;
     std::chrono::system_clock::time_point service_start_time_;
     
+    // Lock-free ingestion drained by the writer thread
+    static constexpr size_t kIngestQueueCapacity = 4096;
+    static constexpr size_t kSaveEveryEvents = 100;
+    static constexpr std::chrono::milliseconds kReaderSyncTimeout{100};
+    mutable BoundedEventQueue<AnalyticsEvent> ingest_queue_;
+    std::thread writer_thread_;
+    std::atomic<bool> writer_running_{false};
+    std::atomic<std::thread::id> writer_id_{};
+    uint64_t next_event_seq_ = 0;
+    size_t events_since_save_ = 0;
+    
     // Callbacks
+    mutable std::mutex callback_mutex_;
     std::function<void(const AnalyticsEvent&)> event_callback_;
     std::function<void(const AnalyticsEvent&)> security_alert_callback_;
     
+    void writerLoop() {
+        writer_id_ = std::this_thread::get_id();
+        // Sleeps until a producer pushes or stop() calls wake()
+        while (writer_running_) {
+            ingest_queue_.waitForItems();
+            uint64_t ticket = ingest_queue_.beginConsumerPass();
+            while (applyPendingEvents() == kIngestQueueCapacity) {
+            }
+            ingest_queue_.endConsumerPass(ticket);
+        }
+    }
+    
+    /**
+     * Readers see the store as of the writer's last pass. While the writer
+     * runs, ask it for one more pass so events logged before the call are
+     * visible; on timeout the reader proceeds with what has been applied.
+     */
+    void awaitWriter() const {
+        // Callbacks run on the writer, so a query from one must not wait on itself
+        if (writer_running_ && writer_id_.load() != std::this_thread::get_id()) {
+            ingest_queue_.waitForConsumer(kReaderSyncTimeout);
+        }
+    }
+    
+    /**
+     * Apply whatever the writer left behind. Only called once the writer
+     * thread has been joined, so there is still a single consumer.
+     */
+    void drainRemainingEvents() {
+        while (applyPendingEvents() > 0) {
+        }
+    }
+    
+    size_t applyPendingEvents() {
+        std::vector<AnalyticsEvent> batch;
+        if (ingest_queue_.drain(batch, kIngestQueueCapacity) == 0) {
+            return 0;
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(events_mutex_);
+            for (auto& event : batch) {
+                event.id = generateEventId(event.timestamp);
+                event.source = "PhantomVault";
+                
+                updateStatistics(event);
+                rollups_.record(event.type, event.profileId, event.timestamp);
+                insertByTimestamp(event);
+            }
+            
+            // Periodic save, now off the logging thread
+            events_since_save_ += batch.size();
+            if (events_since_save_ >= kSaveEveryEvents) {
+                events_since_save_ = 0;
+                saveData();
+            }
+        }
+        
+        std::function<void(const AnalyticsEvent&)> eventCallback;
+        std::function<void(const AnalyticsEvent&)> alertCallback;
+        {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            eventCallback = event_callback_;
+            alertCallback = security_alert_callback_;
+        }
+        for (const auto& event : batch) {
+            if (eventCallback) {
+                eventCallback(event);
+            }
+            if (event.level == SecurityLevel::CRITICAL && alertCallback) {
+                alertCallback(event);
+            }
+        }
+        return batch.size();
+    }
+    
+    /**
+     * Producers stamp events before pushing, so queue order can trail
+     * timestamp order by a few events. Keep events_ sorted for the range
+     * bisection in queryEvents and cleanupOldData.
+     */
+    void insertByTimestamp(const AnalyticsEvent& event) {
+        if (events_.empty() || !(event.timestamp < events_.back().timestamp)) {
+            events_.push_back(event);
+            return;
+        }
+        auto pos = std::upper_bound(events_.begin(), events_.end(), event.timestamp,
+            [](const std::chrono::system_clock::time_point& t, const AnalyticsEvent& e) { return t < e.timestamp; });
+        events_.insert(pos, event);
+    }
+    
     std::string getDefaultDataPath() {
         #ifdef PLATFORM_LINUX
         const char* home = getenv("HOME");
@@ -233,47 +496,118 @@ private:
         #endif
     }
     
-    std::string generateEventId() {
-        auto now = std::chrono::system_clock::now();
-        auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-        
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(1000, 9999);
+    std::string generateEventId(std::chrono::system_clock::time_point when) {
+        auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(when.time_since_epoch()).count();
         
-        return "event_" + std::to_string(timestamp) + "_" + std::to_string(dis(gen));
+        // Sequence suffix keeps ids unique without a random_device read per event
+        return "event_" + std::to_string(timestamp) + "_" + std::to_string(next_event_seq_++);
     }
     
     void updateStatistics(const AnalyticsEvent& event) {
-        statistics_.lastActivity = event.timestamp;
+        applyToStatistics(statistics_, event);
+        
+        if (!event.profileId.empty()) {
+            auto [it, inserted] = profile_statistics_.try_emplace(event.profileId);
+            if (inserted) {
+                it->second.firstUse = event.timestamp;
+            }
+            applyToStatistics(it->second, event);
+        }
+    }
+    
+    static void applyToStatistics(UsageStatistics& stats, const AnalyticsEvent& event) {
+        stats.lastActivity = event.timestamp;
         
         switch (event.type) {
             case EventType::PROFILE_CREATED:
-                statistics_.totalProfiles++;
+                stats.totalProfiles++;
                 break;
             case EventType::FOLDER_LOCKED:
-                statistics_.totalFolders++;
+                stats.totalFolders++;
                 break;
             case EventType::FOLDER_UNLOCKED_TEMPORARY:
             case EventType::FOLDER_UNLOCKED_PERMANENT:
-                statistics_.totalUnlockAttempts++;
-                statistics_.successfulUnlocks++;
+                stats.totalUnlockAttempts++;
+                stats.successfulUnlocks++;
                 break;
             case EventType::PROFILE_AUTH_FAILED:
-                statistics_.totalUnlockAttempts++;
-                statistics_.failedUnlocks++;
+                stats.totalUnlockAttempts++;
+                stats.failedUnlocks++;
                 break;
             case EventType::KEYBOARD_SEQUENCE_DETECTED:
-                statistics_.keyboardSequenceDetections++;
+                stats.keyboardSequenceDetections++;
                 break;
             case EventType::SECURITY_VIOLATION:
-                statistics_.securityViolations++;
+                stats.securityViolations++;
                 break;
             default:
                 break;
         }
     }
     
+    UsageStatistics lookupProfileStatistics(const std::string& profileId) const {
+        auto it = profile_statistics_.find(profileId);
+        return it != profile_statistics_.end() ? it->second : UsageStatistics{};
+    }
+    
+    static bool typeSelected(EventType type, const AnalyticsQuery& query) {
+        return query.eventTypes.empty() ||
+               std::find(query.eventTypes.begin(), query.eventTypes.end(), type) != query.eventTypes.end();
+    }
+    
+    static bool matchesQuery(const AnalyticsEvent& event, const AnalyticsQuery& query) {
+        if (!query.profileId.empty() && event.profileId != query.profileId) {
+            return false;
+        }
+        if (!typeSelected(event.type, query)) {
+            return false;
+        }
+        return query.securityLevels.empty() ||
+               std::find(query.securityLevels.begin(), query.securityLevels.end(), event.level) != query.securityLevels.end();
+    }
+    
+    static json statisticsToJson(const UsageStatistics& stats) {
+        return {
+            {"totalProfiles", stats.totalProfiles},
+            {"totalFolders", stats.totalFolders},
+            {"totalUnlockAttempts", stats.totalUnlockAttempts},
+            {"successfulUnlocks", stats.successfulUnlocks},
+            {"failedUnlocks", stats.failedUnlocks},
+            {"keyboardSequenceDetections", stats.keyboardSequenceDetections},
+            {"securityViolations", stats.securityViolations},
+            {"firstUse", std::chrono::duration_cast<std::chrono::milliseconds>(stats.firstUse.time_since_epoch()).count()},
+            {"lastActivity", std::chrono::duration_cast<std::chrono::milliseconds>(stats.lastActivity.time_since_epoch()).count()},
+            {"totalUptime", stats.totalUptime.count()}
+        };
+    }
+    
+    static UsageStatistics statisticsFromJson(const json& stats) {
+        UsageStatistics result;
+        result.totalProfiles = stats.value("totalProfiles", 0);
+        result.totalFolders = stats.value("totalFolders", 0);
+        result.totalUnlockAttempts = stats.value("totalUnlockAttempts", 0);
+        result.successfulUnlocks = stats.value("successfulUnlocks", 0);
+        result.failedUnlocks = stats.value("failedUnlocks", 0);
+        result.keyboardSequenceDetections = stats.value("keyboardSequenceDetections", 0);
+        result.securityViolations = stats.value("securityViolations", 0);
+        
+        if (stats.contains("firstUse")) {
+            int64_t firstUseMs = stats["firstUse"];
+            result.firstUse = std::chrono::system_clock::from_time_t(firstUseMs / 1000);
+        }
+        
+        if (stats.contains("lastActivity")) {
+            int64_t lastActivityMs = stats["lastActivity"];
+            result.lastActivity = std::chrono::system_clock::from_time_t(lastActivityMs / 1000);
+        }
+        
+        if (stats.contains("totalUptime")) {
+            double uptimeSeconds = stats["totalUptime"];
+            result.totalUptime = std::chrono::duration<double>(uptimeSeconds);
+        }
+        return result;
+    }
+    
     void loadExistingData() {
         try {
             fs::path dataFile = fs::path(data_path_) / "analytics" / "events.json";
@@ -287,26 +621,21 @@ private:
             
             // Load statistics
             if (data.contains("statistics")) {
-                auto stats = data["statistics"];
-                statistics_.totalProfiles = stats.value("totalProfiles", 0);
-                statistics_.totalFolders = stats.value("totalFolders", 0);
-                statistics_.totalUnlockAttempts = stats.value("totalUnlockAttempts", 0);
-                statistics_.successfulUnlocks = stats.value("successfulUnlocks", 0);
-                statistics_.failedUnlocks = stats.value("failedUnlocks", 0);
-                statistics_.keyboardSequenceDetections = stats.value("keyboardSequenceDetections", 0);
-                statistics_.securityViolations = stats.value("securityViolations", 0);
-                
-                if (stats.contains("firstUse")) {
-                    int64_t firstUseMs = stats["firstUse"];
-                    statistics_.firstUse = std::chrono::system_clock::from_time_t(firstUseMs / 1000);
-                }
-                
-                if (stats.contains("totalUptime")) {
-                    double uptimeSeconds = stats["totalUptime"];
-                    statistics_.totalUptime = std::chrono::duration<double>(uptimeSeconds);
+                statistics_ = statisticsFromJson(data["statistics"]);
+            }
+            
+            if (data.contains("profileStatistics")) {
+                for (const auto& [profileId, stats] : data["profileStatistics"].items()) {
+                    profile_statistics_[profileId] = statisticsFromJson(stats);
                 }
             }
             
+            // Load pre-aggregated rollups
+            if (data.contains("rollups")) {
+                rollups_.fromJson(data["rollups"]);
+                rollups_.prune(EventRollups::toEpochSeconds(std::chrono::system_clock::now()));
+            }
+            
             std::cout << "[AnalyticsEngine] Loaded existing analytics data" << std::endl;
             
         } catch (const std::exception& e) {
@@ -321,17 +650,15 @@ private:
             json data;
             
             // Save statistics
-            data["statistics"] = {
-                {"totalProfiles", statistics_.totalProfiles},
-                {"totalFolders", statistics_.totalFolders},
-                {"totalUnlockAttempts", statistics_.totalUnlockAttempts},
-                {"successfulUnlocks", statistics_.successfulUnlocks},
-                {"failedUnlocks", statistics_.failedUnlocks},
-                {"keyboardSequenceDetections", statistics_.keyboardSequenceDetections},
-                {"securityViolations", statistics_.securityViolations},
-                {"firstUse", std::chrono::duration_cast<std::chrono::milliseconds>(statistics_.firstUse.time_since_epoch()).count()},
-                {"totalUptime", statistics_.totalUptime.count()}
-            };
+            data["statistics"] = statisticsToJson(statistics_);
+            
+            data["profileStatistics"] = json::object();
+            for (const auto& [profileId, stats] : profile_statistics_) {
+                data["profileStatistics"][profileId] = statisticsToJson(stats);
+            }
+            
+            // Rollups are persisted with the statistics so reports survive restarts
+            data["rollups"] = rollups_.toJson();
             
             std::ofstream file(dataFile);
             file << data.dump(2);
@@ -345,21 +672,17 @@ private:
         }
     }
     
-    void cleanupLoop() {
-        while (running_) {
-            try {
-                // Cleanup old data every hour
-                std::this_thread::sleep_for(std::chrono::hours(1));
-                
-                if (running_) {
-                    // Periodic save
-                    saveData();
-                }
-                
-            } catch (const std::exception& e) {
-                last_error_ = "Cleanup loop error: " + std::string(e.what());
-                std::this_thread::sleep_for(std::chrono::minutes(10));
+    void runCleanup() {
+        try {
+            if (running_) {
+                // Expire old events and rollup buckets, then periodic save
+                cleanupOldData();
+                std::lock_guard<std::mutex> lock(events_mutex_);
+                saveData();
             }
+            
+        } catch (const std::exception& e) {
+            last_error_ = "Cleanup task error: " + std::string(e.what());
         }
     }
 };
@@ -399,45 +722,27 @@ void AnalyticsEngine::logUsageEvent(EventType type, const std::string& profileId
 }
 
 UsageStatistics AnalyticsEngine::getUsageStatistics() const {
-    // For now, return basic statistics
-    UsageStatistics stats;
-    stats.totalProfiles = 0;
-    stats.totalFolders = 0;
-    stats.totalUnlockAttempts = 0;
-    stats.successfulUnlocks = 0;
-    stats.failedUnlocks = 0;
-    stats.keyboardSequenceDetections = 0;
-    stats.securityViolations = 0;
-    stats.firstUse = std::chrono::system_clock::now();
-    stats.lastActivity = std::chrono::system_clock::now();
-    stats.totalUptime = std::chrono::duration<double>(0);
-    return stats;
+    return pimpl->getUsageStatistics();
 }
 
 UsageStatistics AnalyticsEngine::getProfileStatistics(const std::string& profileId) const {
-    // For now, return empty statistics
-    return getUsageStatistics();
+    return pimpl->getProfileStatistics(profileId);
 }
 
 std::vector<AnalyticsEvent> AnalyticsEngine::queryEvents(const AnalyticsQuery& query) const {
-    // For now, return empty vector
-    return std::vector<AnalyticsEvent>();
+    return pimpl->queryEvents(query);
 }
 
 AnalyticsReport AnalyticsEngine::generateReport(const AnalyticsQuery& query) const {
-    AnalyticsReport report;
-    report.statistics = getUsageStatistics();
-    report.events = queryEvents(query);
-    report.generatedAt = "2024-01-01 00:00:00";
-    return report;
+    return pimpl->generateReport(query);
 }
 
 void AnalyticsEngine::setRetentionPolicy(std::chrono::hours retentionPeriod) {
-    // Stub implementation
+    pimpl->setRetentionPolicy(retentionPeriod);
 }
 
 void AnalyticsEngine::cleanupOldData() {
-    // Stub implementation
+    pimpl->cleanupOldData();
 }
 
 void AnalyticsEngine::exportData(const std::string& filePath, const AnalyticsQuery& query) const {
@@ -445,19 +750,19 @@ void AnalyticsEngine::exportData(const std::string& filePath, const AnalyticsQue
 }
 
 void AnalyticsEngine::clearAllData() {
-    // Stub implementation
+    pimpl->clearAllData();
 }
 
 void AnalyticsEngine::clearProfileData(const std::string& profileId) {
-    // Stub implementation
+    pimpl->clearProfileData(profileId);
 }
 
 void AnalyticsEngine::enableDataCollection(bool enabled) {
-    // Stub implementation
+    pimpl->enableDataCollection(enabled);
 }
 
 bool AnalyticsEngine::isDataCollectionEnabled() const {
-    return true;
+    return pimpl->isDataCollectionEnabled();
 }
 
 void AnalyticsEngine::anonymizeData() {
@@ -469,11 +774,27 @@ size_t AnalyticsEngine::getStorageSize() const {
 }
 
 void AnalyticsEngine::setEventCallback(std::function<void(const AnalyticsEvent&)> callback) {
-    // Stub implementation
+    pimpl->setEventCallback(std::move(callback));
 }
 
 void AnalyticsEngine::setSecurityAlertCallback(std::function<void(const AnalyticsEvent&)> callback) {
-    // Stub implementation
+    pimpl->setSecurityAlertCallback(std::move(callback));
+}
+
+void AnalyticsEngine::setOverflowPolicy(OverflowPolicy policy) {
+    pimpl->setOverflowPolicy(policy);
+}
+
+void AnalyticsEngine::setOverflowSampleRate(uint32_t oneInN) {
+    pimpl->setOverflowSampleRate(oneInN);
+}
+
+void AnalyticsEngine::setOverflowBlockTimeout(std::chrono::milliseconds timeout) {
+    pimpl->setOverflowBlockTimeout(timeout);
+}
+
+EventQueueStats AnalyticsEngine::getIngestionStats() const {
+    return pimpl->getIngestionStats();
 }
 
 std::string AnalyticsEngine::getLastError() const {
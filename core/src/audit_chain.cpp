@@ -0,0 +1,830 @@
+/**
+ * PhantomVault Audit Chain Implementation
+ *
+ * Record line:     {"seq":N,"prev":"<hex>",<event fields>,"hash":"<hex>"}
+ * Checkpoint line: {"chain":..,"offset":..,"prev":..,"root":..,"sealed":..,"seq":..,"hash":"<hex>"}
+ *
+ * In both cases hash = SHA-256 of the line with the trailing hash member
+ * removed, so a line can be checked byte-for-byte without re-serializing it.
+ */
+
+#include "audit_chain.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <openssl/evp.h>
+#include <nlohmann/json.hpp>
+#include <zstd.h>
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace phantomvault {
+
+namespace {
+
+using Digest = std::array<unsigned char, 32>;
+
+constexpr char kHashKey[] = ",\"hash\":\"";
+constexpr size_t kHashKeyLength = sizeof(kHashKey) - 1;
+constexpr size_t kHexLength = 64;
+constexpr size_t kHashSuffixLength = kHashKeyLength + kHexLength + 2; // ,"hash":"<hex>"}
+
+Digest sha256(const void* data, size_t size) {
+    Digest digest{};
+    unsigned int length = 0;
+    EVP_Digest(data, size, digest.data(), &length, EVP_sha256(), nullptr);
+    return digest;
+}
+
+Digest hashPair(const Digest& left, const Digest& right) {
+    unsigned char buffer[64];
+    std::memcpy(buffer, left.data(), 32);
+    std::memcpy(buffer + 32, right.data(), 32);
+    return sha256(buffer, sizeof(buffer));
+}
+
+std::string toHex(const Digest& digest) {
+    static const char kDigits[] = "0123456789abcdef";
+    std::string hex(kHexLength, '0');
+    for (size_t i = 0; i < digest.size(); ++i) {
+        hex[2 * i] = kDigits[digest[i] >> 4];
+        hex[2 * i + 1] = kDigits[digest[i] & 0x0f];
+    }
+    return hex;
+}
+
+bool fromHex(const char* hex, size_t length, Digest& out) {
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    };
+    if (length != kHexLength) {
+        return false;
+    }
+    for (size_t i = 0; i < out.size(); ++i) {
+        int high = nibble(hex[2 * i]);
+        int low = nibble(hex[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        out[i] = static_cast<unsigned char>((high << 4) | low);
+    }
+    return true;
+}
+
+bool fromHex(const std::string& hex, Digest& out) {
+    return fromHex(hex.data(), hex.size(), out);
+}
+
+// Pairwise SHA-256 up to a single root; an odd node is paired with itself
+Digest merkleRoot(std::vector<Digest> level) {
+    if (level.empty()) {
+        return Digest{};
+    }
+    while (level.size() > 1) {
+        size_t next = 0;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            const Digest& right = i + 1 < level.size() ? level[i + 1] : level[i];
+            level[next++] = hashPair(level[i], right);
+        }
+        level.resize(next);
+    }
+    return level.front();
+}
+
+// Hash a JSON object body and append the hash as its last member
+std::string sealLine(const std::string& body, Digest& hash) {
+    hash = sha256(body.data(), body.size());
+    std::string line(body, 0, body.size() - 1);
+    line += kHashKey;
+    line += toHex(hash);
+    line += "\"}";
+    return line;
+}
+
+// Split a sealed line into the hashed body and the recorded hash
+bool splitLine(const std::string& line, std::string& body, Digest& hash) {
+    if (line.size() < kHashSuffixLength + 2) {
+        return false;
+    }
+    size_t pos = line.size() - kHashSuffixLength;
+    if (line.compare(pos, kHashKeyLength, kHashKey) != 0 || line.compare(line.size() - 2, 2, "\"}") != 0) {
+        return false;
+    }
+    if (!fromHex(line.data() + pos + kHashKeyLength, kHexLength, hash)) {
+        return false;
+    }
+    body.assign(line, 0, pos);
+    body += '}';
+    return true;
+}
+
+bool parseRecordHeader(const std::string& body, uint64_t& seq, Digest& prev) {
+    static const char kSeq[] = "{\"seq\":";
+    static const char kPrev[] = ",\"prev\":\"";
+
+    if (body.compare(0, sizeof(kSeq) - 1, kSeq) != 0) {
+        return false;
+    }
+    size_t pos = sizeof(kSeq) - 1;
+    size_t digits = 0;
+    seq = 0;
+    while (pos < body.size() && body[pos] >= '0' && body[pos] <= '9') {
+        seq = seq * 10 + static_cast<uint64_t>(body[pos] - '0');
+        ++pos;
+        ++digits;
+    }
+    if (digits == 0 || body.compare(pos, sizeof(kPrev) - 1, kPrev) != 0) {
+        return false;
+    }
+    pos += sizeof(kPrev) - 1;
+    if (pos + kHexLength >= body.size() || body[pos + kHexLength] != '"') {
+        return false;
+    }
+    return fromHex(body.data() + pos, kHexLength, prev);
+}
+
+} // namespace
+
+class AuditChain::Implementation {
+public:
+    explicit Implementation(const Config& config)
+        : config_(config)
+    {
+        if (config_.checkpointInterval == 0) {
+            config_.checkpointInterval = 1;
+        }
+    }
+
+    ~Implementation() {
+        close();
+    }
+
+    bool open(const std::string& logPath) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        try {
+            log_.close();
+            log_path_ = logPath;
+            checkpoint_path_ = logPath + ".checkpoints";
+            checkpoints_.clear();
+            head_ = Cursor{};
+            previous_segment_hash_ = Digest{};
+            anchor_floor_ = 0;
+            last_error_.clear();
+
+            uint64_t fileSize = fs::exists(log_path_) ? fs::file_size(log_path_) : 0;
+            bool intact = true;
+
+            if (fs::exists(checkpoint_path_)) {
+                std::string error;
+                if (!loadCheckpoints(checkpoint_path_, checkpoints_, error)) {
+                    intact = false;
+                    last_error_ = error;
+                    checkpoints_.clear();
+                    // Keep the damaged file as evidence and start a fresh one
+                    fs::rename(checkpoint_path_, checkpoint_path_ + ".invalid");
+                }
+            }
+
+            if (checkpoints_.empty()) {
+                if (intact && fileSize > 0) {
+                    std::cout << "[AuditChain] Anchoring chain after " << fileSize
+                              << " bytes of unchained log" << std::endl;
+                }
+                head_.offset = fileSize;
+                anchor_floor_ = fileSize;
+                writeCheckpoint(false);
+            } else {
+                anchor_floor_ = checkpoints_.front().offset;
+                Cursor cursor = cursorAtCheckpoint(checkpoints_.size() - 1);
+                VerifyResult result;
+                bool tornTail = false;
+
+                if (fileSize < cursor.offset) {
+                    intact = false;
+                    last_error_ = "Security log is shorter than its last checkpoint";
+                } else if (!checkAnchor(cursor, result) || !scan(cursor, result, tornTail)) {
+                    if (tornTail) {
+                        // A crash mid-write leaves a partial final line; drop it
+                        fs::resize_file(log_path_, cursor.offset);
+                        std::cout << "[AuditChain] Truncated partial record at offset "
+                                  << cursor.offset << std::endl;
+                    } else {
+                        intact = false;
+                        last_error_ = result.error;
+                    }
+                }
+
+                head_ = cursor;
+                if (!intact) {
+                    // Re-anchor at the current end so new records remain verifiable
+                    head_.offset = fs::exists(log_path_) ? fs::file_size(log_path_) : 0;
+                    head_.leaves.clear();
+                    anchor_floor_ = head_.offset;
+                    writeCheckpoint(false);
+                }
+            }
+
+            head_.nextCheckpoint = checkpoints_.size();
+            verified_ = head_;
+
+            log_.open(log_path_, std::ios::app | std::ios::binary);
+            if (!log_.is_open()) {
+                last_error_ = "Failed to open security log: " + log_path_;
+                return false;
+            }
+            fs::permissions(log_path_, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace);
+            fs::permissions(checkpoint_path_, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace);
+
+            if (!intact) {
+                std::cout << "[AuditChain] Integrity check failed on open: " << last_error_ << std::endl;
+            }
+            return intact;
+
+        } catch (const std::exception& e) {
+            last_error_ = "Failed to open audit chain: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (log_.is_open()) {
+            log_.close();
+        }
+    }
+
+    bool append(const std::vector<std::string>& records) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!log_.is_open()) {
+            last_error_ = "Audit chain is not open";
+            return false;
+        }
+
+        try {
+            std::string body;
+            for (const auto& record : records) {
+                if (record.size() < 2 || record.front() != '{' || record.back() != '}') {
+                    continue;
+                }
+
+                body.clear();
+                body += "{\"seq\":";
+                body += std::to_string(head_.seq + 1);
+                body += ",\"prev\":\"";
+                body += toHex(head_.head);
+                body += '"';
+                if (record.size() > 2) {
+                    body += ',';
+                    body.append(record, 1, std::string::npos);
+                } else {
+                    body += '}';
+                }
+
+                Digest hash;
+                std::string line = sealLine(body, hash);
+                log_ << line << '\n';
+
+                head_.seq++;
+                head_.head = hash;
+                head_.offset += line.size() + 1;
+                head_.leaves.push_back(hash);
+
+                if (head_.leaves.size() >= config_.checkpointInterval) {
+                    writeCheckpoint(false);
+                }
+            }
+
+            log_.flush();
+            if (!log_) {
+                last_error_ = "Failed to write security log";
+                return false;
+            }
+            return true;
+
+        } catch (const std::exception& e) {
+            last_error_ = "Failed to append audit records: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    VerifyResult verifyIncremental() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return verifyIncrementalLocked();
+    }
+
+    VerifyResult verifyFull() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        VerifyResult result;
+
+        try {
+            std::vector<Checkpoint> onDisk;
+            if (!loadCheckpoints(checkpoint_path_, onDisk, result.error)) {
+                return result;
+            }
+            if (onDisk.empty()) {
+                result.error = "Checkpoint file is empty";
+                return result;
+            }
+
+            Cursor cursor;
+            cursor.offset = onDisk.front().offset;
+            cursor.seq = onDisk.front().seq;
+            cursor.head = onDisk.front().chain;
+            cursor.nextCheckpoint = 1;
+
+            bool tornTail = false;
+            if (!scanAgainst(onDisk, cursor, result, tornTail) || !checkHead(cursor, result)) {
+                return result;
+            }
+            result.valid = true;
+
+        } catch (const std::exception& e) {
+            result.error = "Full verification failed: " + std::string(e.what());
+        }
+        return result;
+    }
+
+    std::string sealAndRotate() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!log_.is_open()) {
+            last_error_ = "Audit chain is not open";
+            return "";
+        }
+
+        try {
+            // Sealed segments should only ever contain verified data
+            VerifyResult tail = verifyIncrementalLocked();
+            if (!tail.valid) {
+                std::cout << "[AuditChain] Sealing segment that failed verification: " << tail.error << std::endl;
+            }
+
+            if (!writeCheckpoint(true)) {
+                return "";
+            }
+            log_.close();
+
+            auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            std::string rotated = log_path_ + "." + std::to_string(timestamp);
+            std::string compressed = rotated + ".zst";
+
+            if (!compressFile(log_path_, compressed)) {
+                log_.open(log_path_, std::ios::app | std::ios::binary);
+                return "";
+            }
+
+            fs::rename(checkpoint_path_, rotated + ".checkpoints");
+            fs::remove(log_path_);
+            fs::permissions(compressed, fs::perms::owner_read, fs::perm_options::replace);
+            fs::permissions(rotated + ".checkpoints", fs::perms::owner_read, fs::perm_options::replace);
+
+            // The chain carries on into the new segment
+            previous_segment_hash_ = checkpoints_.back().hash;
+            checkpoints_.clear();
+            head_.offset = 0;
+            head_.leaves.clear();
+            anchor_floor_ = 0;
+            writeCheckpoint(false);
+            head_.nextCheckpoint = checkpoints_.size();
+            verified_ = head_;
+
+            log_.open(log_path_, std::ios::app | std::ios::binary);
+            fs::permissions(log_path_, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace);
+
+            std::cout << "[AuditChain] Sealed segment: " << compressed << std::endl;
+            return compressed;
+
+        } catch (const std::exception& e) {
+            last_error_ = "Log rotation failed: " + std::string(e.what());
+            if (!log_.is_open()) {
+                log_.open(log_path_, std::ios::app | std::ios::binary);
+            }
+            return "";
+        }
+    }
+
+    uint64_t getRecordCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return head_.seq;
+    }
+
+    uint64_t getSegmentSize() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return head_.offset;
+    }
+
+    std::string getHeadHash() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return toHex(head_.head);
+    }
+
+    std::string getLastError() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return last_error_;
+    }
+
+private:
+    struct Checkpoint {
+        uint64_t seq = 0;       // last record covered
+        uint64_t offset = 0;    // segment offset just past that record
+        Digest chain{};         // hash of record seq
+        Digest root{};          // Merkle root of the records since the previous checkpoint
+        Digest hash{};          // hash of the checkpoint line itself
+        bool sealed = false;
+    };
+
+    // Position in the record stream plus the leaves awaiting the next checkpoint
+    struct Cursor {
+        uint64_t offset = 0;
+        uint64_t seq = 0;
+        Digest head{};
+        std::vector<Digest> leaves;
+        size_t nextCheckpoint = 0;
+    };
+
+    Config config_;
+    mutable std::mutex mutex_;
+    std::string log_path_;
+    std::string checkpoint_path_;
+    std::ofstream log_;
+    std::vector<Checkpoint> checkpoints_;
+    Digest previous_segment_hash_{};
+    uint64_t anchor_floor_ = 0;   // no chained record ends at or before this offset
+    Cursor head_;
+    Cursor verified_;
+    std::string last_error_;
+
+    Cursor cursorAtCheckpoint(size_t index) const {
+        Cursor cursor;
+        cursor.offset = checkpoints_[index].offset;
+        cursor.seq = checkpoints_[index].seq;
+        cursor.head = checkpoints_[index].chain;
+        cursor.nextCheckpoint = index + 1;
+        return cursor;
+    }
+
+    VerifyResult verifyIncrementalLocked() {
+        VerifyResult result;
+        try {
+            Cursor cursor = verified_;
+            bool tornTail = false;
+            if (!checkAnchor(cursor, result) || !scan(cursor, result, tornTail) || !checkHead(cursor, result)) {
+                last_error_ = result.error;
+                return result;
+            }
+            verified_ = std::move(cursor);
+            result.valid = true;
+        } catch (const std::exception& e) {
+            result.error = "Verification failed: " + std::string(e.what());
+            last_error_ = result.error;
+        }
+        return result;
+    }
+
+    bool checkHead(const Cursor& cursor, VerifyResult& result) const {
+        if (cursor.seq != head_.seq || cursor.offset != head_.offset) {
+            result.error = cursor.seq < head_.seq ? "Security log is missing records"
+                                                  : "Security log contains unexpected records";
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Re-hash the record ending at cursor.offset. Catches rewrites of the last
+     * verified record without re-reading everything before it.
+     */
+    bool checkAnchor(const Cursor& cursor, VerifyResult& result) const {
+        if (cursor.offset <= anchor_floor_) {
+            return true;
+        }
+
+        std::ifstream file(log_path_, std::ios::binary);
+        if (!file) {
+            result.error = "Security log is missing";
+            return false;
+        }
+
+        std::string buffer;
+        size_t window = 4096;
+        for (;;) {
+            uint64_t start = cursor.offset > window ? cursor.offset - window : 0;
+            buffer.resize(static_cast<size_t>(cursor.offset - start));
+            file.seekg(static_cast<std::streamoff>(start));
+            if (!file.read(&buffer[0], static_cast<std::streamsize>(buffer.size()))) {
+                result.error = "Security log is shorter than its verified length";
+                return false;
+            }
+            result.bytesRead += buffer.size();
+
+            if (buffer.empty() || buffer.back() != '\n') {
+                result.error = "Record boundary mismatch at verified offset";
+                return false;
+            }
+            size_t newline = buffer.size() > 1 ? buffer.rfind('\n', buffer.size() - 2) : std::string::npos;
+            if (newline != std::string::npos || start == 0) {
+                size_t begin = newline == std::string::npos ? 0 : newline + 1;
+                std::string line = buffer.substr(begin, buffer.size() - begin - 1);
+                std::string body;
+                Digest recorded;
+                if (!splitLine(line, body, recorded) || recorded != cursor.head ||
+                    sha256(body.data(), body.size()) != recorded) {
+                    result.error = "Last verified record has been modified";
+                    return false;
+                }
+                return true;
+            }
+            window *= 2;
+        }
+    }
+
+    bool scan(Cursor& cursor, VerifyResult& result, bool& tornTail) const {
+        return scanAgainst(checkpoints_, cursor, result, tornTail);
+    }
+
+    /**
+     * Verify records from cursor.offset to the end of the segment, checking
+     * each checkpoint as its record is reached. On failure cursor is left at
+     * the last good record.
+     */
+    bool scanAgainst(const std::vector<Checkpoint>& checkpoints, Cursor& cursor,
+                     VerifyResult& result, bool& tornTail) const {
+        tornTail = false;
+        std::ifstream file(log_path_, std::ios::binary);
+        if (!file) {
+            if (cursor.offset == 0 && checkpoints.size() <= cursor.nextCheckpoint) {
+                return true;
+            }
+            result.error = "Security log is missing";
+            return false;
+        }
+
+        file.seekg(static_cast<std::streamoff>(cursor.offset));
+
+        if (!matchCheckpoints(checkpoints, cursor, result)) {
+            return false;
+        }
+
+        std::string line;
+        std::string body;
+        while (std::getline(file, line)) {
+            if (file.eof()) {
+                tornTail = true;
+                result.error = "Partial record at end of security log";
+                return false;
+            }
+            result.bytesRead += line.size() + 1;
+
+            Digest recorded;
+            Digest prev;
+            uint64_t seq = 0;
+            if (!splitLine(line, body, recorded) || !parseRecordHeader(body, seq, prev)) {
+                result.error = "Malformed record after #" + std::to_string(cursor.seq);
+                return false;
+            }
+            if (seq != cursor.seq + 1 || prev != cursor.head) {
+                result.error = "Chain broken at record #" + std::to_string(seq);
+                return false;
+            }
+            if (sha256(body.data(), body.size()) != recorded) {
+                result.error = "Record #" + std::to_string(seq) + " has been modified";
+                return false;
+            }
+
+            cursor.seq = seq;
+            cursor.head = recorded;
+            cursor.offset += line.size() + 1;
+            cursor.leaves.push_back(recorded);
+            result.recordsVerified++;
+
+            if (!matchCheckpoints(checkpoints, cursor, result)) {
+                return false;
+            }
+        }
+
+        if (cursor.nextCheckpoint < checkpoints.size()) {
+            result.error = "Security log ends before checkpoint #" + std::to_string(checkpoints[cursor.nextCheckpoint].seq);
+            return false;
+        }
+        return true;
+    }
+
+    bool matchCheckpoints(const std::vector<Checkpoint>& checkpoints, Cursor& cursor, VerifyResult& result) const {
+        while (cursor.nextCheckpoint < checkpoints.size() &&
+               checkpoints[cursor.nextCheckpoint].seq <= cursor.seq) {
+            const Checkpoint& checkpoint = checkpoints[cursor.nextCheckpoint];
+            if (checkpoint.seq != cursor.seq || checkpoint.offset != cursor.offset ||
+                checkpoint.chain != cursor.head || checkpoint.root != merkleRoot(cursor.leaves)) {
+                result.error = "Checkpoint mismatch at record #" + std::to_string(checkpoint.seq);
+                return false;
+            }
+            cursor.leaves.clear();
+            cursor.nextCheckpoint++;
+        }
+        return true;
+    }
+
+    bool writeCheckpoint(bool sealed) {
+        try {
+            // Never let a checkpoint reference records that are still buffered
+            if (log_.is_open()) {
+                log_.flush();
+            }
+
+            Checkpoint checkpoint;
+            checkpoint.seq = head_.seq;
+            checkpoint.offset = head_.offset;
+            checkpoint.chain = head_.head;
+            checkpoint.root = merkleRoot(head_.leaves);
+            checkpoint.sealed = sealed;
+
+            const Digest& prev = checkpoints_.empty() ? previous_segment_hash_ : checkpoints_.back().hash;
+            json body = {
+                {"seq", checkpoint.seq},
+                {"offset", checkpoint.offset},
+                {"chain", toHex(checkpoint.chain)},
+                {"root", toHex(checkpoint.root)},
+                {"prev", toHex(prev)},
+                {"sealed", sealed}
+            };
+            std::string line = sealLine(body.dump(), checkpoint.hash);
+
+            std::ofstream out(checkpoint_path_, std::ios::app | std::ios::binary);
+            out << line << '\n';
+            out.flush();
+            if (!out) {
+                last_error_ = "Failed to write checkpoint: " + checkpoint_path_;
+                return false;
+            }
+
+            checkpoints_.push_back(checkpoint);
+            head_.leaves.clear();
+            head_.nextCheckpoint = checkpoints_.size();
+            return true;
+
+        } catch (const std::exception& e) {
+            last_error_ = "Failed to write checkpoint: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    static bool loadCheckpoints(const std::string& path, std::vector<Checkpoint>& out, std::string& error) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            error = "Checkpoint file is missing: " + path;
+            return false;
+        }
+
+        std::string line;
+        std::string body;
+        while (std::getline(file, line)) {
+            if (file.eof()) {
+                error = "Partial checkpoint at end of " + path;
+                return false;
+            }
+
+            Checkpoint checkpoint;
+            if (!splitLine(line, body, checkpoint.hash) ||
+                sha256(body.data(), body.size()) != checkpoint.hash) {
+                error = "Checkpoint " + std::to_string(out.size()) + " has been modified";
+                return false;
+            }
+
+            json parsed = json::parse(body, nullptr, false);
+            Digest prev;
+            if (parsed.is_discarded() ||
+                !fromHex(parsed.value("chain", std::string()), checkpoint.chain) ||
+                !fromHex(parsed.value("root", std::string()), checkpoint.root) ||
+                !fromHex(parsed.value("prev", std::string()), prev)) {
+                error = "Malformed checkpoint " + std::to_string(out.size());
+                return false;
+            }
+            checkpoint.seq = parsed.value("seq", uint64_t(0));
+            checkpoint.offset = parsed.value("offset", uint64_t(0));
+            checkpoint.sealed = parsed.value("sealed", false);
+
+            // The first checkpoint links to the previous segment, which lives elsewhere
+            if (!out.empty() && (prev != out.back().hash || checkpoint.seq < out.back().seq ||
+                                 checkpoint.offset < out.back().offset)) {
+                error = "Checkpoint chain broken at checkpoint " + std::to_string(out.size());
+                return false;
+            }
+            out.push_back(checkpoint);
+        }
+        return true;
+    }
+
+    bool compressFile(const std::string& source, const std::string& destination) {
+        std::ifstream in(source, std::ios::binary);
+        std::string partial = destination + ".partial";
+        std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+        if (!in || !out) {
+            last_error_ = "Failed to open files for segment compression";
+            return false;
+        }
+
+        ZSTD_CCtx* context = ZSTD_createCCtx();
+        if (!context) {
+            last_error_ = "Failed to create zstd context";
+            return false;
+        }
+        ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, config_.compressionLevel);
+
+        std::vector<char> input(ZSTD_CStreamInSize());
+        std::vector<char> output(ZSTD_CStreamOutSize());
+        bool ok = true;
+
+        for (;;) {
+            in.read(input.data(), static_cast<std::streamsize>(input.size()));
+            size_t got = static_cast<size_t>(in.gcount());
+            bool last = got < input.size();
+            ZSTD_EndDirective mode = last ? ZSTD_e_end : ZSTD_e_continue;
+            ZSTD_inBuffer inBuffer = {input.data(), got, 0};
+
+            bool finished = false;
+            while (!finished) {
+                ZSTD_outBuffer outBuffer = {output.data(), output.size(), 0};
+                size_t remaining = ZSTD_compressStream2(context, &outBuffer, &inBuffer, mode);
+                if (ZSTD_isError(remaining)) {
+                    last_error_ = "Segment compression failed: " + std::string(ZSTD_getErrorName(remaining));
+                    ok = false;
+                    break;
+                }
+                out.write(output.data(), static_cast<std::streamsize>(outBuffer.pos));
+                finished = last ? remaining == 0 : inBuffer.pos == inBuffer.size;
+            }
+
+            if (!ok || last) {
+                break;
+            }
+        }
+
+        ZSTD_freeCCtx(context);
+        out.close();
+
+        if (!ok || !out) {
+            fs::remove(partial);
+            if (ok) {
+                last_error_ = "Failed to write compressed segment: " + destination;
+            }
+            return false;
+        }
+
+        fs::rename(partial, destination);
+        return true;
+    }
+};
+
+AuditChain::AuditChain() : pimpl(std::make_unique<Implementation>(Config{})) {}
+AuditChain::AuditChain(const Config& config) : pimpl(std::make_unique<Implementation>(config)) {}
+AuditChain::~AuditChain() = default;
+
+bool AuditChain::open(const std::string& logPath) {
+    return pimpl->open(logPath);
+}
+
+void AuditChain::close() {
+    pimpl->close();
+}
+
+bool AuditChain::append(const std::vector<std::string>& records) {
+    return pimpl->append(records);
+}
+
+AuditChain::VerifyResult AuditChain::verifyIncremental() {
+    return pimpl->verifyIncremental();
+}
+
+AuditChain::VerifyResult AuditChain::verifyFull() const {
+    return pimpl->verifyFull();
+}
+
+std::string AuditChain::sealAndRotate() {
+    return pimpl->sealAndRotate();
+}
+
+uint64_t AuditChain::getRecordCount() const {
+    return pimpl->getRecordCount();
+}
+
+uint64_t AuditChain::getSegmentSize() const {
+    return pimpl->getSegmentSize();
+}
+
+std::string AuditChain::getHeadHash() const {
+    return pimpl->getHeadHash();
+}
+
+std::string AuditChain::getLastError() const {
+    return pimpl->getLastError();
+}
+
+} // namespace phantomvault
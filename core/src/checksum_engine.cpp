@@ -0,0 +1,802 @@
+/**
+ * PhantomVault Checksum Engine Implementation
+ *
+ * BLAKE3 follows the reference tree layout: 1 KiB chunks hashed into chaining
+ * values, merged pairwise by parent nodes, with the root finalized last. The
+ * hasher feeds whole power-of-two subtrees to hashMany(), which compresses
+ * eight chunks (or parent nodes) per AVX2 instruction stream, and splits
+ * subtrees across threads once they are large enough to pay for it.
+ */
+
+#include "checksum_engine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <thread>
+#include <openssl/evp.h>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PHANTOMVAULT_BLAKE3_AVX2 1
+#endif
+
+namespace phantomvault {
+
+namespace {
+
+constexpr size_t kMaxThreads = 8;
+constexpr size_t kDigestSize = 32;
+constexpr size_t kReadBufferSize = 1024 * 1024;
+constexpr uint64_t kMapThreshold = 4 * 1024 * 1024;     // BLAKE3 maps files this large and hashes them in one pass
+constexpr size_t kParallelSubtree = 512 * 1024;         // smallest subtree worth handing to another thread
+
+std::string toHex(const std::vector<uint8_t>& digest) {
+    static const char kDigits[] = "0123456789abcdef";
+    std::string hex(digest.size() * 2, '0');
+    for (size_t i = 0; i < digest.size(); ++i) {
+        hex[2 * i] = kDigits[digest[i] >> 4];
+        hex[2 * i + 1] = kDigits[digest[i] & 0x0f];
+    }
+    return hex;
+}
+
+size_t resolveThreads(size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    return std::min(threads, kMaxThreads);
+}
+
+// ---------------------------------------------------------------------------
+// BLAKE3
+// ---------------------------------------------------------------------------
+
+constexpr size_t kBlockLen = 64;
+constexpr size_t kChunkLen = 1024;
+constexpr size_t kLeafChunks = 64;      // chunks hashed in one batch before recursing
+
+constexpr uint8_t kChunkStart = 1 << 0;
+constexpr uint8_t kChunkEnd = 1 << 1;
+constexpr uint8_t kParent = 1 << 2;
+constexpr uint8_t kRoot = 1 << 3;
+
+constexpr uint32_t kIV[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+constexpr uint8_t kPermutation[16] = {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8};
+
+// Message word order for each of the seven rounds
+struct MessageSchedule {
+    uint8_t round[7][16];
+};
+
+constexpr MessageSchedule makeSchedule() {
+    MessageSchedule schedule{};
+    for (uint8_t i = 0; i < 16; ++i) {
+        schedule.round[0][i] = i;
+    }
+    for (size_t r = 1; r < 7; ++r) {
+        for (size_t i = 0; i < 16; ++i) {
+            schedule.round[r][i] = schedule.round[r - 1][kPermutation[i]];
+        }
+    }
+    return schedule;
+}
+
+constexpr MessageSchedule kSchedule = makeSchedule();
+
+using ChainingValue = std::array<uint8_t, 32>;
+
+inline uint32_t load32(const uint8_t* bytes) {
+    return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+           (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+inline void store32(uint8_t* bytes, uint32_t word) {
+    bytes[0] = static_cast<uint8_t>(word);
+    bytes[1] = static_cast<uint8_t>(word >> 8);
+    bytes[2] = static_cast<uint8_t>(word >> 16);
+    bytes[3] = static_cast<uint8_t>(word >> 24);
+}
+
+inline uint32_t rotr(uint32_t word, int count) {
+    return (word >> count) | (word << (32 - count));
+}
+
+inline void g(uint32_t* v, size_t a, size_t b, size_t c, size_t d, uint32_t x, uint32_t y) {
+    v[a] = v[a] + v[b] + x;
+    v[d] = rotr(v[d] ^ v[a], 16);
+    v[c] = v[c] + v[d];
+    v[b] = rotr(v[b] ^ v[c], 12);
+    v[a] = v[a] + v[b] + y;
+    v[d] = rotr(v[d] ^ v[a], 8);
+    v[c] = v[c] + v[d];
+    v[b] = rotr(v[b] ^ v[c], 7);
+}
+
+// Compress one block into cv, keeping the first half of the output
+void compressInPlace(uint32_t cv[8], const uint8_t block[kBlockLen], uint8_t blockLen, uint64_t counter, uint8_t flags) {
+    uint32_t m[16];
+    for (size_t i = 0; i < 16; ++i) {
+        m[i] = load32(block + 4 * i);
+    }
+    uint32_t v[16] = {
+        cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+        kIV[0], kIV[1], kIV[2], kIV[3],
+        static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), blockLen, flags
+    };
+    for (const auto& s : kSchedule.round) {
+        g(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+        g(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+        g(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+        g(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+        g(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+        g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        g(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+        g(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+    for (size_t i = 0; i < 8; ++i) {
+        cv[i] = v[i] ^ v[i + 8];
+    }
+}
+
+void hashOne(const uint8_t* input, size_t blocks, uint64_t counter, uint8_t flags,
+             uint8_t flagsStart, uint8_t flagsEnd, uint8_t* out) {
+    uint32_t cv[8];
+    std::memcpy(cv, kIV, sizeof(cv));
+    uint8_t blockFlags = flags | flagsStart;
+    for (size_t b = 0; b < blocks; ++b) {
+        if (b + 1 == blocks) {
+            blockFlags |= flagsEnd;
+        }
+        compressInPlace(cv, input + b * kBlockLen, kBlockLen, counter, blockFlags);
+        blockFlags = flags;
+    }
+    for (size_t i = 0; i < 8; ++i) {
+        store32(out + 4 * i, cv[i]);
+    }
+}
+
+#ifdef PHANTOMVAULT_BLAKE3_AVX2
+
+#define PV_AVX2 __attribute__((target("avx2")))
+
+PV_AVX2 inline __m256i add(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+PV_AVX2 inline __m256i xorv(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+
+PV_AVX2 inline __m256i rot16(__m256i x) {
+    return _mm256_shuffle_epi8(x, _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+                                                  13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2));
+}
+
+PV_AVX2 inline __m256i rot12(__m256i x) {
+    return _mm256_or_si256(_mm256_srli_epi32(x, 12), _mm256_slli_epi32(x, 20));
+}
+
+PV_AVX2 inline __m256i rot8(__m256i x) {
+    return _mm256_shuffle_epi8(x, _mm256_set_epi8(12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1,
+                                                  12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1));
+}
+
+PV_AVX2 inline __m256i rot7(__m256i x) {
+    return _mm256_or_si256(_mm256_srli_epi32(x, 7), _mm256_slli_epi32(x, 25));
+}
+
+PV_AVX2 inline void g8(__m256i* v, size_t a, size_t b, size_t c, size_t d, __m256i x, __m256i y) {
+    v[a] = add(add(v[a], v[b]), x);
+    v[d] = rot16(xorv(v[d], v[a]));
+    v[c] = add(v[c], v[d]);
+    v[b] = rot12(xorv(v[b], v[c]));
+    v[a] = add(add(v[a], v[b]), y);
+    v[d] = rot8(xorv(v[d], v[a]));
+    v[c] = add(v[c], v[d]);
+    v[b] = rot7(xorv(v[b], v[c]));
+}
+
+// 8x8 transpose of 32-bit words: row i becomes column i
+PV_AVX2 inline void transpose8(__m256i* rows) {
+    __m256i ab_0145 = _mm256_unpacklo_epi32(rows[0], rows[1]);
+    __m256i ab_2367 = _mm256_unpackhi_epi32(rows[0], rows[1]);
+    __m256i cd_0145 = _mm256_unpacklo_epi32(rows[2], rows[3]);
+    __m256i cd_2367 = _mm256_unpackhi_epi32(rows[2], rows[3]);
+    __m256i ef_0145 = _mm256_unpacklo_epi32(rows[4], rows[5]);
+    __m256i ef_2367 = _mm256_unpackhi_epi32(rows[4], rows[5]);
+    __m256i gh_0145 = _mm256_unpacklo_epi32(rows[6], rows[7]);
+    __m256i gh_2367 = _mm256_unpackhi_epi32(rows[6], rows[7]);
+
+    __m256i abcd_04 = _mm256_unpacklo_epi64(ab_0145, cd_0145);
+    __m256i abcd_15 = _mm256_unpackhi_epi64(ab_0145, cd_0145);
+    __m256i abcd_26 = _mm256_unpacklo_epi64(ab_2367, cd_2367);
+    __m256i abcd_37 = _mm256_unpackhi_epi64(ab_2367, cd_2367);
+    __m256i efgh_04 = _mm256_unpacklo_epi64(ef_0145, gh_0145);
+    __m256i efgh_15 = _mm256_unpackhi_epi64(ef_0145, gh_0145);
+    __m256i efgh_26 = _mm256_unpacklo_epi64(ef_2367, gh_2367);
+    __m256i efgh_37 = _mm256_unpackhi_epi64(ef_2367, gh_2367);
+
+    rows[0] = _mm256_permute2x128_si256(abcd_04, efgh_04, 0x20);
+    rows[1] = _mm256_permute2x128_si256(abcd_15, efgh_15, 0x20);
+    rows[2] = _mm256_permute2x128_si256(abcd_26, efgh_26, 0x20);
+    rows[3] = _mm256_permute2x128_si256(abcd_37, efgh_37, 0x20);
+    rows[4] = _mm256_permute2x128_si256(abcd_04, efgh_04, 0x31);
+    rows[5] = _mm256_permute2x128_si256(abcd_15, efgh_15, 0x31);
+    rows[6] = _mm256_permute2x128_si256(abcd_26, efgh_26, 0x31);
+    rows[7] = _mm256_permute2x128_si256(abcd_37, efgh_37, 0x31);
+}
+
+// Eight inputs of the same length at once, one per 32-bit lane
+PV_AVX2 void hashEight(const uint8_t* const* inputs, size_t blocks, uint64_t counter, bool incrementCounter,
+                       uint8_t flags, uint8_t flagsStart, uint8_t flagsEnd, uint8_t* out) {
+    __m256i h[8];
+    for (size_t i = 0; i < 8; ++i) {
+        h[i] = _mm256_set1_epi32(static_cast<int>(kIV[i]));
+    }
+
+    alignas(32) uint32_t counterLow[8];
+    alignas(32) uint32_t counterHigh[8];
+    for (size_t lane = 0; lane < 8; ++lane) {
+        uint64_t laneCounter = counter + (incrementCounter ? lane : 0);
+        counterLow[lane] = static_cast<uint32_t>(laneCounter);
+        counterHigh[lane] = static_cast<uint32_t>(laneCounter >> 32);
+    }
+    const __m256i low = _mm256_load_si256(reinterpret_cast<const __m256i*>(counterLow));
+    const __m256i high = _mm256_load_si256(reinterpret_cast<const __m256i*>(counterHigh));
+
+    uint8_t blockFlags = flags | flagsStart;
+    for (size_t b = 0; b < blocks; ++b) {
+        if (b + 1 == blocks) {
+            blockFlags |= flagsEnd;
+        }
+
+        __m256i m[16];
+        size_t offset = b * kBlockLen;
+        for (size_t lane = 0; lane < 8; ++lane) {
+            m[lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inputs[lane] + offset));
+            m[lane + 8] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inputs[lane] + offset + 32));
+        }
+        transpose8(m);
+        transpose8(m + 8);
+
+        __m256i v[16] = {
+            h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7],
+            _mm256_set1_epi32(static_cast<int>(kIV[0])), _mm256_set1_epi32(static_cast<int>(kIV[1])),
+            _mm256_set1_epi32(static_cast<int>(kIV[2])), _mm256_set1_epi32(static_cast<int>(kIV[3])),
+            low, high, _mm256_set1_epi32(static_cast<int>(kBlockLen)), _mm256_set1_epi32(blockFlags)
+        };
+        for (const auto& s : kSchedule.round) {
+            g8(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            g8(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            g8(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            g8(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            g8(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            g8(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            g8(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            g8(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+        for (size_t i = 0; i < 8; ++i) {
+            h[i] = xorv(v[i], v[i + 8]);
+        }
+        blockFlags = flags;
+    }
+
+    transpose8(h);
+    for (size_t lane = 0; lane < 8; ++lane) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + lane * 32), h[lane]);
+    }
+}
+
+#undef PV_AVX2
+
+bool detectAvx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif
+
+bool useAvx2() {
+#ifdef PHANTOMVAULT_BLAKE3_AVX2
+    static const bool available = detectAvx2();
+    return available;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Hash count inputs of blocks * 64 bytes each into 32-byte chaining values.
+ * Chunks pass CHUNK_START/CHUNK_END and consecutive counters; parent nodes
+ * pass one block, PARENT and a zero counter.
+ */
+void hashMany(const uint8_t* const* inputs, size_t count, size_t blocks, uint64_t counter, bool incrementCounter,
+              uint8_t flags, uint8_t flagsStart, uint8_t flagsEnd, uint8_t* out) {
+#ifdef PHANTOMVAULT_BLAKE3_AVX2
+    if (useAvx2()) {
+        while (count >= 8) {
+            hashEight(inputs, blocks, counter, incrementCounter, flags, flagsStart, flagsEnd, out);
+            inputs += 8;
+            count -= 8;
+            counter += incrementCounter ? 8 : 0;
+            out += 8 * 32;
+        }
+    }
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        hashOne(inputs[i], blocks, counter, flags, flagsStart, flagsEnd, out + i * 32);
+        counter += incrementCounter ? 1 : 0;
+    }
+}
+
+// A node whose chaining value or root digest has not been taken yet
+struct Output {
+    uint32_t cv[8];
+    uint8_t block[kBlockLen];
+    uint8_t blockLen;
+    uint64_t counter;
+    uint8_t flags;
+
+    ChainingValue chainingValue() const {
+        uint32_t words[8];
+        std::memcpy(words, cv, sizeof(words));
+        compressInPlace(words, block, blockLen, counter, flags);
+        ChainingValue out;
+        for (size_t i = 0; i < 8; ++i) {
+            store32(out.data() + 4 * i, words[i]);
+        }
+        return out;
+    }
+
+    std::vector<uint8_t> rootDigest() const {
+        uint32_t words[8];
+        std::memcpy(words, cv, sizeof(words));
+        compressInPlace(words, block, blockLen, 0, flags | kRoot);
+        std::vector<uint8_t> out(kDigestSize);
+        for (size_t i = 0; i < 8; ++i) {
+            store32(out.data() + 4 * i, words[i]);
+        }
+        return out;
+    }
+};
+
+Output parentOutput(const ChainingValue& left, const ChainingValue& right) {
+    Output output;
+    std::memcpy(output.cv, kIV, sizeof(output.cv));
+    std::memcpy(output.block, left.data(), 32);
+    std::memcpy(output.block + 32, right.data(), 32);
+    output.blockLen = kBlockLen;
+    output.counter = 0;
+    output.flags = kParent;
+    return output;
+}
+
+class ChunkState {
+public:
+    void reset(uint64_t counter) {
+        std::memcpy(cv_, kIV, sizeof(cv_));
+        std::memset(block_, 0, sizeof(block_));
+        counter_ = counter;
+        blockLen_ = 0;
+        blocksCompressed_ = 0;
+    }
+
+    size_t length() const { return blocksCompressed_ * kBlockLen + blockLen_; }
+    uint64_t counter() const { return counter_; }
+
+    void update(const uint8_t* input, size_t size) {
+        while (size > 0) {
+            if (blockLen_ == kBlockLen) {
+                compressInPlace(cv_, block_, kBlockLen, counter_, startFlag());
+                ++blocksCompressed_;
+                blockLen_ = 0;
+                std::memset(block_, 0, sizeof(block_));
+            }
+            size_t take = std::min(kBlockLen - blockLen_, size);
+            std::memcpy(block_ + blockLen_, input, take);
+            blockLen_ += static_cast<uint8_t>(take);
+            input += take;
+            size -= take;
+        }
+    }
+
+    Output output() const {
+        Output output;
+        std::memcpy(output.cv, cv_, sizeof(output.cv));
+        std::memcpy(output.block, block_, sizeof(output.block));
+        output.blockLen = blockLen_;
+        output.counter = counter_;
+        output.flags = startFlag() | kChunkEnd;
+        return output;
+    }
+
+private:
+    uint32_t cv_[8];
+    uint8_t block_[kBlockLen];
+    uint64_t counter_ = 0;
+    uint8_t blockLen_ = 0;
+    uint8_t blocksCompressed_ = 0;
+
+    uint8_t startFlag() const { return blocksCompressed_ == 0 ? kChunkStart : 0; }
+};
+
+void subtreeChildren(const uint8_t* input, size_t length, uint64_t counter, size_t threads, uint8_t* children);
+
+// Chaining value of a complete subtree of 2^k chunks, k >= 0, that is not the root
+void subtreeCv(const uint8_t* input, size_t length, uint64_t counter, size_t threads, uint8_t* out) {
+    if (length > kLeafChunks * kChunkLen) {
+        uint8_t children[kBlockLen];
+        subtreeChildren(input, length, counter, threads, children);
+        const uint8_t* parent = children;
+        hashMany(&parent, 1, 1, 0, false, kParent, 0, 0, out);
+        return;
+    }
+
+    // Every chunk of the leaf in one batch, then each level of parents in place:
+    // parent i reads bytes [64i, 64i + 64) and writes [32i, 32i + 32)
+    size_t count = length / kChunkLen;
+    uint8_t cvs[kLeafChunks * 32];
+    const uint8_t* inputs[kLeafChunks] = {};
+    for (size_t i = 0; i < count; ++i) {
+        inputs[i] = input + i * kChunkLen;
+    }
+    hashMany(inputs, count, kChunkLen / kBlockLen, counter, true, 0, kChunkStart, kChunkEnd, cvs);
+    while (count > 1) {
+        count /= 2;
+        for (size_t i = 0; i < count; ++i) {
+            inputs[i] = cvs + i * kBlockLen;
+        }
+        hashMany(inputs, count, 1, 0, false, kParent, 0, 0, cvs);
+    }
+    std::memcpy(out, cvs, 32);
+}
+
+// Chaining values of the two halves of a subtree of at least two chunks
+void subtreeChildren(const uint8_t* input, size_t length, uint64_t counter, size_t threads, uint8_t* children) {
+    size_t half = length / 2;
+    uint64_t rightCounter = counter + half / kChunkLen;
+    if (threads > 1 && half >= kParallelSubtree) {
+        size_t leftThreads = threads / 2;
+        auto left = std::async(std::launch::async, [&] {
+            subtreeCv(input, half, counter, leftThreads, children);
+        });
+        subtreeCv(input + half, half, rightCounter, threads - leftThreads, children + 32);
+        left.get();
+    } else {
+        subtreeCv(input, half, counter, 1, children);
+        subtreeCv(input + half, half, rightCounter, 1, children + 32);
+    }
+}
+
+class Blake3Hasher : public Hasher {
+public:
+    explicit Blake3Hasher(size_t threads = 1) : threads_(std::max<size_t>(1, threads)) {
+        chunk_.reset(0);
+    }
+
+    void update(const void* data, size_t size) override {
+        const uint8_t* input = static_cast<const uint8_t*>(data);
+
+        // Finish a partial chunk first; it is not the last one if more input follows
+        if (chunk_.length() > 0) {
+            size_t take = std::min(kChunkLen - chunk_.length(), size);
+            chunk_.update(input, take);
+            input += take;
+            size -= take;
+            if (size == 0) {
+                return;
+            }
+            pushCv(chunk_.output().chainingValue(), chunk_.counter());
+            chunk_.reset(chunk_.counter() + 1);
+        }
+
+        // Whole subtrees: a power of two chunks, aligned to the chunks already hashed,
+        // and never the final chunk, which may turn out to be the root
+        while (size > kChunkLen) {
+            size_t subtreeLen = size_t(1) << (63 - __builtin_clzll(static_cast<unsigned long long>(size)));
+            uint64_t bytesSoFar = chunk_.counter() * kChunkLen;
+            while (((subtreeLen - 1) & bytesSoFar) != 0) {
+                subtreeLen /= 2;
+            }
+            uint64_t subtreeChunks = subtreeLen / kChunkLen;
+
+            if (subtreeLen == kChunkLen) {
+                ChainingValue cv;
+                hashMany(&input, 1, kChunkLen / kBlockLen, chunk_.counter(), true, 0, kChunkStart, kChunkEnd, cv.data());
+                pushCv(cv, chunk_.counter());
+            } else {
+                // Kept as two children in case this subtree is the whole message
+                uint8_t children[kBlockLen];
+                subtreeChildren(input, subtreeLen, chunk_.counter(), threads_, children);
+                ChainingValue left;
+                ChainingValue right;
+                std::memcpy(left.data(), children, 32);
+                std::memcpy(right.data(), children + 32, 32);
+                pushCv(left, chunk_.counter());
+                pushCv(right, chunk_.counter() + subtreeChunks / 2);
+            }
+            chunk_.reset(chunk_.counter() + subtreeChunks);
+            input += subtreeLen;
+            size -= subtreeLen;
+        }
+
+        if (size > 0) {
+            chunk_.update(input, size);
+            mergeStack(chunk_.counter());
+        }
+    }
+
+    std::vector<uint8_t> finish() override {
+        if (stack_.empty()) {
+            return chunk_.output().rootDigest();
+        }
+
+        Output output;
+        size_t remaining = stack_.size();
+        if (chunk_.length() > 0) {
+            output = chunk_.output();
+        } else {
+            output = parentOutput(stack_[remaining - 2], stack_[remaining - 1]);
+            remaining -= 2;
+        }
+        while (remaining > 0) {
+            output = parentOutput(stack_[remaining - 1], output.chainingValue());
+            --remaining;
+        }
+        return output.rootDigest();
+    }
+
+private:
+    ChunkState chunk_;
+    std::vector<ChainingValue> stack_;
+    size_t threads_;
+
+    // Collapse completed subtrees; one entry remains per set bit of the chunk count
+    void mergeStack(uint64_t totalChunks) {
+        size_t target = static_cast<size_t>(__builtin_popcountll(totalChunks));
+        while (stack_.size() > target) {
+            ChainingValue right = stack_.back();
+            stack_.pop_back();
+            ChainingValue left = stack_.back();
+            stack_.pop_back();
+            stack_.push_back(parentOutput(left, right).chainingValue());
+        }
+    }
+
+    void pushCv(const ChainingValue& cv, uint64_t counter) {
+        mergeStack(counter);
+        stack_.push_back(cv);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// SHA-256 through OpenSSL
+// ---------------------------------------------------------------------------
+
+class Sha256Hasher : public Hasher {
+public:
+    Sha256Hasher() : context_(EVP_MD_CTX_new()) {
+        EVP_DigestInit_ex(context_, EVP_sha256(), nullptr);
+    }
+
+    ~Sha256Hasher() override { EVP_MD_CTX_free(context_); }
+
+    Sha256Hasher(const Sha256Hasher&) = delete;
+    Sha256Hasher& operator=(const Sha256Hasher&) = delete;
+
+    void update(const void* data, size_t size) override {
+        EVP_DigestUpdate(context_, data, size);
+    }
+
+    std::vector<uint8_t> finish() override {
+        std::vector<uint8_t> digest(kDigestSize);
+        unsigned int length = 0;
+        EVP_DigestFinal_ex(context_, digest.data(), &length);
+        return digest;
+    }
+
+private:
+    EVP_MD_CTX* context_;
+};
+
+std::unique_ptr<Hasher> makeHasher(ChecksumAlgorithm algorithm, size_t threads) {
+    if (algorithm == ChecksumAlgorithm::SHA256) {
+        return std::make_unique<Sha256Hasher>();
+    }
+    return std::make_unique<Blake3Hasher>(threads);
+}
+
+} // namespace
+
+const char* checksumAlgorithmName(ChecksumAlgorithm algorithm) {
+    switch (algorithm) {
+        case ChecksumAlgorithm::SHA256: return "sha256";
+        case ChecksumAlgorithm::BLAKE3: return "blake3";
+    }
+    return "unknown";
+}
+
+std::optional<ChecksumAlgorithm> parseChecksumAlgorithm(const std::string& name) {
+    if (name == "sha256") {
+        return ChecksumAlgorithm::SHA256;
+    }
+    if (name == "blake3") {
+        return ChecksumAlgorithm::BLAKE3;
+    }
+    return std::nullopt;
+}
+
+class ChecksumEngine::Implementation {
+public:
+    explicit Implementation(size_t threads) : threads_(resolveThreads(threads)) {}
+
+    std::string hashBuffer(const void* data, size_t size, ChecksumAlgorithm algorithm) const {
+        auto hasher = makeHasher(algorithm, threads_);
+        hasher->update(data, size);
+        return toHex(hasher->finish());
+    }
+
+    std::string hashFile(const std::string& path, ChecksumAlgorithm algorithm) const {
+        std::string error;
+        std::string digest = hashPath(path, algorithm, threads_, error);
+        if (digest.empty()) {
+            last_error_ = error;
+        }
+        return digest;
+    }
+
+    std::vector<std::string> hashFiles(const std::vector<std::string>& paths, ChecksumAlgorithm algorithm) const {
+        std::vector<std::string> digests(paths.size());
+        if (paths.size() == 1) {
+            digests[0] = hashFile(paths[0], algorithm);
+            return digests;
+        }
+
+        // Whole files per worker: for many small files, one sequential stream each
+        std::vector<std::string> errors(paths.size());
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t i = next++; i < paths.size(); i = next++) {
+                digests[i] = hashPath(paths[i], algorithm, 1, errors[i]);
+            }
+        };
+
+        size_t threads = std::min(threads_, paths.size());
+        if (threads <= 1) {
+            worker();
+        } else {
+            std::vector<std::thread> pool;
+            pool.reserve(threads);
+            for (size_t i = 0; i < threads; ++i) {
+                pool.emplace_back(worker);
+            }
+            for (auto& thread : pool) {
+                thread.join();
+            }
+        }
+
+        for (const auto& error : errors) {
+            if (!error.empty()) {
+                last_error_ = error;
+                break;
+            }
+        }
+        return digests;
+    }
+
+    std::string getLastError() const {
+        return last_error_;
+    }
+
+private:
+    size_t threads_;
+    mutable std::string last_error_;
+
+    static std::string hashPath(const std::string& path, ChecksumAlgorithm algorithm, size_t threads, std::string& error) {
+        thread_local std::vector<uint8_t> buffer(kReadBufferSize);
+        auto hasher = makeHasher(algorithm, threads);
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            error = "Failed to open file for checksum: " + path;
+            return "";
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            error = "Failed to stat file for checksum: " + path;
+            return "";
+        }
+        uint64_t size = static_cast<uint64_t>(info.st_size);
+
+        // Large BLAKE3 inputs in one pass, so whole subtrees can go to other threads
+        if (algorithm == ChecksumAlgorithm::BLAKE3 && size >= kMapThreshold) {
+            void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                ::madvise(mapping, size, MADV_SEQUENTIAL);
+                ::madvise(mapping, size, MADV_WILLNEED);
+                hasher->update(mapping, size);
+                ::munmap(mapping, size);
+                ::close(fd);
+                return toHex(hasher->finish());
+            }
+        }
+
+#ifdef PLATFORM_LINUX
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        while (true) {
+            ssize_t n = ::read(fd, buffer.data(), buffer.size());
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                ::close(fd);
+                error = "Failed to read file for checksum: " + path;
+                return "";
+            }
+            if (n == 0) {
+                break;
+            }
+            hasher->update(buffer.data(), static_cast<size_t>(n));
+        }
+        ::close(fd);
+#else
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            error = "Failed to open file for checksum: " + path;
+            return "";
+        }
+        while (file.read(reinterpret_cast<char*>(buffer.data()), buffer.size()) || file.gcount() > 0) {
+            hasher->update(buffer.data(), static_cast<size_t>(file.gcount()));
+        }
+        if (file.bad()) {
+            error = "Failed to read file for checksum: " + path;
+            return "";
+        }
+#endif
+        return toHex(hasher->finish());
+    }
+};
+
+ChecksumEngine::ChecksumEngine(size_t threads) : pimpl(std::make_unique<Implementation>(threads)) {}
+ChecksumEngine::~ChecksumEngine() = default;
+
+std::unique_ptr<Hasher> ChecksumEngine::createHasher(ChecksumAlgorithm algorithm) {
+    return makeHasher(algorithm, 1);
+}
+
+std::string ChecksumEngine::hashBuffer(const void* data, size_t size, ChecksumAlgorithm algorithm) const {
+    return pimpl->hashBuffer(data, size, algorithm);
+}
+
+std::string ChecksumEngine::hashFile(const std::string& path, ChecksumAlgorithm algorithm) const {
+    return pimpl->hashFile(path, algorithm);
+}
+
+std::vector<std::string> ChecksumEngine::hashFiles(const std::vector<std::string>& paths,
+                                                   ChecksumAlgorithm algorithm) const {
+    return pimpl->hashFiles(paths, algorithm);
+}
+
+bool ChecksumEngine::simdAvailable() {
+    return useAvx2();
+}
+
+std::string ChecksumEngine::getLastError() const {
+    return pimpl->getLastError();
+}
+
+} // namespace phantomvault
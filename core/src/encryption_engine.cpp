@@ -1,4 +1,7 @@
 #include "encryption_engine.hpp"
+#include "checksum_engine.hpp"
+#include "instrumentation.hpp"
+#include "secure_memory.hpp"
 #include <openssl/evp.h>
 #include <openssl/rand.h>
 #include <openssl/sha.h>
@@ -15,8 +18,7 @@
 #include <thread>
 #include <atomic>
 #include <chrono>
-#include <memory_resource>
-#include <array>
+#include <optional>
 
 #ifdef PLATFORM_LINUX
 #include <unistd.h>
@@ -63,7 +65,12 @@ EncryptionEngine::EncryptionResult EncryptionEngine::encryptFile(
     clearError();
     EncryptionResult result;
     
+    // Plaintext, key and compressed plaintext are zeroed when the scope ends
+    phantomvault::SecureArena& arena = scratchArena();
+    phantomvault::SecureArena::Scope scope(arena);
+    
     // Read file data
+    std::optional<phantomvault::ScopedSpan> read_span(std::in_place, phantomvault::Operation::READ);
     std::ifstream file(file_path, std::ios::binary);
     if (!file.is_open()) {
         setError("Failed to open file: " + file_path);
@@ -83,7 +90,7 @@ EncryptionEngine::EncryptionResult EncryptionEngine::encryptFile(
     }
     
     // Read file data
-    std::vector<uint8_t> file_data(file_size);
+    phantomvault::SecureBuffer file_data(file_size, &arena);
     file.read(reinterpret_cast<char*>(file_data.data()), file_size);
     file.close();
     
@@ -92,6 +99,7 @@ EncryptionEngine::EncryptionResult EncryptionEngine::encryptFile(
         result.error_message = last_error_;
         return result;
     }
+    read_span.reset();
     
     // Generate salt and IV
     result.salt = generateSalt(config.salt_length);
@@ -104,31 +112,34 @@ EncryptionEngine::EncryptionResult EncryptionEngine::encryptFile(
     }
     
     // Derive key using Argon2id
-    std::vector<uint8_t> key = deriveKey(password, result.salt, config);
-    if (key.empty()) {
+    phantomvault::SecureBuffer key(config.key_length, &arena);
+    if (!deriveKeyInto(password, result.salt, config, key.data())) {
         result.error_message = last_error_;
         return result;
     }
     
+    // Checksum exactly what gets encrypted, so unlock can verify it without rereading the file
+    result.checksum_algorithm = phantomvault::checksumAlgorithmName(phantomvault::ChecksumEngine::kDefaultAlgorithm);
+    result.checksum = calculateChecksum(file_data.data(), file_data.size(), result.checksum_algorithm);
+    
     // Compress data before encryption
     result.original_size = file_data.size();
-    std::vector<uint8_t> compressed_data = compressData(file_data);
-    if (compressed_data.empty()) {
+    phantomvault::SecureBuffer compressed_data(ZSTD_compressBound(file_data.size()), &arena);
+    size_t compressed_size = compressBytes(file_data.data(), file_data.size(),
+                                           compressed_data.data(), compressed_data.size(), 3);
+    const uint8_t* payload = compressed_data.data();
+    if (compressed_size == 0) {
         // If compression fails, use original data
-        compressed_data = file_data;
+        clearError();
+        payload = file_data.data();
+        compressed_size = file_data.size();
         result.compression_algorithm = "none";
     }
-    result.compressed_size = compressed_data.size();
+    result.compressed_size = compressed_size;
     
     // Encrypt compressed data
-    result.encrypted_data = encryptData(compressed_data, key, result.iv);
-    
-    // Secure cleanup
-    secureWipe(file_data);
-    secureWipe(compressed_data);
-    secureWipe(key);
-    
-    if (result.encrypted_data.empty()) {
+    if (!encryptBytes(payload, compressed_size, key.data(), key.size(), result.iv, result.encrypted_data)) {
+        result.encrypted_data.clear();
         result.error_message = last_error_;
         return result;
     }
@@ -145,73 +156,152 @@ std::vector<uint8_t> EncryptionEngine::decryptFile(
     const KeyDerivationConfig& config) {
     
     clearError();
+    phantomvault::SecureArena& arena = scratchArena();
+    phantomvault::SecureArena::Scope scope(arena);
     
     // Derive key using Argon2id
-    std::vector<uint8_t> key = deriveKey(password, salt, config);
-    if (key.empty()) {
+    phantomvault::SecureBuffer key(config.key_length, &arena);
+    if (!deriveKeyInto(password, salt, config, key.data())) {
         return {};
     }
     
     // Decrypt data
-    std::vector<uint8_t> decrypted_data = decryptData(encrypted_data, key, iv);
-    
-    // Secure cleanup
-    secureWipe(key);
+    std::vector<uint8_t> decrypted_data(encrypted_data.size() + AES_BLOCK_SIZE);
+    size_t decrypted_size = 0;
+    if (!decryptBytes(encrypted_data.data(), encrypted_data.size(), key.data(), key.size(), iv,
+                      decrypted_data.data(), decrypted_size)) {
+        secureWipe(decrypted_data);
+        return {};
+    }
+    decrypted_data.resize(decrypted_size);
     
     return decrypted_data;
 }
 
+bool EncryptionEngine::decryptFile(
+    const std::vector<uint8_t>& encrypted_data,
+    const std::string& password,
+    const std::vector<uint8_t>& iv,
+    const std::vector<uint8_t>& salt,
+    const std::string& compression_algorithm,
+    size_t original_size,
+    phantomvault::SecureBuffer& output,
+    const KeyDerivationConfig& config) {
+    
+    clearError();
+    output.clear();
+    
+    bool compressed = compression_algorithm == "zstd";
+    if (!compressed && compression_algorithm != "none") {
+        setError("Unsupported compression algorithm: " + compression_algorithm);
+        return false;
+    }
+    
+    if (compressed && original_size == 0) {
+        setError("Original size cannot be zero");
+        return false;
+    }
+    
+    // Reserve the output before opening the scope so the scope does not
+    // reclaim it; only the key and intermediate plaintext are scoped here
+    output.reserve(compressed ? original_size : encrypted_data.size() + AES_BLOCK_SIZE);
+    phantomvault::SecureArena& arena = scratchArena();
+    phantomvault::SecureArena::Scope scope(arena);
+    
+    phantomvault::SecureBuffer key(config.key_length, &arena);
+    if (!deriveKeyInto(password, salt, config, key.data())) {
+        return false;
+    }
+    
+    if (!compressed) {
+        output.resize(encrypted_data.size() + AES_BLOCK_SIZE);
+        size_t decrypted_size = 0;
+        if (!decryptBytes(encrypted_data.data(), encrypted_data.size(), key.data(), key.size(), iv,
+                          output.data(), decrypted_size)) {
+            phantomvault::secureZero(output.data(), output.size());
+            output.clear();
+            return false;
+        }
+        output.resize(decrypted_size);
+        return true;
+    }
+    
+    phantomvault::SecureBuffer decrypted_data(encrypted_data.size() + AES_BLOCK_SIZE, &arena);
+    size_t decrypted_size = 0;
+    if (!decryptBytes(encrypted_data.data(), encrypted_data.size(), key.data(), key.size(), iv,
+                      decrypted_data.data(), decrypted_size)) {
+        return false;
+    }
+    
+    output.resize(original_size);
+    if (!decompressBytes(decrypted_data.data(), decrypted_size, output.data(), original_size)) {
+        phantomvault::secureZero(output.data(), output.size());
+        output.clear();
+        return false;
+    }
+    return true;
+}
+
 std::vector<uint8_t> EncryptionEngine::encryptData(
     const std::vector<uint8_t>& data,
     const std::vector<uint8_t>& key,
     const std::vector<uint8_t>& iv) {
     
-    auto start_time = std::chrono::high_resolution_clock::now();
     clearError();
     
-    if (key.size() != AES_KEY_SIZE) {
+    std::vector<uint8_t> encrypted_data;
+    if (!encryptBytes(data.data(), data.size(), key.data(), key.size(), iv, encrypted_data)) {
+        encrypted_data.clear();
+    }
+    return encrypted_data;
+}
+
+bool EncryptionEngine::encryptBytes(
+    const uint8_t* data, size_t size,
+    const uint8_t* key, size_t key_size,
+    const std::vector<uint8_t>& iv,
+    std::vector<uint8_t>& encrypted_data) {
+    
+    phantomvault::ScopedSpan span(phantomvault::Operation::ENCRYPT);
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    if (key_size != AES_KEY_SIZE) {
         setError("Invalid key size for AES-256");
-        return {};
+        return false;
     }
     
     if (iv.size() != AES_BLOCK_SIZE) {
         setError("Invalid IV size for AES");
-        return {};
+        return false;
     }
     
     EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
     if (!ctx) {
         setError("Failed to create cipher context");
-        return {};
-    }
-    
-    // Use memory pool if enabled for zero-overhead allocation
-    std::vector<uint8_t> encrypted_data;
-    if (memory_pooling_enabled_ && memory_pool_) {
-        std::pmr::vector<uint8_t> pool_vector(memory_pool_.get());
-        // For simplicity, we'll still use regular vector but this shows the concept
+        return false;
     }
     
+    bool ok = false;
     do {
         // Initialize encryption with AES-256-XTS
-        if (EVP_EncryptInit_ex(ctx, EVP_aes_256_xts(), nullptr, key.data(), iv.data()) != 1) {
+        if (EVP_EncryptInit_ex(ctx, EVP_aes_256_xts(), nullptr, key, iv.data()) != 1) {
             setError("Failed to initialize encryption");
             break;
         }
         
         // Calculate maximum output size
-        size_t max_output_size = data.size() + AES_BLOCK_SIZE;
+        size_t max_output_size = size + AES_BLOCK_SIZE;
         encrypted_data.resize(max_output_size);
         
         int len = 0;
         int total_len = 0;
         
         // Encrypt data with SIMD optimization if enabled
-        if (simd_enabled_ && data.size() >= 64) {
+        if (simd_enabled_ && size >= 64) {
             // Use SIMD-optimized encryption for large data blocks
-            if (!encryptDataSIMD(data, encrypted_data, ctx, len, total_len)) {
+            if (!encryptDataSIMD(data, size, encrypted_data, ctx, len, total_len)) {
                 // Fallback to standard encryption
-                if (EVP_EncryptUpdate(ctx, encrypted_data.data(), &len, data.data(), data.size()) != 1) {
+                if (EVP_EncryptUpdate(ctx, encrypted_data.data(), &len, data, size) != 1) {
                     setError("Failed to encrypt data");
                     break;
                 }
@@ -219,7 +309,7 @@ std::vector<uint8_t> EncryptionEngine::encryptData(
             }
         } else {
             // Standard encryption
-            if (EVP_EncryptUpdate(ctx, encrypted_data.data(), &len, data.data(), data.size()) != 1) {
+            if (EVP_EncryptUpdate(ctx, encrypted_data.data(), &len, data, size) != 1) {
                 setError("Failed to encrypt data");
                 break;
             }
@@ -235,28 +325,25 @@ std::vector<uint8_t> EncryptionEngine::encryptData(
         
         // Resize to actual encrypted size
         encrypted_data.resize(total_len);
+        ok = true;
         
     } while (false);
     
     EVP_CIPHER_CTX_free(ctx);
     
-    if (!last_error_.empty()) {
-        encrypted_data.clear();
-    }
-    
     // Record performance metrics if profiling is enabled
-    if (profiling_enabled_) {
+    if (ok && profiling_enabled_) {
         auto end_time = std::chrono::high_resolution_clock::now();
         last_operation_time_ = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time);
         
         if (last_operation_time_.count() > 0) {
             double seconds = last_operation_time_.count() / 1e9;
-            double mb_processed = data.size() / (1024.0 * 1024.0);
+            double mb_processed = size / (1024.0 * 1024.0);
             last_throughput_mbps_ = mb_processed / seconds;
         }
     }
     
-    return encrypted_data;
+    return ok;
 }
 
 std::vector<uint8_t> EncryptionEngine::decryptData(
@@ -266,64 +353,75 @@ std::vector<uint8_t> EncryptionEngine::decryptData(
     
     clearError();
     
-    if (key.size() != AES_KEY_SIZE) {
-        setError("Invalid key size for AES-256");
+    std::vector<uint8_t> decrypted_data(encrypted_data.size() + AES_BLOCK_SIZE);
+    size_t decrypted_size = 0;
+    if (!decryptBytes(encrypted_data.data(), encrypted_data.size(), key.data(), key.size(), iv,
+                      decrypted_data.data(), decrypted_size)) {
+        secureWipe(decrypted_data);
         return {};
     }
+    decrypted_data.resize(decrypted_size);
+    
+    return decrypted_data;
+}
+
+bool EncryptionEngine::decryptBytes(
+    const uint8_t* encrypted_data, size_t size,
+    const uint8_t* key, size_t key_size,
+    const std::vector<uint8_t>& iv,
+    uint8_t* output, size_t& output_size) {
+    
+    phantomvault::ScopedSpan span(phantomvault::Operation::ENCRYPT);
+    
+    if (key_size != AES_KEY_SIZE) {
+        setError("Invalid key size for AES-256");
+        return false;
+    }
     
     if (iv.size() != AES_BLOCK_SIZE) {
         setError("Invalid IV size for AES");
-        return {};
+        return false;
     }
     
     EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
     if (!ctx) {
         setError("Failed to create cipher context");
-        return {};
+        return false;
     }
     
-    std::vector<uint8_t> decrypted_data;
-    
+    // output holds at least size + AES_BLOCK_SIZE bytes
+    bool ok = false;
     do {
         // Initialize decryption with AES-256-XTS
-        if (EVP_DecryptInit_ex(ctx, EVP_aes_256_xts(), nullptr, key.data(), iv.data()) != 1) {
+        if (EVP_DecryptInit_ex(ctx, EVP_aes_256_xts(), nullptr, key, iv.data()) != 1) {
             setError("Failed to initialize decryption");
             break;
         }
         
-        // Calculate maximum output size
-        decrypted_data.resize(encrypted_data.size() + AES_BLOCK_SIZE);
-        
         int len = 0;
         int total_len = 0;
         
         // Decrypt data
-        if (EVP_DecryptUpdate(ctx, decrypted_data.data(), &len, 
-                             encrypted_data.data(), encrypted_data.size()) != 1) {
+        if (EVP_DecryptUpdate(ctx, output, &len, encrypted_data, size) != 1) {
             setError("Failed to decrypt data");
             break;
         }
         total_len += len;
         
         // Finalize decryption (removes padding)
-        if (EVP_DecryptFinal_ex(ctx, decrypted_data.data() + total_len, &len) != 1) {
+        if (EVP_DecryptFinal_ex(ctx, output + total_len, &len) != 1) {
             setError("Failed to finalize decryption - invalid padding or wrong key");
             break;
         }
         total_len += len;
         
-        // Resize to actual decrypted size
-        decrypted_data.resize(total_len);
+        output_size = total_len;
+        ok = true;
         
     } while (false);
     
     EVP_CIPHER_CTX_free(ctx);
-    
-    if (!last_error_.empty()) {
-        decrypted_data.clear();
-    }
-    
-    return decrypted_data;
+    return ok;
 }
 
 std::vector<uint8_t> EncryptionEngine::deriveKey(
@@ -333,33 +431,47 @@ std::vector<uint8_t> EncryptionEngine::deriveKey(
     
     clearError();
     
+    std::vector<uint8_t> key(config.key_length);
+    if (!deriveKeyInto(password, salt, config, key.data())) {
+        secureWipe(key);
+        return {};
+    }
+    return key;
+}
+
+bool EncryptionEngine::deriveKeyInto(
+    const std::string& password,
+    const std::vector<uint8_t>& salt,
+    const KeyDerivationConfig& config,
+    uint8_t* key) {
+    
+    phantomvault::ScopedSpan span(phantomvault::Operation::KDF);
+    
     if (password.empty()) {
         setError("Password cannot be empty");
-        return {};
+        return false;
     }
     
     if (salt.empty()) {
         setError("Salt cannot be empty");
-        return {};
+        return false;
     }
     
     if (config.memory_cost < 8) {
         setError("Memory cost too low (minimum 8 KiB)");
-        return {};
+        return false;
     }
     
     if (config.time_cost < 1) {
         setError("Time cost too low (minimum 1)");
-        return {};
+        return false;
     }
     
     if (config.parallelism < 1) {
         setError("Parallelism too low (minimum 1)");
-        return {};
+        return false;
     }
     
-    std::vector<uint8_t> key(config.key_length);
-    
     // Use Argon2id for key derivation (memory-hard, resistant to GPU attacks)
     int result = argon2id_hash_raw(
         config.time_cost,           // t_cost (iterations)
@@ -369,16 +481,16 @@ std::vector<uint8_t> EncryptionEngine::deriveKey(
         password.length(),          // pwdlen
         salt.data(),               // salt
         salt.size(),               // saltlen
-        key.data(),                // hash
+        key,                       // hash
         config.key_length          // hashlen
     );
     
     if (result != ARGON2_OK) {
         setError("Argon2id key derivation failed: " + std::string(argon2_error_message(result)));
-        return {};
+        return false;
     }
     
-    return key;
+    return true;
 }
 
 std::vector<uint8_t> EncryptionEngine::generateRandomBytes(size_t length) {
@@ -410,69 +522,84 @@ std::vector<uint8_t> EncryptionEngine::generateIV() {
 std::vector<uint8_t> EncryptionEngine::compressData(const std::vector<uint8_t>& data, int compression_level) {
     clearError();
     
-    if (data.empty()) {
-        setError("Cannot compress empty data");
+    // Estimate compressed size (worst case: original size + header)
+    std::vector<uint8_t> compressed_data(ZSTD_compressBound(data.size()));
+    size_t compressed_size = compressBytes(data.data(), data.size(),
+                                           compressed_data.data(), compressed_data.size(), compression_level);
+    if (compressed_size == 0) {
         return {};
     }
     
+    // Resize to actual compressed size
+    compressed_data.resize(compressed_size);
+    return compressed_data;
+}
+
+size_t EncryptionEngine::compressBytes(const uint8_t* data, size_t size,
+                                       uint8_t* output, size_t capacity, int compression_level) {
+    phantomvault::ScopedSpan span(phantomvault::Operation::COMPRESS);
+    
+    if (size == 0) {
+        setError("Cannot compress empty data");
+        return 0;
+    }
+    
     if (compression_level < 1 || compression_level > 22) {
         setError("Invalid compression level (must be 1-22)");
-        return {};
+        return 0;
     }
     
-    // Estimate compressed size (worst case: original size + header)
-    size_t max_compressed_size = ZSTD_compressBound(data.size());
-    std::vector<uint8_t> compressed_data(max_compressed_size);
-    
     // Compress using Zstandard
-    size_t compressed_size = ZSTD_compress(
-        compressed_data.data(), max_compressed_size,
-        data.data(), data.size(),
-        compression_level
-    );
+    size_t compressed_size = ZSTD_compress(output, capacity, data, size, compression_level);
     
     if (ZSTD_isError(compressed_size)) {
         setError("Compression failed: " + std::string(ZSTD_getErrorName(compressed_size)));
-        return {};
+        return 0;
     }
     
-    // Resize to actual compressed size
-    compressed_data.resize(compressed_size);
-    return compressed_data;
+    return compressed_size;
 }
 
 std::vector<uint8_t> EncryptionEngine::decompressData(const std::vector<uint8_t>& compressed_data, size_t original_size) {
     clearError();
     
-    if (compressed_data.empty()) {
-        setError("Cannot decompress empty data");
-        return {};
-    }
-    
     if (original_size == 0) {
         setError("Original size cannot be zero");
         return {};
     }
     
     std::vector<uint8_t> decompressed_data(original_size);
+    if (!decompressBytes(compressed_data.data(), compressed_data.size(), decompressed_data.data(), original_size)) {
+        secureWipe(decompressed_data);
+        return {};
+    }
+    
+    return decompressed_data;
+}
+
+bool EncryptionEngine::decompressBytes(const uint8_t* compressed_data, size_t size,
+                                       uint8_t* output, size_t original_size) {
+    phantomvault::ScopedSpan span(phantomvault::Operation::COMPRESS);
+    
+    if (size == 0) {
+        setError("Cannot decompress empty data");
+        return false;
+    }
     
     // Decompress using Zstandard
-    size_t decompressed_size = ZSTD_decompress(
-        decompressed_data.data(), original_size,
-        compressed_data.data(), compressed_data.size()
-    );
+    size_t decompressed_size = ZSTD_decompress(output, original_size, compressed_data, size);
     
     if (ZSTD_isError(decompressed_size)) {
         setError("Decompression failed: " + std::string(ZSTD_getErrorName(decompressed_size)));
-        return {};
+        return false;
     }
     
     if (decompressed_size != original_size) {
         setError("Decompressed size mismatch");
-        return {};
+        return false;
     }
     
-    return decompressed_data;
+    return true;
 }
 
 std::vector<uint8_t> EncryptionEngine::decryptFile(
@@ -484,85 +611,55 @@ std::vector<uint8_t> EncryptionEngine::decryptFile(
     size_t original_size,
     const KeyDerivationConfig& config) {
     
-    clearError();
+    phantomvault::SecureArena& arena = scratchArena();
+    phantomvault::SecureArena::Scope scope(arena);
     
-    // First decrypt the data
-    std::vector<uint8_t> decrypted_data = decryptFile(encrypted_data, password, iv, salt, config);
-    if (decrypted_data.empty()) {
-        return {};
-    }
-    
-    // Then decompress if needed
-    if (compression_algorithm == "zstd") {
-        std::vector<uint8_t> decompressed_data = decompressData(decrypted_data, original_size);
-        secureWipe(decrypted_data);
-        return decompressed_data;
-    } else if (compression_algorithm == "none") {
-        return decrypted_data;
-    } else {
-        setError("Unsupported compression algorithm: " + compression_algorithm);
-        secureWipe(decrypted_data);
+    phantomvault::SecureBuffer plaintext(&arena);
+    if (!decryptFile(encrypted_data, password, iv, salt, compression_algorithm, original_size, plaintext, config)) {
         return {};
     }
+    return std::vector<uint8_t>(plaintext.begin(), plaintext.end());
 }
 
 std::string EncryptionEngine::calculateFileChecksum(const std::string& file_path) {
+    return calculateFileChecksum(file_path, phantomvault::checksumAlgorithmName(phantomvault::ChecksumEngine::kDefaultAlgorithm));
+}
+
+std::string EncryptionEngine::calculateFileChecksum(const std::string& file_path, const std::string& algorithm) {
     clearError();
     
-    std::ifstream file(file_path, std::ios::binary);
-    if (!file.is_open()) {
-        setError("Failed to open file for checksum: " + file_path);
+    auto parsed = phantomvault::parseChecksumAlgorithm(algorithm);
+    if (!parsed) {
+        setError("Unsupported checksum algorithm: " + algorithm);
         return "";
     }
     
-    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-    if (!ctx) {
-        setError("Failed to create hash context");
-        return "";
+    phantomvault::ChecksumEngine engine(parallel_threads_);
+    std::string checksum = engine.hashFile(file_path, *parsed);
+    if (checksum.empty()) {
+        setError(engine.getLastError());
     }
+    return checksum;
+}
+
+std::string EncryptionEngine::calculateChecksum(const std::vector<uint8_t>& data, const std::string& algorithm) {
+    return calculateChecksum(data.data(), data.size(), algorithm);
+}
+
+std::string EncryptionEngine::calculateChecksum(const uint8_t* data, size_t size, const std::string& algorithm) {
+    clearError();
     
-    std::string checksum;
-    
-    do {
-        if (EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr) != 1) {
-            setError("Failed to initialize SHA-256");
-            break;
-        }
-        
-        char buffer[8192];
-        while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
-            if (EVP_DigestUpdate(ctx, buffer, file.gcount()) != 1) {
-                setError("Failed to update hash");
-                break;
-            }
-        }
-        
-        if (!last_error_.empty()) break;
-        
-        unsigned char hash[SHA256_DIGEST_LENGTH];
-        unsigned int hash_len;
-        
-        if (EVP_DigestFinal_ex(ctx, hash, &hash_len) != 1) {
-            setError("Failed to finalize hash");
-            break;
-        }
-        
-        // Convert to hex string
-        std::stringstream ss;
-        for (unsigned int i = 0; i < hash_len; ++i) {
-            ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
-        }
-        checksum = ss.str();
-        
-    } while (false);
-    
-    EVP_MD_CTX_free(ctx);
-    file.close();
+    auto parsed = phantomvault::parseChecksumAlgorithm(algorithm);
+    if (!parsed) {
+        setError("Unsupported checksum algorithm: " + algorithm);
+        return "";
+    }
     
-    return checksum;
+    phantomvault::ChecksumEngine engine(parallel_threads_);
+    return engine.hashBuffer(data, size, *parsed);
 }
 
-EncryptionEngine::FileMetadata EncryptionEngine::getFileMetadata(const std::string& file_path) {
+EncryptionEngine::FileMetadata EncryptionEngine::getFileMetadata(const std::string& file_path, bool with_checksum) {
     clearError();
     FileMetadata metadata;
     
@@ -584,46 +681,18 @@ EncryptionEngine::FileMetadata EncryptionEngine::getFileMetadata(const std::stri
     metadata.original_permissions = perm_ss.str();
     
     // Calculate checksum
-    metadata.checksum_sha256 = calculateFileChecksum(file_path);
+    if (with_checksum) {
+        metadata.checksum_algorithm = phantomvault::checksumAlgorithmName(phantomvault::ChecksumEngine::kDefaultAlgorithm);
+        metadata.checksum = calculateFileChecksum(file_path, metadata.checksum_algorithm);
+    }
     
     return metadata;
 }
 
 void EncryptionEngine::secureWipe(void* data, size_t size) {
-    if (data && size > 0) {
-        // Use multiple passes with different patterns for enhanced security
-        volatile uint8_t* ptr = static_cast<volatile uint8_t*>(data);
-        
-        // Pass 1: Fill with 0xFF
-        for (size_t i = 0; i < size; ++i) {
-            ptr[i] = 0xFF;
-        }
-        
-        // Pass 2: Fill with 0x00
-        for (size_t i = 0; i < size; ++i) {
-            ptr[i] = 0x00;
-        }
-        
-        // Pass 3: Fill with random data
-        std::vector<uint8_t> random_data(size);
-        if (RAND_bytes(random_data.data(), size) == 1) {
-            for (size_t i = 0; i < size; ++i) {
-                ptr[i] = random_data[i];
-            }
-        }
-        
-        // Final pass: Fill with 0x00
-        for (size_t i = 0; i < size; ++i) {
-            ptr[i] = 0x00;
-        }
-        
-        // Memory barrier to prevent reordering
-        #ifdef __GNUC__
-        __asm__ __volatile__("" ::: "memory");
-        #elif defined(_MSC_VER)
-        _ReadWriteBarrier();
-        #endif
-    }
+    // One zeroing pass: RAM keeps no remanence that extra patterns would
+    // erase, and the barrier in secureZero keeps the pass from being elided
+    phantomvault::secureZero(data, size);
 }
 
 void EncryptionEngine::secureWipe(std::vector<uint8_t>& data) {
@@ -638,18 +707,8 @@ bool EncryptionEngine::constantTimeCompare(const void* a, const void* b, size_t
         return false;
     }
     
-    const volatile uint8_t* ptr_a = static_cast<const volatile uint8_t*>(a);
-    const volatile uint8_t* ptr_b = static_cast<const volatile uint8_t*>(b);
-    
-    volatile uint8_t result = 0;
-    
     // Compare all bytes regardless of early differences (constant-time)
-    for (size_t i = 0; i < size; ++i) {
-        result |= ptr_a[i] ^ ptr_b[i];
-    }
-    
-    // Return true if result is 0 (all bytes matched)
-    return result == 0;
+    return phantomvault::constantTimeEqual(a, b, size);
 }
 
 bool EncryptionEngine::constantTimeCompare(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
@@ -671,7 +730,7 @@ bool EncryptionEngine::selfTest() {
         return false;
     }
     
-    KeyDerivationConfig test_config(8192, 2, 1, 32, 32); // Lightweight config for testing
+    KeyDerivationConfig test_config(8192, 2, 1, 32, AES_KEY_SIZE); // Lightweight config for testing
     std::vector<uint8_t> key1 = deriveKey(test_password, test_salt, test_config);
     std::vector<uint8_t> key2 = deriveKey(test_password, test_salt, test_config);
     
@@ -736,10 +795,11 @@ void EncryptionEngine::clearError() {
 }
 
 // SIMD-optimized encryption helper
-bool EncryptionEngine::encryptDataSIMD(const std::vector<uint8_t>& data, 
+bool EncryptionEngine::encryptDataSIMD(const uint8_t* data, size_t size,
                                       std::vector<uint8_t>& encrypted_data,
                                       EVP_CIPHER_CTX* ctx, int& len, int& total_len) {
     (void)data;           // Suppress unused parameter warning
+    (void)size;           // Suppress unused parameter warning
     (void)encrypted_data; // Suppress unused parameter warning
     (void)ctx;            // Suppress unused parameter warning
     (void)len;            // Suppress unused parameter warning
@@ -749,14 +809,14 @@ bool EncryptionEngine::encryptDataSIMD(const std::vector<uint8_t>& data,
         #ifdef __AVX2__
         // Use AVX2 for parallel processing of multiple blocks
         const size_t simd_block_size = 32; // AVX2 processes 32 bytes at a time
-        const size_t num_simd_blocks = data.size() / simd_block_size;
+        const size_t num_simd_blocks = size / simd_block_size;
         
         if (num_simd_blocks > 0) {
             // Process SIMD-aligned blocks
             size_t simd_processed = 0;
             
             for (size_t i = 0; i < num_simd_blocks; ++i) {
-                const uint8_t* block_data = data.data() + (i * simd_block_size);
+                const uint8_t* block_data = data + (i * simd_block_size);
                 
                 // Load data into AVX2 register
                 __m256i data_vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block_data));
@@ -773,12 +833,12 @@ bool EncryptionEngine::encryptDataSIMD(const std::vector<uint8_t>& data,
             }
             
             // Process remaining bytes with standard method
-            if (simd_processed < data.size()) {
-                size_t remaining = data.size() - simd_processed;
+            if (simd_processed < size) {
+                size_t remaining = size - simd_processed;
                 int remaining_len = 0;
                 
                 if (EVP_EncryptUpdate(ctx, encrypted_data.data() + total_len, &remaining_len,
-                                    data.data() + simd_processed, remaining) != 1) {
+                                    data + simd_processed, remaining) != 1) {
                     return false;
                 }
                 
@@ -841,21 +901,28 @@ double EncryptionEngine::getThroughputMBps() const {
     return last_throughput_mbps_;
 }
 
-// Memory pool allocation for zero-overhead operations
+// Secure arena for per-file keys and plaintext
+phantomvault::SecureArena& EncryptionEngine::scratchArena() {
+    if (memory_pooling_enabled_ && memory_pool_) {
+        return *memory_pool_;
+    }
+    return phantomvault::SecureArena::forThread();
+}
+
 void EncryptionEngine::enableMemoryPooling() {
-    try {
-        // Create a monotonic buffer resource for fast allocation
-        static std::array<std::byte, 64 * 1024 * 1024> buffer; // 64MB pool
-        memory_pool_ = std::make_unique<std::pmr::monotonic_buffer_resource>(
-            buffer.data(), buffer.size(), std::pmr::null_memory_resource());
-        
-        memory_pooling_enabled_ = true;
-        std::cout << "[EncryptionEngine] Memory pooling enabled (64MB pool)" << std::endl;
-        
-    } catch (const std::exception& e) {
-        setError("Failed to enable memory pooling: " + std::string(e.what()));
+    // Plaintext and its compressed copy coexist during lock and unlock, plus keys
+    size_t capacity = MAX_FILE_SIZE + ZSTD_compressBound(MAX_FILE_SIZE) + 64 * 1024;
+    auto arena = std::make_unique<phantomvault::SecureArena>(capacity);
+    if (arena->capacity() == 0) {
+        setError("Failed to enable memory pooling: secure arena mapping failed");
         memory_pooling_enabled_ = false;
+        return;
     }
+    
+    memory_pool_ = std::move(arena);
+    memory_pooling_enabled_ = true;
+    std::cout << "[EncryptionEngine] Memory pooling enabled (" << memory_pool_->capacity() / (1024 * 1024) << "MB secure arena"
+              << (memory_pool_->isLocked() ? ", locked" : ", not locked: memlock limit") << ")" << std::endl;
 }
 
 void EncryptionEngine::disableMemoryPooling() {
@@ -865,7 +932,7 @@ void EncryptionEngine::disableMemoryPooling() {
 }
 
 size_t EncryptionEngine::getMemoryPoolSize() const {
-    return memory_pooling_enabled_ ? 64 * 1024 * 1024 : 0; // 64MB when enabled
+    return memory_pooling_enabled_ && memory_pool_ ? memory_pool_->capacity() : 0;
 }
 
 } // namespace PhantomVault
\ No newline at end of file
@@ -5,7 +5,13 @@
  */
 
 #include "error_handler.hpp"
+#include "audit_chain.hpp"
+#include "checksum_engine.hpp"
 #include "encryption_engine.hpp"
+#include "event_queue.hpp"
+#include "performance_monitor.hpp"
+#include "rate_limiter.hpp"
+#include "security_event_store.hpp"
 #include <iostream>
 #include <fstream>
 #include <filesystem>
@@ -21,7 +27,6 @@
 #include <condition_variable>
 #include <queue>
 #include <unordered_map>
-#include <openssl/sha.h>
 #include <openssl/evp.h>
 #include <openssl/rand.h>
 #include <nlohmann/json.hpp>
@@ -51,16 +56,16 @@ public:
         , retention_period_(std::chrono::hours(24 * 7)) // 7 days default
         , real_time_alerts_(true)
         , last_error_()
-        , security_events_()
-        , rate_limits_()
-        , events_mutex_()
-        , rate_limit_mutex_()
+        , event_store_()
+        , audit_chain_()
+        , rate_limiter_()
         , security_alert_callback_()
         , critical_error_callback_()
         , config_monitoring_enabled_(false)
 
         , automatic_backups_enabled_(false)
         , backup_interval_(std::chrono::hours(6))
+        , backup_io_limiter_(std::make_unique<ResourceLimiter>())
     {}
     
     ~Implementation() {
@@ -88,10 +93,16 @@ public:
             // Load existing events if log file exists
             loadExistingEvents();
             
+            // Recover the hash chain; only records written since the last checkpoint are re-read
+            bool chainIntact = audit_chain_.open(log_path_);
+            
             // Note: Encrypted backup functionality will be added in future iterations
             
-            // Start cleanup thread
-            cleanup_thread_ = std::thread(&Implementation::cleanupLoop, this);
+            // Start the writer thread; retention cleanup runs now and every 5 minutes
+            writer_running_ = true;
+            writer_thread_ = std::thread(&Implementation::writerLoop, this);
+            cleanup_task_ = AdaptiveScheduler::getInstance().scheduleTask(
+                [this]() { runCleanup(); }, std::chrono::minutes(5), std::chrono::milliseconds(0), -1);
             
             initialized_ = true;
             
@@ -99,6 +110,12 @@ public:
             logSecurityEvent(SecurityEventType::SYSTEM_COMPROMISE, ErrorSeverity::INFO, "",
                            "ErrorHandler initialized", {{"logPath", log_path_}});
             
+            if (!chainIntact) {
+                logSecurityEvent(SecurityEventType::SYSTEM_COMPROMISE, ErrorSeverity::CRITICAL, "",
+                               "Security log failed integrity verification",
+                               {{"error", audit_chain_.getLastError()}});
+            }
+            
             std::cout << "[ErrorHandler] Initialized with log path: " << log_path_ << std::endl;
             return true;
             
@@ -210,89 +227,44 @@ public:
                          const std::string& profileId, const std::string& description,
                          const std::map<std::string, std::string>& metadata) {
         try {
-            std::lock_guard<std::mutex> lock(events_mutex_);
-            
+            // Hot path: capture and enqueue. Sanitization, id generation,
+            // callbacks and the log append run on the writer thread.
             SecurityEvent event;
-            event.id = generateEventId();
             event.type = type;
             event.severity = severity;
             event.profileId = profileId;
             event.description = description;
-            event.details = sanitizeErrorMessage(description);
-            event.timestamp = std::chrono::system_clock::now();
             event.sourceComponent = "ErrorHandler";
             event.metadata = metadata;
             
-            security_events_.push_back(event);
-            
-            // Trigger callbacks
-            if (severity == ErrorSeverity::CRITICAL && critical_error_callback_) {
-                critical_error_callback_(event);
-            }
-            
-            if (real_time_alerts_ && security_alert_callback_) {
-                security_alert_callback_(event);
-            }
-            
-            // Periodic save
-            if (security_events_.size() % 10 == 0) {
-                saveEvents();
-            }
+            ingest_queue_.push(std::move(event));
             
         } catch (const std::exception& e) {
             last_error_ = "Failed to log security event: " + std::string(e.what());
         }
     }
     
+    void setOverflowPolicy(OverflowPolicy policy) {
+        ingest_queue_.setPolicy(policy);
+    }
+    
+    void setOverflowSampleRate(uint32_t oneInN) {
+        ingest_queue_.setSampleRate(oneInN);
+    }
+    
+    void setOverflowBlockTimeout(std::chrono::milliseconds timeout) {
+        ingest_queue_.setBlockTimeout(timeout);
+    }
+    
+    EventQueueStats getIngestionStats() const {
+        return ingest_queue_.getStats();
+    }
+    
     bool checkRateLimit(const std::string& identifier, int maxAttempts, 
                        std::chrono::minutes windowMinutes) {
         try {
-            std::lock_guard<std::mutex> lock(rate_limit_mutex_);
-            
-            auto now = std::chrono::system_clock::now();
-            auto& rateLimit = rate_limits_[identifier];
-            
-            // Initialize if first attempt
-            if (rateLimit.attemptCount == 0) {
-                rateLimit.identifier = identifier;
-                rateLimit.firstAttempt = now;
-                rateLimit.lastAttempt = now;
-                rateLimit.attemptCount = 1;
-                rateLimit.isBlocked = false;
-                return true;
-            }
-            
-            // Check if block has expired
-            if (rateLimit.isBlocked && now > rateLimit.blockExpiry) {
-                rateLimit.isBlocked = false;
-                rateLimit.attemptCount = 0;
-            }
-            
-            // If currently blocked, deny
-            if (rateLimit.isBlocked) {
-                return false;
-            }
-            
-            // Check if window has expired
-            if (now - rateLimit.firstAttempt > windowMinutes) {
-                rateLimit.firstAttempt = now;
-                rateLimit.attemptCount = 1;
-                rateLimit.lastAttempt = now;
-                return true;
-            }
-            
-            // Increment attempt count
-            rateLimit.attemptCount++;
-            rateLimit.lastAttempt = now;
-            
-            // Check if limit exceeded
-            if (rateLimit.attemptCount > maxAttempts) {
-                rateLimit.isBlocked = true;
-                rateLimit.blockExpiry = now + std::chrono::hours(1); // Block for 1 hour
-                return false;
-            }
-            
-            return true;
+            // Sharded limiter: attempts for different identifiers never share a lock
+            return rate_limiter_.allow(identifier, maxAttempts, windowMinutes);
             
         } catch (const std::exception& e) {
             last_error_ = "Rate limit check failed: " + std::string(e.what());
@@ -354,6 +326,7 @@ public:
                                    originalPath.filename().string() + "_" + std::to_string(timestamp);
             
             // Copy file to backup location
+            throttleBackupIO(fs::file_size(filePath));
             fs::copy_file(filePath, backupPath);
             fs::permissions(backupPath, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace);
             
@@ -501,36 +474,19 @@ public:
     std::vector<SecurityEvent> getSecurityEvents(const std::string& profileId,
                                                 SecurityEventType type,
                                                 std::chrono::hours timeRange) const {
-        std::lock_guard<std::mutex> lock(events_mutex_);
+        awaitWriter();
         
-        std::vector<SecurityEvent> filteredEvents;
+        // Served from the per-type / per-profile index, newest first until out of range
         auto cutoffTime = std::chrono::system_clock::now() - timeRange;
-        
-        for (const auto& event : security_events_) {
-            bool matchesProfile = profileId.empty() || event.profileId == profileId;
-            bool matchesType = event.type == type;
-            bool withinTimeRange = event.timestamp >= cutoffTime;
-            
-            if (matchesProfile && matchesType && withinTimeRange) {
-                filteredEvents.push_back(event);
-            }
-        }
-        
-        return filteredEvents;
+        return event_store_.query(profileId, type, cutoffTime);
     }
     
     void resetRateLimit(const std::string& identifier) {
-        std::lock_guard<std::mutex> lock(rate_limit_mutex_);
-        rate_limits_.erase(identifier);
+        rate_limiter_.reset(identifier);
     }
     
     RateLimitInfo getRateLimitInfo(const std::string& identifier) const {
-        std::lock_guard<std::mutex> lock(rate_limit_mutex_);
-        auto it = rate_limits_.find(identifier);
-        if (it != rate_limits_.end()) {
-            return it->second;
-        }
-        return RateLimitInfo{}; // Return empty info if not found
+        return rate_limiter_.getInfo(identifier);
     }
     
     bool restoreFileFromBackup(const std::string& filePath, const std::string& backupPath) {
@@ -540,6 +496,7 @@ public:
             }
             
             // Copy backup file back to original location
+            throttleBackupIO(fs::file_size(backupPath));
             fs::copy_file(backupPath, filePath, fs::copy_options::overwrite_existing);
             
             // Clean up backup file
@@ -553,6 +510,10 @@ public:
         }
     }
     
+    void setBackupIOLimit(size_t max_bytes_per_second) {
+        backup_io_limiter_->setIOLimit(max_bytes_per_second);
+    }
+    
     void cleanupBackups(const std::string& profileId, std::chrono::hours maxAge) {
         (void)profileId; // Suppress unused parameter warning
         try {
@@ -586,29 +547,45 @@ public:
     
     void exportAuditLog(const std::string& filePath, const std::string& profileId) const {
         try {
-            std::ofstream file(filePath);
-            
-            std::lock_guard<std::mutex> lock(events_mutex_);
-            
-            for (const auto& event : security_events_) {
-                if (profileId.empty() || event.profileId == profileId) {
-                    json eventJson;
-                    eventJson["id"] = event.id;
-                    eventJson["type"] = static_cast<int>(event.type);
-                    eventJson["severity"] = static_cast<int>(event.severity);
-                    eventJson["profileId"] = event.profileId;
-                    eventJson["description"] = event.description;
-                    eventJson["details"] = event.details;
-                    eventJson["sourceComponent"] = event.sourceComponent;
-                    eventJson["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-                        event.timestamp.time_since_epoch()).count();
-                    eventJson["metadata"] = event.metadata;
-                    
-                    file << eventJson.dump() << std::endl;
-                }
+            awaitWriter();
+            
+            // Snapshot shares ownership of the immutable event chunks, so the
+            // export streams without blocking logging or authentication
+            auto snapshot = event_store_.snapshot();
+            
+            std::string partialPath = filePath + ".partial";
+            std::ofstream file(partialPath, std::ios::trunc);
+            if (!file) {
+                last_error_ = "Failed to open audit export file: " + filePath;
+                return;
             }
             
+            size_t written = 0;
+            snapshot.forEach([&](const SecurityEvent& event) {
+                if (!profileId.empty() && event.profileId != profileId) {
+                    return;
+                }
+                
+                json eventJson;
+                eventJson["id"] = event.id;
+                eventJson["type"] = static_cast<int>(event.type);
+                eventJson["severity"] = static_cast<int>(event.severity);
+                eventJson["profileId"] = event.profileId;
+                eventJson["description"] = event.description;
+                eventJson["details"] = event.details;
+                eventJson["sourceComponent"] = event.sourceComponent;
+                eventJson["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    event.timestamp.time_since_epoch()).count();
+                eventJson["metadata"] = event.metadata;
+                
+                file << eventJson.dump() << '\n';
+                if (++written % 1024 == 0) {
+                    file.flush();
+                }
+            });
+            
             file.close();
+            fs::rename(partialPath, filePath);
             
         } catch (const std::exception& e) {
             last_error_ = "Failed to export audit log: " + std::string(e.what());
@@ -616,32 +593,23 @@ public:
     }
     
     void setSecurityAlertCallback(std::function<void(const SecurityEvent&)> callback) {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
         security_alert_callback_ = callback;
     }
     
     void setCriticalErrorCallback(std::function<void(const SecurityEvent&)> callback) {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
         critical_error_callback_ = callback;
     }
     
     size_t getEventCount(SecurityEventType type) const {
-        std::lock_guard<std::mutex> lock(events_mutex_);
-        
-        return std::count_if(security_events_.begin(), security_events_.end(),
-                           [type](const SecurityEvent& event) {
-                               return event.type == type;
-                           });
+        awaitWriter();
+        return event_store_.count(type);
     }
     
     std::map<SecurityEventType, size_t> getEventStatistics() const {
-        std::lock_guard<std::mutex> lock(events_mutex_);
-        
-        std::map<SecurityEventType, size_t> stats;
-        
-        for (const auto& event : security_events_) {
-            stats[event.type]++;
-        }
-        
-        return stats;
+        awaitWriter();
+        return event_store_.statistics();
     }
     
     void setMaxLogSize(size_t maxSizeBytes) {
@@ -755,8 +723,8 @@ public:
             return;
         }
         
-        config_monitoring_running_ = true;
-        config_monitor_thread_ = std::thread(&Implementation::configurationMonitoringLoop, this);
+        config_monitor_task_ = AdaptiveScheduler::getInstance().scheduleTask(
+            [this]() { runConfigurationCheck(); }, std::chrono::seconds(30), std::chrono::milliseconds(0));
         config_monitoring_enabled_ = true;
         
         std::cout << "[ErrorHandler] Configuration monitoring enabled" << std::endl;
@@ -767,11 +735,8 @@ public:
             return;
         }
         
-        config_monitoring_running_ = false;
-        
-        if (config_monitor_thread_.joinable()) {
-            config_monitor_thread_.join();
-        }
+        AdaptiveScheduler::getInstance().cancelTask(config_monitor_task_);
+        config_monitor_task_ = 0;
         
         config_monitoring_enabled_ = false;
         std::cout << "[ErrorHandler] Configuration monitoring disabled" << std::endl;
@@ -978,52 +943,20 @@ public:
                        "Backup scheduled", {{"file_path", filePath}});
     }
     void rotateLogFile() {
-        try {
-            auto now = std::chrono::system_clock::now();
-            auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-            
-            std::string rotated_path = log_path_ + "." + std::to_string(timestamp);
-            
-            // Move current log to rotated file
-            fs::rename(log_path_, rotated_path);
-            
-            // Compress rotated log (simplified - just rename)
-            std::string compressed_path = rotated_path + ".old";
-            fs::rename(rotated_path, compressed_path);
-            
-            // Set secure permissions on rotated log
-            fs::permissions(compressed_path, fs::perms::owner_read, fs::perm_options::replace);
-            
-            std::cout << "[ErrorHandler] Log file rotated: " << compressed_path << std::endl;
-            
-        } catch (const std::exception& e) {
-            last_error_ = "Log rotation failed: " + std::string(e.what());
+        std::string sealed_path = audit_chain_.sealAndRotate();
+        if (sealed_path.empty()) {
+            last_error_ = audit_chain_.getLastError();
+            return;
         }
+        std::cout << "[ErrorHandler] Log file rotated: " << sealed_path << std::endl;
     }
     
     bool verifyLogIntegrity() const {
-        try {
-            if (!fs::exists(log_path_)) {
-                return true; // No log file to verify
-            }
-            
-            std::string checksum_file = log_path_ + ".checksum";
-            if (!fs::exists(checksum_file)) {
-                return false; // No checksum file
-            }
-            
-            std::ifstream file(checksum_file);
-            std::string expected_checksum;
-            if (file && std::getline(file, expected_checksum)) {
-                std::string actual_checksum = calculateFileHash(log_path_);
-                return expected_checksum == actual_checksum;
-            }
-            
-            return false;
-            
-        } catch (const std::exception& e) {
-            return false;
+        auto result = audit_chain_.verifyIncremental();
+        if (!result.valid) {
+            last_error_ = "Log integrity verification failed: " + result.error;
         }
+        return result.valid;
     }
     
 
@@ -1048,6 +981,7 @@ public:
                     
                     try {
                         fs::create_directories(fs::path(targetPath).parent_path());
+                        throttleBackupIO(entry.file_size());
                         fs::copy_file(entry.path(), targetPath, fs::copy_options::overwrite_existing);
                         result.recoveredFiles.push_back(targetPath);
                     } catch (const std::exception& e) {
@@ -1074,34 +1008,47 @@ private:
     bool real_time_alerts_;
     mutable std::string last_error_;
     
-    std::vector<SecurityEvent> security_events_;
-    std::map<std::string, RateLimitInfo> rate_limits_;
-    
-    mutable std::mutex events_mutex_;
-    mutable std::mutex rate_limit_mutex_;
+    SecurityEventStore event_store_;
+    mutable AuditChain audit_chain_; // verification advances its watermark
+    RateLimiter rate_limiter_;
     
-    std::thread cleanup_thread_;
-    std::atomic<bool> cleanup_running_{true};
+    AdaptiveScheduler::TaskId cleanup_task_{0};
     
+    mutable std::mutex callback_mutex_;
     std::function<void(const SecurityEvent&)> security_alert_callback_;
     std::function<void(const SecurityEvent&)> critical_error_callback_;
     
+    // Lock-free ingestion drained by the writer thread
+    static constexpr size_t kIngestQueueCapacity = 4096;
+    static constexpr std::chrono::milliseconds kReaderSyncTimeout{100};
+    // Security events make up the audit trail, so producers wait for room
+    // rather than evicting older events
+    mutable BoundedEventQueue<SecurityEvent> ingest_queue_{kIngestQueueCapacity, OverflowPolicy::BLOCK};
+    std::thread writer_thread_;
+    std::atomic<bool> writer_running_{false};
+    std::atomic<std::thread::id> writer_id_{};
+    uint64_t next_event_seq_ = 0;
+    
     // Configuration protection members
     std::vector<std::string> protected_config_paths_;
     std::map<std::string, std::string> config_file_hashes_;
     bool config_monitoring_enabled_;
-    std::thread config_monitor_thread_;
-    std::atomic<bool> config_monitoring_running_{false};
+    AdaptiveScheduler::TaskId config_monitor_task_{0};
     
     // Note: Encrypted backup infrastructure will be added in future iterations
     std::map<std::string, BackupMetadata> backup_metadata_;
     std::string backup_root_path_;
     bool automatic_backups_enabled_;
     std::chrono::hours backup_interval_;
-    std::thread backup_scheduler_thread_;
-    std::atomic<bool> backup_scheduler_running_{false};
     EncryptionEngine* backup_encryption_engine_{nullptr};
     mutable std::mutex backup_mutex_;
+    std::unique_ptr<ResourceLimiter> backup_io_limiter_;  // paces backup/restore copies
+    
+    // A copy reads and writes every byte once; a no-op while no limit is set
+    void throttleBackupIO(uintmax_t bytes) {
+        backup_io_limiter_->recordIO(static_cast<size_t>(bytes) * 2);
+        backup_io_limiter_->enforceIOLimit();
+    }
     
     std::string getDefaultLogPath() {
         #ifdef PLATFORM_LINUX
@@ -1140,6 +1087,76 @@ private:
         return "event_" + std::to_string(timestamp) + "_" + std::to_string(dis(gen));
     }
     
+    void writerLoop() {
+        writer_id_ = std::this_thread::get_id();
+        // Sleeps until a producer pushes or stop() calls wake()
+        while (writer_running_) {
+            ingest_queue_.waitForItems();
+            uint64_t ticket = ingest_queue_.beginConsumerPass();
+            while (applyPendingEvents() == kIngestQueueCapacity) {
+            }
+            ingest_queue_.endConsumerPass(ticket);
+        }
+    }
+    
+    /**
+     * Queries read the store as the writer left it. While the writer runs,
+     * wait for one more pass so events logged before the call are included.
+     */
+    void awaitWriter() const {
+        // Alert callbacks run on the writer; a query from one must not wait on itself
+        if (writer_running_ && writer_id_.load() != std::this_thread::get_id()) {
+            ingest_queue_.waitForConsumer(kReaderSyncTimeout);
+        }
+    }
+    
+    /**
+     * Apply what is left once the writer has been joined
+     */
+    void drainRemainingEvents() {
+        while (applyPendingEvents() > 0) {
+        }
+    }
+    
+    /**
+     * Move queued events into the store and append them to the log
+     */
+    size_t applyPendingEvents() {
+        std::vector<SecurityEvent> batch;
+        if (ingest_queue_.drain(batch, kIngestQueueCapacity) == 0) {
+            return 0;
+        }
+        
+        for (auto& event : batch) {
+            auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                event.timestamp.time_since_epoch()).count();
+            event.id = "event_" + std::to_string(timestamp) + "_" + std::to_string(next_event_seq_++);
+            event.details = sanitizeErrorMessage(event.description);
+        }
+        
+        event_store_.append(batch);
+        
+        // Append only the new batch to the log; no store lock is held during file I/O
+        saveEvents(batch);
+        
+        std::function<void(const SecurityEvent&)> alertCallback;
+        std::function<void(const SecurityEvent&)> criticalCallback;
+        {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            alertCallback = security_alert_callback_;
+            criticalCallback = critical_error_callback_;
+        }
+        for (const auto& event : batch) {
+            if (event.severity == ErrorSeverity::CRITICAL && criticalCallback) {
+                criticalCallback(event);
+            }
+            if (real_time_alerts_ && alertCallback) {
+                alertCallback(event);
+            }
+        }
+        return batch.size();
+    }
+    
     void loadExistingEvents() {
         try {
             if (!fs::exists(log_path_)) {
@@ -1148,6 +1165,7 @@ private:
             
             std::ifstream file(log_path_);
             std::string line;
+            std::vector<SecurityEvent> loaded;
             
             while (std::getline(file, line)) {
                 if (line.empty()) continue;
@@ -1171,7 +1189,7 @@ private:
                         event.metadata = eventJson["metadata"].get<std::map<std::string, std::string>>();
                     }
                     
-                    security_events_.push_back(event);
+                    loaded.push_back(std::move(event));
                     
                 } catch (const std::exception& e) {
                     // Skip malformed log entries
@@ -1179,22 +1197,24 @@ private:
                 }
             }
             
+            event_store_.append(loaded);
+            
         } catch (const std::exception& e) {
             last_error_ = "Failed to load existing events: " + std::string(e.what());
         }
     }
     
-    void saveEvents() {
+    void saveEvents(const std::vector<SecurityEvent>& newEvents) {
         try {
             // Check if log rotation is needed
-            if (fs::exists(log_path_) && fs::file_size(log_path_) > max_log_size_) {
+            if (audit_chain_.getSegmentSize() > max_log_size_) {
                 rotateLogFile();
             }
             
-            std::ofstream file(log_path_, std::ios::app);
+            std::vector<std::string> records;
+            records.reserve(newEvents.size());
             
-            // Save only new events (simple approach - save all for now)
-            for (const auto& event : security_events_) {
+            for (const auto& event : newEvents) {
                 json eventJson;
                 eventJson["id"] = event.id;
                 eventJson["type"] = static_cast<int>(event.type);
@@ -1213,16 +1233,12 @@ private:
                 }
                 eventJson["metadata"] = sanitized_metadata;
                 
-                file << eventJson.dump() << std::endl;
+                records.push_back(eventJson.dump());
             }
             
-            file.close();
-            
-            // Set secure permissions
-            fs::permissions(log_path_, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace);
-            
-            // Create integrity checksum for log file
-            createLogIntegrityChecksum();
+            if (!audit_chain_.append(records)) {
+                last_error_ = "Failed to save events: " + audit_chain_.getLastError();
+            }
             
         } catch (const std::exception& e) {
             last_error_ = "Failed to save events: " + std::string(e.what());
@@ -1232,56 +1248,41 @@ private:
     // Missing method implementations
     void cleanup() {
         try {
-            cleanup_running_ = false;
-            if (cleanup_thread_.joinable()) {
-                cleanup_thread_.join();
+            // Scheduled tasks first, so none runs against a closed log
+            if (cleanup_task_) {
+                AdaptiveScheduler::getInstance().cancelTask(cleanup_task_);
+                cleanup_task_ = 0;
             }
-            
-            config_monitoring_running_ = false;
-            if (config_monitor_thread_.joinable()) {
-                config_monitor_thread_.join();
+            if (config_monitor_task_) {
+                AdaptiveScheduler::getInstance().cancelTask(config_monitor_task_);
+                config_monitor_task_ = 0;
             }
             
-            backup_scheduler_running_ = false;
-            if (backup_scheduler_thread_.joinable()) {
-                backup_scheduler_thread_.join();
+            writer_running_ = false;
+            ingest_queue_.wake();
+            if (writer_thread_.joinable()) {
+                writer_thread_.join();
             }
+            drainRemainingEvents();
+            audit_chain_.close();
         } catch (const std::exception& e) {
             // Ignore cleanup errors
         }
     }
     
-    void cleanupLoop() {
-        while (cleanup_running_) {
-            try {
-                // Clean old events
-                auto now = std::chrono::system_clock::now();
-                auto cutoff = now - retention_period_;
-                
-                std::lock_guard<std::mutex> lock(events_mutex_);
-                security_events_.erase(
-                    std::remove_if(security_events_.begin(), security_events_.end(),
-                        [cutoff](const SecurityEvent& event) {
-                            return event.timestamp < cutoff;
-                        }),
-                    security_events_.end()
-                );
-                
-                // Clean old rate limits
-                std::lock_guard<std::mutex> rate_lock(rate_limit_mutex_);
-                for (auto it = rate_limits_.begin(); it != rate_limits_.end();) {
-                    if (it->second.blockExpiry < now) {
-                        it = rate_limits_.erase(it);
-                    } else {
-                        ++it;
-                    }
-                }
-                
-            } catch (const std::exception& e) {
-                // Continue cleanup loop even on errors
-            }
+    void runCleanup() {
+        try {
+            // Clean old events
+            auto now = std::chrono::system_clock::now();
+            auto cutoff = now - retention_period_;
             
-            std::this_thread::sleep_for(std::chrono::minutes(5));
+            event_store_.pruneOlderThan(cutoff);
+            
+            // Clean old rate limits (entries also expire lazily on access)
+            rate_limiter_.sweepExpired();
+            
+        } catch (const std::exception& e) {
+            // Retried on the next run
         }
     }
     
@@ -1322,46 +1323,18 @@ private:
     }
     
     std::string calculateFileHash(const std::string& filePath) const {
-        try {
-            std::ifstream file(filePath, std::ios::binary);
-            if (!file.is_open()) {
-                return "";
-            }
-            
-            std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-            file.close();
-            
-            // Use SHA-256 for file hashing
-            unsigned char hash[SHA256_DIGEST_LENGTH];
-            SHA256_CTX sha256;
-            SHA256_Init(&sha256);
-            SHA256_Update(&sha256, content.c_str(), content.size());
-            SHA256_Final(hash, &sha256);
-            
-            std::stringstream ss;
-            for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-                ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
-            }
-            
-            return ss.str();
-        } catch (const std::exception& e) {
-            return "";
-        }
+        // Baselines only live in memory, so the default (fastest) algorithm is safe to use
+        phantomvault::ChecksumEngine engine(1);
+        return engine.hashFile(filePath);
     }
     
     void performEmergencyMemoryCleanup() {
         try {
             // Clear event cache
-            {
-                std::lock_guard<std::mutex> lock(events_mutex_);
-                security_events_.clear();
-            }
+            event_store_.clear();
             
             // Clear rate limit cache
-            {
-                std::lock_guard<std::mutex> lock(rate_limit_mutex_);
-                rate_limits_.clear();
-            }
+            rate_limiter_.clear();
             
             // Clear backup metadata
             {
@@ -1392,6 +1365,9 @@ private:
             if (fs::exists(log_path_)) {
                 fs::copy_file(log_path_, emergency_backup_path + "/security.log");
             }
+            if (fs::exists(log_path_ + ".checkpoints")) {
+                fs::copy_file(log_path_ + ".checkpoints", emergency_backup_path + "/security.log.checkpoints");
+            }
             
         } catch (const std::exception& e) {
             // Emergency backup failure should not crash system
@@ -1439,28 +1415,11 @@ private:
         return sanitized;
     }
     
-    void createLogIntegrityChecksum() {
+    void runConfigurationCheck() {
         try {
-            std::string checksum = calculateFileHash(log_path_);
-            if (!checksum.empty()) {
-                std::string checksum_file = log_path_ + ".checksum";
-                std::ofstream file(checksum_file);
-                file << checksum;
-                file.close();
-            }
+            validateConfigurationIntegrity();
         } catch (const std::exception& e) {
-            // Checksum creation failure should not crash system
-        }
-    }
-    
-    void configurationMonitoringLoop() {
-        while (config_monitoring_running_) {
-            try {
-                validateConfigurationIntegrity();
-                std::this_thread::sleep_for(std::chrono::seconds(30));
-            } catch (const std::exception& e) {
-                // Continue monitoring even on errors
-            }
+            // Retried on the next run
         }
     }
     
@@ -1551,6 +1510,10 @@ void ErrorHandler::cleanupBackups(const std::string& profileId, std::chrono::hou
     pimpl->cleanupBackups(profileId, maxAge);
 }
 
+void ErrorHandler::setBackupIOLimit(size_t max_bytes_per_second) {
+    pimpl->setBackupIOLimit(max_bytes_per_second);
+}
+
 void ErrorHandler::exportAuditLog(const std::string& filePath, const std::string& profileId) const {
     pimpl->exportAuditLog(filePath, profileId);
 }
@@ -1563,6 +1526,22 @@ void ErrorHandler::setCriticalErrorCallback(std::function<void(const SecurityEve
     pimpl->setCriticalErrorCallback(callback);
 }
 
+void ErrorHandler::setOverflowPolicy(OverflowPolicy policy) {
+    pimpl->setOverflowPolicy(policy);
+}
+
+void ErrorHandler::setOverflowSampleRate(uint32_t oneInN) {
+    pimpl->setOverflowSampleRate(oneInN);
+}
+
+void ErrorHandler::setOverflowBlockTimeout(std::chrono::milliseconds timeout) {
+    pimpl->setOverflowBlockTimeout(timeout);
+}
+
+EventQueueStats ErrorHandler::getIngestionStats() const {
+    return pimpl->getIngestionStats();
+}
+
 size_t ErrorHandler::getEventCount(SecurityEventType type) const {
     return pimpl->getEventCount(type);
 }
@@ -0,0 +1,716 @@
+/**
+ * PhantomVault Folder Index Implementation
+ */
+
+#include "folder_index.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace phantomvault {
+
+namespace {
+
+constexpr char kIndexMagic[8] = {'P', 'V', 'F', 'I', 'D', 'X', '0', '1'};
+constexpr uint32_t kIndexVersion = 1;
+constexpr uint64_t kEmptySlot = 0;
+constexpr uint64_t kTombstone = 1;
+constexpr uint32_t kMinSlots = 64;
+constexpr size_t kMinGrowth = 64 * 1024;
+
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t slotCount;         // power of two
+    uint64_t generation;        // 0 while an update is in flight
+    uint64_t entryCount;
+    uint64_t tombstoneCount;
+    uint64_t recordsEnd;        // file offset just past the last record
+    uint64_t deadBytes;
+    uint64_t reserved;
+};
+static_assert(sizeof(IndexHeader) == 64, "IndexHeader must stay 64 bytes");
+
+struct IndexSlot {
+    uint64_t hash;              // kEmptySlot, kTombstone, or identifier hash
+    uint64_t recordOffset;
+};
+static_assert(sizeof(IndexSlot) == 16, "IndexSlot must stay 16 bytes");
+
+// FNV-1a, remapped so real hashes never collide with the slot markers
+uint64_t hashIdentifier(const std::string& identifier) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : identifier) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash < 2 ? hash + 2 : hash;
+}
+
+uint32_t slotCountFor(size_t entries) {
+    uint32_t slots = kMinSlots;
+    while (slots < entries * 2) {
+        slots <<= 1;
+    }
+    return slots;
+}
+
+int64_t toMillis(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromMillis(int64_t millis) {
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(millis));
+}
+
+class RecordWriter {
+public:
+    explicit RecordWriter(std::string& out) : out_(out) {}
+
+    template<typename T>
+    void put(T value) {
+        out_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void putString(const std::string& value) {
+        put<uint32_t>(static_cast<uint32_t>(value.size()));
+        out_.append(value);
+    }
+
+private:
+    std::string& out_;
+};
+
+class RecordReader {
+public:
+    RecordReader(const uint8_t* data, size_t size) : cursor_(data), end_(data + size) {}
+
+    template<typename T>
+    T get() {
+        T value{};
+        if (static_cast<size_t>(end_ - cursor_) < sizeof(T)) {
+            ok_ = false;
+            return value;
+        }
+        std::memcpy(&value, cursor_, sizeof(T));
+        cursor_ += sizeof(T);
+        return value;
+    }
+
+    std::string getString() {
+        uint32_t length = get<uint32_t>();
+        if (!ok_ || static_cast<size_t>(end_ - cursor_) < length) {
+            ok_ = false;
+            return {};
+        }
+        std::string value(reinterpret_cast<const char*>(cursor_), length);
+        cursor_ += length;
+        return value;
+    }
+
+    // Compare the next string without materializing it
+    bool matchString(const std::string& expected) {
+        uint32_t length = get<uint32_t>();
+        if (!ok_ || length != expected.size() || static_cast<size_t>(end_ - cursor_) < length) {
+            return false;
+        }
+        bool match = std::memcmp(cursor_, expected.data(), length) == 0;
+        cursor_ += length;
+        return match;
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    const uint8_t* cursor_;
+    const uint8_t* end_;
+    bool ok_ = true;
+};
+
+/**
+ * Record: u32 length | identifier | stamp | fixed fields | strings | xattrs | decoys
+ */
+std::string encodeRecord(const std::string& identifier, const FolderMetadata& metadata,
+                         const FolderIndex::SourceStamp& stamp) {
+    std::string out;
+    RecordWriter writer(out);
+    writer.put<uint32_t>(0); // patched below
+    writer.putString(identifier);
+    writer.put<int64_t>(stamp.modifiedNs);
+    writer.put<uint64_t>(stamp.size);
+    writer.put<int64_t>(toMillis(metadata.created_time));
+    writer.put<int64_t>(toMillis(metadata.modified_time));
+    writer.put<int64_t>(toMillis(metadata.accessed_time));
+    writer.put<uint32_t>(metadata.permissions);
+    writer.put<uint8_t>(metadata.was_hidden ? 1 : 0);
+    writer.putString(metadata.original_path);
+    writer.putString(metadata.encrypted_path_hash);
+    writer.putString(metadata.owner);
+    writer.putString(metadata.group);
+    writer.putString(metadata.original_location);
+    writer.putString(metadata.obfuscation_salt);
+    writer.put<uint32_t>(static_cast<uint32_t>(metadata.extended_attributes.size()));
+    for (const auto& attr : metadata.extended_attributes) {
+        writer.putString(attr.first);
+        writer.putString(attr.second);
+    }
+    writer.put<uint32_t>(static_cast<uint32_t>(metadata.decoy_paths.size()));
+    for (const auto& decoy : metadata.decoy_paths) {
+        writer.putString(decoy);
+    }
+
+    uint32_t length = static_cast<uint32_t>(out.size());
+    std::memcpy(&out[0], &length, sizeof(length));
+    return out;
+}
+
+bool decodeRecord(const uint8_t* data, size_t available, FolderIndex::Entry& entry) {
+    RecordReader reader(data, available);
+    uint32_t length = reader.get<uint32_t>();
+    if (!reader.ok() || length < sizeof(uint32_t) || length > available) {
+        return false;
+    }
+
+    RecordReader record(data + sizeof(uint32_t), length - sizeof(uint32_t));
+    FolderMetadata& metadata = entry.metadata;
+    entry.identifier = record.getString();
+    entry.stamp.modifiedNs = record.get<int64_t>();
+    entry.stamp.size = record.get<uint64_t>();
+    metadata.created_time = fromMillis(record.get<int64_t>());
+    metadata.modified_time = fromMillis(record.get<int64_t>());
+    metadata.accessed_time = fromMillis(record.get<int64_t>());
+    metadata.permissions = record.get<uint32_t>();
+    metadata.was_hidden = record.get<uint8_t>() != 0;
+    metadata.original_path = record.getString();
+    metadata.encrypted_path_hash = record.getString();
+    metadata.owner = record.getString();
+    metadata.group = record.getString();
+    metadata.original_location = record.getString();
+    metadata.obfuscation_salt = record.getString();
+
+    uint32_t attrCount = record.get<uint32_t>();
+    for (uint32_t i = 0; i < attrCount && record.ok(); ++i) {
+        std::string name = record.getString();
+        metadata.extended_attributes[name] = record.getString();
+    }
+    uint32_t decoyCount = record.get<uint32_t>();
+    for (uint32_t i = 0; i < decoyCount && record.ok(); ++i) {
+        metadata.decoy_paths.push_back(record.getString());
+    }
+
+    metadata.obfuscated_identifier = entry.identifier;
+    return record.ok();
+}
+
+} // namespace
+
+class FolderIndex::Implementation {
+public:
+    Implementation() = default;
+
+    ~Implementation() {
+        close();
+    }
+
+    bool open(const std::string& path) {
+        close();
+        path_ = path;
+
+        if (!mapFile()) {
+            return false;
+        }
+
+        const IndexHeader* head = header();
+        uint64_t slotsEnd = sizeof(IndexHeader) + static_cast<uint64_t>(head->slotCount) * sizeof(IndexSlot);
+        bool valid = std::memcmp(head->magic, kIndexMagic, sizeof(kIndexMagic)) == 0 &&
+                     head->version == kIndexVersion &&
+                     head->slotCount >= kMinSlots &&
+                     (head->slotCount & (head->slotCount - 1)) == 0 &&
+                     slotsEnd <= head->recordsEnd &&
+                     head->recordsEnd <= mapped_size_ &&
+                     head->generation != 0;
+        if (!valid) {
+            last_error_ = "Folder index is corrupt or was interrupted: " + path;
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        unmapFile();
+    }
+
+    bool isOpen() const {
+        return base_ != nullptr;
+    }
+
+    uint64_t getGeneration() const {
+        return isOpen() ? header()->generation : 0;
+    }
+
+    size_t size() const {
+        return isOpen() ? static_cast<size_t>(header()->entryCount) : 0;
+    }
+
+    size_t getMappedBytes() const {
+        return isOpen() ? mapped_size_ : 0;
+    }
+
+    size_t getDeadBytes() const {
+        return isOpen() ? static_cast<size_t>(header()->deadBytes) : 0;
+    }
+
+    std::optional<FolderMetadata> lookup(const std::string& identifier) const {
+        int64_t slot = findSlot(identifier, hashIdentifier(identifier));
+        if (slot < 0) {
+            return std::nullopt;
+        }
+        Entry entry;
+        if (!decodeAt(slots()[slot].recordOffset, entry)) {
+            return std::nullopt;
+        }
+        return std::move(entry.metadata);
+    }
+
+    std::optional<SourceStamp> lookupStamp(const std::string& identifier) const {
+        int64_t slot = findSlot(identifier, hashIdentifier(identifier));
+        if (slot < 0) {
+            return std::nullopt;
+        }
+        Entry entry;
+        if (!decodeAt(slots()[slot].recordOffset, entry)) {
+            return std::nullopt;
+        }
+        return entry.stamp;
+    }
+
+    bool contains(const std::string& identifier) const {
+        return findSlot(identifier, hashIdentifier(identifier)) >= 0;
+    }
+
+    void forEachIdentifier(const std::function<void(const std::string&)>& callback) const {
+        if (!isOpen()) {
+            return;
+        }
+        const IndexSlot* table = slots();
+        for (uint32_t i = 0; i < header()->slotCount; ++i) {
+            if (table[i].hash < 2) {
+                continue;
+            }
+            RecordReader reader(base_ + table[i].recordOffset + sizeof(uint32_t),
+                                mapped_size_ - table[i].recordOffset - sizeof(uint32_t));
+            std::string identifier = reader.getString();
+            if (reader.ok()) {
+                callback(identifier);
+            }
+        }
+    }
+
+    bool put(const std::string& identifier, const FolderMetadata& metadata,
+             const SourceStamp& stamp, uint64_t generation) {
+        if (!isOpen()) {
+            last_error_ = "Folder index is not open";
+            return false;
+        }
+
+        uint64_t hash = hashIdentifier(identifier);
+        int64_t existing = findSlot(identifier, hash);
+
+        // Keep the load factor at or below 0.7; growing means a fresh file
+        IndexHeader* head = header();
+        if (existing < 0 && (head->entryCount + head->tombstoneCount + 1) * 10 > head->slotCount * 7ULL) {
+            std::vector<Entry> entries = collectEntries();
+            entries.push_back(Entry{identifier, metadata, stamp});
+            return rewrite(path_, entries, generation);
+        }
+
+        std::string record = encodeRecord(identifier, metadata, stamp);
+        if (!ensureCapacity(header()->recordsEnd + record.size())) {
+            return false;
+        }
+
+        head = header();
+        head->generation = 0;
+        uint64_t offset = head->recordsEnd;
+        std::memcpy(base_ + offset, record.data(), record.size());
+
+        IndexSlot* table = slots();
+        if (existing >= 0) {
+            head->deadBytes += recordLength(table[existing].recordOffset);
+            table[existing].recordOffset = offset;
+        } else {
+            uint64_t mask = head->slotCount - 1;
+            uint64_t position = hash & mask;
+            while (table[position].hash >= 2) {
+                position = (position + 1) & mask;
+            }
+            if (table[position].hash == kTombstone) {
+                head->tombstoneCount--;
+            }
+            table[position].hash = hash;
+            table[position].recordOffset = offset;
+            head->entryCount++;
+        }
+
+        head->recordsEnd = offset + record.size();
+        head->generation = generation;
+        return persist();
+    }
+
+    bool erase(const std::string& identifier, uint64_t generation) {
+        if (!isOpen()) {
+            last_error_ = "Folder index is not open";
+            return false;
+        }
+
+        int64_t slot = findSlot(identifier, hashIdentifier(identifier));
+        IndexHeader* head = header();
+        head->generation = 0;
+        if (slot >= 0) {
+            IndexSlot& entry = slots()[slot];
+            head->deadBytes += recordLength(entry.recordOffset);
+            entry.hash = kTombstone;
+            entry.recordOffset = 0;
+            head->entryCount--;
+            head->tombstoneCount++;
+        }
+        head->generation = generation;
+        return persist();
+    }
+
+    bool rewrite(const std::string& path, const std::vector<Entry>& entries, uint64_t generation) {
+        try {
+            uint32_t slotCount = slotCountFor(entries.size());
+            size_t recordsStart = sizeof(IndexHeader) + static_cast<size_t>(slotCount) * sizeof(IndexSlot);
+
+            std::string image(recordsStart, '\0');
+            IndexSlot* table = reinterpret_cast<IndexSlot*>(&image[sizeof(IndexHeader)]);
+            uint64_t mask = slotCount - 1;
+            uint64_t entryCount = 0;
+
+            for (const auto& entry : entries) {
+                std::string record = encodeRecord(entry.identifier, entry.metadata, entry.stamp);
+                uint64_t offset = image.size();
+                uint64_t hash = hashIdentifier(entry.identifier);
+
+                // image may reallocate, so resolve the table after appending
+                image.append(record);
+                table = reinterpret_cast<IndexSlot*>(&image[sizeof(IndexHeader)]);
+
+                uint64_t position = hash & mask;
+                while (table[position].hash != kEmptySlot) {
+                    position = (position + 1) & mask;
+                }
+                table[position].hash = hash;
+                table[position].recordOffset = offset;
+                entryCount++;
+            }
+
+            IndexHeader head{};
+            std::memcpy(head.magic, kIndexMagic, sizeof(kIndexMagic));
+            head.version = kIndexVersion;
+            head.slotCount = slotCount;
+            head.generation = generation;
+            head.entryCount = entryCount;
+            head.recordsEnd = image.size();
+            std::memcpy(&image[0], &head, sizeof(head));
+
+            std::string tempPath = path + ".tmp";
+            {
+                std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+                out.write(image.data(), static_cast<std::streamsize>(image.size()));
+                out.flush();
+                if (!out) {
+                    last_error_ = "Failed to write folder index: " + tempPath;
+                    return false;
+                }
+            }
+            fs::permissions(tempPath, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace);
+            fs::rename(tempPath, path);
+            return open(path);
+
+        } catch (const std::exception& e) {
+            last_error_ = "Failed to rewrite folder index: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    bool compact() {
+        if (!isOpen()) {
+            return true;
+        }
+        uint64_t generation = header()->generation;
+        std::vector<Entry> entries = collectEntries();
+        return rewrite(path_, entries, generation);
+    }
+
+    std::string getLastError() const {
+        return last_error_;
+    }
+
+private:
+    std::string path_;
+    uint8_t* base_ = nullptr;
+    size_t mapped_size_ = 0;
+    mutable std::string last_error_;
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    int fd_ = -1;
+#else
+    std::vector<uint8_t> buffer_;
+#endif
+
+    IndexHeader* header() const {
+        return reinterpret_cast<IndexHeader*>(base_);
+    }
+
+    IndexSlot* slots() const {
+        return reinterpret_cast<IndexSlot*>(base_ + sizeof(IndexHeader));
+    }
+
+    uint32_t recordLength(uint64_t offset) const {
+        uint32_t length = 0;
+        if (offset + sizeof(length) <= mapped_size_) {
+            std::memcpy(&length, base_ + offset, sizeof(length));
+        }
+        return length;
+    }
+
+    bool decodeAt(uint64_t offset, Entry& entry) const {
+        if (offset >= header()->recordsEnd) {
+            return false;
+        }
+        return decodeRecord(base_ + offset, static_cast<size_t>(header()->recordsEnd - offset), entry);
+    }
+
+    int64_t findSlot(const std::string& identifier, uint64_t hash) const {
+        if (!isOpen()) {
+            return -1;
+        }
+        const IndexSlot* table = slots();
+        uint64_t mask = header()->slotCount - 1;
+        uint64_t position = hash & mask;
+
+        for (uint32_t probe = 0; probe < header()->slotCount; ++probe) {
+            const IndexSlot& slot = table[position];
+            if (slot.hash == kEmptySlot) {
+                return -1;
+            }
+            if (slot.hash == hash && slot.recordOffset + sizeof(uint32_t) < header()->recordsEnd) {
+                RecordReader reader(base_ + slot.recordOffset + sizeof(uint32_t),
+                                    static_cast<size_t>(header()->recordsEnd - slot.recordOffset - sizeof(uint32_t)));
+                if (reader.matchString(identifier)) {
+                    return static_cast<int64_t>(position);
+                }
+            }
+            position = (position + 1) & mask;
+        }
+        return -1;
+    }
+
+    std::vector<Entry> collectEntries() const {
+        std::vector<Entry> entries;
+        entries.reserve(size());
+        const IndexSlot* table = slots();
+        for (uint32_t i = 0; i < header()->slotCount; ++i) {
+            if (table[i].hash < 2) {
+                continue;
+            }
+            Entry entry;
+            if (decodeAt(table[i].recordOffset, entry)) {
+                entries.push_back(std::move(entry));
+            }
+        }
+        return entries;
+    }
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    bool mapFile() {
+        fd_ = ::open(path_.c_str(), O_RDWR | O_CLOEXEC);
+        if (fd_ < 0) {
+            last_error_ = "Folder index not found: " + path_;
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(IndexHeader)) {
+            last_error_ = "Folder index is truncated: " + path_;
+            unmapFile();
+            return false;
+        }
+
+        return mapRegion(static_cast<size_t>(st.st_size));
+    }
+
+    bool mapRegion(size_t size) {
+        void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (region == MAP_FAILED) {
+            last_error_ = "Failed to map folder index: " + path_;
+            unmapFile();
+            return false;
+        }
+        base_ = static_cast<uint8_t*>(region);
+        mapped_size_ = size;
+        return true;
+    }
+
+    void unmapFile() {
+        if (base_) {
+            munmap(base_, mapped_size_);
+            base_ = nullptr;
+            mapped_size_ = 0;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    bool ensureCapacity(uint64_t required) {
+        if (required <= mapped_size_) {
+            return true;
+        }
+        size_t newSize = std::max<size_t>({static_cast<size_t>(required), mapped_size_ + mapped_size_ / 2,
+                                           mapped_size_ + kMinGrowth});
+        if (ftruncate(fd_, static_cast<off_t>(newSize)) != 0) {
+            last_error_ = "Failed to grow folder index: " + path_;
+            return false;
+        }
+        munmap(base_, mapped_size_);
+        base_ = nullptr;
+        return mapRegion(newSize);
+    }
+
+    bool persist() {
+        msync(base_, mapped_size_, MS_ASYNC);
+        return true;
+    }
+#else
+    // No mmap here: keep the image in memory and write it back after updates
+    bool mapFile() {
+        std::ifstream in(path_, std::ios::binary | std::ios::ate);
+        if (!in) {
+            last_error_ = "Folder index not found: " + path_;
+            return false;
+        }
+        size_t size = static_cast<size_t>(in.tellg());
+        if (size < sizeof(IndexHeader)) {
+            last_error_ = "Folder index is truncated: " + path_;
+            return false;
+        }
+        buffer_.resize(size);
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(size));
+        base_ = buffer_.data();
+        mapped_size_ = size;
+        return true;
+    }
+
+    void unmapFile() {
+        buffer_.clear();
+        buffer_.shrink_to_fit();
+        base_ = nullptr;
+        mapped_size_ = 0;
+    }
+
+    bool ensureCapacity(uint64_t required) {
+        if (required > mapped_size_) {
+            buffer_.resize(static_cast<size_t>(std::max<uint64_t>(required, mapped_size_ + kMinGrowth)));
+            base_ = buffer_.data();
+            mapped_size_ = buffer_.size();
+        }
+        return true;
+    }
+
+    bool persist() {
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(base_), static_cast<std::streamsize>(mapped_size_));
+        if (!out) {
+            last_error_ = "Failed to write folder index: " + path_;
+            return false;
+        }
+        return true;
+    }
+#endif
+};
+
+FolderIndex::FolderIndex() : pimpl(std::make_unique<Implementation>()) {}
+FolderIndex::~FolderIndex() = default;
+
+bool FolderIndex::open(const std::string& path) {
+    return pimpl->open(path);
+}
+
+void FolderIndex::close() {
+    pimpl->close();
+}
+
+bool FolderIndex::isOpen() const {
+    return pimpl->isOpen();
+}
+
+uint64_t FolderIndex::getGeneration() const {
+    return pimpl->getGeneration();
+}
+
+size_t FolderIndex::size() const {
+    return pimpl->size();
+}
+
+size_t FolderIndex::getMappedBytes() const {
+    return pimpl->getMappedBytes();
+}
+
+size_t FolderIndex::getDeadBytes() const {
+    return pimpl->getDeadBytes();
+}
+
+std::optional<FolderMetadata> FolderIndex::lookup(const std::string& identifier) const {
+    return pimpl->lookup(identifier);
+}
+
+std::optional<FolderIndex::SourceStamp> FolderIndex::lookupStamp(const std::string& identifier) const {
+    return pimpl->lookupStamp(identifier);
+}
+
+bool FolderIndex::contains(const std::string& identifier) const {
+    return pimpl->contains(identifier);
+}
+
+void FolderIndex::forEachIdentifier(const std::function<void(const std::string&)>& callback) const {
+    pimpl->forEachIdentifier(callback);
+}
+
+bool FolderIndex::put(const std::string& identifier, const FolderMetadata& metadata,
+                      const SourceStamp& stamp, uint64_t generation) {
+    return pimpl->put(identifier, metadata, stamp, generation);
+}
+
+bool FolderIndex::erase(const std::string& identifier, uint64_t generation) {
+    return pimpl->erase(identifier, generation);
+}
+
+bool FolderIndex::rewrite(const std::string& path, const std::vector<Entry>& entries, uint64_t generation) {
+    return pimpl->rewrite(path, entries, generation);
+}
+
+bool FolderIndex::compact() {
+    return pimpl->compact();
+}
+
+std::string FolderIndex::getLastError() const {
+    return pimpl->getLastError();
+}
+
+} // namespace phantomvault
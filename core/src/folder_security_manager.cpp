@@ -12,6 +12,7 @@
 #include "profile_vault.hpp"
 #include "privilege_manager.hpp"
 #include "vault_handler.hpp"
+#include "instrumentation.hpp"
 #include <iostream>
 #include <fstream>
 #include <filesystem>
@@ -90,6 +91,7 @@ public:
     FolderOperationResult lockFolder(const std::string& profileId, 
                                    const std::string& folderPath, 
                                    const std::string& masterKey) {
+        TraceSpan span("folder_lock");
         FolderOperationResult result;
         
         try {
@@ -408,6 +410,7 @@ private:
                              const std::string& masterKey, 
                              UnlockMode mode,
                              const std::vector<std::string>& /* specificFolderIds */ = {}) {
+        TraceSpan span("folder_unlock");
         UnlockResult result;
         
         try {
@@ -0,0 +1,653 @@
+/**
+ * PhantomVault Instrumentation Implementation
+ *
+ * Every thread records into its own heap-allocated shard, which only that
+ * thread writes; counters are atomics so readers can merge without stopping
+ * writers, but an increment is a relaxed load and store, never a locked RMW.
+ * The registry of shards is only locked when a thread records for the first
+ * time, when it exits and when someone reads.
+ *
+ * Trace buffers follow the same single-writer rule: a thread appends an
+ * event and then publishes the new count with a release store, so a reader
+ * copies [0, count) while the owner keeps appending. A session is a
+ * generation number; a thread that sees a new one swaps in a fresh buffer
+ * under the session lock, and the old buffer lives on until both the thread
+ * and any reader have let go of it.
+ */
+
+#include "instrumentation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+#ifdef PLATFORM_LINUX
+#include <sys/syscall.h>
+#endif
+
+namespace phantomvault {
+
+namespace {
+
+constexpr const char* kOperationNames[kOperationCount] = {
+    "kdf", "read", "compress", "encrypt", "write", "wipe", "metadata_commit", "ipc_handler"
+};
+
+// Prometheus bucket boundaries, as label text and in nanoseconds
+struct PrometheusBucket {
+    const char* label;
+    uint64_t nanos;
+};
+
+constexpr PrometheusBucket kPrometheusBuckets[] = {
+    {"1e-06", 1000ULL}, {"1e-05", 10000ULL}, {"0.0001", 100000ULL}, {"0.001", 1000000ULL},
+    {"0.005", 5000000ULL}, {"0.01", 10000000ULL}, {"0.05", 50000000ULL}, {"0.1", 100000000ULL},
+    {"0.5", 500000000ULL}, {"1", 1000000000ULL}, {"5", 5000000000ULL}, {"10", 10000000000ULL}
+};
+
+constexpr double kReportedQuantiles[] = {0.5, 0.9, 0.99};
+
+// Exact decimal seconds; a double at stream precision would round long sums
+std::string formatNanosAsSeconds(uint64_t nanos) {
+    char fraction[16];
+    std::snprintf(fraction, sizeof(fraction), ".%09llu", static_cast<unsigned long long>(nanos % 1000000000ULL));
+    return std::to_string(nanos / 1000000000ULL) + fraction;
+}
+
+struct Shard {
+    std::array<std::array<std::atomic<uint64_t>, LatencyHistogram::kBucketCount>, kOperationCount> buckets;
+    std::array<std::atomic<uint64_t>, kOperationCount> counts;
+    std::array<std::atomic<uint64_t>, kOperationCount> sums;
+};
+
+// Single writer: no read-modify-write needed
+inline void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<Shard*> live;
+    std::array<LatencyHistogram, kOperationCount> retired;     // folded in from exited threads
+};
+
+// Never destroyed: threads may still exit while static objects are torn down
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+std::atomic<bool> g_enabled{true};
+
+LatencyHistogram loadShard(const Shard& shard, size_t operation) {
+    std::array<uint64_t, LatencyHistogram::kBucketCount> buckets;
+    for (size_t bucket = 0; bucket < LatencyHistogram::kBucketCount; ++bucket) {
+        buckets[bucket] = shard.buckets[operation][bucket].load(std::memory_order_relaxed);
+    }
+    return LatencyHistogram::fromCounts(buckets, shard.counts[operation].load(std::memory_order_relaxed),
+                                        shard.sums[operation].load(std::memory_order_relaxed));
+}
+
+struct ShardOwner {
+    Shard* shard;
+
+    ShardOwner() : shard(new Shard()) {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.live.push_back(shard);
+    }
+
+    ~ShardOwner() {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (size_t operation = 0; operation < kOperationCount; ++operation) {
+            reg.retired[operation].merge(loadShard(*shard, operation));
+        }
+        reg.live.erase(std::remove(reg.live.begin(), reg.live.end(), shard), reg.live.end());
+        delete shard;
+    }
+};
+
+thread_local ShardOwner t_shard;
+
+// Trace recording
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    uint64_t startNanos;        // since the session epoch
+    uint64_t durationNanos;
+};
+
+struct TraceBuffer {
+    TraceBuffer(uint64_t threadId, size_t eventCapacity, std::chrono::steady_clock::time_point sessionEpoch)
+        : thread(threadId)
+        , capacity(eventCapacity)
+        , epoch(sessionEpoch)
+        , events(new TraceEvent[eventCapacity]) {}
+
+    const uint64_t thread;
+    const size_t capacity;
+    const std::chrono::steady_clock::time_point epoch;
+    std::unique_ptr<TraceEvent[]> events;
+    std::atomic<size_t> count{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+struct TraceSession {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    std::chrono::steady_clock::time_point epoch;
+    size_t eventsPerThread = TraceRecorder::kDefaultEventsPerThread;
+};
+
+// Never destroyed, like the registry
+TraceSession& traceSession() {
+    static TraceSession* instance = new TraceSession();
+    return *instance;
+}
+
+std::atomic<bool> g_recording{false};
+std::atomic<uint64_t> g_trace_generation{0};
+std::atomic<uint64_t> g_next_trace_thread{1};
+
+uint64_t currentThreadId() {
+#ifdef PLATFORM_LINUX
+    return static_cast<uint64_t>(syscall(SYS_gettid));     // matches top, perf and /proc
+#else
+    return g_next_trace_thread.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+struct TraceBufferOwner {
+    uint64_t generation = 0;
+    uint64_t thread = currentThreadId();
+    std::shared_ptr<TraceBuffer> buffer;
+};
+
+thread_local TraceBufferOwner t_trace;
+
+uint64_t processId() {
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    return static_cast<uint64_t>(getpid());
+#else
+    return 1;
+#endif
+}
+
+// Microseconds with nanosecond digits, as the trace format expects
+void appendMicros(std::string& out, uint64_t nanos) {
+    char text[32];
+    int length = std::snprintf(text, sizeof(text), "%llu.%03u",
+                               static_cast<unsigned long long>(nanos / 1000), static_cast<unsigned>(nanos % 1000));
+    out.append(text, static_cast<size_t>(length));
+}
+
+std::vector<std::shared_ptr<TraceBuffer>> sessionBuffers() {
+    TraceSession& session = traceSession();
+    std::lock_guard<std::mutex> lock(session.mutex);
+    return session.buffers;
+}
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+struct TraceSignalState {
+    std::mutex mutex;
+    std::string directory;
+    int pipe[2] = {-1, -1};
+};
+
+TraceSignalState& traceSignalState() {
+    static TraceSignalState* instance = new TraceSignalState();
+    return *instance;
+}
+
+std::atomic<int> g_trace_signal_fd{-1};
+
+// Only write(2) here; the watcher thread does the work
+extern "C" void onTraceSignal(int) {
+    int saved_errno = errno;
+    int fd = g_trace_signal_fd.load(std::memory_order_relaxed);
+    if (fd >= 0) {
+        char byte = 1;
+        ssize_t written = write(fd, &byte, 1);
+        (void)written;
+    }
+    errno = saved_errno;
+}
+
+void toggleTraceFromSignal() {
+    if (!TraceRecorder::isRecording()) {
+        TraceRecorder::start();
+        std::cout << "[TraceRecorder] Recording started" << std::endl;
+        return;
+    }
+
+    TraceRecorder::stop();
+    std::string directory;
+    {
+        TraceSignalState& state = traceSignalState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        directory = state.directory;
+    }
+    auto stamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string path = directory + "/trace-" + std::to_string(stamp) + ".json";
+    if (TraceRecorder::writeChromeTrace(path)) {
+        std::cout << "[TraceRecorder] Wrote " << TraceRecorder::eventCount() << " events to " << path << std::endl;
+    } else {
+        std::cerr << "[TraceRecorder] Failed to write trace: " << path << std::endl;
+    }
+}
+
+void traceSignalLoop(int fd) {
+    for (;;) {
+        char byte;
+        ssize_t received = read(fd, &byte, 1);
+        if (received == 1) {
+            toggleTraceFromSignal();
+        } else if (received < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return;
+        }
+    }
+}
+#endif
+
+} // anonymous namespace
+
+const char* operationName(Operation operation) {
+    size_t index = static_cast<size_t>(operation);
+    return index < kOperationCount ? kOperationNames[index] : "unknown";
+}
+
+// LatencyHistogram
+size_t LatencyHistogram::bucketFor(uint64_t nanos) {
+    constexpr uint64_t kSubBuckets = 1ULL << kSubBucketBits;
+    if (nanos < kSubBuckets) {
+        return static_cast<size_t>(nanos);
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(nanos));
+#else
+    unsigned exponent = 0;
+    while (nanos >> (exponent + 1)) {
+        ++exponent;
+    }
+#endif
+    if (exponent > kMaxExponent) {
+        return kBucketCount - 1;
+    }
+    unsigned shift = exponent - kSubBucketBits;
+    return static_cast<size_t>(((shift + 1) << kSubBucketBits) + ((nanos >> shift) & (kSubBuckets - 1)));
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t bucket) {
+    constexpr uint64_t kSubBuckets = 1ULL << kSubBucketBits;
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    unsigned shift = static_cast<unsigned>(bucket >> kSubBucketBits) - 1;
+    return (kSubBuckets + (bucket & (kSubBuckets - 1))) << shift;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t bucket) {
+    constexpr uint64_t kSubBuckets = 1ULL << kSubBucketBits;
+    if (bucket < kSubBuckets) {
+        return bucket + 1;
+    }
+    unsigned shift = static_cast<unsigned>(bucket >> kSubBucketBits) - 1;
+    return bucketLowerBound(bucket) + (1ULL << shift);
+}
+
+LatencyHistogram LatencyHistogram::fromCounts(const std::array<uint64_t, kBucketCount>& buckets, uint64_t count,
+                                              uint64_t sumNanos) {
+    LatencyHistogram histogram;
+    histogram.buckets_ = buckets;
+    histogram.count_ = count;
+    histogram.sum_ = sumNanos;
+    return histogram;
+}
+
+void LatencyHistogram::record(uint64_t nanos) {
+    buckets_[bucketFor(nanos)]++;
+    count_++;
+    sum_ += nanos;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+        buckets_[bucket] += other.buckets_[bucket];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+}
+
+void LatencyHistogram::clear() {
+    buckets_.fill(0);
+    count_ = 0;
+    sum_ = 0;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * count_)));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+        seen += buckets_[bucket];
+        if (seen >= target) {
+            return bucketUpperBound(bucket) - 1;
+        }
+    }
+    return bucketUpperBound(kBucketCount - 1) - 1;
+}
+
+// Instrumentation
+void Instrumentation::record(Operation operation, std::chrono::nanoseconds elapsed) {
+    size_t index = static_cast<size_t>(operation);
+    if (index >= kOperationCount) {
+        return;
+    }
+    uint64_t nanos = static_cast<uint64_t>(std::max<int64_t>(0, elapsed.count()));
+    Shard& shard = *t_shard.shard;
+    bump(shard.buckets[index][LatencyHistogram::bucketFor(nanos)], 1);
+    bump(shard.counts[index], 1);
+    bump(shard.sums[index], nanos);
+}
+
+LatencyHistogram Instrumentation::snapshot(Operation operation) {
+    size_t index = static_cast<size_t>(operation);
+    LatencyHistogram merged;
+    if (index >= kOperationCount) {
+        return merged;
+    }
+
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    merged = reg.retired[index];
+    for (const Shard* shard : reg.live) {
+        merged.merge(loadShard(*shard, index));
+    }
+    return merged;
+}
+
+std::string Instrumentation::prometheusText() {
+    std::ostringstream out;
+    out << "# HELP phantomvault_operation_duration_seconds Latency of vault operations\n";
+    out << "# TYPE phantomvault_operation_duration_seconds histogram\n";
+
+    std::array<LatencyHistogram, kOperationCount> histograms;
+    for (size_t index = 0; index < kOperationCount; ++index) {
+        histograms[index] = snapshot(static_cast<Operation>(index));
+    }
+
+    for (size_t index = 0; index < kOperationCount; ++index) {
+        const LatencyHistogram& histogram = histograms[index];
+        std::string label = std::string("operation=\"") + kOperationNames[index] + "\"";
+
+        // Cumulative; a fine bucket counts toward a boundary once it ends at or below it
+        size_t bucket = 0;
+        uint64_t cumulative = 0;
+        for (const auto& boundary : kPrometheusBuckets) {
+            while (bucket < LatencyHistogram::kBucketCount &&
+                   LatencyHistogram::bucketUpperBound(bucket) <= boundary.nanos) {
+                cumulative += histogram.bucketCount(bucket++);
+            }
+            out << "phantomvault_operation_duration_seconds_bucket{" << label << ",le=\"" << boundary.label
+                << "\"} " << cumulative << "\n";
+        }
+        out << "phantomvault_operation_duration_seconds_bucket{" << label << ",le=\"+Inf\"} " << histogram.count() << "\n";
+        out << "phantomvault_operation_duration_seconds_sum{" << label << "} " << formatNanosAsSeconds(histogram.sumNanos()) << "\n";
+        out << "phantomvault_operation_duration_seconds_count{" << label << "} " << histogram.count() << "\n";
+    }
+
+    out << "# HELP phantomvault_operation_duration_quantile_seconds Latency quantiles, within 6.25%\n";
+    out << "# TYPE phantomvault_operation_duration_quantile_seconds gauge\n";
+    for (size_t index = 0; index < kOperationCount; ++index) {
+        for (double quantile : kReportedQuantiles) {
+            out << "phantomvault_operation_duration_quantile_seconds{operation=\"" << kOperationNames[index]
+                << "\",quantile=\"" << quantile << "\"} " << histograms[index].percentile(quantile) / 1e9 << "\n";
+        }
+    }
+    return out.str();
+}
+
+void Instrumentation::setEnabled(bool enabled) {
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Instrumentation::isEnabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void Instrumentation::reset() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& histogram : reg.retired) {
+        histogram.clear();
+    }
+    // Racing increments from the owners may survive; good enough for a reset
+    for (Shard* shard : reg.live) {
+        for (size_t index = 0; index < kOperationCount; ++index) {
+            for (auto& counter : shard->buckets[index]) {
+                counter.store(0, std::memory_order_relaxed);
+            }
+            shard->counts[index].store(0, std::memory_order_relaxed);
+            shard->sums[index].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+// ScopedSpan
+ScopedSpan::ScopedSpan(Operation operation)
+    : operation_(operation)
+    , active_(Instrumentation::isEnabled())
+    , tracing_(TraceRecorder::isRecording()) {
+    if (active_ || tracing_) {
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+ScopedSpan::~ScopedSpan() {
+    if (active_ || tracing_) {
+        auto end = std::chrono::steady_clock::now();
+        if (active_) {
+            Instrumentation::record(operation_, end - start_);
+        }
+        if (tracing_) {
+            TraceRecorder::record(operationName(operation_), "operation", start_, end);
+        }
+    }
+}
+
+// TraceRecorder
+void TraceRecorder::start(size_t eventsPerThread) {
+    TraceSession& session = traceSession();
+    std::lock_guard<std::mutex> lock(session.mutex);
+    session.buffers.clear();
+    session.eventsPerThread = std::max<size_t>(1, eventsPerThread);
+    session.epoch = std::chrono::steady_clock::now();
+    g_trace_generation.fetch_add(1, std::memory_order_release);
+    g_recording.store(true, std::memory_order_release);
+}
+
+void TraceRecorder::stop() {
+    g_recording.store(false, std::memory_order_release);
+}
+
+bool TraceRecorder::isRecording() {
+    return g_recording.load(std::memory_order_relaxed);
+}
+
+void TraceRecorder::record(const char* name, const char* category,
+                           std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    if (!g_recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    TraceBufferOwner& owner = t_trace;
+    if (owner.generation != g_trace_generation.load(std::memory_order_acquire)) {
+        TraceSession& session = traceSession();
+        std::lock_guard<std::mutex> lock(session.mutex);
+        owner.buffer = std::make_shared<TraceBuffer>(owner.thread, session.eventsPerThread, session.epoch);
+        owner.generation = g_trace_generation.load(std::memory_order_relaxed);
+        session.buffers.push_back(owner.buffer);
+    }
+
+    TraceBuffer& buffer = *owner.buffer;
+    size_t index = buffer.count.load(std::memory_order_relaxed);
+    if (index == buffer.capacity) {
+        bump(buffer.dropped, 1);
+        return;
+    }
+
+    // Spans already open when the session started are clipped to its epoch
+    auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(start - buffer.epoch).count();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    buffer.events[index] = {name, category,
+                            static_cast<uint64_t>(std::max<int64_t>(0, since_epoch)),
+                            static_cast<uint64_t>(std::max<int64_t>(0, duration + std::min<int64_t>(0, since_epoch)))};
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+size_t TraceRecorder::eventCount() {
+    size_t total = 0;
+    for (const auto& buffer : sessionBuffers()) {
+        total += buffer->count.load(std::memory_order_acquire);
+    }
+    return total;
+}
+
+uint64_t TraceRecorder::droppedCount() {
+    uint64_t total = 0;
+    for (const auto& buffer : sessionBuffers()) {
+        total += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+std::string TraceRecorder::chromeTraceJson() {
+    auto buffers = sessionBuffers();
+    std::string pid = std::to_string(processId());
+
+    uint64_t dropped = 0;
+    size_t total = 0;
+    for (const auto& buffer : buffers) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+        total += buffer->count.load(std::memory_order_acquire);
+    }
+
+    std::string out;
+    out.reserve(128 + total * 96);
+    out += "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":";
+    out += std::to_string(dropped);
+    out += "},\"traceEvents\":[{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":";
+    out += pid;
+    out += ",\"tid\":0,\"args\":{\"name\":\"phantomvault\"}}";
+
+    for (const auto& buffer : buffers) {
+        std::string tid = std::to_string(buffer->thread);
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t index = 0; index < count; ++index) {
+            const TraceEvent& event = buffer->events[index];
+            out += ",\n{\"name\":\"";
+            out += event.name;
+            out += "\",\"cat\":\"";
+            out += event.category;
+            out += "\",\"ph\":\"X\",\"ts\":";
+            appendMicros(out, event.startNanos);
+            out += ",\"dur\":";
+            appendMicros(out, event.durationNanos);
+            out += ",\"pid\":";
+            out += pid;
+            out += ",\"tid\":";
+            out += tid;
+            out += "}";
+        }
+    }
+    out += "]}\n";
+    return out;
+}
+
+bool TraceRecorder::writeChromeTrace(const std::string& path) {
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    std::string json = chromeTraceJson();
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    return static_cast<bool>(file);
+}
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+bool TraceRecorder::installSignalHandler(const std::string& directory) {
+    TraceSignalState& state = traceSignalState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.directory = directory;
+    if (state.pipe[0] >= 0) {
+        return true;
+    }
+
+    if (::pipe(state.pipe) != 0) {
+        return false;
+    }
+    for (int fd : state.pipe) {
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    // A burst of signals must never block the handler
+    fcntl(state.pipe[1], F_SETFL, fcntl(state.pipe[1], F_GETFL) | O_NONBLOCK);
+    g_trace_signal_fd.store(state.pipe[1], std::memory_order_relaxed);
+
+    std::thread(traceSignalLoop, state.pipe[0]).detach();
+
+    struct sigaction action {};
+    action.sa_handler = onTraceSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    return sigaction(SIGUSR2, &action, nullptr) == 0;
+}
+#else
+bool TraceRecorder::installSignalHandler(const std::string& /* directory */) {
+    return false;
+}
+#endif
+
+// TraceSpan
+TraceSpan::TraceSpan(const char* name, const char* category)
+    : name_(name)
+    , category_(category)
+    , active_(TraceRecorder::isRecording()) {
+    if (active_) {
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+TraceSpan::~TraceSpan() {
+    if (active_) {
+        TraceRecorder::record(name_, category_, start_, std::chrono::steady_clock::now());
+    }
+}
+
+} // namespace phantomvault
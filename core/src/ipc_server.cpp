@@ -10,6 +10,8 @@
 #include "folder_security_manager.hpp"
 #include "keyboard_sequence_detector.hpp"
 #include "analytics_engine.hpp"
+#include "performance_monitor.hpp"
+#include "instrumentation.hpp"
 
 #include <iostream>
 #include <thread>
@@ -56,6 +58,7 @@ public:
         , folder_security_manager_(nullptr)
         , keyboard_sequence_detector_(nullptr)
         , analytics_engine_(nullptr)
+        , performance_monitor_(nullptr)
     {}
     
     ~Implementation() {
@@ -148,6 +151,8 @@ public:
             closesocket(server_socket_);
             WSACleanup();
             #else
+            // close() alone does not wake a thread blocked in accept() on Linux
+            shutdown(server_socket_, SHUT_RDWR);
             close(server_socket_);
             #endif
             server_socket_ = -1;
@@ -180,6 +185,10 @@ public:
         analytics_engine_ = engine;
     }
     
+    void setPerformanceMonitor(PerformanceMonitor* monitor) {
+        performance_monitor_ = monitor;
+    }
+    
     void registerRoute(const std::string& method, const std::string& path, RequestHandler handler) {
         std::lock_guard<std::mutex> lock(routes_mutex_);
         std::string key = method + ":" + path;
@@ -214,6 +223,7 @@ private:
     FolderSecurityManager* folder_security_manager_;
     KeyboardSequenceDetector* keyboard_sequence_detector_;
     AnalyticsEngine* analytics_engine_;
+    PerformanceMonitor* performance_monitor_;
     
     void serverLoop() {
         std::cout << "[IPCServer] Server loop started" << std::endl;
@@ -391,6 +401,7 @@ private:
     }
     
     HttpResponse handleRoute(const HttpRequest& request) {
+        ScopedSpan span(Operation::IPC_HANDLER);
         std::lock_guard<std::mutex> lock(routes_mutex_);
         
         std::string key = request.method + ":" + request.path;
@@ -411,6 +422,14 @@ private:
             return handleGetVaultFolders(request);
         }
         
+        if (request.method == "GET" && request.path.find("/api/performance/history") == 0) {
+            return handleGetPerformanceHistory(request);
+        }
+        
+        if (request.method == "POST" && request.path.find("/api/trace/start") == 0) {
+            return handleStartTrace(request);
+        }
+        
         // Route not found
         HttpResponse response;
         response.status_code = 404;
@@ -497,6 +516,29 @@ private:
             return handleGetAnalytics(req);
         });
         
+        registerRoute("GET", "/api/performance/history", [this](const HttpRequest& req) -> HttpResponse {
+            return handleGetPerformanceHistory(req);
+        });
+        
+        registerRoute("GET", "/api/metrics", [this](const HttpRequest&) -> HttpResponse {
+            return handleGetMetrics();
+        });
+        
+        // Trace recording; GET /api/trace serves Chrome trace JSON
+        registerRoute("POST", "/api/trace/start", [this](const HttpRequest& req) -> HttpResponse {
+            return handleStartTrace(req);
+        });
+        
+        registerRoute("POST", "/api/trace/stop", [this](const HttpRequest&) -> HttpResponse {
+            return handleStopTrace();
+        });
+        
+        registerRoute("GET", "/api/trace", [this](const HttpRequest&) -> HttpResponse {
+            HttpResponse response;
+            response.body = TraceRecorder::chromeTraceJson();
+            return response;
+        });
+        
         // Platform routes
         registerRoute("GET", "/api/platform", [this](const HttpRequest&) -> HttpResponse {
             return handleGetPlatformInfo();
@@ -864,6 +906,114 @@ private:
         return response;
     }
     
+    // Prometheus text exposition: operation latency histograms plus process gauges
+    HttpResponse handleGetMetrics() {
+        HttpResponse response;
+        response.headers["Content-Type"] = "text/plain; version=0.0.4";
+        
+        std::ostringstream body;
+        body << Instrumentation::prometheusText();
+        if (performance_monitor_) {
+            auto metrics = performance_monitor_->getMetrics();
+            body << "# HELP phantomvault_cpu_percent System CPU usage at the last sample\n"
+                 << "# TYPE phantomvault_cpu_percent gauge\n"
+                 << "phantomvault_cpu_percent " << metrics.cpuStats.totalTime << "\n"
+                 << "# HELP phantomvault_memory_kilobytes Memory tracked by the service\n"
+                 << "# TYPE phantomvault_memory_kilobytes gauge\n"
+                 << "phantomvault_memory_kilobytes " << metrics.memoryUsage << "\n";
+        }
+        body << "# HELP phantomvault_ipc_requests_total Requests handled by the IPC server\n"
+             << "# TYPE phantomvault_ipc_requests_total counter\n"
+             << "phantomvault_ipc_requests_total " << request_count_.load() << "\n";
+        
+        response.body = body.str();
+        return response;
+    }
+    
+    // Starts a new trace session; ?events=N sets the per-thread buffer size
+    HttpResponse handleStartTrace(const HttpRequest& request) {
+        HttpResponse response;
+        
+        size_t events = TraceRecorder::kDefaultEventsPerThread;
+        std::string events_param = extractQueryParam(request.path, "events");
+        if (!events_param.empty()) {
+            events = static_cast<size_t>(std::clamp(std::atol(events_param.c_str()), 1024L, 1048576L));
+        }
+        
+        TraceRecorder::start(events);
+        json result = {
+            {"success", true},
+            {"recording", true},
+            {"eventsPerThread", events}
+        };
+        response.body = result.dump();
+        return response;
+    }
+    
+    HttpResponse handleStopTrace() {
+        HttpResponse response;
+        
+        TraceRecorder::stop();
+        json result = {
+            {"success", true},
+            {"recording", false},
+            {"events", TraceRecorder::eventCount()},
+            {"dropped", TraceRecorder::droppedCount()}
+        };
+        response.body = result.dump();
+        return response;
+    }
+    
+    // Served straight from the monitor's history ring; ?hours=N (1-24, default 24)
+    HttpResponse handleGetPerformanceHistory(const HttpRequest& request) {
+        HttpResponse response;
+        
+        try {
+            if (!performance_monitor_) {
+                response.status_code = 500;
+                response.body = R"({"success": false, "error": "Performance monitor not available"})";
+                return response;
+            }
+            
+            int hours = 24;
+            std::string hours_param = extractQueryParam(request.path, "hours");
+            if (!hours_param.empty()) {
+                hours = std::clamp(std::atoi(hours_param.c_str()), 1, 24);
+            }
+            
+            auto history = performance_monitor_->getHistory(std::chrono::hours(hours));
+            
+            json samples = json::array();
+            for (const auto& sample : history) {
+                samples.push_back({
+                    {"timestamp", sample.timestampMs},
+                    {"cpuAverage", sample.cpuAverage / 100.0},
+                    {"cpuPeak", sample.cpuPeak / 100.0},
+                    {"cpuUser", sample.cpuUser / 100.0},
+                    {"cpuSystem", sample.cpuSystem / 100.0},
+                    {"memoryKB", sample.memoryKB},
+                    {"batteryLevel", sample.batteryLevel},
+                    {"onBattery", (sample.flags & MetricsSample::kOnBattery) != 0},
+                    {"charging", (sample.flags & MetricsSample::kCharging) != 0},
+                    {"sampleCount", sample.sampleCount}
+                });
+            }
+            
+            json result = {
+                {"success", true},
+                {"hours", hours},
+                {"samples", samples}
+            };
+            response.body = result.dump();
+            
+        } catch (const std::exception& e) {
+            response.status_code = 500;
+            response.body = R"({"success": false, "error": ")" + std::string(e.what()) + R"("})";
+        }
+        
+        return response;
+    }
+    
     HttpResponse handleGetPlatformInfo() {
         HttpResponse response;
         
@@ -1730,6 +1880,10 @@ void IPCServer::setAnalyticsEngine(AnalyticsEngine* engine) {
     pimpl->setAnalyticsEngine(engine);
 }
 
+void IPCServer::setPerformanceMonitor(PerformanceMonitor* monitor) {
+    pimpl->setPerformanceMonitor(monitor);
+}
+
 void IPCServer::registerRoute(const std::string& method, const std::string& path, RequestHandler handler) {
     pimpl->registerRoute(method, path, handler);
 }
@@ -6,11 +6,12 @@
  */
 
 #include "keyboard_sequence_detector.hpp"
+#include "password_pattern_matcher.hpp"
 #include <iostream>
 #include <thread>
 #include <atomic>
 #include <mutex>
-#include <regex>
+#include <condition_variable>
 #include <algorithm>
 #include <chrono>
 #include <queue>
@@ -24,12 +25,18 @@
 #include <X11/Xlib.h>
 #include <X11/keysym.h>
 #include <X11/XKBlib.h>
+#include <X11/Xproto.h>
 #include <X11/extensions/record.h>
 #include <X11/extensions/XTest.h>
 #include <unistd.h>
+#include <cerrno>
 #include <cstring>
 #include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
 #include <sys/mman.h>
+#include <sys/timerfd.h>
 #include <linux/input.h>
 #include <fcntl.h>
 #elif defined(_WIN32)
@@ -57,7 +64,14 @@ public:
         uint32_t keycode;
         bool is_press;
         uint8_t modifiers;
+        char character;     // typed character, a kSequence* control code, or 0
     };
+    
+    // Non-printing keys that steer sequence capture, carried in KeyEvent::character
+    static constexpr char kSequenceEnter = '\n';
+    static constexpr char kSequenceBackspace = '\b';
+    static constexpr char kSequenceEscape = '\x1b';
+    
     Implementation()
         : running_(false)
         , sequence_active_(false)
@@ -71,11 +85,18 @@ public:
         , sequence_timeout_(std::chrono::seconds(10))
         #ifdef PLATFORM_LINUX
         , x11_display_(nullptr)
+        , x11_data_display_(nullptr)
         , x11_record_context_(0)
+        , epoll_fd_(-1)
+        , wake_fd_(-1)
+        , timer_fd_(-1)
         , ctrl_pressed_(false)
         , alt_pressed_(false)
+        , shift_pressed_(false)
         , last_key_time_()
-        , current_sequence_()
+        , sequence_matcher_()
+        , sequence_length_(0)
+        , sequence_matches_(0)
         #endif
         , hardware_monitoring_enabled_(false)
         , lock_free_processing_enabled_(false)
@@ -96,11 +117,19 @@ public:
         #ifdef PLATFORM_LINUX
         if (x11_display_) {
             if (x11_record_context_) {
-                XRecordDisableContext(x11_display_, x11_record_context_);
                 XRecordFreeContext(x11_display_, x11_record_context_);
             }
             XCloseDisplay(x11_display_);
         }
+        if (x11_data_display_) {
+            XCloseDisplay(x11_data_display_);
+        }
+        closeInputDevices();
+        for (int fd : {epoll_fd_, wake_fd_, timer_fd_}) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
         #endif
     }
     
@@ -151,19 +180,17 @@ public:
                 return true;
             }
             
-            // If in headless mode, just mark as running but don't start detection
-            if (is_headless_) {
-                running_ = true;
-                std::cout << "[KeyboardSequenceDetector] Started in headless mode (keyboard detection disabled)" << std::endl;
-                return true;
-            }
-            
             running_ = true;
             
-            // Start keyboard detection thread
+            // Start keyboard detection thread. Without X11 it still serves the
+            // sequence timeout and any evdev keyboards, and costs nothing idle.
             detection_thread_ = std::thread(&Implementation::keyboardDetectionLoop, this);
             
-            std::cout << "[KeyboardSequenceDetector] Started keyboard detection" << std::endl;
+            if (is_headless_) {
+                std::cout << "[KeyboardSequenceDetector] Started in headless mode (X11 capture disabled)" << std::endl;
+            } else {
+                std::cout << "[KeyboardSequenceDetector] Started keyboard detection" << std::endl;
+            }
             return true;
             
         } catch (const std::exception& e) {
@@ -179,11 +206,20 @@ public:
         }
         
         running_ = false;
+        wakeDetectionLoop();
         
         if (detection_thread_.joinable()) {
             detection_thread_.join();
         }
         
+        #ifdef PLATFORM_LINUX
+        // Recording is controlled from the control connection, not the data one
+        if (x11_display_ && x11_record_context_) {
+            XRecordDisableContext(x11_display_, x11_record_context_);
+            XFlush(x11_display_);
+        }
+        #endif
+        
         std::cout << "[KeyboardSequenceDetector] Stopped keyboard detection" << std::endl;
     }
     
@@ -230,12 +266,15 @@ public:
         sequence_active_ = true;
         keyboard_buffer_.clear();
         #ifdef PLATFORM_LINUX
-        current_sequence_.clear();
+        sequence_matcher_.reset();
+        sequence_length_ = 0;
+        sequence_matches_ = 0;
         #endif
         
         // Set timeout
         sequence_timeout_ = std::chrono::seconds(timeoutSeconds);
         sequence_start_time_ = std::chrono::steady_clock::now();
+        armSequenceTimer(sequence_timeout_);
         
         std::cout << "[KeyboardSequenceDetector] Activated sequence detection for " << timeoutSeconds << " seconds" << std::endl;
     }
@@ -245,8 +284,11 @@ public:
         sequence_active_ = false;
         keyboard_buffer_.clear();
         #ifdef PLATFORM_LINUX
-        current_sequence_.clear();
+        sequence_matcher_.reset();
+        sequence_length_ = 0;
+        sequence_matches_ = 0;
         #endif
+        armSequenceTimer(std::chrono::seconds(0));
         
         std::cout << "[KeyboardSequenceDetector] Deactivated sequence detection" << std::endl;
     }
@@ -259,51 +301,29 @@ public:
     std::vector<PasswordPattern> extractPasswordPatterns(const std::string& input) const {
         std::vector<PasswordPattern> patterns;
         
-        // Pattern 1: T+password (temporary unlock)
-        std::regex tempPattern(R"(T\+([^\s]+))");
-        std::smatch match;
-        
-        std::string::const_iterator searchStart = input.cbegin();
-        while (std::regex_search(searchStart, input.cend(), match, tempPattern)) {
-            PasswordPattern pattern;
-            pattern.password = match[1].str();
-            pattern.isTemporary = true;
-            pattern.detectedAt = std::chrono::system_clock::now();
-            patterns.push_back(pattern);
-            searchStart = match.suffix().first;
-        }
-        
-        // Pattern 2: P+password (permanent unlock)
-        std::regex permPattern(R"(P\+([^\s]+))");
-        searchStart = input.cbegin();
-        while (std::regex_search(searchStart, input.cend(), match, permPattern)) {
-            PasswordPattern pattern;
-            pattern.password = match[1].str();
-            pattern.isPermanent = true;
-            pattern.detectedAt = std::chrono::system_clock::now();
-            patterns.push_back(pattern);
-            searchStart = match.suffix().first;
-        }
-        
-        // Pattern 3: Look for standalone password words (6+ chars)
-        std::regex wordPattern(R"(\b([a-zA-Z0-9@#$%^&*!]{6,})\b)");
-        searchStart = input.cbegin();
-        while (std::regex_search(searchStart, input.cend(), match, wordPattern)) {
-            std::string candidate = match[1].str();
-            if (isValidPasswordPattern(candidate)) {
-                PasswordPattern pattern;
-                pattern.password = candidate;
-                pattern.isTemporary = false; // Default to temporary
-                pattern.isPermanent = false;
-                pattern.detectedAt = std::chrono::system_clock::now();
-                patterns.push_back(pattern);
+        PasswordPatternMatcher matcher;
+        PatternMatch match;
+        for (char c : input) {
+            if (matcher.feed(c, match)) {
+                patterns.push_back(toPasswordPattern(match));
             }
-            searchStart = match.suffix().first;
+        }
+        if (matcher.finish(match)) {
+            patterns.push_back(toPasswordPattern(match));
         }
         
         return patterns;
     }
     
+    static PasswordPattern toPasswordPattern(const PatternMatch& match) {
+        PasswordPattern pattern;
+        pattern.password = std::string(match.password);
+        pattern.isTemporary = match.kind == PatternKind::TEMPORARY;
+        pattern.isPermanent = match.kind == PatternKind::PERMANENT;
+        pattern.detectedAt = std::chrono::system_clock::now();
+        return pattern;
+    }
+    
     bool isValidPasswordPattern(const std::string& pattern) const {
         if (pattern.length() < 6) {
             return false;
@@ -398,6 +418,11 @@ public:
     
     void disableHardwareLevelMonitoring() {
         hardware_monitoring_enabled_.store(false, std::memory_order_release);
+        
+        #ifdef PLATFORM_LINUX
+        closeInputDevices();
+        #endif
+        
         std::cout << "[KeyboardSequenceDetector] Hardware-level monitoring disabled" << std::endl;
     }
     
@@ -485,7 +510,7 @@ public:
     }
     
     // Lock-free event processing
-    bool pushKeyEvent(uint32_t keycode, bool is_press, uint8_t modifiers) {
+    bool pushKeyEvent(uint32_t keycode, bool is_press, uint8_t modifiers, char character = 0) {
         auto timestamp = std::chrono::high_resolution_clock::now();
         
         size_t head = ring_buffer_head_.load(std::memory_order_acquire);
@@ -497,7 +522,7 @@ public:
         }
         
         // Store event
-        event_ring_buffer_[head] = {timestamp, keycode, is_press, modifiers};
+        event_ring_buffer_[head] = {timestamp, keycode, is_press, modifiers, character};
         
         // Update head pointer
         ring_buffer_head_.store(next_head, std::memory_order_release);
@@ -560,136 +585,260 @@ public:
     
     // Platform-specific keyboard event handling
     #ifdef PLATFORM_LINUX
+    // What a key does for sequence detection, independent of where it was read
+    enum class KeyRole {
+        CHARACTER,
+        CONTROL,
+        ALT,
+        SHIFT,
+        ENTER,
+        ESCAPE,
+        BACKSPACE,
+        OTHER
+    };
+    
     void handleX11KeyEvent(::XRecordInterceptData* data) {
-        auto start_time = std::chrono::high_resolution_clock::now();
+        if (data->category != XRecordFromServer || !data->data) {
+            return;
+        }
+        
+        // evdev devices, when open, already deliver every key
+        if (input_device_count_.load(std::memory_order_acquire) > 0) {
+            return;
+        }
         
-        if (data->category != XRecordFromServer) {
+        // RECORD hands over the raw wire event, not an Xlib XKeyEvent
+        const xEvent* event = reinterpret_cast<const xEvent*>(data->data);
+        int type = event->u.u.type & 0x7f;
+        if (type != KeyPress && type != KeyRelease) {
             return;
         }
         
-        XKeyEvent* event = (XKeyEvent*)data->data;
+        KeyCode keycode = event->u.u.detail;
+        bool shifted = (event->u.keyButtonPointer.state & ShiftMask) != 0;
+        KeySym keysym = XkbKeycodeToKeysym(x11_display_, keycode, 0, shifted ? 1 : 0);
+        
+        KeyRole role = KeyRole::OTHER;
+        char key_char = 0;
+        if (keysym == XK_Control_L || keysym == XK_Control_R) {
+            role = KeyRole::CONTROL;
+        } else if (keysym == XK_Alt_L || keysym == XK_Alt_R) {
+            role = KeyRole::ALT;
+        } else if (keysym == XK_Return || keysym == XK_KP_Enter) {
+            role = KeyRole::ENTER;
+        } else if (keysym == XK_Escape) {
+            role = KeyRole::ESCAPE;
+        } else if (keysym == XK_BackSpace) {
+            role = KeyRole::BACKSPACE;
+        } else if (keysym >= XK_space && keysym <= XK_asciitilde) {
+            role = KeyRole::CHARACTER;
+            key_char = static_cast<char>(keysym);
+        } else if (keysym == XK_KP_Add) {
+            role = KeyRole::CHARACTER;
+            key_char = '+';
+        }
+        
+        handleKey(role, key_char, type == KeyPress, keycode);
+    }
+    
+    void handleInputDeviceEvent(const input_event& event) {
+        if (event.type != EV_KEY || event.value == 2) {
+            return;     // autorepeat is not typing
+        }
+        bool is_press = event.value == 1;
+        
+        KeyRole role = KeyRole::OTHER;
+        char key_char = 0;
+        switch (event.code) {
+            case KEY_LEFTCTRL: case KEY_RIGHTCTRL: role = KeyRole::CONTROL; break;
+            case KEY_LEFTALT: case KEY_RIGHTALT: role = KeyRole::ALT; break;
+            case KEY_LEFTSHIFT: case KEY_RIGHTSHIFT: role = KeyRole::SHIFT; break;
+            case KEY_ENTER: case KEY_KPENTER: role = KeyRole::ENTER; break;
+            case KEY_ESC: role = KeyRole::ESCAPE; break;
+            case KEY_BACKSPACE: role = KeyRole::BACKSPACE; break;
+            default:
+                key_char = inputDeviceCharacter(event.code, shift_pressed_);
+                role = key_char != 0 ? KeyRole::CHARACTER : KeyRole::OTHER;
+                break;
+        }
+        
+        handleKey(role, key_char, is_press, event.code);
+    }
+    
+    void handleKey(KeyRole role, char key_char, bool is_press, uint32_t keycode) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        
+        // Handle modifier keys
+        if (role == KeyRole::CONTROL) {
+            ctrl_pressed_ = is_press;
+            return;
+        }
+        if (role == KeyRole::ALT) {
+            alt_pressed_ = is_press;
+            return;
+        }
+        if (role == KeyRole::SHIFT) {
+            shift_pressed_ = is_press;
+            return;
+        }
         
-        if (event->type == KeyPress || event->type == KeyRelease) {
-            KeyCode keycode = event->keycode;
-            bool is_press = (event->type == KeyPress);
+        // Check for Ctrl+Alt+V hotkey
+        if (is_press && ctrl_pressed_ && alt_pressed_ && (key_char == 'v' || key_char == 'V')) {
+            std::cout << "[KeyboardSequenceDetector] Ctrl+Alt+V detected!" << std::endl;
             
-            // Convert keycode to keysym
-            KeySym keysym = XkbKeycodeToKeysym(x11_display_, keycode, 0, 0);
+            // Record ultra-fast response time
+            auto response_time = std::chrono::high_resolution_clock::now() - start_time;
+            recordResponseTime(std::chrono::duration_cast<std::chrono::nanoseconds>(response_time));
             
-            // Handle modifier keys
-            if (keysym == XK_Control_L || keysym == XK_Control_R) {
-                ctrl_pressed_ = is_press;
-                return;
+            // Use lock-free processing if enabled
+            if (lock_free_processing_enabled_.load(std::memory_order_acquire)) {
+                uint8_t modifiers = (ctrl_pressed_ ? 1 : 0) | (alt_pressed_ ? 2 : 0);
+                pushKeyEvent(keycode, is_press, modifiers);
             }
             
-            if (keysym == XK_Alt_L || keysym == XK_Alt_R) {
-                alt_pressed_ = is_press;
-                return;
+            // Activate sequence detection
+            activateSequenceDetection(10);
+            
+            if (on_sequence_detected_) {
+                on_sequence_detected_();
+            }
+            return;
+        }
+        
+        // If sequence detection is active, queue the key for the matcher
+        if (!is_press || !isSequenceDetectionActive()) {
+            return;
+        }
+        
+        char input = 0;
+        switch (role) {
+            case KeyRole::ENTER: input = kSequenceEnter; break;
+            case KeyRole::ESCAPE: input = kSequenceEscape; break;
+            case KeyRole::BACKSPACE: input = kSequenceBackspace; break;
+            case KeyRole::CHARACTER: input = key_char; break;
+            default: return;
+        }
+        
+        uint8_t modifiers = (ctrl_pressed_ ? 1 : 0) | (alt_pressed_ ? 2 : 0);
+        if (!pushKeyEvent(keycode, true, modifiers, input)) {
+            // Consumer fell behind; make room rather than lose a keystroke
+            drainKeyEvents();
+            pushKeyEvent(keycode, true, modifiers, input);
+        }
+    }
+    
+    /**
+     * Consumer side of event_ring_buffer_: feeds queued keys to the streaming
+     * matcher, which reports each pattern as soon as its token ends.
+     */
+    void drainKeyEvents() {
+        KeyEvent event;
+        while (popKeyEvent(event)) {
+            if (event.character == 0 || !sequence_active_.load(std::memory_order_acquire)) {
+                continue;
             }
             
-            // Check for Ctrl+Alt+V hotkey
-            if (is_press && ctrl_pressed_ && alt_pressed_ && keysym == XK_v) {
-                std::cout << "[KeyboardSequenceDetector] Ctrl+Alt+V detected!" << std::endl;
-                
-                // Record ultra-fast response time
-                auto response_time = std::chrono::high_resolution_clock::now() - start_time;
-                recordResponseTime(std::chrono::duration_cast<std::chrono::nanoseconds>(response_time));
-                
-                // Use lock-free processing if enabled
-                if (lock_free_processing_enabled_.load(std::memory_order_acquire)) {
-                    uint8_t modifiers = (ctrl_pressed_ ? 1 : 0) | (alt_pressed_ ? 2 : 0);
-                    pushKeyEvent(keycode, is_press, modifiers);
-                }
-                
-                // Activate sequence detection
-                activateSequenceDetection(10);
-                
-                if (on_sequence_detected_) {
-                    on_sequence_detected_();
-                }
-                return;
+            // Reset the token if too much time passed between keys
+            if (event.timestamp - last_key_time_ > std::chrono::seconds(2)) {
+                sequence_matcher_.reset();
             }
+            last_key_time_ = event.timestamp;
             
-            // If sequence detection is active, capture keys
-            if (isSequenceDetectionActive() && is_press) {
-                auto now = std::chrono::steady_clock::now();
-                
-                // Reset sequence if too much time passed between keys
-                if (now - last_key_time_ > std::chrono::seconds(2)) {
-                    current_sequence_.clear();
-                }
-                
-                last_key_time_ = now;
-                
-                // Convert keysym to character
-                char key_char = 0;
-                if (keysym >= XK_space && keysym <= XK_asciitilde) {
-                    key_char = (char)keysym;
-                } else if (keysym >= XK_0 && keysym <= XK_9) {
-                    key_char = '0' + (keysym - XK_0);
-                } else if (keysym >= XK_a && keysym <= XK_z) {
-                    key_char = 'a' + (keysym - XK_a);
-                } else if (keysym >= XK_A && keysym <= XK_Z) {
-                    key_char = 'A' + (keysym - XK_A);
-                } else if (keysym == XK_Return || keysym == XK_KP_Enter) {
-                    // Enter pressed - process the sequence
-                    processKeyboardSequence(current_sequence_);
-                    current_sequence_.clear();
+            PatternMatch match;
+            switch (event.character) {
+                case kSequenceEnter:
+                    // Enter pressed - end the last token and the sequence
+                    if (sequence_matcher_.finish(match)) {
+                        reportPasswordPattern(match);
+                    }
+                    if (sequence_matches_ == 0) {
+                        std::cout << "[KeyboardSequenceDetector] No valid password patterns found" << std::endl;
+                    }
                     deactivateSequenceDetection();
-                    return;
-                } else if (keysym == XK_Escape) {
+                    continue;
+                case kSequenceEscape:
                     // Escape pressed - cancel sequence detection
-                    current_sequence_.clear();
                     deactivateSequenceDetection();
-                    return;
-                } else if (keysym == XK_BackSpace) {
-                    // Backspace - remove last character
-                    if (!current_sequence_.empty()) {
-                        current_sequence_.pop_back();
-                    }
-                    return;
+                    continue;
+                case kSequenceBackspace:
+                    sequence_matcher_.backspace();
+                    continue;
+                default:
+                    break;
+            }
+            
+            if (sequence_matcher_.feed(event.character, match)) {
+                reportPasswordPattern(match);
+            }
+            
+            // Limit sequence length for security
+            if (++sequence_length_ > 100) {
+                deactivateSequenceDetection();
+            }
+        }
+    }
+    
+    // US layout character for an evdev key code, 0 for keys that do not type one
+    static char inputDeviceCharacter(uint16_t code, bool shifted) {
+        struct Keymap {
+            std::array<char, KEY_MAX + 1> normal{};
+            std::array<char, KEY_MAX + 1> shift{};
+            
+            void set(uint16_t code, char normal_char, char shift_char) {
+                normal[code] = normal_char;
+                shift[code] = shift_char;
+            }
+            
+            void row(uint16_t first_code, const char* letters) {
+                for (uint16_t i = 0; letters[i] != 0; ++i) {
+                    set(first_code + i, letters[i], static_cast<char>(letters[i] - 'a' + 'A'));
                 }
-                
-                // Add character to sequence
-                if (key_char != 0) {
-                    current_sequence_ += key_char;
-                    
-                    // Limit sequence length for security
-                    if (current_sequence_.length() > 100) {
-                        current_sequence_.clear();
-                        deactivateSequenceDetection();
-                    }
+            }
+            
+            Keymap() {
+                const char* digits = "1234567890";
+                const char* shifted_digits = "!@#$%^&*()";
+                for (uint16_t i = 0; i < 10; ++i) {
+                    set(KEY_1 + i, digits[i], shifted_digits[i]);
                 }
+                row(KEY_Q, "qwertyuiop");
+                row(KEY_A, "asdfghjkl");
+                row(KEY_Z, "zxcvbnm");
+                set(KEY_MINUS, '-', '_');
+                set(KEY_EQUAL, '=', '+');
+                set(KEY_LEFTBRACE, '[', '{');
+                set(KEY_RIGHTBRACE, ']', '}');
+                set(KEY_SEMICOLON, ';', ':');
+                set(KEY_APOSTROPHE, '\'', '"');
+                set(KEY_GRAVE, '`', '~');
+                set(KEY_BACKSLASH, '\\', '|');
+                set(KEY_COMMA, ',', '<');
+                set(KEY_DOT, '.', '>');
+                set(KEY_SLASH, '/', '?');
+                set(KEY_SPACE, ' ', ' ');
+                set(KEY_KPPLUS, '+', '+');
             }
+        };
+        static const Keymap keymap;
+        
+        if (code > KEY_MAX) {
+            return 0;
         }
+        return shifted ? keymap.shift[code] : keymap.normal[code];
     }
     
-    void processKeyboardSequence(const std::string& sequence) {
-        if (sequence.empty()) {
-            return;
-        }
-        
-        std::cout << "[KeyboardSequenceDetector] Processing keyboard sequence: " 
-                  << sequence.length() << " characters" << std::endl;
+    void reportPasswordPattern(const PatternMatch& match) {
+        PasswordPattern pattern = toPasswordPattern(match);
+        detection_count_++;
+        sequence_matches_++;
+        last_detection_time_ = pattern.detectedAt;
         
-        // Extract password patterns from sequence
-        auto patterns = extractPasswordPatterns(sequence);
+        std::cout << "[KeyboardSequenceDetector] Found password pattern: " 
+                  << (pattern.isTemporary ? "TEMP" : (pattern.isPermanent ? "PERM" : "DEFAULT"))
+                  << " [" << pattern.password.length() << " chars]" << std::endl;
         
-        if (!patterns.empty()) {
-            detection_count_++;
-            last_detection_time_ = std::chrono::system_clock::now();
-            
-            for (const auto& pattern : patterns) {
-                std::cout << "[KeyboardSequenceDetector] Found password pattern: " 
-                          << (pattern.isTemporary ? "TEMP" : (pattern.isPermanent ? "PERM" : "DEFAULT"))
-                          << " [" << pattern.password.length() << " chars]" << std::endl;
-                
-                if (on_password_detected_) {
-                    on_password_detected_(pattern);
-                }
-            }
-        } else {
-            std::cout << "[KeyboardSequenceDetector] No valid password patterns found" << std::endl;
+        if (on_password_detected_) {
+            on_password_detected_(pattern);
         }
     }
     #endif
@@ -716,12 +865,26 @@ private:
     
     // Platform-specific members
     #ifdef PLATFORM_LINUX
-    Display* x11_display_;
+    Display* x11_display_;          // control connection: context setup and teardown
+    Display* x11_data_display_;     // data connection the RECORD context streams key events on
     XRecordContext x11_record_context_;
+    int epoll_fd_;
+    int wake_fd_;                   // eventfd, written by stop()
+    int timer_fd_;                  // timerfd, armed while a sequence is active
+    std::vector<int> input_device_fds_;
+    std::atomic<size_t> input_device_count_{0};
+    std::mutex device_mutex_;
     bool ctrl_pressed_;
     bool alt_pressed_;
-    std::chrono::steady_clock::time_point last_key_time_;
-    std::string current_sequence_;
+    bool shift_pressed_;
+    std::chrono::high_resolution_clock::time_point last_key_time_;
+    PasswordPatternMatcher sequence_matcher_;
+    size_t sequence_length_;
+    size_t sequence_matches_;
+    #else
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    uint64_t wake_generation_ = 0;
     #endif
     
     // Ultra-fast performance optimization members
@@ -747,66 +910,284 @@ private:
     void keyboardDetectionLoop() {
         std::cout << "[KeyboardSequenceDetector] Keyboard detection loop started" << std::endl;
         
+        #ifdef PLATFORM_LINUX
+        runLinuxEventLoop();
+        #else
         while (running_) {
             try {
-                #ifdef PLATFORM_LINUX
-                processLinuxKeyboard();
-                #elif defined(PLATFORM_WINDOWS)
+                #if defined(PLATFORM_WINDOWS)
                 processWindowsKeyboard();
                 #elif defined(PLATFORM_MACOS)
                 processMacOSKeyboard();
                 #else
-                // Fallback: just sleep and check timeout
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                waitForWake();
                 #endif
                 
-                // Check for sequence timeout
-                if (isSequenceDetectionActive() && std::chrono::steady_clock::now() - sequence_start_time_ >= sequence_timeout_) {
-                    deactivateSequenceDetection();
-                    if (on_sequence_timeout_) {
-                        on_sequence_timeout_();
-                    }
-                }
+                handleSequenceTimeout();
                 
             } catch (const std::exception& e) {
                 last_error_ = "Keyboard detection error: " + std::string(e.what());
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
             }
         }
+        #endif
         
         std::cout << "[KeyboardSequenceDetector] Keyboard detection loop stopped" << std::endl;
     }
     
+    void handleSequenceTimeout() {
+        bool expired = false;
+        {
+            std::lock_guard<std::mutex> lock(buffer_mutex_);
+            expired = sequence_active_ && std::chrono::steady_clock::now() - sequence_start_time_ >= sequence_timeout_;
+        }
+        
+        if (expired) {
+            deactivateSequenceDetection();
+            if (on_sequence_timeout_) {
+                on_sequence_timeout_();
+            }
+        }
+    }
+    
     #ifdef PLATFORM_LINUX
-    void initializeHardwareMonitoring() {
-        try {
-            // Attempt to open /dev/input/event* devices for hardware-level monitoring
-            for (int i = 0; i < 32; ++i) {
-                std::string device_path = "/dev/input/event" + std::to_string(i);
-                int fd = open(device_path.c_str(), O_RDONLY | O_NONBLOCK);
+    void wakeDetectionLoop() {
+        if (wake_fd_ >= 0) {
+            uint64_t one = 1;
+            ssize_t written = write(wake_fd_, &one, sizeof(one));
+            (void)written;
+        }
+    }
+    
+    // Zero disarms the timer
+    void armSequenceTimer(std::chrono::seconds timeout) {
+        if (timer_fd_ < 0) {
+            return;
+        }
+        struct itimerspec spec {};
+        spec.it_value.tv_sec = static_cast<time_t>(timeout.count());
+        timerfd_settime(timer_fd_, 0, &spec, nullptr);
+    }
+    
+    bool createEventDescriptors() {
+        if (epoll_fd_ >= 0) {
+            return true;
+        }
+        
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (epoll_fd_ < 0 || wake_fd_ < 0 || timer_fd_ < 0 || !watchDescriptor(wake_fd_) || !watchDescriptor(timer_fd_)) {
+            last_error_ = "Failed to create keyboard event descriptors: " + std::string(strerror(errno));
+            return false;
+        }
+        return true;
+    }
+    
+    bool watchDescriptor(int fd) {
+        if (epoll_fd_ < 0) {
+            return false;
+        }
+        struct epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        return epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+    
+    /**
+     * One blocking wait over every input source: the X11 RECORD data
+     * connection, evdev keyboards, the sequence timer and the stop() wakeup.
+     * Nothing runs until one of them is readable.
+     */
+    void runLinuxEventLoop() {
+        if (epoll_fd_ < 0) {
+            last_error_ = "Keyboard detection started before initialization";
+            return;
+        }
+        
+        int x11_fd = -1;
+        if (x11_data_display_ && x11_record_context_) {
+            if (XRecordEnableContextAsync(x11_data_display_, x11_record_context_, x11KeyboardCallback,
+                                          reinterpret_cast<XPointer>(this))) {
+                x11_fd = ConnectionNumber(x11_data_display_);
+                watchDescriptor(x11_fd);
                 
-                if (fd >= 0) {
-                    // Check if this is a keyboard device
-                    unsigned long evbit = 0;
-                    if (ioctl(fd, EVIOCGBIT(0, sizeof(evbit)), &evbit) >= 0) {
-                        if (evbit & (1 << EV_KEY)) {
-                            std::cout << "[KeyboardSequenceDetector] Found keyboard device: " << device_path << std::endl;
-                            // Store file descriptor for hardware monitoring
-                            // In a full implementation, we'd store these and monitor them
+                // Replies read while enabling are already buffered inside Xlib
+                XRecordProcessReplies(x11_data_display_);
+            } else {
+                last_error_ = "Failed to enable X11 record context";
+            }
+        }
+        
+        std::array<struct epoll_event, 16> events;
+        while (running_) {
+            int ready = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), -1);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                last_error_ = "Keyboard event wait failed: " + std::string(strerror(errno));
+                break;
+            }
+            
+            for (int i = 0; i < ready; ++i) {
+                int fd = events[i].data.fd;
+                try {
+                    if (fd == wake_fd_) {
+                        uint64_t count = 0;
+                        ssize_t bytes = read(wake_fd_, &count, sizeof(count));
+                        (void)bytes;
+                    } else if (fd == timer_fd_) {
+                        uint64_t expirations = 0;
+                        if (read(timer_fd_, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+                            handleSequenceTimeout();
                         }
+                    } else if (fd == x11_fd) {
+                        XRecordProcessReplies(x11_data_display_);
+                    } else {
+                        readInputDevice(fd);
                     }
-                    close(fd);
+                } catch (const std::exception& e) {
+                    last_error_ = "Keyboard detection error: " + std::string(e.what());
                 }
             }
-        } catch (const std::exception& e) {
-            std::cout << "[KeyboardSequenceDetector] Hardware monitoring initialization failed: " << e.what() << std::endl;
+            
+            // Handlers only queue keys; match the whole batch in one pass
+            try {
+                drainKeyEvents();
+            } catch (const std::exception& e) {
+                last_error_ = "Keyboard detection error: " + std::string(e.what());
+            }
+        }
+        
+        if (x11_fd >= 0) {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, x11_fd, nullptr);
+        }
+    }
+    
+    void readInputDevice(int fd) {
+        std::array<input_event, 64> buffer;
+        ssize_t bytes = 0;
+        {
+            std::lock_guard<std::mutex> lock(device_mutex_);
+            if (std::find(input_device_fds_.begin(), input_device_fds_.end(), fd) == input_device_fds_.end()) {
+                return;
+            }
+            
+            bytes = read(fd, buffer.data(), sizeof(buffer));
+            if (bytes < 0 && errno == ENODEV) {
+                // Keyboard unplugged
+                epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+                close(fd);
+                input_device_fds_.erase(std::find(input_device_fds_.begin(), input_device_fds_.end(), fd));
+                input_device_count_.store(input_device_fds_.size(), std::memory_order_release);
+                return;
+            }
+        }
+        
+        // Handlers run unlocked, since callbacks may toggle hardware monitoring
+        for (ssize_t i = 0; i + static_cast<ssize_t>(sizeof(input_event)) <= bytes; i += sizeof(input_event)) {
+            handleInputDeviceEvent(buffer[i / sizeof(input_event)]);
+        }
+    }
+    
+    void closeInputDevices() {
+        std::lock_guard<std::mutex> lock(device_mutex_);
+        for (int fd : input_device_fds_) {
+            if (epoll_fd_ >= 0) {
+                epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+            }
+            close(fd);
+        }
+        input_device_fds_.clear();
+        input_device_count_.store(0, std::memory_order_release);
+    }
+    #else
+    void wakeDetectionLoop() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            ++wake_generation_;
+        }
+        wake_cv_.notify_all();
+    }
+    
+    // The waiter recomputes its deadline from the sequence state on every wakeup
+    void armSequenceTimer(std::chrono::seconds) {
+        wakeDetectionLoop();
+    }
+    
+    // Block until stop(), a sequence change, or the active sequence's deadline
+    void waitForWake() {
+        uint64_t seen = 0;
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            seen = wake_generation_;
+        }
+        
+        bool has_deadline = false;
+        std::chrono::steady_clock::time_point deadline;
+        {
+            std::lock_guard<std::mutex> lock(buffer_mutex_);
+            has_deadline = sequence_active_;
+            deadline = sequence_start_time_ + sequence_timeout_;
+        }
+        
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        auto woken = [this, seen] { return wake_generation_ != seen || !running_; };
+        if (has_deadline) {
+            wake_cv_.wait_until(lock, deadline, woken);
+        } else {
+            wake_cv_.wait(lock, woken);
         }
     }
     #endif
     
+    #ifdef PLATFORM_LINUX
+    void initializeHardwareMonitoring() {
+        std::lock_guard<std::mutex> lock(device_mutex_);
+        if (!input_device_fds_.empty()) {
+            return;
+        }
+        
+        auto has_bit = [](const unsigned long* bits, int bit) {
+            constexpr int kBitsPerLong = 8 * sizeof(unsigned long);
+            return (bits[bit / kBitsPerLong] >> (bit % kBitsPerLong)) & 1UL;
+        };
+        
+        // Open /dev/input/event* keyboards and add them to the event loop
+        for (int i = 0; i < 32; ++i) {
+            std::string device_path = "/dev/input/event" + std::to_string(i);
+            int fd = open(device_path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+            if (fd < 0) {
+                continue;
+            }
+            
+            // Keyboards have letter and Enter keys; mice and power buttons report EV_KEY too
+            unsigned long evbit[1] = {0};
+            unsigned long keybit[KEY_MAX / (8 * sizeof(unsigned long)) + 1] = {0};
+            bool keyboard = ioctl(fd, EVIOCGBIT(0, sizeof(evbit)), evbit) >= 0 && has_bit(evbit, EV_KEY) &&
+                            ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keybit)), keybit) >= 0 &&
+                            has_bit(keybit, KEY_A) && has_bit(keybit, KEY_ENTER);
+            
+            if (!keyboard || !watchDescriptor(fd)) {
+                close(fd);
+                continue;
+            }
+            
+            std::cout << "[KeyboardSequenceDetector] Found keyboard device: " << device_path << std::endl;
+            input_device_fds_.push_back(fd);
+        }
+        
+        input_device_count_.store(input_device_fds_.size(), std::memory_order_release);
+    }
+    #endif
+    
     #ifdef PLATFORM_LINUX
     bool initializeLinux() {
         try {
+            if (!createEventDescriptors()) {
+                return false;
+            }
+            
             // Open X11 display - try different display options for headless systems
             x11_display_ = XOpenDisplay(nullptr);
             if (!x11_display_) {
@@ -819,7 +1200,7 @@ private:
                 // If still no display, run in headless mode (disable keyboard detection)
                 if (!x11_display_) {
                     std::cout << "[KeyboardSequenceDetector] No X11 display available - running in headless mode" << std::endl;
-                    std::cout << "[KeyboardSequenceDetector] Keyboard sequence detection disabled" << std::endl;
+                    std::cout << "[KeyboardSequenceDetector] X11 capture disabled; input devices and timeouts still work" << std::endl;
                     is_headless_ = true;
                     return true; // Return success but with disabled functionality
                 }
@@ -862,6 +1243,18 @@ private:
                 return false;
             }
             
+            // Recorded events arrive on a second connection, which the event loop waits on
+            XSync(x11_display_, False);
+            x11_data_display_ = XOpenDisplay(DisplayString(x11_display_));
+            if (!x11_data_display_) {
+                last_error_ = "Failed to open X11 data connection";
+                XRecordFreeContext(x11_display_, x11_record_context_);
+                x11_record_context_ = 0;
+                XCloseDisplay(x11_display_);
+                x11_display_ = nullptr;
+                return false;
+            }
+            
             std::cout << "[KeyboardSequenceDetector] Initialized Linux X11 keyboard detection" << std::endl;
             return true;
             
@@ -875,24 +1268,6 @@ private:
         }
     }
     
-    void processLinuxKeyboard() {
-        if (!x11_display_ || !x11_record_context_) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            return;
-        }
-        
-        try {
-            // Process X11 keyboard events
-            if (!XRecordEnableContext(x11_display_, x11_record_context_, x11KeyboardCallback, (XPointer)this)) {
-                last_error_ = "Failed to enable X11 record context";
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
-            
-        } catch (const std::exception& e) {
-            last_error_ = "Linux keyboard processing error: " + std::string(e.what());
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-    }
     #endif
     
     #ifdef PLATFORM_WINDOWS
@@ -903,8 +1278,8 @@ private:
     }
     
     void processWindowsKeyboard() {
-        // Process Windows keyboard messages
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        // No hook is installed yet, so there is nothing to pump; sleep until woken
+        waitForWake();
     }
     #endif
     
@@ -916,8 +1291,8 @@ private:
     }
     
     void processMacOSKeyboard() {
-        // Process macOS keyboard events
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        // No event tap is installed yet, so there is nothing to pump; sleep until woken
+        waitForWake();
     }
     #endif
 };
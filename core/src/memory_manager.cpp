@@ -1,77 +1,317 @@
 /**
  * PhantomVault Memory Manager Implementation
- * 
+ *
  * Efficient memory management with pools and smart allocation strategies.
+ *
+ * Free blocks carry their own bookkeeping: a thread cache is a singly linked
+ * list through the blocks, and a batch handed to a central list is such a
+ * list whose first block also records its length and the next batch. Central
+ * lists are Treiber stacks of batches. The head names a batch by a 32-bit
+ * block id rather than a pointer, leaving room for a 32-bit tag that changes
+ * on every push and pop, so a stale head can never be swapped back in (ABA).
+ * A block id is its slab's index in the class's slab table plus its index
+ * in the slab; slabs are aligned to their size and keep their table index in
+ * the first block, so the id of any block is two loads away.
+ *
+ * Slabs are never returned to the system, which is what makes it safe for a
+ * pop to read the link of a batch another thread may have just taken.
  */
 
 #include "memory_manager.hpp"
 #include <algorithm>
+#include <array>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
 #include <new>
 
 namespace phantomvault {
 
-// MemoryPool implementation
-template<size_t BlockSize, size_t PoolSize>
-MemoryPool<BlockSize, PoolSize>::MemoryPool() : used_blocks_(0) {
-    initializeFreeList();
+namespace {
+
+constexpr size_t kSizeClassCount = 8;
+constexpr size_t kMinBlockShift = 4;                // 16 bytes, room for a FreeBlock
+constexpr size_t kSlabBytes = 64 * 1024;
+constexpr size_t kMaxSlabsPerClass = 4096;          // 256 MB of blocks per class
+constexpr uint32_t kBlockIndexBits = 12;            // 4096 blocks per slab at 16 bytes
+constexpr int64_t kUsageStep = 64 * 1024;
+
+static_assert((size_t(1) << (kMinBlockShift + kSizeClassCount - 1)) == MemoryManager::kMaxPooledSize,
+              "size classes must end at kMaxPooledSize");
+static_assert((kSlabBytes >> kMinBlockShift) <= (size_t(1) << kBlockIndexBits), "block index overflow");
+
+inline size_t sizeClassFor(size_t size) {
+    size_t size_class = 0;
+    while ((size_t(1) << (kMinBlockShift + size_class)) < size) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+inline size_t blockSize(size_t size_class) {
+    return size_t(1) << (kMinBlockShift + size_class);
 }
 
-template<size_t BlockSize, size_t PoolSize>
-MemoryPool<BlockSize, PoolSize>::~MemoryPool() {
-    // Memory is automatically freed when pool_ goes out of scope
+// Blocks moved between a thread cache and a central list at a time: 64 small, 4 at 2 KB
+inline uint32_t batchSize(size_t size_class) {
+    return static_cast<uint32_t>(std::clamp<size_t>(8192 / blockSize(size_class), 4, 64));
+}
+
+// Overlaid on a free block
+struct FreeBlock {
+    FreeBlock* next;                    // next block in the thread cache or batch
+    std::atomic<uint64_t> batchLink;    // first block of a batch: length << 32 | next batch id
+};
+
+static_assert(sizeof(FreeBlock) <= (size_t(1) << kMinBlockShift), "FreeBlock must fit the smallest class");
+
+struct CentralList {
+    std::atomic<uint64_t> head{0};      // tag << 32 | batch id, id 0 = empty
+    std::atomic<uint32_t> slabCount{0};
+    std::array<std::atomic<char*>, kMaxSlabsPerClass> slabs{};
+};
+
+// Never destroyed: threads may still exit while static objects are torn down
+std::array<CentralList, kSizeClassCount>& centralLists() {
+    static auto* lists = new std::array<CentralList, kSizeClassCount>();
+    return *lists;
 }
 
-template<size_t BlockSize, size_t PoolSize>
-void MemoryPool<BlockSize, PoolSize>::initializeFreeList() {
-    free_blocks_.reserve(PoolSize);
-    for (size_t i = 0; i < PoolSize; ++i) {
-        free_blocks_.push_back(pool_ + i * BlockSize);
+inline uint32_t blockId(size_t size_class, const void* block) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(block);
+    const char* slab = reinterpret_cast<const char*>(address & ~(uintptr_t(kSlabBytes) - 1));
+    uint32_t slab_index;
+    std::memcpy(&slab_index, slab, sizeof(slab_index));
+    uint32_t block_index = static_cast<uint32_t>((address - reinterpret_cast<uintptr_t>(slab)) >> (kMinBlockShift + size_class));
+    return ((slab_index << kBlockIndexBits) | block_index) + 1;
+}
+
+inline FreeBlock* blockAt(size_t size_class, uint32_t id) {
+    --id;
+    char* slab = centralLists()[size_class].slabs[id >> kBlockIndexBits].load(std::memory_order_acquire);
+    return reinterpret_cast<FreeBlock*>(slab + (size_t(id & ((1u << kBlockIndexBits) - 1)) << (kMinBlockShift + size_class)));
+}
+
+inline uint64_t nextTag(uint64_t head) {
+    return (head & ~uint64_t(0xffffffff)) + (uint64_t(1) << 32);
+}
+
+void pushBatch(size_t size_class, FreeBlock* batch, uint32_t count) {
+    CentralList& list = centralLists()[size_class];
+    uint32_t id = blockId(size_class, batch);
+    uint64_t head = list.head.load(std::memory_order_relaxed);
+    uint64_t replacement;
+    do {
+        batch->batchLink.store((uint64_t(count) << 32) | static_cast<uint32_t>(head), std::memory_order_relaxed);
+        replacement = nextTag(head) | id;
+    } while (!list.head.compare_exchange_weak(head, replacement, std::memory_order_release, std::memory_order_relaxed));
+}
+
+FreeBlock* popBatch(size_t size_class, uint32_t& count) {
+    CentralList& list = centralLists()[size_class];
+    uint64_t head = list.head.load(std::memory_order_acquire);
+    while (static_cast<uint32_t>(head) != 0) {
+        FreeBlock* batch = blockAt(size_class, static_cast<uint32_t>(head));
+        uint64_t link = batch->batchLink.load(std::memory_order_relaxed);
+        uint64_t replacement = nextTag(head) | static_cast<uint32_t>(link);
+        if (list.head.compare_exchange_weak(head, replacement, std::memory_order_acquire, std::memory_order_acquire)) {
+            count = static_cast<uint32_t>(link >> 32);
+            return batch;
+        }
     }
+    return nullptr;
 }
 
-template<size_t BlockSize, size_t PoolSize>
-void* MemoryPool<BlockSize, PoolSize>::allocate() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (free_blocks_.empty()) {
-        return nullptr; // Pool exhausted
+/**
+ * Carves a new slab into batches: the first is returned, the rest go to the
+ * central list. Block 0 of every slab holds the slab's table index.
+ */
+FreeBlock* growClass(size_t size_class, uint32_t& count) {
+    CentralList& list = centralLists()[size_class];
+    uint32_t slab_index = list.slabCount.fetch_add(1, std::memory_order_relaxed);
+    if (slab_index >= kMaxSlabsPerClass) {
+        list.slabCount.store(kMaxSlabsPerClass, std::memory_order_relaxed);
+        return nullptr;
     }
-    
-    void* ptr = free_blocks_.back();
-    free_blocks_.pop_back();
-    ++used_blocks_;
-    
-    return ptr;
+    char* slab = static_cast<char*>(::operator new(kSlabBytes, std::align_val_t(kSlabBytes), std::nothrow));
+    if (!slab) {
+        return nullptr;
+    }
+    std::memcpy(slab, &slab_index, sizeof(slab_index));
+    list.slabs[slab_index].store(slab, std::memory_order_release);
+
+    const size_t size = blockSize(size_class);
+    const uint32_t batch_size = batchSize(size_class);
+    FreeBlock* first = nullptr;
+    uint32_t first_count = 0;
+    for (size_t offset = size; offset < kSlabBytes;) {
+        FreeBlock* batch = nullptr;
+        FreeBlock** tail = &batch;
+        uint32_t length = 0;
+        for (; length < batch_size && offset < kSlabBytes; ++length, offset += size) {
+            FreeBlock* block = new (slab + offset) FreeBlock;
+            *tail = block;
+            tail = &block->next;
+        }
+        *tail = nullptr;
+        if (!first) {
+            first = batch;
+            first_count = length;
+        } else {
+            pushBatch(size_class, batch, length);
+        }
+    }
+    count = first_count;
+    return first;
 }
 
-template<size_t BlockSize, size_t PoolSize>
-void MemoryPool<BlockSize, PoolSize>::deallocate(void* ptr) {
-    if (!ptr) return;
-    
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    // Verify pointer is within our pool
-    if (ptr >= pool_ && ptr < pool_ + PoolSize * BlockSize) {
-        free_blocks_.push_back(ptr);
-        --used_blocks_;
+// Per-thread statistics; only the owning thread writes, so no RMW is needed
+struct StatsShard {
+    std::atomic<uint64_t> allocated{0};
+    std::atomic<uint64_t> deallocated{0};
+    std::atomic<uint64_t> pooledAllocated{0};
+    std::atomic<uint64_t> pooledDeallocated{0};
+};
+
+inline void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+struct StatsTotals {
+    uint64_t allocated = 0;
+    uint64_t deallocated = 0;
+    uint64_t pooledAllocated = 0;
+    uint64_t pooledDeallocated = 0;
+
+    void add(const StatsShard& shard) {
+        allocated += shard.allocated.load(std::memory_order_relaxed);
+        deallocated += shard.deallocated.load(std::memory_order_relaxed);
+        pooledAllocated += shard.pooledAllocated.load(std::memory_order_relaxed);
+        pooledDeallocated += shard.pooledDeallocated.load(std::memory_order_relaxed);
+    }
+};
+
+struct StatsRegistry {
+    std::mutex mutex;
+    std::vector<StatsShard*> live;
+    StatsTotals retired;                // folded in from exited threads
+    StatsTotals baseline;               // totals at the last resetStats()
+    std::atomic<int64_t> usage{0};      // shared total, updated in kUsageStep steps
+    std::atomic<int64_t> peak{0};
+    int64_t baselineUsage = 0;
+};
+
+// Never destroyed, like the central lists
+StatsRegistry& statsRegistry() {
+    static StatsRegistry* instance = new StatsRegistry();
+    return *instance;
+}
+
+struct ClassCache {
+    FreeBlock* head = nullptr;
+    uint32_t count = 0;
+};
+
+struct ThreadCache {
+    std::array<ClassCache, kSizeClassCount> classes;
+    StatsShard* stats;
+    int64_t pendingUsage = 0;           // not yet added to the shared total
+
+    ThreadCache() : stats(new StatsShard()) {
+        StatsRegistry& registry = statsRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.live.push_back(stats);
+    }
+
+    ~ThreadCache() {
+        flush();
+        StatsRegistry& registry = statsRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.retired.add(*stats);
+        registry.live.erase(std::remove(registry.live.begin(), registry.live.end(), stats), registry.live.end());
+        delete stats;
+    }
+
+    void addUsage(int64_t delta) {
+        pendingUsage += delta;
+        if (pendingUsage >= kUsageStep || pendingUsage <= -kUsageStep) {
+            publishUsage();
+        }
     }
+
+    void publishUsage() {
+        StatsRegistry& registry = statsRegistry();
+        int64_t usage = registry.usage.fetch_add(pendingUsage, std::memory_order_relaxed) + pendingUsage;
+        pendingUsage = 0;
+        int64_t peak = registry.peak.load(std::memory_order_relaxed);
+        while (usage > peak && !registry.peak.compare_exchange_weak(peak, usage, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Hands every cached block back to the central lists
+    void flush() {
+        for (size_t size_class = 0; size_class < kSizeClassCount; ++size_class) {
+            ClassCache& cache = classes[size_class];
+            while (cache.count > 0) {
+                releaseBatch(size_class, std::min(cache.count, batchSize(size_class)));
+            }
+        }
+        publishUsage();
+    }
+
+    // Detaches the first count cached blocks as one batch
+    void releaseBatch(size_t size_class, uint32_t count) {
+        ClassCache& cache = classes[size_class];
+        FreeBlock* batch = cache.head;
+        FreeBlock* last = batch;
+        for (uint32_t i = 1; i < count; ++i) {
+            last = last->next;
+        }
+        cache.head = last->next;
+        cache.count -= count;
+        last->next = nullptr;
+        pushBatch(size_class, batch, count);
+    }
+};
+
+thread_local ThreadCache t_cache;
+
+void* allocateBlock(size_t size_class) {
+    ClassCache& cache = t_cache.classes[size_class];
+    if (cache.count == 0) {
+        uint32_t count = 0;
+        FreeBlock* batch = popBatch(size_class, count);
+        if (!batch) {
+            batch = growClass(size_class, count);
+        }
+        if (!batch) {
+            return nullptr;
+        }
+        cache.head = batch;
+        cache.count = count;
+    }
+    FreeBlock* block = cache.head;
+    cache.head = block->next;
+    --cache.count;
+    return block;
 }
 
-// Explicit template instantiations
-template class MemoryPool<32, 1024>;
-template class MemoryPool<128, 512>;
-template class MemoryPool<512, 256>;
-template class MemoryPool<2048, 128>;
+void deallocateBlock(void* ptr, size_t size_class) {
+    ClassCache& cache = t_cache.classes[size_class];
+    FreeBlock* block = new (ptr) FreeBlock;
+    block->next = cache.head;
+    cache.head = block;
+    // Keep up to two batches so alternating allocate/free does not bounce batches
+    if (++cache.count >= 2 * batchSize(size_class)) {
+        t_cache.releaseBatch(size_class, batchSize(size_class));
+    }
+}
+
+} // anonymous namespace
 
 // MemoryManager implementation
-MemoryManager::MemoryManager() 
-    : small_pool_(std::make_unique<MemoryPool<32>>())
-    , medium_pool_(std::make_unique<MemoryPool<128>>())
-    , large_pool_(std::make_unique<MemoryPool<512>>())
-    , xlarge_pool_(std::make_unique<MemoryPool<2048>>())
-    , memory_limit_(10 * 1024 * 1024) // 10MB default limit
+MemoryManager::MemoryManager()
+    : memory_limit_(10 * 1024 * 1024) // 10MB default limit
 {
     resetStats();
 }
@@ -79,130 +319,86 @@ MemoryManager::MemoryManager()
 MemoryManager::~MemoryManager() = default;
 
 MemoryManager& MemoryManager::getInstance() {
-    static MemoryManager instance;
-    return instance;
+    // Never destroyed: thread caches return blocks on thread exit
+    static MemoryManager* instance = new MemoryManager();
+    return *instance;
 }
 
 void* MemoryManager::allocate(size_t size) {
     if (size == 0) return nullptr;
-    
+
     // Check memory limit
     if (isMemoryLimitExceeded()) {
         return nullptr;
     }
-    
-    void* ptr = nullptr;
-    
-    // Try pool allocation first
-    ptr = allocateFromPool(size);
-    
-    // Fall back to system allocation if pools are exhausted
-    if (!ptr) {
-        ptr = allocateFromSystem(size);
-    }
-    
+
+    bool pooled = size <= kMaxPooledSize;
+    void* ptr = pooled ? allocateBlock(sizeClassFor(size)) : std::malloc(size);
     if (ptr) {
-        updateStats(size, true);
-        
-        // Track allocation size for proper deallocation
-        std::lock_guard<std::mutex> lock(allocation_mutex_);
-        allocation_sizes_[ptr] = size;
+        ThreadCache& cache = t_cache;
+        bump(cache.stats->allocated, size);
+        if (pooled) {
+            bump(cache.stats->pooledAllocated, size);
+        }
+        cache.addUsage(static_cast<int64_t>(size));
     }
-    
+
     return ptr;
 }
 
 void MemoryManager::deallocate(void* ptr, size_t size) {
     if (!ptr) return;
-    
-    // Remove from tracking
-    {
-        std::lock_guard<std::mutex> lock(allocation_mutex_);
-        auto it = allocation_sizes_.find(ptr);
-        if (it != allocation_sizes_.end()) {
-            size = it->second; // Use tracked size
-            allocation_sizes_.erase(it);
-        }
-    }
-    
-    updateStats(size, false);
-    
-    // Try pool deallocation first
-    bool deallocated = false;
-    
-    if (size <= 32) {
-        small_pool_->deallocate(ptr);
-        deallocated = true;
-    } else if (size <= 128) {
-        medium_pool_->deallocate(ptr);
-        deallocated = true;
-    } else if (size <= 512) {
-        large_pool_->deallocate(ptr);
-        deallocated = true;
-    } else if (size <= 2048) {
-        xlarge_pool_->deallocate(ptr);
-        deallocated = true;
-    }
-    
-    // Fall back to system deallocation
-    if (!deallocated) {
-        std::free(ptr);
-    }
-}
 
-void* MemoryManager::allocateFromPool(size_t size) {
-    if (size <= 32) {
-        return small_pool_->allocate();
-    } else if (size <= 128) {
-        return medium_pool_->allocate();
-    } else if (size <= 512) {
-        return large_pool_->allocate();
-    } else if (size <= 2048) {
-        return xlarge_pool_->allocate();
-    }
-    
-    return nullptr; // Size too large for pools
-}
-
-void* MemoryManager::allocateFromSystem(size_t size) {
-    return std::malloc(size);
-}
+    ThreadCache& cache = t_cache;
+    bump(cache.stats->deallocated, size);
+    cache.addUsage(-static_cast<int64_t>(size));
 
-void MemoryManager::updateStats(size_t size, bool allocating) {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    
-    if (allocating) {
-        stats_.totalAllocated += size;
-        stats_.currentUsage += size;
-        stats_.peakUsage = std::max(stats_.peakUsage, stats_.currentUsage);
+    if (size != 0 && size <= kMaxPooledSize) {
+        bump(cache.stats->pooledDeallocated, size);
+        deallocateBlock(ptr, sizeClassFor(size));
     } else {
-        stats_.totalDeallocated += size;
-        stats_.currentUsage = (stats_.currentUsage >= size) ? 
-                             stats_.currentUsage - size : 0;
+        std::free(ptr);
     }
-    
-    // Update pool usage
-    stats_.poolUsage = small_pool_->getUsedBlocks() * 32 +
-                      medium_pool_->getUsedBlocks() * 128 +
-                      large_pool_->getUsedBlocks() * 512 +
-                      xlarge_pool_->getUsedBlocks() * 2048;
-    
-    stats_.systemUsage = stats_.currentUsage - stats_.poolUsage;
 }
 
 MemoryManager::MemoryStats MemoryManager::getStats() const {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    return stats_;
+    StatsRegistry& registry = statsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    StatsTotals totals = registry.retired;
+    for (const StatsShard* shard : registry.live) {
+        totals.add(*shard);
+    }
+
+    MemoryStats stats;
+    stats.totalAllocated = totals.allocated - registry.baseline.allocated;
+    stats.totalDeallocated = totals.deallocated - registry.baseline.deallocated;
+    stats.currentUsage = stats.totalAllocated >= stats.totalDeallocated ?
+                         stats.totalAllocated - stats.totalDeallocated : 0;
+    uint64_t pooled_allocated = totals.pooledAllocated - registry.baseline.pooledAllocated;
+    uint64_t pooled_deallocated = totals.pooledDeallocated - registry.baseline.pooledDeallocated;
+    stats.poolUsage = pooled_allocated >= pooled_deallocated ? pooled_allocated - pooled_deallocated : 0;
+    stats.systemUsage = stats.currentUsage >= stats.poolUsage ? stats.currentUsage - stats.poolUsage : 0;
+
+    int64_t peak = registry.peak.load(std::memory_order_relaxed) - registry.baselineUsage;
+    stats.peakUsage = std::max(stats.currentUsage, static_cast<size_t>(std::max<int64_t>(0, peak)));
+    return stats;
 }
 
 void MemoryManager::resetStats() {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    stats_ = MemoryStats{};
+    StatsRegistry& registry = statsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    StatsTotals totals = registry.retired;
+    for (const StatsShard* shard : registry.live) {
+        totals.add(*shard);
+    }
+    registry.baseline = totals;
+    registry.baselineUsage = static_cast<int64_t>(totals.allocated - totals.deallocated);
+    registry.peak.store(registry.baselineUsage, std::memory_order_relaxed);
 }
 
 void MemoryManager::compactPools() {
-    // Pools are pre-allocated, so compaction is not needed
-    // This could be extended to support dynamic pool resizing
+    // Slabs stay mapped; this only stops the caller's cache from holding blocks
+    t_cache.flush();
 }
 
 void MemoryManager::setMemoryLimit(size_t limitBytes) {
@@ -210,8 +406,8 @@ void MemoryManager::setMemoryLimit(size_t limitBytes) {
 }
 
 bool MemoryManager::isMemoryLimitExceeded() const {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    return stats_.currentUsage >= memory_limit_;
+    int64_t usage = statsRegistry().usage.load(std::memory_order_relaxed) + t_cache.pendingUsage;
+    return usage >= 0 && static_cast<size_t>(usage) >= memory_limit_;
 }
 
-} // namespace phantomvault
\ No newline at end of file
+} // namespace phantomvault
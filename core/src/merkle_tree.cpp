@@ -0,0 +1,728 @@
+/**
+ * PhantomVault Merkle Tree Implementation
+ *
+ * integrity.mtree: {"version":1,"algorithm":"sha256","root":"<hex>",
+ *                   "leaves":[{"id","kind","hash","size","fp"},...]}
+ * kind is "p" for a packed object and "f" for a standalone .enc file; fp is
+ * the object's location/mtime fingerprint, used to skip rehashing unchanged
+ * objects on rebuild. A packed object's location includes the generation of
+ * its segment store, so a store recreated by a later lock never matches.
+ */
+
+#include "merkle_tree.hpp"
+#include "segment_store.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <set>
+#include <thread>
+#include <unordered_set>
+#include <openssl/evp.h>
+#include <nlohmann/json.hpp>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace phantomvault {
+
+namespace {
+
+using Digest = std::array<unsigned char, 32>;
+
+constexpr int kFormatVersion = 1;
+constexpr size_t kMaxThreads = 8;
+constexpr size_t kReadBufferSize = 1024 * 1024;
+constexpr uint64_t kChunkBytes = 8 * 1024 * 1024;   // work unit handed to one thread at a time
+
+enum class Kind : unsigned char {
+    PACKED = 'p',
+    FILE = 'f'
+};
+
+// An encrypted object as currently found on disk
+struct Entry {
+    std::string id;
+    Kind kind = Kind::PACKED;
+    std::string path;
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    uint64_t fingerprint = 0;
+};
+
+struct Leaf {
+    std::string id;
+    Kind kind = Kind::PACKED;
+    Digest content{};
+    uint64_t size = 0;
+    uint64_t fingerprint = 0;
+};
+
+using LeafKey = std::pair<std::string, Kind>;
+
+bool leafOrder(const Leaf& a, const Leaf& b) {
+    return a.id != b.id ? a.id < b.id : a.kind < b.kind;
+}
+
+std::string toHex(const Digest& digest) {
+    static const char kDigits[] = "0123456789abcdef";
+    std::string hex(digest.size() * 2, '0');
+    for (size_t i = 0; i < digest.size(); ++i) {
+        hex[2 * i] = kDigits[digest[i] >> 4];
+        hex[2 * i + 1] = kDigits[digest[i] & 0x0f];
+    }
+    return hex;
+}
+
+bool fromHex(const std::string& hex, Digest& out) {
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    };
+    if (hex.size() != out.size() * 2) {
+        return false;
+    }
+    for (size_t i = 0; i < out.size(); ++i) {
+        int high = nibble(hex[2 * i]);
+        int low = nibble(hex[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        out[i] = static_cast<unsigned char>((high << 4) | low);
+    }
+    return true;
+}
+
+uint64_t mix(uint64_t hash, uint64_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+class Sha256 {
+public:
+    Sha256() : context_(EVP_MD_CTX_new()) {}
+    ~Sha256() { EVP_MD_CTX_free(context_); }
+
+    Sha256(const Sha256&) = delete;
+    Sha256& operator=(const Sha256&) = delete;
+
+    void begin() { EVP_DigestInit_ex(context_, EVP_sha256(), nullptr); }
+    void update(const void* data, size_t size) { EVP_DigestUpdate(context_, data, size); }
+
+    Digest finish() {
+        Digest digest{};
+        unsigned int length = 0;
+        EVP_DigestFinal_ex(context_, digest.data(), &length);
+        return digest;
+    }
+
+private:
+    EVP_MD_CTX* context_;
+};
+
+Digest leafHash(Sha256& sha, const Leaf& leaf) {
+    const unsigned char prefix[2] = {0x00, static_cast<unsigned char>(leaf.kind)};
+    const unsigned char separator = 0x00;
+    sha.begin();
+    sha.update(prefix, sizeof(prefix));
+    sha.update(leaf.id.data(), leaf.id.size());
+    sha.update(&separator, 1);
+    sha.update(leaf.content.data(), leaf.content.size());
+    return sha.finish();
+}
+
+Digest nodeHash(Sha256& sha, const Digest& left, const Digest& right) {
+    const unsigned char prefix = 0x01;
+    sha.begin();
+    sha.update(&prefix, 1);
+    sha.update(left.data(), left.size());
+    sha.update(right.data(), right.size());
+    return sha.finish();
+}
+
+/**
+ * Reads and hashes objects for one worker thread. Segment files stay open
+ * across objects, since consecutive work items are usually in the same one.
+ */
+class ObjectReader {
+public:
+    ObjectReader() : buffer_(kReadBufferSize) {}
+
+    ~ObjectReader() {
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+#endif
+    }
+
+    ObjectReader(const ObjectReader&) = delete;
+    ObjectReader& operator=(const ObjectReader&) = delete;
+
+    std::optional<Digest> hash(const Entry& entry) {
+        if (!openFile(entry.path)) {
+            return std::nullopt;
+        }
+
+        sha_.begin();
+        uint64_t done = 0;
+        while (done < entry.length) {
+            size_t want = static_cast<size_t>(std::min<uint64_t>(buffer_.size(), entry.length - done));
+            if (!readAt(entry.offset + done, want)) {
+                return std::nullopt;
+            }
+            sha_.update(buffer_.data(), want);
+            done += want;
+        }
+        return sha_.finish();
+    }
+
+private:
+    Sha256 sha_;
+    std::vector<unsigned char> buffer_;
+    std::string path_;
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    int fd_ = -1;
+#else
+    std::ifstream file_;
+#endif
+
+    bool openFile(const std::string& path) {
+        if (path == path_) {
+            return true;
+        }
+        path_.clear();
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            return false;
+        }
+#ifdef PLATFORM_LINUX
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#else
+        file_.close();
+        file_.clear();
+        file_.open(path, std::ios::binary);
+        if (!file_) {
+            return false;
+        }
+#endif
+        path_ = path;
+        return true;
+    }
+
+    bool readAt(uint64_t offset, size_t size) {
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+        size_t done = 0;
+        while (done < size) {
+            ssize_t n = ::pread(fd_, buffer_.data() + done, size - done, static_cast<off_t>(offset + done));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+#else
+        file_.seekg(static_cast<std::streamoff>(offset));
+        return static_cast<bool>(file_.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(size)));
+#endif
+    }
+};
+
+/**
+ * Hash entries in parallel. Work is ordered by file and offset and handed out
+ * in chunks of a few megabytes, so each thread reads sequentially and the
+ * disk, not the hashing, sets the pace.
+ */
+std::vector<std::optional<Digest>> hashEntries(const std::vector<const Entry*>& entries, size_t threads,
+                                               uint64_t& bytesRead) {
+    std::vector<std::optional<Digest>> digests(entries.size());
+    bytesRead = 0;
+    if (entries.empty()) {
+        return digests;
+    }
+
+    std::vector<size_t> order(entries.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&entries](size_t a, size_t b) {
+        if (entries[a]->path != entries[b]->path) {
+            return entries[a]->path < entries[b]->path;
+        }
+        return entries[a]->offset < entries[b]->offset;
+    });
+
+    std::vector<size_t> chunkStarts;
+    uint64_t chunkBytes = kChunkBytes;
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (chunkBytes >= kChunkBytes) {
+            chunkStarts.push_back(i);
+            chunkBytes = 0;
+        }
+        chunkBytes += std::max<uint64_t>(entries[order[i]]->length, 4096);
+    }
+    chunkStarts.push_back(order.size());
+
+    size_t chunkCount = chunkStarts.size() - 1;
+    threads = threads > 0 ? threads : std::max<size_t>(1, std::thread::hardware_concurrency());
+    threads = std::min({threads, kMaxThreads, chunkCount});
+
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<uint64_t> totalBytes{0};
+    auto worker = [&]() {
+        ObjectReader reader;
+        uint64_t localBytes = 0;
+        for (size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+            for (size_t i = chunkStarts[chunk]; i < chunkStarts[chunk + 1]; ++i) {
+                const Entry& entry = *entries[order[i]];
+                digests[order[i]] = reader.hash(entry);
+                localBytes += entry.length;
+            }
+        }
+        totalBytes += localBytes;
+    };
+
+    if (threads <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> pool;
+        pool.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            pool.emplace_back(worker);
+        }
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+
+    bytesRead = totalBytes;
+    return digests;
+}
+
+} // namespace
+
+class MerkleTree::Implementation {
+public:
+    bool build(const std::string& vaultFolder, size_t threads) {
+        std::vector<Entry> entries;
+        if (!scan(vaultFolder, entries)) {
+            return false;
+        }
+
+        std::map<LeafKey, const Leaf*> previous;
+        for (const auto& leaf : leaves_) {
+            previous.emplace(LeafKey(leaf.id, leaf.kind), &leaf);
+        }
+
+        std::vector<Leaf> leaves(entries.size());
+        std::vector<const Entry*> toHash;
+        std::vector<size_t> toHashSlots;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const Entry& entry = entries[i];
+            leaves[i].id = entry.id;
+            leaves[i].kind = entry.kind;
+            leaves[i].size = entry.length;
+            leaves[i].fingerprint = entry.fingerprint;
+
+            auto it = previous.find(LeafKey(entry.id, entry.kind));
+            if (it != previous.end() && it->second->fingerprint == entry.fingerprint && it->second->size == entry.length) {
+                leaves[i].content = it->second->content;
+            } else {
+                toHash.push_back(&entry);
+                toHashSlots.push_back(i);
+            }
+        }
+
+        uint64_t bytesRead = 0;
+        auto digests = hashEntries(toHash, threads, bytesRead);
+        for (size_t i = 0; i < digests.size(); ++i) {
+            if (!digests[i]) {
+                last_error_ = "Failed to read vault object: " + toHash[i]->id;
+                return false;
+            }
+            leaves[toHashSlots[i]].content = *digests[i];
+        }
+
+        std::sort(leaves.begin(), leaves.end(), leafOrder);
+        leaves_ = std::move(leaves);
+        rebuildLevels();
+        recorded_root_ = computedRoot();
+        return true;
+    }
+
+    bool update(const std::string& vaultFolder, const std::vector<std::string>& objectIds) {
+        if (objectIds.empty()) {
+            return true;
+        }
+        std::vector<Entry> entries;
+        if (!scan(vaultFolder, entries)) {
+            return false;
+        }
+
+        std::unordered_set<std::string> wanted(objectIds.begin(), objectIds.end());
+        std::vector<const Entry*> toHash;
+        for (const auto& entry : entries) {
+            if (wanted.count(entry.id)) {
+                toHash.push_back(&entry);
+            }
+        }
+
+        uint64_t bytesRead = 0;
+        auto digests = hashEntries(toHash, 0, bytesRead);
+
+        // Changed contents of existing leaves only touch their paths to the root
+        bool structural = false;
+        std::vector<size_t> touched;
+        std::map<LeafKey, size_t> positions;
+        for (size_t i = 0; i < leaves_.size(); ++i) {
+            positions.emplace(LeafKey(leaves_[i].id, leaves_[i].kind), i);
+        }
+        std::set<LeafKey> present;
+        for (size_t i = 0; i < toHash.size(); ++i) {
+            if (!digests[i]) {
+                last_error_ = "Failed to read vault object: " + toHash[i]->id;
+                return false;
+            }
+            LeafKey key(toHash[i]->id, toHash[i]->kind);
+            present.insert(key);
+
+            Leaf leaf;
+            leaf.id = toHash[i]->id;
+            leaf.kind = toHash[i]->kind;
+            leaf.content = *digests[i];
+            leaf.size = toHash[i]->length;
+            leaf.fingerprint = toHash[i]->fingerprint;
+
+            auto it = positions.find(key);
+            if (it != positions.end()) {
+                leaves_[it->second] = std::move(leaf);
+                touched.push_back(it->second);
+            } else {
+                leaves_.push_back(std::move(leaf));
+                structural = true;
+            }
+        }
+
+        size_t before = leaves_.size();
+        leaves_.erase(std::remove_if(leaves_.begin(), leaves_.end(), [&](const Leaf& leaf) {
+            return wanted.count(leaf.id) && !present.count(LeafKey(leaf.id, leaf.kind));
+        }), leaves_.end());
+        structural = structural || leaves_.size() != before;
+
+        if (structural) {
+            std::sort(leaves_.begin(), leaves_.end(), leafOrder);
+            rebuildLevels();
+        } else {
+            for (size_t position : touched) {
+                updatePath(position);
+            }
+        }
+        recorded_root_ = computedRoot();
+        return true;
+    }
+
+    bool save(const std::string& path) const {
+        try {
+            json document;
+            document["version"] = kFormatVersion;
+            document["algorithm"] = "sha256";
+            document["root"] = toHex(recorded_root_);
+            json leaves = json::array();
+            for (const auto& leaf : leaves_) {
+                leaves.push_back({
+                    {"id", leaf.id},
+                    {"kind", std::string(1, static_cast<char>(leaf.kind))},
+                    {"hash", toHex(leaf.content)},
+                    {"size", leaf.size},
+                    {"fp", leaf.fingerprint}
+                });
+            }
+            document["leaves"] = std::move(leaves);
+
+            std::string tempPath = path + ".tmp";
+            {
+                std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+                if (!file) {
+                    last_error_ = "Failed to create " + tempPath;
+                    return false;
+                }
+                file << document.dump();
+                if (!file) {
+                    last_error_ = "Failed to write " + tempPath;
+                    return false;
+                }
+            }
+            fs::permissions(tempPath, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace);
+            fs::rename(tempPath, path);
+            return true;
+        } catch (const std::exception& e) {
+            last_error_ = "Failed to save integrity tree: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    bool load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            last_error_ = "Integrity tree not found: " + path;
+            return false;
+        }
+        json document = json::parse(file, nullptr, false);
+        if (document.is_discarded() || !document.is_object() || document.value("version", 0) != kFormatVersion ||
+            document.value("algorithm", "") != "sha256") {
+            last_error_ = "Unreadable integrity tree: " + path;
+            return false;
+        }
+
+        try {
+            Digest root{};
+            if (!fromHex(document.value("root", ""), root)) {
+                last_error_ = "Integrity tree has no valid root";
+                return false;
+            }
+            std::vector<Leaf> leaves;
+            for (const auto& record : document.at("leaves")) {
+                Leaf leaf;
+                leaf.id = record.at("id").get<std::string>();
+                leaf.kind = record.at("kind").get<std::string>() == "f" ? Kind::FILE : Kind::PACKED;
+                if (!fromHex(record.at("hash").get<std::string>(), leaf.content)) {
+                    last_error_ = "Integrity tree has a malformed leaf: " + leaf.id;
+                    return false;
+                }
+                leaf.size = record.at("size").get<uint64_t>();
+                leaf.fingerprint = record.at("fp").get<uint64_t>();
+                leaves.push_back(std::move(leaf));
+            }
+            std::sort(leaves.begin(), leaves.end(), leafOrder);
+            leaves_ = std::move(leaves);
+            rebuildLevels();
+            recorded_root_ = root;
+            return true;
+        } catch (const std::exception& e) {
+            last_error_ = "Unreadable integrity tree: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    VerifyResult verify(const std::string& vaultFolder, const VerifyOptions& options) const {
+        auto start = std::chrono::steady_clock::now();
+        VerifyResult result;
+        result.objectsTotal = leaves_.size();
+        result.rootMatches = computedRoot() == recorded_root_;
+
+        std::vector<Entry> entries;
+        if (!scan(vaultFolder, entries)) {
+            result.duration = elapsedSince(start);
+            return result;
+        }
+        std::map<LeafKey, const Entry*> onDisk;
+        for (const auto& entry : entries) {
+            onDisk.emplace(LeafKey(entry.id, entry.kind), &entry);
+        }
+
+        // Full scrub, or a random sample for a spot-check
+        std::vector<size_t> chosen(leaves_.size());
+        std::iota(chosen.begin(), chosen.end(), 0);
+        bool sampling = options.sampleRate < 1.0;
+        if (sampling) {
+            size_t count = static_cast<size_t>(std::ceil(std::max(0.0, options.sampleRate) * leaves_.size()));
+            std::mt19937_64 random(options.seed != 0 ? options.seed : std::random_device{}());
+            std::shuffle(chosen.begin(), chosen.end(), random);
+            chosen.resize(std::min(count, chosen.size()));
+        }
+
+        std::vector<const Entry*> toHash;
+        std::vector<size_t> toHashLeaves;
+        for (size_t index : chosen) {
+            const Leaf& leaf = leaves_[index];
+            auto it = onDisk.find(LeafKey(leaf.id, leaf.kind));
+            if (it == onDisk.end()) {
+                result.missingObjects.push_back(leaf.id);
+                continue;
+            }
+            toHash.push_back(it->second);
+            toHashLeaves.push_back(index);
+        }
+
+        if (!sampling) {
+            std::set<LeafKey> known;
+            for (const auto& leaf : leaves_) {
+                known.emplace(leaf.id, leaf.kind);
+            }
+            for (const auto& entry : entries) {
+                if (!known.count(LeafKey(entry.id, entry.kind))) {
+                    result.unexpectedObjects.push_back(entry.id);
+                }
+            }
+        }
+
+        auto digests = hashEntries(toHash, options.threads, result.bytesChecked);
+        for (size_t i = 0; i < digests.size(); ++i) {
+            const Leaf& leaf = leaves_[toHashLeaves[i]];
+            if (!digests[i]) {
+                result.missingObjects.push_back(leaf.id);
+            } else if (*digests[i] != leaf.content) {
+                result.corruptObjects.push_back(leaf.id);
+            }
+        }
+        result.objectsChecked = toHash.size();
+
+        result.success = result.rootMatches && result.corruptObjects.empty() &&
+                         result.missingObjects.empty() && result.unexpectedObjects.empty();
+        result.duration = elapsedSince(start);
+        return result;
+    }
+
+    std::string getRootHex() const {
+        return toHex(recorded_root_);
+    }
+
+    size_t getLeafCount() const {
+        return leaves_.size();
+    }
+
+    std::string getLastError() const {
+        return last_error_;
+    }
+
+private:
+    std::vector<Leaf> leaves_;
+    std::vector<std::vector<Digest>> levels_;   // levels_[0] = leaf hashes, back() = root
+    Digest recorded_root_{};
+    mutable std::string last_error_;
+
+    static std::chrono::milliseconds elapsedSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    Digest computedRoot() const {
+        return levels_.empty() || levels_.back().empty() ? Digest{} : levels_.back().front();
+    }
+
+    void rebuildLevels() {
+        Sha256 sha;
+        levels_.clear();
+        std::vector<Digest> level;
+        level.reserve(leaves_.size());
+        for (const auto& leaf : leaves_) {
+            level.push_back(leafHash(sha, leaf));
+        }
+        levels_.push_back(std::move(level));
+
+        while (levels_.back().size() > 1) {
+            const auto& below = levels_.back();
+            std::vector<Digest> above;
+            above.reserve((below.size() + 1) / 2);
+            for (size_t i = 0; i + 1 < below.size(); i += 2) {
+                above.push_back(nodeHash(sha, below[i], below[i + 1]));
+            }
+            if (below.size() % 2 == 1) {
+                above.push_back(below.back());
+            }
+            levels_.push_back(std::move(above));
+        }
+    }
+
+    void updatePath(size_t position) {
+        Sha256 sha;
+        levels_[0][position] = leafHash(sha, leaves_[position]);
+        for (size_t depth = 1; depth < levels_.size(); ++depth) {
+            const auto& below = levels_[depth - 1];
+            size_t left = position & ~size_t(1);
+            position /= 2;
+            levels_[depth][position] = left + 1 < below.size() ? nodeHash(sha, below[left], below[left + 1])
+                                                                : below[left];
+        }
+    }
+
+    // Packed objects from the segment index, then standalone .enc files
+    bool scan(const std::string& vaultFolder, std::vector<Entry>& entries) const {
+        try {
+            if (SegmentStore::exists(vaultFolder)) {
+                SegmentStore pack;
+                if (!pack.open(vaultFolder)) {
+                    last_error_ = "Failed to open vault pack: " + pack.getLastError();
+                    return false;
+                }
+                entries.reserve(pack.getObjectCount());
+                pack.forEachObject([&](const std::string& id, const SegmentStore::ObjectLocation& location) {
+                    Entry entry;
+                    entry.id = id;
+                    entry.kind = Kind::PACKED;
+                    entry.path = SegmentStore::segmentPath(vaultFolder, location.segment);
+                    entry.offset = location.offset;
+                    entry.length = location.length;
+                    entry.fingerprint = mix(mix(mix(pack.getGeneration(), location.segment), location.offset),
+                                            location.length);
+                    entries.push_back(std::move(entry));
+                });
+            }
+
+            for (const auto& file : fs::recursive_directory_iterator(vaultFolder)) {
+                if (!file.is_regular_file() || file.path().extension() != ".enc") {
+                    continue;
+                }
+                std::string relative = fs::relative(file.path(), vaultFolder).generic_string();
+                Entry entry;
+                entry.id = relative.substr(0, relative.size() - 4);
+                entry.kind = Kind::FILE;
+                entry.path = file.path().string();
+                entry.length = file.file_size();
+                entry.fingerprint = mix(static_cast<uint64_t>(file.last_write_time().time_since_epoch().count()),
+                                        entry.length);
+                entries.push_back(std::move(entry));
+            }
+            return true;
+        } catch (const std::exception& e) {
+            last_error_ = "Failed to scan vault folder: " + std::string(e.what());
+            return false;
+        }
+    }
+};
+
+MerkleTree::MerkleTree() : pimpl(std::make_unique<Implementation>()) {}
+MerkleTree::~MerkleTree() = default;
+
+bool MerkleTree::build(const std::string& vaultFolder, size_t threads) { return pimpl->build(vaultFolder, threads); }
+
+bool MerkleTree::update(const std::string& vaultFolder, const std::vector<std::string>& objectIds) {
+    return pimpl->update(vaultFolder, objectIds);
+}
+
+bool MerkleTree::save(const std::string& path) const { return pimpl->save(path); }
+bool MerkleTree::load(const std::string& path) { return pimpl->load(path); }
+
+MerkleTree::VerifyResult MerkleTree::verify(const std::string& vaultFolder) const {
+    return pimpl->verify(vaultFolder, VerifyOptions{});
+}
+
+MerkleTree::VerifyResult MerkleTree::verify(const std::string& vaultFolder, const VerifyOptions& options) const {
+    return pimpl->verify(vaultFolder, options);
+}
+
+std::string MerkleTree::getRootHex() const { return pimpl->getRootHex(); }
+size_t MerkleTree::getLeafCount() const { return pimpl->getLeafCount(); }
+std::string MerkleTree::getLastError() const { return pimpl->getLastError(); }
+
+} // namespace phantomvault
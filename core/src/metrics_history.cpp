@@ -0,0 +1,250 @@
+/**
+ * PhantomVault Metrics History Implementation
+ *
+ * Each slot is a seqlock: the writer marks it odd while storing the record
+ * words and then publishes 2 * (append index + 1). A reader accepts a slot
+ * only if it sees that exact value before and after copying the words, which
+ * rejects both torn reads and records already overwritten by a later lap.
+ */
+
+#include "metrics_history.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace phantomvault {
+
+namespace {
+
+constexpr char kHistoryMagic[8] = {'P', 'V', 'M', 'H', 'I', 'S', 'T', '1'};
+constexpr uint32_t kHistoryVersion = 1;
+constexpr size_t kSampleWords = sizeof(MetricsSample) / sizeof(uint64_t);
+
+struct HistoryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t capacity;
+    std::atomic<uint64_t> appended;     // total records ever appended
+};
+
+struct HistorySlot {
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> words[kSampleWords];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "history slots are shared through a file mapping");
+static_assert(sizeof(HistoryHeader) == 32 && sizeof(HistorySlot) == 32, "history file layout");
+
+} // anonymous namespace
+
+class MetricsHistory::Implementation {
+public:
+    explicit Implementation(size_t capacity)
+        : capacity_(std::max<size_t>(1, capacity))
+        , memory_header_{}
+        , memory_slots_(new HistorySlot[capacity_]())
+        , header_(&memory_header_)
+        , slots_(memory_slots_.get()) {
+        std::memcpy(memory_header_.magic, kHistoryMagic, sizeof(kHistoryMagic));
+        memory_header_.version = kHistoryVersion;
+        memory_header_.recordSize = sizeof(MetricsSample);
+        memory_header_.capacity = capacity_;
+    }
+
+    ~Implementation() {
+        unmapFile();
+    }
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    bool open(const std::string& path) {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        if (mapping_) {
+            last_error_ = "Metrics history is already open";
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            last_error_ = "Failed to open metrics history: " + path;
+            return false;
+        }
+
+        size_t size = sizeof(HistoryHeader) + capacity_ * sizeof(HistorySlot);
+        struct stat st;
+        bool reuse = fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == size;
+        if (!reuse && (ftruncate(fd, 0) != 0 || ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+            ::close(fd);
+            last_error_ = "Failed to size metrics history: " + path;
+            return false;
+        }
+
+        void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (region == MAP_FAILED) {
+            last_error_ = "Failed to map metrics history: " + path;
+            return false;
+        }
+
+        auto* header = static_cast<HistoryHeader*>(region);
+        reuse = reuse && std::memcmp(header->magic, kHistoryMagic, sizeof(kHistoryMagic)) == 0 &&
+                header->version == kHistoryVersion && header->recordSize == sizeof(MetricsSample) &&
+                header->capacity == capacity_;
+        if (!reuse) {
+            std::memset(region, 0, size);
+            std::memcpy(header->magic, kHistoryMagic, sizeof(kHistoryMagic));
+            header->version = kHistoryVersion;
+            header->recordSize = sizeof(MetricsSample);
+            header->capacity = capacity_;
+        }
+
+        mapping_ = region;
+        mapped_size_ = size;
+        header_ = header;
+        slots_ = reinterpret_cast<HistorySlot*>(static_cast<uint8_t*>(region) + sizeof(HistoryHeader));
+        memory_slots_.reset();
+        return true;
+    }
+
+    bool flush() {
+        if (!mapping_) {
+            return true;
+        }
+        if (msync(mapping_, mapped_size_, MS_ASYNC) != 0) {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            last_error_ = "Failed to flush metrics history";
+            return false;
+        }
+        return true;
+    }
+
+    void unmapFile() {
+        if (mapping_) {
+            msync(mapping_, mapped_size_, MS_SYNC);
+            munmap(mapping_, mapped_size_);
+            mapping_ = nullptr;
+            mapped_size_ = 0;
+        }
+    }
+#else
+    bool open(const std::string& path) {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        last_error_ = "Persistent metrics history needs mmap; keeping it in memory: " + path;
+        return false;
+    }
+
+    bool flush() {
+        return true;
+    }
+
+    void unmapFile() {}
+#endif
+
+    void append(const MetricsSample& sample) {
+        uint64_t index = header_->appended.load(std::memory_order_relaxed);
+        HistorySlot& slot = slots_[index % capacity_];
+
+        uint64_t words[kSampleWords];
+        std::memcpy(words, &sample, sizeof(words));
+
+        slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kSampleWords; ++i) {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot.sequence.store(2 * index + 2, std::memory_order_release);
+        header_->appended.store(index + 1, std::memory_order_release);
+    }
+
+    std::vector<MetricsSample> snapshot(std::chrono::system_clock::time_point since) const {
+        uint64_t since_ms = static_cast<uint64_t>(std::max<int64_t>(0,
+            std::chrono::duration_cast<std::chrono::milliseconds>(since.time_since_epoch()).count()));
+
+        uint64_t end = header_->appended.load(std::memory_order_acquire);
+        uint64_t begin = end > capacity_ ? end - capacity_ : 0;
+
+        std::vector<MetricsSample> samples;
+        samples.reserve(static_cast<size_t>(end - begin));
+        for (uint64_t index = begin; index < end; ++index) {
+            const HistorySlot& slot = slots_[index % capacity_];
+            uint64_t expected = 2 * index + 2;
+            if (slot.sequence.load(std::memory_order_acquire) != expected) {
+                continue;   // being rewritten by the next lap
+            }
+
+            uint64_t words[kSampleWords];
+            for (size_t i = 0; i < kSampleWords; ++i) {
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+                continue;
+            }
+
+            MetricsSample sample;
+            std::memcpy(&sample, words, sizeof(words));
+            if (sample.timestampMs > since_ms) {
+                samples.push_back(sample);
+            }
+        }
+        return samples;
+    }
+
+    size_t size() const {
+        return static_cast<size_t>(std::min<uint64_t>(header_->appended.load(std::memory_order_acquire), capacity_));
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    bool isPersistent() const {
+        return mapping_ != nullptr;
+    }
+
+    std::string getLastError() const {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        return last_error_;
+    }
+
+private:
+    size_t capacity_;
+    HistoryHeader memory_header_;
+    std::unique_ptr<HistorySlot[]> memory_slots_;
+    HistoryHeader* header_;
+    HistorySlot* slots_;
+    void* mapping_ = nullptr;
+    size_t mapped_size_ = 0;
+
+    mutable std::mutex error_mutex_;
+    std::string last_error_;
+};
+
+MetricsHistory::MetricsHistory(size_t capacity) : pimpl(std::make_unique<Implementation>(capacity)) {}
+MetricsHistory::~MetricsHistory() = default;
+
+bool MetricsHistory::open(const std::string& path) { return pimpl->open(path); }
+void MetricsHistory::append(const MetricsSample& sample) { pimpl->append(sample); }
+std::vector<MetricsSample> MetricsHistory::snapshot(std::chrono::system_clock::time_point since) const {
+    return pimpl->snapshot(since);
+}
+bool MetricsHistory::flush() { return pimpl->flush(); }
+
+size_t MetricsHistory::size() const { return pimpl->size(); }
+size_t MetricsHistory::capacity() const { return pimpl->capacity(); }
+bool MetricsHistory::isPersistent() const { return pimpl->isPersistent(); }
+std::string MetricsHistory::getLastError() const { return pimpl->getLastError(); }
+
+} // namespace phantomvault
@@ -0,0 +1,391 @@
+/**
+ * PhantomVault Operation Journal Implementation
+ */
+
+#include "operation_journal.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace phantomvault {
+
+namespace {
+
+constexpr const char* kJournalExtension = ".wal";
+
+const char* typeName(OperationJournal::OperationType type) {
+    return type == OperationJournal::OperationType::UNLOCK ? "unlock" : "lock";
+}
+
+bool syncPath(const std::string& path) {
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#else
+    (void)path;
+    return true;
+#endif
+}
+
+// One call that flushes every dirty file on the filesystem holding path
+bool syncFilesystemOf(const std::string& path) {
+#ifdef PLATFORM_LINUX
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = ::syncfs(fd) == 0;
+    ::close(fd);
+    return synced;
+#elif defined(PLATFORM_MACOS)
+    (void)path;
+    ::sync();
+    return true;
+#else
+    (void)path;
+    return true;
+#endif
+}
+
+} // namespace
+
+class OperationJournal::Implementation {
+public:
+    explicit Implementation(const Config& config) : config_(config) {}
+
+    bool initialize(const std::string& directory) {
+        try {
+            fs::create_directories(directory);
+            fs::permissions(directory, fs::perms::owner_all, fs::perm_options::replace);
+            directory_ = directory;
+            return true;
+        } catch (const std::exception& e) {
+            last_error_ = "Failed to initialize operation journal: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    bool begin(const Operation& operation) {
+        if (directory_.empty()) {
+            last_error_ = "Operation journal is not initialized";
+            return false;
+        }
+        if (active_) {
+            last_error_ = "Operation already in progress: " + active_->id;
+            return false;
+        }
+        active_ = operation;
+        clearPending();
+
+        std::error_code ec;
+        if (fs::exists(pathFor(operation.id), ec)) {
+            return true;  // resuming; the begin record is already durable
+        }
+
+        json record;
+        record["type"] = "begin";
+        record["op"] = typeName(operation.type);
+        record["folder"] = operation.folderPath;
+        record["vault_location"] = operation.vaultLocation;
+        record["mode"] = operation.mode;
+        record["started"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+            operation.startedAt.time_since_epoch()).count();
+        if (!append(record)) {
+            active_.reset();
+            return false;
+        }
+        return true;
+    }
+
+    void recordFile(const std::string& relativePath, uint64_t bytes, const std::string& syncPath) {
+        pending_files_.push_back(relativePath);
+        pending_bytes_ += bytes;
+        if (!syncPath.empty()) {
+            pending_syncs_.push_back(syncPath);
+        }
+    }
+
+    bool shouldCheckpoint() const {
+        return pending_files_.size() >= config_.checkpointFiles || pending_bytes_ >= config_.checkpointBytes;
+    }
+
+    bool checkpoint() {
+        if (!active_) {
+            last_error_ = "No operation in progress";
+            return false;
+        }
+        if (pending_files_.empty()) {
+            return true;
+        }
+
+        // File contents first, so a durable record never lists a file that is not
+        if (!syncPendingFiles()) {
+            return false;
+        }
+
+        json record;
+        record["type"] = "files";
+        record["paths"] = pending_files_;
+        record["bytes"] = pending_bytes_;
+        if (!append(record)) {
+            return false;
+        }
+
+        active_->completedFiles.insert(pending_files_.begin(), pending_files_.end());
+        active_->completedBytes += pending_bytes_;
+        clearPending();
+        return true;
+    }
+
+    bool markPhase(const std::string& phase) {
+        if (!checkpoint()) {
+            return false;
+        }
+        if (!append(json{{"type", "phase"}, {"phase", phase}})) {
+            return false;
+        }
+        active_->phase = phase;
+        return true;
+    }
+
+    bool complete() {
+        if (!active_) {
+            last_error_ = "No operation in progress";
+            return false;
+        }
+        std::error_code ec;
+        fs::remove(pathFor(active_->id), ec);
+        active_.reset();
+        clearPending();
+        if (ec) {
+            last_error_ = "Failed to remove operation journal: " + ec.message();
+            return false;
+        }
+        return true;
+    }
+
+    void release() {
+        active_.reset();
+        clearPending();
+    }
+
+    bool isActive() const {
+        return active_.has_value();
+    }
+
+    std::optional<Operation> load(const std::string& id) const {
+        if (directory_.empty()) {
+            return std::nullopt;
+        }
+        std::ifstream file(pathFor(id));
+        if (!file) {
+            return std::nullopt;
+        }
+
+        Operation operation;
+        bool begun = false;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            json record = json::parse(line, nullptr, false);
+            if (record.is_discarded() || !record.is_object()) {
+                continue;  // torn by a crash mid-append, never synced
+            }
+
+            std::string type = record.value("type", "");
+            if (type == "begin") {
+                operation.id = id;
+                operation.type = record.value("op", "") == "unlock" ? OperationType::UNLOCK : OperationType::LOCK;
+                operation.folderPath = record.value("folder", "");
+                operation.vaultLocation = record.value("vault_location", "");
+                operation.mode = record.value("mode", "");
+                operation.startedAt = std::chrono::system_clock::time_point(
+                    std::chrono::milliseconds(record.value("started", int64_t(0))));
+                begun = true;
+            } else if (type == "files" && record.contains("paths")) {
+                for (const auto& path : record["paths"]) {
+                    operation.completedFiles.insert(path.get<std::string>());
+                }
+                operation.completedBytes += record.value("bytes", uint64_t(0));
+            } else if (type == "phase") {
+                operation.phase = record.value("phase", "");
+            }
+        }
+
+        if (!begun) {
+            return std::nullopt;
+        }
+        return operation;
+    }
+
+    std::vector<Operation> listPending() const {
+        std::vector<Operation> operations;
+        if (directory_.empty()) {
+            return operations;
+        }
+        std::error_code ec;
+        for (fs::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->path().extension() != kJournalExtension) {
+                continue;
+            }
+            auto operation = load(it->path().stem().string());
+            if (operation) {
+                operations.push_back(std::move(*operation));
+            }
+        }
+        return operations;
+    }
+
+    bool discard(const std::string& id) {
+        if (active_ && active_->id == id) {
+            release();
+        }
+        std::error_code ec;
+        fs::remove(pathFor(id), ec);
+        if (ec) {
+            last_error_ = "Failed to discard operation journal: " + ec.message();
+            return false;
+        }
+        return true;
+    }
+
+    std::string getLastError() const {
+        return last_error_;
+    }
+
+private:
+    Config config_;
+    std::string directory_;
+    std::optional<Operation> active_;
+    std::vector<std::string> pending_files_;
+    std::vector<std::string> pending_syncs_;
+    uint64_t pending_bytes_ = 0;
+    mutable std::string last_error_;
+
+    std::string pathFor(const std::string& id) const {
+        return directory_ + "/" + id + kJournalExtension;
+    }
+
+    void clearPending() {
+        pending_files_.clear();
+        pending_syncs_.clear();
+        pending_bytes_ = 0;
+    }
+
+    bool syncPendingFiles() {
+        if (pending_syncs_.empty()) {
+            return true;
+        }
+        if (pending_syncs_.size() > config_.perFileSyncLimit) {
+            if (!syncFilesystemOf(pending_syncs_.front())) {
+                last_error_ = "Failed to sync filesystem: " + std::string(std::strerror(errno));
+                return false;
+            }
+            return true;
+        }
+
+        // New files also need their directory entries on disk
+        std::set<std::string> directories;
+        for (const auto& path : pending_syncs_) {
+            if (!syncPath(path)) {
+                last_error_ = "Failed to sync " + path + ": " + std::strerror(errno);
+                return false;
+            }
+            directories.insert(fs::path(path).parent_path().string());
+        }
+        for (const auto& directory : directories) {
+            syncPath(directory);
+        }
+        return true;
+    }
+
+    // One record per line; the leading newline keeps it off the line of a torn earlier append
+    bool append(const json& record) {
+        std::string line = "\n" + record.dump() + "\n";
+        std::string path = pathFor(active_->id);
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            last_error_ = "Failed to open operation journal: " + std::string(std::strerror(errno));
+            return false;
+        }
+        size_t written = 0;
+        while (written < line.size()) {
+            ssize_t n = ::write(fd, line.data() + written, line.size() - written);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                last_error_ = "Failed to write operation journal: " + std::string(std::strerror(errno));
+                ::close(fd);
+                return false;
+            }
+            written += static_cast<size_t>(n);
+        }
+#ifdef PLATFORM_MACOS
+        bool synced = ::fsync(fd) == 0;
+#else
+        bool synced = ::fdatasync(fd) == 0;
+#endif
+        ::close(fd);
+        if (!synced) {
+            last_error_ = "Failed to sync operation journal";
+            return false;
+        }
+        return true;
+#else
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file << line;
+        file.flush();
+        if (!file) {
+            last_error_ = "Failed to write operation journal";
+            return false;
+        }
+        return true;
+#endif
+    }
+};
+
+OperationJournal::OperationJournal() : pimpl(std::make_unique<Implementation>(Config{})) {}
+OperationJournal::OperationJournal(const Config& config) : pimpl(std::make_unique<Implementation>(config)) {}
+OperationJournal::~OperationJournal() = default;
+
+bool OperationJournal::initialize(const std::string& directory) { return pimpl->initialize(directory); }
+bool OperationJournal::begin(const Operation& operation) { return pimpl->begin(operation); }
+
+void OperationJournal::recordFile(const std::string& relativePath, uint64_t bytes, const std::string& syncPath) {
+    pimpl->recordFile(relativePath, bytes, syncPath);
+}
+
+bool OperationJournal::shouldCheckpoint() const { return pimpl->shouldCheckpoint(); }
+bool OperationJournal::checkpoint() { return pimpl->checkpoint(); }
+bool OperationJournal::markPhase(const std::string& phase) { return pimpl->markPhase(phase); }
+bool OperationJournal::complete() { return pimpl->complete(); }
+void OperationJournal::release() { pimpl->release(); }
+bool OperationJournal::isActive() const { return pimpl->isActive(); }
+std::optional<OperationJournal::Operation> OperationJournal::load(const std::string& id) const { return pimpl->load(id); }
+std::vector<OperationJournal::Operation> OperationJournal::listPending() const { return pimpl->listPending(); }
+bool OperationJournal::discard(const std::string& id) { return pimpl->discard(id); }
+std::string OperationJournal::getLastError() const { return pimpl->getLastError(); }
+
+} // namespace phantomvault
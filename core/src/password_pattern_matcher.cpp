@@ -0,0 +1,201 @@
+/**
+ * PhantomVault Password Pattern Matcher Implementation
+ *
+ * Characters are mapped to an input class once, through a 256-entry table,
+ * and the class drives a STATE_COUNT x class transition table. The state and
+ * character-class mask after every prefix of the token are kept, so Backspace
+ * just steps back one position.
+ */
+
+#include "password_pattern_matcher.hpp"
+#include "secure_memory.hpp"
+
+namespace phantomvault {
+
+namespace {
+
+enum State : uint8_t {
+    START,          // empty token
+    PREFIX_T,       // "T"
+    PREFIX_P,       // "P"
+    TEMPORARY,      // "T+..."
+    PERMANENT,      // "P+..."
+    WORD,           // only password characters so far
+    OTHER,          // anything else; never a pattern
+    STATE_COUNT
+};
+
+enum InputClass : uint8_t {
+    SPACE,          // ends a token
+    LETTER_T,
+    LETTER_P,
+    PLUS,
+    WORD_CHAR,      // [a-zA-Z0-9@#$%^&*!] other than T and P
+    OTHER_CHAR,
+    INPUT_CLASS_COUNT
+};
+
+// Composition bits, counted the way isValidPasswordPattern() counts them
+constexpr uint8_t kLower = 1;
+constexpr uint8_t kUpper = 2;
+constexpr uint8_t kDigit = 4;
+constexpr uint8_t kSpecial = 8;
+
+struct CharTables {
+    std::array<uint8_t, 256> input_class{};
+    std::array<uint8_t, 256> composition{};
+
+    constexpr CharTables() {
+        for (int c = 0; c < 256; ++c) {
+            input_class[c] = OTHER_CHAR;
+            composition[c] = kSpecial;
+        }
+        for (int c = 'a'; c <= 'z'; ++c) {
+            input_class[c] = WORD_CHAR;
+            composition[c] = kLower;
+        }
+        for (int c = 'A'; c <= 'Z'; ++c) {
+            input_class[c] = WORD_CHAR;
+            composition[c] = kUpper;
+        }
+        for (int c = '0'; c <= '9'; ++c) {
+            input_class[c] = WORD_CHAR;
+            composition[c] = kDigit;
+        }
+        for (char c : {'@', '#', '$', '%', '^', '&', '*', '!'}) {
+            input_class[static_cast<uint8_t>(c)] = WORD_CHAR;
+        }
+        for (char c : {' ', '\t', '\n', '\v', '\f', '\r'}) {
+            input_class[static_cast<uint8_t>(c)] = SPACE;
+        }
+        input_class['T'] = LETTER_T;
+        input_class['P'] = LETTER_P;
+        input_class['+'] = PLUS;
+    }
+};
+
+constexpr CharTables kCharTables;
+
+constexpr int popcount4(uint8_t bits) {
+    return (bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1);
+}
+
+// Next state by [state][input class]; SPACE ends the token before the lookup
+constexpr uint8_t kTransitions[STATE_COUNT][INPUT_CLASS_COUNT] = {
+    //               SPACE  LETTER_T   LETTER_P   PLUS       WORD_CHAR  OTHER_CHAR
+    /* START */     {START, PREFIX_T,  PREFIX_P,  OTHER,     WORD,      OTHER},
+    /* PREFIX_T */  {START, WORD,      WORD,      TEMPORARY, WORD,      OTHER},
+    /* PREFIX_P */  {START, WORD,      WORD,      PERMANENT, WORD,      OTHER},
+    /* TEMPORARY */ {START, TEMPORARY, TEMPORARY, TEMPORARY, TEMPORARY, TEMPORARY},
+    /* PERMANENT */ {START, PERMANENT, PERMANENT, PERMANENT, PERMANENT, PERMANENT},
+    /* WORD */      {START, WORD,      WORD,      OTHER,     WORD,      OTHER},
+    /* OTHER */     {START, OTHER,     OTHER,     OTHER,     OTHER,     OTHER},
+};
+
+} // anonymous namespace
+
+PasswordPatternMatcher::PasswordPatternMatcher()
+    : token_{}
+    , states_{}
+    , classes_{}
+    , length_(0)
+    , overflow_(0)
+    , pending_wipe_(false) {
+    states_[0] = START;
+    classes_[0] = 0;
+}
+
+PasswordPatternMatcher::~PasswordPatternMatcher() {
+    wipe();
+}
+
+bool PasswordPatternMatcher::feed(char c, PatternMatch& match) {
+    if (pending_wipe_) {
+        wipe();
+    }
+
+    uint8_t byte = static_cast<uint8_t>(c);
+    uint8_t input = kCharTables.input_class[byte];
+    if (input == SPACE) {
+        return endToken(match);
+    }
+
+    if (length_ == kMaxTokenLength) {
+        ++overflow_;
+        return false;
+    }
+
+    token_[length_] = c;
+    classes_[length_ + 1] = classes_[length_] | kCharTables.composition[byte];
+    states_[length_ + 1] = kTransitions[states_[length_]][input];
+    ++length_;
+    return false;
+}
+
+bool PasswordPatternMatcher::finish(PatternMatch& match) {
+    if (pending_wipe_) {
+        wipe();
+    }
+    return endToken(match);
+}
+
+void PasswordPatternMatcher::backspace() {
+    if (pending_wipe_) {
+        wipe();
+    }
+
+    if (overflow_ > 0) {
+        --overflow_;
+    } else if (length_ > 0) {
+        --length_;
+        token_[length_] = 0;
+    }
+}
+
+void PasswordPatternMatcher::reset() {
+    length_ = 0;
+    overflow_ = 0;
+    wipe();
+}
+
+bool PasswordPatternMatcher::endToken(PatternMatch& match) {
+    bool found = false;
+
+    if (overflow_ == 0) {
+        switch (states_[length_]) {
+            case TEMPORARY:
+            case PERMANENT:
+                // Needs something after the "T+" / "P+"
+                if (length_ > 2) {
+                    match.kind = states_[length_] == TEMPORARY ? PatternKind::TEMPORARY : PatternKind::PERMANENT;
+                    match.password = std::string_view(token_.data() + 2, length_ - 2);
+                    found = true;
+                }
+                break;
+            case PREFIX_T:
+            case PREFIX_P:
+            case WORD:
+                if (length_ >= kMinWordLength && popcount4(classes_[length_]) >= 2) {
+                    match.kind = PatternKind::DEFAULT;
+                    match.password = std::string_view(token_.data(), length_);
+                    found = true;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    // The characters stay until the caller has had the match
+    pending_wipe_ = length_ > 0;
+    length_ = 0;
+    overflow_ = 0;
+    return found;
+}
+
+void PasswordPatternMatcher::wipe() {
+    secureZero(token_.data(), token_.size());
+    pending_wipe_ = false;
+}
+
+} // namespace phantomvault
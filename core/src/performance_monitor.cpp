@@ -13,17 +13,36 @@
 #include <condition_variable>
 #include <queue>
 #include <map>
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <filesystem>
+#include <sstream>
+#include <ctime>
+#include <cstring>
 
 #ifdef PLATFORM_LINUX
 #include <unistd.h>
 #include <sys/times.h>
 #include <sys/sysinfo.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <pwd.h>
 #include <fstream>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 #elif PLATFORM_WINDOWS
 #include <windows.h>
 #include <psapi.h>
 #include <powrprof.h>
+#include <shlobj.h>
 #elif PLATFORM_MACOS
+#include <unistd.h>
+#include <pwd.h>
 #include <mach/mach.h>
 #include <sys/sysctl.h>
 #include <IOKit/ps/IOPowerSources.h>
@@ -39,17 +58,30 @@ public:
         , adaptive_tuning_enabled_(true)
         , memory_limit_kb_(8192) // 8MB default
         , cpu_limit_percent_(5.0) // 5% CPU max
-        , monitoring_thread_()
+        , monitoring_task_(0)
         , last_cpu_times_{}
         , start_time_(std::chrono::steady_clock::now())
     {}
     
     ~Implementation() {
         stop();
+        #ifdef PLATFORM_LINUX
+        for (int fd : {stat_fd_, ac_online_fd_, battery_capacity_fd_}) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        #endif
     }
     
-    bool initialize() {
+    bool initialize(const std::string& dataPath) {
         try {
+            std::string history_file = (dataPath.empty() ? getDefaultDataPath() : dataPath) + "/metrics/history.bin";
+            if (!history_.open(history_file)) {
+                // Still sampled; the history just starts empty on every run
+                std::cerr << "[PerformanceMonitor] " << history_.getLastError() << std::endl;
+            }
+            
             // Initialize platform-specific monitoring
             #ifdef PLATFORM_LINUX
             if (!initializeLinux()) {
@@ -80,7 +112,8 @@ public:
         }
         
         running_ = true;
-        monitoring_thread_ = std::thread(&Implementation::monitoringLoop, this);
+        monitoring_task_ = AdaptiveScheduler::getInstance().scheduleTask(
+            [this]() { sampleMetrics(); }, getSleepDuration(), std::chrono::milliseconds(0));
         
         std::cout << "[PerformanceMonitor] Started monitoring" << std::endl;
         return true;
@@ -93,9 +126,9 @@ public:
         
         running_ = false;
         
-        if (monitoring_thread_.joinable()) {
-            monitoring_thread_.join();
-        }
+        AdaptiveScheduler::getInstance().cancelTask(monitoring_task_);
+        monitoring_task_ = 0;
+        history_.flush();
         
         std::cout << "[PerformanceMonitor] Stopped monitoring" << std::endl;
     }
@@ -132,9 +165,18 @@ public:
         return current_metrics_.batteryInfo;
     }
     
+    std::vector<MetricsSample> getHistory(std::chrono::seconds window) const {
+        return history_.snapshot(std::chrono::system_clock::now() - window);
+    }
+    
     void setPerformanceMode(PerformanceMode mode) {
         performance_mode_ = mode;
         applyPerformanceMode();
+        
+        // Sampling rate follows the mode
+        if (running_) {
+            AdaptiveScheduler::getInstance().rescheduleTask(monitoring_task_, getSleepDuration());
+        }
         std::cout << "[PerformanceMonitor] Performance mode set to " << 
                      static_cast<int>(mode) << std::endl;
     }
@@ -222,66 +264,123 @@ private:
     std::atomic<size_t> memory_limit_kb_;
     std::atomic<double> cpu_limit_percent_;
     
-    std::thread monitoring_thread_;
+    std::atomic<AdaptiveScheduler::TaskId> monitoring_task_;
     mutable std::mutex metrics_mutex_;
     PerformanceMetrics current_metrics_;
     
     PerformanceCallback performance_callback_;
     BatteryCallback battery_callback_;
     
+    // Samples are averaged over kHistoryInterval into one history record;
+    // only the sampling task touches the window
+    static constexpr std::chrono::seconds kHistoryInterval{10};
+    static constexpr size_t kHistoryFlushRecords = 30;     // msync every 5 minutes
+    MetricsHistory history_;
+    struct {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        double cpu_sum = 0.0;
+        double cpu_peak = 0.0;
+        double user_sum = 0.0;
+        double system_sum = 0.0;
+        uint16_t samples = 0;
+    } history_window_;
+    size_t records_since_flush_ = 0;
+    
     // Platform-specific data
     #ifdef PLATFORM_LINUX
     struct {
-        long user_time = 0;
-        long system_time = 0;
-        long idle_time = 0;
-        long total_time = 0;
+        long long user_time = 0;
+        long long system_time = 0;
+        long long idle_time = 0;
+        long long total_time = 0;
     } last_cpu_times_;
+    
+    // Opened once and re-read from offset 0 on every sample
+    int stat_fd_ = -1;
+    int ac_online_fd_ = -1;
+    int battery_capacity_fd_ = -1;
     #endif
     
     std::chrono::steady_clock::time_point start_time_;
     
-    void monitoringLoop() {
-        while (running_) {
-            try {
-                updateMetrics();
-                
-                if (adaptive_tuning_enabled_) {
-                    performAdaptiveTuning();
-                }
-                
-                // Notify callbacks
-                if (performance_callback_) {
-                    performance_callback_(getMetrics());
-                }
-                
-                // Sleep based on performance mode
-                auto sleepDuration = getSleepDuration();
-                std::this_thread::sleep_for(sleepDuration);
-                
-            } catch (const std::exception& e) {
-                std::cerr << "[PerformanceMonitor] Monitoring error: " << e.what() << std::endl;
-                std::this_thread::sleep_for(std::chrono::seconds(1));
+    // Runs on the shared scheduler at getSleepDuration() intervals
+    void sampleMetrics() {
+        try {
+            updateMetrics();
+            
+            PerformanceMetrics metrics = getMetrics();
+            recordHistory(metrics);
+            
+            if (adaptive_tuning_enabled_) {
+                performAdaptiveTuning(metrics);
+            }
+            
+            // Notify callbacks; no lock is held here
+            if (performance_callback_) {
+                performance_callback_(metrics);
             }
+            
+        } catch (const std::exception& e) {
+            std::cerr << "[PerformanceMonitor] Monitoring error: " << e.what() << std::endl;
         }
     }
     
     void updateMetrics() {
-        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        // Measure outside the lock; calculateCPUEfficiency() takes it too
+        CPUStats cpuStats = measureCPUUsage();
+        BatteryInfo batteryInfo = getBatteryStatus();
         
-        // Update CPU stats
-        current_metrics_.cpuStats = measureCPUUsage();
-        
-        // Update battery info
-        current_metrics_.batteryInfo = getBatteryStatus();
+        {
+            std::lock_guard<std::mutex> lock(metrics_mutex_);
+            current_metrics_.cpuStats = cpuStats;
+            current_metrics_.batteryInfo = batteryInfo;
+        }
         
         // Calculate CPU efficiency (lower is better)
-        current_metrics_.cpuEfficiency = calculateCPUEfficiency();
+        double efficiency = calculateCPUEfficiency();
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        current_metrics_.cpuEfficiency = efficiency;
     }
     
-    void performAdaptiveTuning() {
-        auto metrics = getMetrics();
+    void recordHistory(const PerformanceMetrics& metrics) {
+        auto& window = history_window_;
+        window.cpu_sum += metrics.cpuStats.totalTime;
+        window.cpu_peak = std::max(window.cpu_peak, metrics.cpuStats.totalTime);
+        window.user_sum += metrics.cpuStats.userTime;
+        window.system_sum += metrics.cpuStats.systemTime;
+        window.samples++;
+        
+        auto now = std::chrono::steady_clock::now();
+        if (now - window.start < kHistoryInterval) {
+            return;
+        }
+        
+        auto hundredths = [](double percent) {
+            return static_cast<uint16_t>(std::clamp(percent * 100.0, 0.0, 10000.0));
+        };
+        MetricsSample sample;
+        sample.timestampMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        sample.cpuAverage = hundredths(window.cpu_sum / window.samples);
+        sample.cpuPeak = hundredths(window.cpu_peak);
+        sample.cpuUser = hundredths(window.user_sum / window.samples);
+        sample.cpuSystem = hundredths(window.system_sum / window.samples);
+        sample.memoryKB = static_cast<uint32_t>(std::min<size_t>(metrics.memoryUsage, UINT32_MAX));
+        sample.batteryLevel = static_cast<uint8_t>(std::clamp(metrics.batteryInfo.batteryLevel, 0, 100));
+        sample.flags = (metrics.batteryInfo.isOnBattery ? MetricsSample::kOnBattery : 0) |
+                       (metrics.batteryInfo.isCharging ? MetricsSample::kCharging : 0);
+        sample.sampleCount = window.samples;
+        history_.append(sample);
         
+        if (++records_since_flush_ >= kHistoryFlushRecords) {
+            history_.flush();
+            records_since_flush_ = 0;
+        }
+        history_window_ = {};
+        history_window_.start = now;
+    }
+    
+    void performAdaptiveTuning(const PerformanceMetrics& metrics) {
         // Adapt based on battery status
         if (metrics.batteryInfo.isOnBattery && metrics.batteryInfo.batteryLevel < 20) {
             if (performance_mode_ != PerformanceMode::POWER_SAVER) {
@@ -289,11 +388,8 @@ private:
             }
         }
         
-        // Adapt based on CPU usage
-        if (metrics.cpuStats.totalTime > cpu_limit_percent_ * 1.5) {
-            // Reduce activity if CPU usage is too high
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
+        // CPU pressure is handled by the scheduler, which stretches the
+        // intervals of background tasks while the limit is exceeded
         
         // Adapt based on memory usage
         if (metrics.memoryUsage > memory_limit_kb_ * 0.8) {
@@ -347,38 +443,101 @@ private:
         return 1.0;
     }
     
+    std::string getDefaultDataPath() {
+        #ifdef PLATFORM_LINUX
+        const char* home = getenv("HOME");
+        if (!home) {
+            struct passwd* pw = getpwuid(getuid());
+            home = pw->pw_dir;
+        }
+        return std::string(home) + "/.phantomvault";
+        #elif PLATFORM_WINDOWS
+        char path[MAX_PATH];
+        if (SHGetFolderPathA(NULL, CSIDL_APPDATA, NULL, 0, path) == S_OK) {
+            return std::string(path) + "\\PhantomVault";
+        }
+        return "C:\\ProgramData\\PhantomVault";
+        #elif PLATFORM_MACOS
+        const char* home = getenv("HOME");
+        if (!home) {
+            struct passwd* pw = getpwuid(getuid());
+            home = pw->pw_dir;
+        }
+        return std::string(home) + "/Library/Application Support/PhantomVault";
+        #else
+        return "./phantomvault_data";
+        #endif
+    }
+    
     // Platform-specific implementations
     #ifdef PLATFORM_LINUX
     bool initializeLinux() {
-        // Check if we can read /proc/stat and /proc/meminfo
-        std::ifstream stat("/proc/stat");
-        std::ifstream meminfo("/proc/meminfo");
-        return stat.is_open() && meminfo.is_open();
+        if (stat_fd_ < 0) {
+            stat_fd_ = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+            ac_online_fd_ = open("/sys/class/power_supply/ADP1/online", O_RDONLY | O_CLOEXEC);
+            battery_capacity_fd_ = open("/sys/class/power_supply/BAT0/capacity", O_RDONLY | O_CLOEXEC);
+        }
+        return stat_fd_ >= 0;
+    }
+    
+    // Re-reads a /proc or sysfs file from the start; the text is NUL-terminated
+    static bool readAt(int fd, char* buffer, size_t size) {
+        if (fd < 0) {
+            return false;
+        }
+        ssize_t length = pread(fd, buffer, size - 1, 0);
+        if (length <= 0) {
+            return false;
+        }
+        buffer[length] = '\0';
+        return true;
+    }
+    
+    // Skips to the next decimal field; false at the end of the line
+    static bool parseField(const char*& cursor, long long& value) {
+        while (*cursor == ' ') {
+            ++cursor;
+        }
+        if (*cursor < '0' || *cursor > '9') {
+            return false;
+        }
+        value = 0;
+        while (*cursor >= '0' && *cursor <= '9') {
+            value = value * 10 + (*cursor++ - '0');
+        }
+        return true;
     }
     
     CPUStats measureCPUUsage() {
         CPUStats stats;
         
-        std::ifstream stat("/proc/stat");
-        if (!stat.is_open()) {
+        // The aggregate "cpu" line always comes first and fits easily
+        char buffer[256];
+        if (!readAt(stat_fd_, buffer, sizeof(buffer)) || std::strncmp(buffer, "cpu ", 4) != 0) {
             return stats;
         }
         
-        std::string line;
-        std::getline(stat, line);
-        
-        // Parse CPU times from /proc/stat
-        long user, nice, system, idle, iowait, irq, softirq, steal;
-        sscanf(line.c_str(), "cpu %ld %ld %ld %ld %ld %ld %ld %ld",
-               &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal);
-        
-        long total = user + nice + system + idle + iowait + irq + softirq + steal;
+        // user nice system idle iowait irq softirq steal
+        long long fields[8] = {};
+        const char* cursor = buffer + 4;
+        for (long long& field : fields) {
+            if (!parseField(cursor, field)) {
+                break;
+            }
+        }
+        long long user = fields[0];
+        long long system = fields[2];
+        long long idle = fields[3];
+        long long total = 0;
+        for (long long field : fields) {
+            total += field;
+        }
         
         if (last_cpu_times_.total_time > 0) {
-            long total_diff = total - last_cpu_times_.total_time;
-            long idle_diff = idle - last_cpu_times_.idle_time;
-            long user_diff = user - last_cpu_times_.user_time;
-            long system_diff = system - last_cpu_times_.system_time;
+            long long total_diff = total - last_cpu_times_.total_time;
+            long long idle_diff = idle - last_cpu_times_.idle_time;
+            long long user_diff = user - last_cpu_times_.user_time;
+            long long system_diff = system - last_cpu_times_.system_time;
             
             if (total_diff > 0) {
                 stats.idleTime = (100.0 * idle_diff) / total_diff;
@@ -400,18 +559,17 @@ private:
     BatteryInfo getBatteryStatus() {
         BatteryInfo info;
         
-        // Try to read battery information from /sys/class/power_supply/
-        std::ifstream ac_online("/sys/class/power_supply/ADP1/online");
-        if (ac_online.is_open()) {
-            int online;
-            ac_online >> online;
-            info.isOnBattery = (online == 0);
-            info.isCharging = (online == 1);
+        char buffer[32];
+        long long value = 0;
+        const char* cursor = buffer;
+        if (readAt(ac_online_fd_, buffer, sizeof(buffer)) && parseField(cursor, value)) {
+            info.isOnBattery = (value == 0);
+            info.isCharging = (value == 1);
         }
         
-        std::ifstream bat_capacity("/sys/class/power_supply/BAT0/capacity");
-        if (bat_capacity.is_open()) {
-            bat_capacity >> info.batteryLevel;
+        cursor = buffer;
+        if (readAt(battery_capacity_fd_, buffer, sizeof(buffer)) && parseField(cursor, value)) {
+            info.batteryLevel = static_cast<int>(value);
         }
         
         return info;
@@ -461,7 +619,7 @@ private:
 PerformanceMonitor::PerformanceMonitor() : pimpl(std::make_unique<Implementation>()) {}
 PerformanceMonitor::~PerformanceMonitor() = default;
 
-bool PerformanceMonitor::initialize() { return pimpl->initialize(); }
+bool PerformanceMonitor::initialize(const std::string& dataPath) { return pimpl->initialize(dataPath); }
 bool PerformanceMonitor::start() { return pimpl->start(); }
 void PerformanceMonitor::stop() { pimpl->stop(); }
 bool PerformanceMonitor::isRunning() const { return pimpl->isRunning(); }
@@ -469,6 +627,7 @@ bool PerformanceMonitor::isRunning() const { return pimpl->isRunning(); }
 PerformanceMetrics PerformanceMonitor::getMetrics() const { return pimpl->getMetrics(); }
 CPUStats PerformanceMonitor::getCPUStats() const { return pimpl->getCPUStats(); }
 BatteryInfo PerformanceMonitor::getBatteryInfo() const { return pimpl->getBatteryInfo(); }
+std::vector<MetricsSample> PerformanceMonitor::getHistory(std::chrono::seconds window) const { return pimpl->getHistory(window); }
 
 void PerformanceMonitor::setPerformanceMode(PerformanceMode mode) { pimpl->setPerformanceMode(mode); }
 PerformanceMode PerformanceMonitor::getPerformanceMode() const { return pimpl->getPerformanceMode(); }
@@ -493,4 +652,901 @@ void PerformanceMonitor::incrementHttpRequests() { ++performance_counters_.httpR
 void PerformanceMonitor::incrementFileOperations() { ++performance_counters_.fileOperations; }
 void PerformanceMonitor::incrementEncryptionOperations() { ++performance_counters_.encryptionOperations; }
 
-} // namespace phantomvault
\ No newline at end of file
+// AdaptiveScheduler
+class AdaptiveScheduler::Implementation {
+public:
+    Implementation(PerformanceMonitor* monitor, size_t workers)
+        : monitor_(monitor)
+        , worker_count_(std::max<size_t>(1, workers))
+        , epoch_(std::chrono::steady_clock::now())
+    {}
+    
+    ~Implementation() {
+        shutdown();
+    }
+    
+    TaskId schedule(Task task, std::chrono::milliseconds interval, std::chrono::milliseconds delay, int priority) {
+        if (!task) {
+            return 0;
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_) {
+            return 0;
+        }
+        startThreads();
+        
+        auto entry = std::make_shared<Entry>();
+        entry->id = next_id_++;
+        entry->task = std::move(task);
+        entry->interval = interval;
+        entry->priority = priority;
+        tasks_[entry->id] = entry;
+        
+        arm(*entry, delay);
+        return entry->id;
+    }
+    
+    bool cancelTask(TaskId taskId) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = tasks_.find(taskId);
+        if (it == tasks_.end()) {
+            return false;
+        }
+        
+        std::shared_ptr<Entry> entry = it->second;
+        entry->cancelled = true;
+        ++entry->generation;
+        
+        if (!entry->running) {
+            tasks_.erase(it);
+            return true;
+        }
+        
+        // The worker erases it once the current run returns
+        if (entry->runner != std::this_thread::get_id()) {
+            done_cv_.wait(lock, [&entry] { return !entry->running; });
+        }
+        return true;
+    }
+    
+    void pauseTask(TaskId taskId) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tasks_.find(taskId);
+        if (it != tasks_.end() && !it->second->paused) {
+            it->second->paused = true;
+            ++it->second->generation;
+        }
+    }
+    
+    void resumeTask(TaskId taskId) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tasks_.find(taskId);
+        if (it == tasks_.end() || !it->second->paused) {
+            return;
+        }
+        
+        Entry& entry = *it->second;
+        entry.paused = false;
+        if (entry.running) {
+            return;     // re-armed when the run finishes
+        }
+        
+        if (entry.interval.count() > 0) {
+            arm(entry, effectiveInterval(entry));
+        } else {
+            // One-shot tasks keep their original deadline
+            uint64_t now = currentTick();
+            arm(entry, kTick * static_cast<int64_t>(entry.expiry > now ? entry.expiry - now : 0));
+        }
+    }
+    
+    bool rescheduleTask(TaskId taskId, std::chrono::milliseconds interval) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tasks_.find(taskId);
+        if (it == tasks_.end() || interval.count() <= 0) {
+            return false;
+        }
+        
+        Entry& entry = *it->second;
+        entry.interval = interval;
+        if (!entry.running && !entry.paused && !entry.queued) {
+            arm(entry, effectiveInterval(entry));
+        }
+        return true;
+    }
+    
+    void setPerformanceMonitor(PerformanceMonitor* monitor) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        monitor_ = monitor;
+    }
+    
+    void setAdaptiveMode(bool enabled) {
+        adaptive_mode_ = enabled;
+    }
+    
+    void setBatteryAwareScheduling(bool enabled) {
+        battery_aware_ = enabled;
+    }
+    
+    void setCPUAwareScheduling(bool enabled) {
+        cpu_aware_ = enabled;
+    }
+    
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopped_) {
+                return;
+            }
+            stopped_ = true;
+        }
+        wheel_cv_.notify_all();
+        ready_cv_.notify_all();
+        
+        if (wheel_thread_.joinable()) {
+            wheel_thread_.join();
+        }
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        workers_.clear();
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.clear();
+        for (auto& level : wheel_) {
+            for (auto& slot : level) {
+                slot.clear();
+            }
+        }
+        occupied_.fill(0);
+        ready_ = {};
+        done_cv_.notify_all();
+    }
+    
+    size_t getActiveTaskCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return static_cast<size_t>(std::count_if(tasks_.begin(), tasks_.end(),
+            [](const auto& task) { return !task.second->paused && !task.second->cancelled; }));
+    }
+    
+    size_t getCompletedTaskCount() const {
+        return completed_.load(std::memory_order_relaxed);
+    }
+    
+    size_t getWakeupCount() const {
+        return wakeups_.load(std::memory_order_relaxed);
+    }
+
+private:
+    // 4 levels of 64 slots at 10 ms cover 64^4 ticks, about 46 hours; longer
+    // deadlines park in the last slot and are re-filed when it cascades.
+    static constexpr std::chrono::milliseconds kTick{10};
+    static constexpr int kSlotBits = 6;
+    static constexpr size_t kSlots = size_t(1) << kSlotBits;
+    static constexpr uint64_t kSlotMask = kSlots - 1;
+    static constexpr int kLevels = 4;
+    static constexpr uint64_t kRange = uint64_t(1) << (kSlotBits * kLevels);
+    
+    struct Entry {
+        TaskId id = 0;
+        Task task;
+        std::chrono::milliseconds interval{0};      // 0 for one-shot tasks
+        int priority = 0;
+        uint64_t expiry = 0;                        // absolute tick
+        uint64_t generation = 0;                    // bumped to void wheel and queue references
+        bool paused = false;
+        bool cancelled = false;
+        bool queued = false;
+        bool running = false;
+        std::thread::id runner;
+    };
+    
+    struct SlotRef {
+        std::shared_ptr<Entry> entry;
+        uint64_t generation;
+    };
+    
+    struct ReadyTask {
+        int priority;
+        uint64_t sequence;
+        std::shared_ptr<Entry> entry;
+        uint64_t generation;
+        
+        bool operator<(const ReadyTask& other) const {
+            // Highest priority first, FIFO within a priority
+            return priority != other.priority ? priority < other.priority : sequence > other.sequence;
+        }
+    };
+    
+    PerformanceMonitor* monitor_;
+    size_t worker_count_;
+    std::chrono::steady_clock::time_point epoch_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable wheel_cv_;
+    std::condition_variable ready_cv_;
+    std::condition_variable done_cv_;
+    std::thread wheel_thread_;
+    std::vector<std::thread> workers_;
+    bool stopped_ = false;
+    
+    std::map<TaskId, std::shared_ptr<Entry>> tasks_;
+    TaskId next_id_ = 1;
+    
+    std::array<std::array<std::vector<SlotRef>, kSlots>, kLevels> wheel_;
+    std::array<uint64_t, kLevels> occupied_{};      // non-empty slots per level
+    uint64_t now_tick_ = 0;                         // last tick the wheel processed
+    uint64_t sleep_until_tick_ = UINT64_MAX;        // wheel thread's current deadline
+    
+    std::priority_queue<ReadyTask> ready_;
+    uint64_t ready_sequence_ = 0;
+    
+    std::atomic<bool> adaptive_mode_{true};
+    std::atomic<bool> battery_aware_{true};
+    std::atomic<bool> cpu_aware_{true};
+    std::atomic<size_t> completed_{0};
+    std::atomic<size_t> wakeups_{0};
+    
+    uint64_t currentTick() const {
+        return static_cast<uint64_t>((std::chrono::steady_clock::now() - epoch_) / kTick);
+    }
+    
+    void startThreads() {
+        if (wheel_thread_.joinable()) {
+            return;
+        }
+        wheel_thread_ = std::thread(&Implementation::wheelLoop, this);
+        for (size_t i = 0; i < worker_count_; ++i) {
+            workers_.emplace_back(&Implementation::workerLoop, this);
+        }
+    }
+    
+    std::chrono::milliseconds effectiveInterval(const Entry& entry) const {
+        std::chrono::milliseconds interval = entry.interval;
+        if (!adaptive_mode_ || !monitor_ || entry.priority > 0) {
+            return interval;
+        }
+        
+        // Stretch background work while on battery or under CPU pressure
+        if ((battery_aware_ && monitor_->getBatteryInfo().isOnBattery) ||
+            (cpu_aware_ && monitor_->isResourceLimitExceeded())) {
+            interval *= 2;
+        }
+        return interval;
+    }
+    
+    // Puts the entry on the wheel delay from now. Caller holds mutex_.
+    void arm(Entry& entry, std::chrono::milliseconds delay) {
+        uint64_t ticks = static_cast<uint64_t>((delay + kTick - std::chrono::milliseconds(1)) / kTick);
+        uint64_t expiry = currentTick() + std::max<uint64_t>(ticks, 1);
+        
+        // Round long deadlines up to a coarse boundary (up to 1/16 of the delay
+        // late) so independent timers share wakeups
+        uint64_t granularity = 1;
+        while (granularity * 2 <= ticks / 16) {
+            granularity *= 2;
+        }
+        expiry = (expiry + granularity - 1) & ~(granularity - 1);
+        
+        entry.expiry = expiry;
+        entry.queued = false;
+        ++entry.generation;
+        insert(entry.id, expiry);
+        
+        if (expiry < sleep_until_tick_) {
+            wheel_cv_.notify_one();
+        }
+    }
+    
+    void insert(TaskId id, uint64_t expiry) {
+        auto it = tasks_.find(id);
+        if (it == tasks_.end()) {
+            return;
+        }
+        const std::shared_ptr<Entry>& entry = it->second;
+        
+        if (expiry <= now_tick_) {
+            enqueue(entry);
+            return;
+        }
+        
+        uint64_t delta = expiry - now_tick_;
+        int level = 0;
+        while (level < kLevels - 1 && delta >= (uint64_t(1) << (kSlotBits * (level + 1)))) {
+            ++level;
+        }
+        uint64_t when = delta < kRange ? expiry : now_tick_ + kRange - 1;
+        size_t slot = static_cast<size_t>((when >> (kSlotBits * level)) & kSlotMask);
+        
+        wheel_[level][slot].push_back({entry, entry->generation});
+        occupied_[level] |= uint64_t(1) << slot;
+    }
+    
+    void enqueue(const std::shared_ptr<Entry>& entry) {
+        entry->queued = true;
+        ready_.push({entry->priority, ready_sequence_++, entry, entry->generation});
+        ready_cv_.notify_one();
+    }
+    
+    // Moves the wheel to target, cascading and firing slots on the way. Runs of
+    // empty levels are skipped to their next boundary rather than tick by tick.
+    void advanceTo(uint64_t target) {
+        while (now_tick_ < target) {
+            uint64_t step_mask = 0;
+            int level = 0;
+            while (level < kLevels && occupied_[level] == 0) {
+                step_mask = (uint64_t(1) << (kSlotBits * (level + 1))) - 1;
+                ++level;
+            }
+            now_tick_ = level == kLevels ? target : std::min(target, (now_tick_ | step_mask) + 1);
+            
+            // Higher levels first, so entries they re-file into lower slots
+            // due now are seen by the lower cascades
+            int top = 0;
+            while (top + 1 < kLevels && (now_tick_ & ((uint64_t(1) << (kSlotBits * (top + 1))) - 1)) == 0) {
+                ++top;
+            }
+            for (int cascade_level = top; cascade_level >= 1; --cascade_level) {
+                cascade(cascade_level, static_cast<size_t>((now_tick_ >> (kSlotBits * cascade_level)) & kSlotMask));
+            }
+            cascade(0, static_cast<size_t>(now_tick_ & kSlotMask));
+        }
+    }
+    
+    // Re-files every live entry of a slot relative to now_tick_; level 0
+    // entries are due and go straight to the ready queue
+    void cascade(int level, size_t slot) {
+        if ((occupied_[level] & (uint64_t(1) << slot)) == 0) {
+            return;
+        }
+        
+        std::vector<SlotRef> refs;
+        refs.swap(wheel_[level][slot]);
+        occupied_[level] &= ~(uint64_t(1) << slot);
+        
+        for (const auto& ref : refs) {
+            if (ref.generation == ref.entry->generation) {
+                insert(ref.entry->id, ref.entry->expiry);
+            }
+        }
+    }
+    
+    // Earliest tick at which some slot fires or cascades
+    std::optional<uint64_t> nextWakeTick() const {
+        std::optional<uint64_t> next;
+        for (int level = 0; level < kLevels; ++level) {
+            uint64_t bits = occupied_[level];
+            if (bits == 0) {
+                continue;
+            }
+            
+            int shift = kSlotBits * level;
+            uint64_t base = (now_tick_ >> shift) + 1;
+            for (size_t slot = 0; slot < kSlots; ++slot) {
+                if (bits & (uint64_t(1) << slot)) {
+                    uint64_t block = base + ((slot - base) & kSlotMask);
+                    uint64_t tick = block << shift;
+                    if (!next || tick < *next) {
+                        next = tick;
+                    }
+                }
+            }
+        }
+        return next;
+    }
+    
+    void wheelLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopped_) {
+            advanceTo(currentTick());
+            
+            std::optional<uint64_t> next = nextWakeTick();
+            if (next) {
+                sleep_until_tick_ = *next;
+                wheel_cv_.wait_until(lock, epoch_ + kTick * static_cast<int64_t>(*next));
+            } else {
+                sleep_until_tick_ = UINT64_MAX;
+                wheel_cv_.wait(lock);
+            }
+            wakeups_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    
+    void workerLoop() {
+        // Everything scheduled here is housekeeping
+        ResourceLimiter::demoteCurrentThread();
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            ready_cv_.wait(lock, [this] { return stopped_ || !ready_.empty(); });
+            if (stopped_) {
+                return;
+            }
+            
+            ReadyTask ready = ready_.top();
+            ready_.pop();
+            Entry& entry = *ready.entry;
+            if (ready.generation != entry.generation || entry.cancelled || entry.paused) {
+                continue;
+            }
+            
+            entry.queued = false;
+            entry.running = true;
+            entry.runner = std::this_thread::get_id();
+            lock.unlock();
+            
+            try {
+                entry.task();
+            } catch (const std::exception& e) {
+                std::cerr << "[AdaptiveScheduler] Task " << entry.id << " failed: " << e.what() << std::endl;
+            } catch (...) {
+                std::cerr << "[AdaptiveScheduler] Task " << entry.id << " failed" << std::endl;
+            }
+            
+            lock.lock();
+            entry.running = false;
+            entry.runner = std::thread::id();
+            completed_.fetch_add(1, std::memory_order_relaxed);
+            
+            if (entry.cancelled || entry.interval.count() <= 0) {
+                tasks_.erase(entry.id);
+            } else if (!entry.paused && !stopped_) {
+                // Fixed delay after each run, like the sleep loops this replaces
+                arm(entry, effectiveInterval(entry));
+            }
+            done_cv_.notify_all();
+        }
+    }
+};
+
+AdaptiveScheduler::AdaptiveScheduler(PerformanceMonitor* monitor, size_t workers)
+    : pimpl(std::make_unique<Implementation>(monitor, workers)) {}
+AdaptiveScheduler::~AdaptiveScheduler() = default;
+
+AdaptiveScheduler& AdaptiveScheduler::getInstance() {
+    static AdaptiveScheduler instance(nullptr);
+    return instance;
+}
+
+AdaptiveScheduler::TaskId AdaptiveScheduler::scheduleTask(Task task, std::chrono::milliseconds interval, int priority) {
+    return interval.count() > 0 ? pimpl->schedule(std::move(task), interval, interval, priority) : 0;
+}
+
+AdaptiveScheduler::TaskId AdaptiveScheduler::scheduleTask(Task task, std::chrono::milliseconds interval,
+                                                          std::chrono::milliseconds firstRunDelay, int priority) {
+    return interval.count() > 0 ? pimpl->schedule(std::move(task), interval, firstRunDelay, priority) : 0;
+}
+
+AdaptiveScheduler::TaskId AdaptiveScheduler::scheduleDelayedTask(Task task, std::chrono::milliseconds delay, int priority) {
+    return pimpl->schedule(std::move(task), std::chrono::milliseconds(0), delay, priority);
+}
+
+bool AdaptiveScheduler::cancelTask(TaskId taskId) { return pimpl->cancelTask(taskId); }
+void AdaptiveScheduler::pauseTask(TaskId taskId) { pimpl->pauseTask(taskId); }
+void AdaptiveScheduler::resumeTask(TaskId taskId) { pimpl->resumeTask(taskId); }
+bool AdaptiveScheduler::rescheduleTask(TaskId taskId, std::chrono::milliseconds interval) { return pimpl->rescheduleTask(taskId, interval); }
+
+void AdaptiveScheduler::setPerformanceMonitor(PerformanceMonitor* monitor) { pimpl->setPerformanceMonitor(monitor); }
+void AdaptiveScheduler::setAdaptiveMode(bool enabled) { pimpl->setAdaptiveMode(enabled); }
+void AdaptiveScheduler::setBatteryAwareScheduling(bool enabled) { pimpl->setBatteryAwareScheduling(enabled); }
+void AdaptiveScheduler::setCPUAwareScheduling(bool enabled) { pimpl->setCPUAwareScheduling(enabled); }
+void AdaptiveScheduler::shutdown() { pimpl->shutdown(); }
+
+size_t AdaptiveScheduler::getActiveTaskCount() const { return pimpl->getActiveTaskCount(); }
+size_t AdaptiveScheduler::getCompletedTaskCount() const { return pimpl->getCompletedTaskCount(); }
+size_t AdaptiveScheduler::getWakeupCount() const { return pimpl->getWakeupCount(); }
+
+// ResourceLimiter
+namespace {
+
+/**
+ * Tokens accrue at rate per second up to capacity; a consumer may overdraw
+ * and then waits until the balance is back to zero. rate <= 0 disables it.
+ */
+struct TokenBucket {
+    double rate = 0.0;
+    double capacity = 0.0;
+    double tokens = 0.0;
+    std::chrono::steady_clock::time_point last_refill = std::chrono::steady_clock::now();
+    
+    void configure(double new_rate, double burst_seconds) {
+        rate = new_rate;
+        capacity = rate * burst_seconds;
+        tokens = capacity;
+        last_refill = std::chrono::steady_clock::now();
+    }
+    
+    bool enabled() const { return rate > 0.0; }
+    
+    double available(std::chrono::steady_clock::time_point now) const {
+        std::chrono::duration<double> elapsed = now - last_refill;
+        return std::min(capacity, tokens + elapsed.count() * rate);
+    }
+    
+    void consume(double amount) {
+        auto now = std::chrono::steady_clock::now();
+        tokens = available(now) - amount;
+        last_refill = now;
+    }
+    
+    // How long until the balance is back to zero
+    std::chrono::duration<double> overdraft() {
+        consume(0.0);
+        return std::chrono::duration<double>(tokens < 0.0 ? -tokens / rate : 0.0);
+    }
+};
+
+double processCPUSeconds() {
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    timespec ts{};
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) == 0) {
+        return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+    }
+#endif
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+} // anonymous namespace
+
+class ResourceLimiter::Implementation {
+public:
+    // Memory
+    void setMemoryLimit(size_t limitKB) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        memory_limit_kb_ = limitKB;
+        if (!cgroup_path_.empty()) {
+            writeCgroupFile("memory.high", limitKB == 0 ? "max" : std::to_string(limitKB * 1024));
+        }
+    }
+    
+    bool checkMemoryLimit() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return memory_limit_kb_ == 0 || currentMemoryKB() <= memory_limit_kb_;
+    }
+    
+    void enforceMemoryLimit() {
+        if (checkMemoryLimit()) {
+            return;
+        }
+        MemoryManager::getInstance().compactPools();
+#if defined(PLATFORM_LINUX) && defined(__GLIBC__)
+        malloc_trim(0);
+#endif
+    }
+    
+    // CPU
+    void setCPULimit(double maxPercent) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        double rate = std::max(0.0, maxPercent) / 100.0;
+        // Half a second of CPU burst, so short jobs are not chopped into sleeps
+        cpu_bucket_.configure(rate, 0.5);
+        cpu_last_seconds_ = processCPUSeconds();
+        if (!cgroup_path_.empty()) {
+            constexpr long kPeriodMicros = 100000;
+            std::string quota = rate > 0.0 ? std::to_string(std::max(1000L, static_cast<long>(rate * kPeriodMicros))) : "max";
+            writeCgroupFile("cpu.max", quota + " " + std::to_string(kPeriodMicros));
+        }
+    }
+    
+    bool checkCPULimit() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!cpu_bucket_.enabled()) {
+            return true;
+        }
+        double used = processCPUSeconds() - cpu_last_seconds_;
+        return cpu_bucket_.available(std::chrono::steady_clock::now()) >= used;
+    }
+    
+    void enforceCPULimit() {
+        std::chrono::duration<double> wait{0.0};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!cpu_bucket_.enabled()) {
+                return;
+            }
+            double now_seconds = processCPUSeconds();
+            cpu_bucket_.consume(now_seconds - cpu_last_seconds_);
+            cpu_last_seconds_ = now_seconds;
+            wait = cpu_bucket_.overdraft();
+        }
+        if (wait.count() > 0.0) {
+            std::this_thread::sleep_for(wait);
+        }
+    }
+    
+    // I/O
+    void setIOLimit(size_t maxBytesPerSecond) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Allow a quarter second of burst so small files are not serialized on sleeps
+        io_bucket_.configure(static_cast<double>(maxBytesPerSecond), 0.25);
+    }
+    
+    bool checkIOLimit(size_t bytesUsed) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return !io_bucket_.enabled() ||
+               io_bucket_.available(std::chrono::steady_clock::now()) >= static_cast<double>(bytesUsed);
+    }
+    
+    void recordIO(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (io_bucket_.enabled()) {
+            io_bucket_.consume(static_cast<double>(bytes));
+        }
+    }
+    
+    void enforceIOLimit() {
+        std::chrono::duration<double> wait{0.0};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!io_bucket_.enabled()) {
+                return;
+            }
+            wait = io_bucket_.overdraft();
+        }
+        if (wait.count() > 0.0) {
+            std::this_thread::sleep_for(wait);
+        }
+    }
+    
+    // Network
+    void setNetworkLimit(size_t maxBytesPerSecond) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        network_bucket_.configure(static_cast<double>(maxBytesPerSecond), 0.25);
+    }
+    
+    bool checkNetworkLimit(size_t bytesUsed) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return !network_bucket_.enabled() ||
+               network_bucket_.available(std::chrono::steady_clock::now()) >= static_cast<double>(bytesUsed);
+    }
+    
+    void recordNetwork(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (network_bucket_.enabled()) {
+            network_bucket_.consume(static_cast<double>(bytes));
+        }
+    }
+    
+    // cgroup v2
+    bool attachToCgroup(const std::string& leafName) {
+        std::lock_guard<std::mutex> lock(mutex_);
+#ifdef PLATFORM_LINUX
+        if (!cgroup_path_.empty()) {
+            return true;
+        }
+        if (leafName.empty() || leafName.find('/') != std::string::npos) {
+            last_error_ = "Invalid cgroup name: " + leafName;
+            return false;
+        }
+        
+        // On the unified hierarchy the only entry is "0::/path"
+        std::ifstream self("/proc/self/cgroup");
+        std::string line, current;
+        while (std::getline(self, line)) {
+            if (line.rfind("0::", 0) == 0) {
+                current = line.substr(3);
+            }
+        }
+        if (current.empty() || !std::filesystem::exists("/sys/fs/cgroup/cgroup.controllers")) {
+            last_error_ = "cgroup v2 is not available";
+            return false;
+        }
+        
+        std::filesystem::path parent = std::filesystem::path("/sys/fs/cgroup") / current.substr(1);
+        if (parent.filename() == leafName) {
+            // Already placed in the leaf, e.g. by the service unit
+            cgroup_path_ = parent.string();
+            return true;
+        }
+        
+        // Controllers can only be enabled for children of a group without
+        // processes, so the parent must be ours alone
+        std::ifstream procs(parent / "cgroup.procs");
+        std::string pid;
+        while (procs >> pid) {
+            if (pid != std::to_string(getpid())) {
+                last_error_ = "cgroup " + current + " is shared with other processes";
+                return false;
+            }
+        }
+        
+        std::error_code ec;
+        std::filesystem::path leaf = parent / leafName;
+        std::filesystem::create_directory(leaf, ec);
+        if (ec) {
+            last_error_ = "Failed to create cgroup " + leaf.string() + ": " + ec.message();
+            return false;
+        }
+        if (!writeFile(leaf / "cgroup.procs", std::to_string(getpid()))) {
+            last_error_ = "Failed to move process into cgroup " + leaf.string();
+            return false;
+        }
+        cgroup_path_ = leaf.string();
+        
+        // Whatever the parent was not delegated stays unavailable; the
+        // corresponding setters then fail individually
+        std::string missing;
+        for (const char* controller : {"cpu", "io", "memory"}) {
+            if (!writeFile(parent / "cgroup.subtree_control", std::string("+") + controller)) {
+                missing += missing.empty() ? controller : std::string(", ") + controller;
+            }
+        }
+        if (!missing.empty()) {
+            std::cout << "[ResourceLimiter] cgroup controllers not delegated: " << missing << std::endl;
+        }
+        
+        // Apply limits that were set before attaching
+        if (cpu_bucket_.enabled()) {
+            writeCgroupFile("cpu.max", std::to_string(std::max(1000L, static_cast<long>(cpu_bucket_.rate * 100000))) + " 100000");
+        }
+        if (memory_limit_kb_ > 0) {
+            writeCgroupFile("memory.high", std::to_string(memory_limit_kb_ * 1024));
+        }
+        return true;
+#else
+        (void)leafName;
+        last_error_ = "cgroups are only supported on Linux";
+        return false;
+#endif
+    }
+    
+    bool isCgroupAttached() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return !cgroup_path_.empty();
+    }
+    
+    std::string getCgroupPath() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cgroup_path_;
+    }
+    
+    bool setCgroupWeights(uint32_t cpuWeight, uint32_t ioWeight) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cpuWeight < 1 || cpuWeight > 10000 || ioWeight < 1 || ioWeight > 10000) {
+            last_error_ = "cgroup weights must be between 1 and 10000";
+            return false;
+        }
+        bool cpu_ok = writeCgroupFile("cpu.weight", std::to_string(cpuWeight));
+        bool io_ok = writeCgroupFile("io.weight", "default " + std::to_string(ioWeight));
+        return cpu_ok && io_ok;
+    }
+    
+    bool setDeviceIOLimit(const std::string& path, size_t readBytesPerSecond, size_t writeBytesPerSecond) {
+        std::lock_guard<std::mutex> lock(mutex_);
+#ifdef PLATFORM_LINUX
+        struct stat st{};
+        if (stat(path.c_str(), &st) != 0) {
+            last_error_ = "Cannot stat " + path;
+            return false;
+        }
+        
+        // io.max takes whole disks; a partition's sysfs entry sits under its disk
+        std::string device = std::to_string(major(st.st_dev)) + ":" + std::to_string(minor(st.st_dev));
+        std::filesystem::path sys_entry = "/sys/dev/block/" + device;
+        std::error_code ec;
+        if (!std::filesystem::exists(sys_entry, ec)) {
+            last_error_ = path + " is not on a block device (" + device + ")";
+            return false;
+        }
+        if (std::filesystem::exists(sys_entry / "partition", ec)) {
+            std::ifstream disk_dev(std::filesystem::canonical(sys_entry, ec).parent_path() / "dev");
+            std::getline(disk_dev, device);
+        }
+        
+        auto limit = [](size_t bytes) { return bytes == 0 ? std::string("max") : std::to_string(bytes); };
+        return writeCgroupFile("io.max", device + " rbps=" + limit(readBytesPerSecond) + " wbps=" + limit(writeBytesPerSecond));
+#else
+        (void)path;
+        (void)readBytesPerSecond;
+        (void)writeBytesPerSecond;
+        last_error_ = "Device I/O limits are only supported on Linux";
+        return false;
+#endif
+    }
+    
+    static void demoteCurrentThread() {
+#ifdef PLATFORM_LINUX
+        // Both apply to the calling thread only when given its tid
+        pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+        setpriority(PRIO_PROCESS, static_cast<id_t>(tid), 19);
+        constexpr int kIoprioWhoProcess = 1;
+        constexpr int kIoprioClassIdle = 3;
+        constexpr int kIoprioClassShift = 13;
+        syscall(SYS_ioprio_set, kIoprioWhoProcess, tid, kIoprioClassIdle << kIoprioClassShift);
+#elif PLATFORM_WINDOWS
+        SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#elif PLATFORM_MACOS
+        setpriority(PRIO_DARWIN_THREAD, 0, PRIO_DARWIN_BG);
+#endif
+    }
+    
+    std::string getLastError() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return last_error_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    size_t memory_limit_kb_ = 0;
+    TokenBucket cpu_bucket_;
+    double cpu_last_seconds_ = 0.0;
+    TokenBucket io_bucket_;
+    TokenBucket network_bucket_;
+    std::string cgroup_path_;
+    mutable std::string last_error_;
+    
+    size_t currentMemoryKB() const {
+#ifdef PLATFORM_LINUX
+        if (!cgroup_path_.empty()) {
+            std::ifstream current(cgroup_path_ + "/memory.current");
+            size_t bytes = 0;
+            if (current >> bytes) {
+                return bytes / 1024;
+            }
+        }
+        std::ifstream statm("/proc/self/statm");
+        size_t size_pages = 0, resident_pages = 0;
+        if (statm >> size_pages >> resident_pages) {
+            return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+        }
+#endif
+        return MemoryManager::getInstance().getStats().currentUsage / 1024;
+    }
+    
+    bool writeCgroupFile(const std::string& name, const std::string& value) {
+        if (cgroup_path_.empty()) {
+            last_error_ = "Not attached to a cgroup";
+            return false;
+        }
+        if (!writeFile(std::filesystem::path(cgroup_path_) / name, value)) {
+            last_error_ = "Failed to write " + value + " to " + cgroup_path_ + "/" + name;
+            return false;
+        }
+        return true;
+    }
+    
+    // Kernel interface files report a rejected value on write or close
+    static bool writeFile(const std::filesystem::path& path, const std::string& value) {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+        file << value;
+        file.close();
+        return !file.fail();
+    }
+};
+
+ResourceLimiter::ResourceLimiter() : pimpl(std::make_unique<Implementation>()) {}
+ResourceLimiter::~ResourceLimiter() = default;
+
+void ResourceLimiter::setMemoryLimit(size_t limitKB) { pimpl->setMemoryLimit(limitKB); }
+bool ResourceLimiter::checkMemoryLimit() const { return pimpl->checkMemoryLimit(); }
+void ResourceLimiter::enforceMemoryLimit() { pimpl->enforceMemoryLimit(); }
+
+void ResourceLimiter::setCPULimit(double maxPercent) { pimpl->setCPULimit(maxPercent); }
+bool ResourceLimiter::checkCPULimit() const { return pimpl->checkCPULimit(); }
+void ResourceLimiter::enforceCPULimit() { pimpl->enforceCPULimit(); }
+
+void ResourceLimiter::setIOLimit(size_t maxBytesPerSecond) { pimpl->setIOLimit(maxBytesPerSecond); }
+bool ResourceLimiter::checkIOLimit(size_t bytesUsed) const { return pimpl->checkIOLimit(bytesUsed); }
+void ResourceLimiter::recordIO(size_t bytes) { pimpl->recordIO(bytes); }
+void ResourceLimiter::enforceIOLimit() { pimpl->enforceIOLimit(); }
+
+void ResourceLimiter::setNetworkLimit(size_t maxBytesPerSecond) { pimpl->setNetworkLimit(maxBytesPerSecond); }
+bool ResourceLimiter::checkNetworkLimit(size_t bytesUsed) const { return pimpl->checkNetworkLimit(bytesUsed); }
+void ResourceLimiter::recordNetwork(size_t bytes) { pimpl->recordNetwork(bytes); }
+
+bool ResourceLimiter::attachToCgroup(const std::string& leafName) { return pimpl->attachToCgroup(leafName); }
+bool ResourceLimiter::isCgroupAttached() const { return pimpl->isCgroupAttached(); }
+std::string ResourceLimiter::getCgroupPath() const { return pimpl->getCgroupPath(); }
+bool ResourceLimiter::setCgroupWeights(uint32_t cpuWeight, uint32_t ioWeight) { return pimpl->setCgroupWeights(cpuWeight, ioWeight); }
+bool ResourceLimiter::setDeviceIOLimit(const std::string& path, size_t readBytesPerSecond, size_t writeBytesPerSecond) {
+    return pimpl->setDeviceIOLimit(path, readBytesPerSecond, writeBytesPerSecond);
+}
+void ResourceLimiter::demoteCurrentThread() { Implementation::demoteCurrentThread(); }
+std::string ResourceLimiter::getLastError() const { return pimpl->getLastError(); }
+
+} // namespace phantomvault
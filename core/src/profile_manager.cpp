@@ -7,6 +7,7 @@
 
 #include "profile_manager.hpp"
 #include "error_handler.hpp"
+#include "instrumentation.hpp"
 #include <iostream>
 #include <fstream>
 #include <filesystem>
@@ -920,6 +921,8 @@ private
     }
     
     std::string hashPassword(const std::string& password) {
+        ScopedSpan span(Operation::KDF);
+        
         // Generate salt
         unsigned char salt[16];
         if (RAND_bytes(salt, sizeof(salt)) != 1) {
@@ -947,6 +950,7 @@ private
     }
     
     bool verifyPassword(const std::string& password, const std::string& storedHash) {
+        ScopedSpan span(Operation::KDF);
         try {
             // Split salt and hash
             size_t colonPos = storedHash.find(':');
@@ -1,6 +1,9 @@
 #include "profile_vault.hpp"
 #include "error_handler.hpp"
 #include "vault_handler.hpp"
+#include "segment_store.hpp"
+#include "instrumentation.hpp"
+#include "secure_arena.hpp"
 #include <nlohmann/json.hpp>
 #include <fstream>
 #include <iostream>
@@ -27,6 +30,19 @@ namespace fs = std::filesystem;
 
 namespace PhantomVault {
 
+namespace {
+
+// Set while the calling thread runs background vault work. throttleIO only
+// charges the bucket then, so a lock or unlock the user asked for is not paced.
+thread_local int t_background_depth = 0;
+
+struct BackgroundWork {
+    BackgroundWork() { ++t_background_depth; }
+    ~BackgroundWork() { --t_background_depth; }
+};
+
+} // anonymous namespace
+
 // ProfileVault Implementation
 
 ProfileVault::ProfileVault(const std::string& profile_id, const std::string& vault_root_path)
@@ -37,8 +53,11 @@ ProfileVault::ProfileVault(const std::string& profile_id, const std::string& vau
     , temp_unlock_file_(vault_path_ + "/temp_unlock.json")
     , encryption_engine_(std::make_unique<EncryptionEngine>())
     , error_handler_(std::make_unique<phantomvault::ErrorHandler>())
-    , vault_handler_(std::make_unique<phantomvault::VaultHandler>()) {
+    , vault_handler_(std::make_unique<phantomvault::VaultHandler>())
+    , journal_(std::make_unique<phantomvault::OperationJournal>())
+    , io_limiter_(std::make_unique<phantomvault::ResourceLimiter>()) {
     clearError();
+    setBackgroundIOLimit(kDefaultBackgroundIOLimit);
 }
 
 ProfileVault::~ProfileVault() = default;
@@ -72,6 +91,16 @@ bool ProfileVault::initialize() {
             }
         }
         
+        // Operations interrupted by a crash resume from here on their next lock/unlock
+        if (!journal_->initialize(vault_path_ + "/journal")) {
+            setError(journal_->getLastError());
+            return false;
+        }
+        size_t interrupted = journal_->listPending().size();
+        if (interrupted > 0) {
+            std::cout << "[ProfileVault] " << interrupted << " interrupted operation(s) pending resume" << std::endl;
+        }
+        
         // Load temporary unlock state if exists
         if (fs::exists(temp_unlock_file_)) {
             loadTemporaryUnlockState();
@@ -83,6 +112,10 @@ bool ProfileVault::initialize() {
             return false;
         }
         
+        // One arena sized for the largest file keeps plaintext in a single locked
+        // mapping; if it cannot be mapped the engine uses the thread's arena
+        encryption_engine_->enableMemoryPooling();
+        
         // Initialize error handler
         std::string error_log_path = vault_path_ + "/vault_security.log";
         if (error_handler_ && !error_handler_->initialize(error_log_path)) {
@@ -141,6 +174,7 @@ bool ProfileVault::createVaultStructure() {
 }
 
 VaultOperationResult ProfileVault::lockFolder(const std::string& folder_path, const std::string& master_key) {
+    phantomvault::TraceSpan span("vault_lock");
     clearError();
     VaultOperationResult result;
     
@@ -151,6 +185,18 @@ VaultOperationResult ProfileVault::lockFolder(const std::string& folder_path, co
             return result;
         }
         
+        // An interrupted lock of this folder picks up where it stopped
+        std::string vault_location = generateVaultLocation(folder_path);
+        if (auto pending = journal_->load(vault_location)) {
+            if (pending->type != phantomvault::OperationJournal::OperationType::LOCK) {
+                result.error_details = "An interrupted unlock of this folder must be completed first";
+                return result;
+            }
+            std::cout << "[ProfileVault] Resuming interrupted lock: " << folder_path
+                      << " (" << pending->completedFiles.size() << " files already stored)" << std::endl;
+            return runLock(*pending, master_key);
+        }
+        
         if (!fs::exists(folder_path)) {
             result.error_details = "Folder does not exist: " + folder_path;
             return result;
@@ -167,58 +213,114 @@ VaultOperationResult ProfileVault::lockFolder(const std::string& folder_path, co
             return result;
         }
         
-        // Encrypt and store the folder
-        result = encryptAndStoreFolder(folder_path, master_key);
+        phantomvault::OperationJournal::Operation operation;
+        operation.id = vault_location;
+        operation.type = phantomvault::OperationJournal::OperationType::LOCK;
+        operation.folderPath = folder_path;
+        operation.vaultLocation = vault_location;
+        operation.startedAt = std::chrono::system_clock::now();
+        return runLock(operation, master_key);
         
-        if (result.success) {
-            // Hide the original folder
-            if (!hideOriginalFolder(folder_path)) {
-                // If hiding fails, we should clean up the vault entry
-                setError("Failed to hide original folder, cleaning up vault entry");
-                
-                // Cleanup: Remove the vault files we just created
-                std::string vault_location = generateVaultLocation(folder_path);
-                std::string vault_folder_path = getVaultFolderPath(vault_location);
-                std::string metadata_path = getFolderMetadataPath(vault_location);
-                
-                if (fs::exists(vault_folder_path)) {
-                    fs::remove_all(vault_folder_path);
-                }
-                if (fs::exists(metadata_path)) {
-                    fs::remove(metadata_path);
-                }
-                
-                // Remove from vault metadata
-                auto it = std::find(vault_metadata_.locked_folders.begin(),
-                                   vault_metadata_.locked_folders.end(), folder_path);
-                if (it != vault_metadata_.locked_folders.end()) {
-                    vault_metadata_.locked_folders.erase(it);
-                    vault_metadata_.total_folders--;
-                    saveVaultMetadata();
-                }
-                
-                result.success = false;
-                result.error_details = last_error_;
-                return result;
+    } catch (const std::exception& e) {
+        journal_->release();
+        result.error_details = "Failed to lock folder: " + std::string(e.what());
+        return result;
+    }
+}
+
+VaultOperationResult ProfileVault::runLock(const phantomvault::OperationJournal::Operation& operation, const std::string& master_key) {
+    VaultOperationResult result;
+    const std::string& folder_path = operation.folderPath;
+    
+    if (!journal_->begin(operation)) {
+        result.error_details = "Failed to journal lock: " + journal_->getLastError();
+        return result;
+    }
+    
+    if (operation.phase.empty()) {
+        if (!fs::exists(folder_path)) {
+            // Source gone before it was fully stored; nothing left to resume from
+            if (!isFolderLocked(folder_path)) {
+                std::error_code ec;
+                fs::remove_all(getVaultFolderPath(operation.vaultLocation), ec);
+                fs::remove(getFolderMetadataPath(operation.vaultLocation), ec);
             }
-            
-            result.message = "Folder successfully locked and encrypted";
-            std::cout << "[ProfileVault] Locked folder: " << folder_path << std::endl;
+            journal_->discard(operation.id);
+            result.error_details = "Folder does not exist: " + folder_path;
+            return result;
         }
         
-        return result;
+        // Encrypt and store the folder
+        result = encryptAndStoreFolder(folder_path, master_key, operation);
+        if (!result.success) {
+            journal_->release();
+            return result;
+        }
         
-    } catch (const std::exception& e) {
-        result.error_details = "Failed to lock folder: " + std::string(e.what());
+        if (!journal_->markPhase("stored")) {
+            journal_->release();
+            result.success = false;
+            result.error_details = "Failed to journal lock: " + journal_->getLastError();
+            return result;
+        }
+    }
+    
+    // Hide the original folder, unless a resumed lock already got that far
+    if (fs::exists(folder_path) && !hideOriginalFolder(folder_path)) {
+        // If hiding fails, we should clean up the vault entry
+        setError("Failed to hide original folder, cleaning up vault entry");
+        
+        // Cleanup: Remove the vault files we just created
+        std::string vault_folder_path = getVaultFolderPath(operation.vaultLocation);
+        std::string metadata_path = getFolderMetadataPath(operation.vaultLocation);
+        
+        if (fs::exists(vault_folder_path)) {
+            fs::remove_all(vault_folder_path);
+        }
+        if (fs::exists(metadata_path)) {
+            fs::remove(metadata_path);
+        }
+        
+        // Remove from vault metadata
+        auto it = std::find(vault_metadata_.locked_folders.begin(),
+                           vault_metadata_.locked_folders.end(), folder_path);
+        if (it != vault_metadata_.locked_folders.end()) {
+            vault_metadata_.locked_folders.erase(it);
+            vault_metadata_.total_folders--;
+            saveVaultMetadata();
+        }
+        
+        journal_->discard(operation.id);
+        result.success = false;
+        result.error_details = last_error_;
         return result;
     }
+    
+    journal_->complete();
+    result.success = true;
+    result.message = "Folder successfully locked and encrypted";
+    std::cout << "[ProfileVault] Locked folder: " << folder_path << std::endl;
+    return result;
 }
 
 VaultOperationResult ProfileVault::unlockFolder(const std::string& folder_path, const std::string& master_key, UnlockMode mode) {
+    phantomvault::TraceSpan span("vault_unlock");
     clearError();
     VaultOperationResult result;
     
     try {
+        // An interrupted unlock of this folder picks up where it stopped
+        std::string vault_location = generateVaultLocation(folder_path);
+        if (auto pending = journal_->load(vault_location)) {
+            if (pending->type != phantomvault::OperationJournal::OperationType::UNLOCK) {
+                result.error_details = "An interrupted lock of this folder must be completed first";
+                return result;
+            }
+            std::cout << "[ProfileVault] Resuming interrupted unlock: " << folder_path
+                      << " (" << pending->completedFiles.size() << " files already restored)" << std::endl;
+            return runUnlock(*pending, master_key);
+        }
+        
         // Check if folder is locked
         if (!isFolderLocked(folder_path)) {
             result.error_details = "Folder is not locked: " + folder_path;
@@ -232,64 +334,146 @@ VaultOperationResult ProfileVault::unlockFolder(const std::string& folder_path,
             return result;
         }
         
+        phantomvault::OperationJournal::Operation operation;
+        operation.id = vault_location;
+        operation.type = phantomvault::OperationJournal::OperationType::UNLOCK;
+        operation.folderPath = folder_path;
+        operation.vaultLocation = folder_info->vault_location;
+        operation.mode = mode == UnlockMode::TEMPORARY ? "temporary" : "permanent";
+        operation.startedAt = std::chrono::system_clock::now();
+        return runUnlock(operation, master_key);
+        
+    } catch (const std::exception& e) {
+        journal_->release();
+        result.error_details = "Failed to unlock folder: " + std::string(e.what());
+        return result;
+    }
+}
+
+VaultOperationResult ProfileVault::runUnlock(const phantomvault::OperationJournal::Operation& operation, const std::string& master_key) {
+    VaultOperationResult result;
+    const std::string& folder_path = operation.folderPath;
+    UnlockMode mode = operation.mode == "temporary" ? UnlockMode::TEMPORARY : UnlockMode::PERMANENT;
+    
+    if (!journal_->begin(operation)) {
+        result.error_details = "Failed to journal unlock: " + journal_->getLastError();
+        return result;
+    }
+    
+    if (operation.phase.empty()) {
         // Decrypt and restore the folder
-        result = decryptAndRestoreFolder(folder_info->vault_location, folder_path, master_key, mode);
-        
-        if (result.success) {
-            if (mode == UnlockMode::TEMPORARY) {
-                // Add to temporary unlock tracking
-                temp_unlock_state_.unlocked_folders.push_back(folder_path);
-                temp_unlock_state_.unlock_timestamp = std::chrono::system_clock::now();
-                saveTemporaryUnlockState();
-                
-                result.message = "Folder temporarily unlocked (will auto-lock on system events)";
+        result = decryptAndRestoreFolder(operation.vaultLocation, folder_path, master_key, mode, operation);
+        if (!result.success) {
+            journal_->release();
+            return result;
+        }
+        
+        if (!journal_->markPhase("restored")) {
+            journal_->release();
+            result.success = false;
+            result.error_details = "Failed to journal unlock: " + journal_->getLastError();
+            return result;
+        }
+    }
+    
+    // Everything below is safe to repeat if a resumed unlock already ran part of it
+    if (mode == UnlockMode::TEMPORARY) {
+        // Add to temporary unlock tracking
+        if (!isFolderTemporarilyUnlocked(folder_path)) {
+            temp_unlock_state_.unlocked_folders.push_back(folder_path);
+        }
+        temp_unlock_state_.unlock_timestamp = std::chrono::system_clock::now();
+        saveTemporaryUnlockState();
+        
+        result.message = "Folder temporarily unlocked (will auto-lock on system events)";
+    } else {
+        // Remove from vault tracking for permanent unlock
+        auto it = std::find(vault_metadata_.locked_folders.begin(), 
+                          vault_metadata_.locked_folders.end(), folder_path);
+        if (it != vault_metadata_.locked_folders.end()) {
+            vault_metadata_.locked_folders.erase(it);
+            vault_metadata_.total_folders--;
+            saveVaultMetadata();
+        }
+        
+        // Secure deletion from vault using VaultHandler
+        if (vault_handler_) {
+            std::hash<std::string> hasher;
+            std::string folder_identifier = "folder_" + std::to_string(hasher(folder_path));
+            
+            auto cleanup_result = vault_handler_->secureDeleteFromVault(profile_id_, folder_identifier);
+            if (cleanup_result.success) {
+                std::cout << "[ProfileVault] Secure deletion completed: " << cleanup_result.message << std::endl;
             } else {
-                // Remove from vault tracking for permanent unlock
-                auto it = std::find(vault_metadata_.locked_folders.begin(), 
-                                  vault_metadata_.locked_folders.end(), folder_path);
-                if (it != vault_metadata_.locked_folders.end()) {
-                    vault_metadata_.locked_folders.erase(it);
-                    vault_metadata_.total_folders--;
-                    saveVaultMetadata();
-                }
+                std::cout << "[ProfileVault] Secure deletion failed, using basic cleanup: " 
+                          << cleanup_result.error_details << std::endl;
                 
-                // Secure deletion from vault using VaultHandler
-                if (vault_handler_) {
-                    std::hash<std::string> hasher;
-                    std::string folder_identifier = "folder_" + std::to_string(hasher(folder_path));
-                    
-                    auto cleanup_result = vault_handler_->secureDeleteFromVault(profile_id_, folder_identifier);
-                    if (cleanup_result.success) {
-                        std::cout << "[ProfileVault] Secure deletion completed: " << cleanup_result.message << std::endl;
-                    } else {
-                        std::cout << "[ProfileVault] Secure deletion failed, using basic cleanup: " 
-                                  << cleanup_result.error_details << std::endl;
-                        
-                        // Fallback: Basic cleanup
-                        std::string vault_folder_path = getVaultFolderPath(folder_info->vault_location);
-                        if (fs::exists(vault_folder_path)) {
-                            fs::remove_all(vault_folder_path);
-                        }
-                    }
-                } else {
-                    // Fallback: Basic cleanup
-                    std::string vault_folder_path = getVaultFolderPath(folder_info->vault_location);
-                    if (fs::exists(vault_folder_path)) {
-                        fs::remove_all(vault_folder_path);
-                    }
+                // Fallback: Basic cleanup
+                std::string vault_folder_path = getVaultFolderPath(operation.vaultLocation);
+                if (fs::exists(vault_folder_path)) {
+                    fs::remove_all(vault_folder_path);
                 }
-                
-                result.message = "Folder permanently unlocked and removed from vault";
             }
-            
-            std::cout << "[ProfileVault] Unlocked folder: " << folder_path 
-                     << " (mode: " << (mode == UnlockMode::TEMPORARY ? "temporary" : "permanent") << ")" << std::endl;
+        } else {
+            // Fallback: Basic cleanup
+            std::string vault_folder_path = getVaultFolderPath(operation.vaultLocation);
+            if (fs::exists(vault_folder_path)) {
+                fs::remove_all(vault_folder_path);
+            }
+        }
+        
+        result.message = "Folder permanently unlocked and removed from vault";
+    }
+    
+    journal_->complete();
+    result.success = true;
+    std::cout << "[ProfileVault] Unlocked folder: " << folder_path 
+             << " (mode: " << operation.mode << ")" << std::endl;
+    return result;
+}
+
+std::vector<std::string> ProfileVault::getInterruptedOperations() const {
+    std::vector<std::string> folders;
+    for (const auto& operation : journal_->listPending()) {
+        folders.push_back(operation.folderPath);
+    }
+    return folders;
+}
+
+VaultOperationResult ProfileVault::resumeInterruptedOperations(const std::string& master_key) {
+    BackgroundWork background;
+    clearError();
+    VaultOperationResult result;
+    
+    try {
+        std::vector<std::string> failed_folders;
+        
+        for (const auto& operation : journal_->listPending()) {
+            auto resumed = operation.type == phantomvault::OperationJournal::OperationType::LOCK
+                ? runLock(operation, master_key)
+                : runUnlock(operation, master_key);
+            if (resumed.success) {
+                result.processed_files.push_back(operation.folderPath);
+            } else {
+                failed_folders.push_back(operation.folderPath);
+                std::cout << "[ProfileVault] Failed to resume operation on " << operation.folderPath
+                          << ": " << resumed.error_details << std::endl;
+            }
+        }
+        
+        if (failed_folders.empty()) {
+            result.success = true;
+            result.message = "Resumed " + std::to_string(result.processed_files.size()) + " interrupted operation(s)";
+        } else {
+            result.error_details = "Failed to resume some operations";
+            result.processed_files = failed_folders;
         }
         
         return result;
         
     } catch (const std::exception& e) {
-        result.error_details = "Failed to unlock folder: " + std::string(e.what());
+        journal_->release();
+        result.error_details = "Failed to resume interrupted operations: " + std::string(e.what());
         return result;
     }
 }
@@ -343,6 +527,7 @@ bool ProfileVault::isValidMasterKey(const std::string& master_key) const {
 }
 
 VaultOperationResult ProfileVault::relockTemporaryFolders() {
+    BackgroundWork background;
     clearError();
     VaultOperationResult result;
     
@@ -351,7 +536,8 @@ VaultOperationResult ProfileVault::relockTemporaryFolders() {
         
         for (const auto& folder_path : temp_unlock_state_.unlocked_folders) {
             if (fs::exists(folder_path)) {
-                // Hide the folder again
+                // Hide the folder again; a rename, but each one commits vault metadata
+                throttleIO(kRelockIOCharge);
                 if (!hideOriginalFolder(folder_path)) {
                     failed_folders.push_back(folder_path);
                 }
@@ -425,6 +611,72 @@ bool ProfileVault::validateVaultIntegrity() const {
     }
 }
 
+VaultOperationResult ProfileVault::verifyFolderContents(const std::string& folder_path, double sample_rate) const {
+    clearError();
+    VaultOperationResult result;
+    
+    try {
+        auto folder_info = getFolderInfo(folder_path);
+        if (!folder_info) {
+            result.error_details = "Folder is not in the vault: " + folder_path;
+            return result;
+        }
+        if (folder_info->integrity_root.empty()) {
+            result.error_details = "Folder was locked without an integrity tree; re-lock it to add one";
+            return result;
+        }
+        
+        phantomvault::MerkleTree::VerifyOptions options;
+        options.sampleRate = sample_rate;
+        auto verification = verifyFolderTree(*folder_info, options);
+        
+        result.processed_files = verification.corruptObjects;
+        result.processed_files.insert(result.processed_files.end(),
+                                      verification.missingObjects.begin(), verification.missingObjects.end());
+        result.processed_files.insert(result.processed_files.end(),
+                                      verification.unexpectedObjects.begin(), verification.unexpectedObjects.end());
+        
+        result.success = verification.success;
+        result.message = "Verified " + std::to_string(verification.objectsChecked) + " of " +
+                         std::to_string(verification.objectsTotal) + " objects (" +
+                         std::to_string(verification.bytesChecked) + " bytes) in " +
+                         std::to_string(verification.duration.count()) + " ms";
+        if (!result.success) {
+            if (!verification.rootMatches) {
+                result.error_details = last_error_.empty() ? "Integrity tree does not match the folder metadata" : last_error_;
+            } else {
+                result.error_details = std::to_string(result.processed_files.size()) + " object(s) failed verification";
+            }
+            
+            if (error_handler_) {
+                error_handler_->handleVaultCorruption(profile_id_, vault_path_,
+                                                      "Folder content verification failed: " + folder_path);
+            }
+        }
+        
+        return result;
+        
+    } catch (const std::exception& e) {
+        result.error_details = "Failed to verify folder contents: " + std::string(e.what());
+        return result;
+    }
+}
+
+void ProfileVault::setBackgroundIOLimit(size_t max_bytes_per_second) {
+    io_limiter_->setIOLimit(max_bytes_per_second);
+    error_handler_->setBackupIOLimit(max_bytes_per_second);
+}
+
+// No-op outside background work, or while no limit is set
+void ProfileVault::throttleIO(size_t bytes) {
+    if (t_background_depth == 0) {
+        return;
+    }
+    phantomvault::TraceSpan span("io_throttle");
+    io_limiter_->recordIO(bytes);
+    io_limiter_->enforceIOLimit();
+}
+
 bool ProfileVault::cleanupCorruptedEntries() {
     clearError();
     
@@ -485,7 +737,7 @@ size_t ProfileVault::getVaultSize() const {
         if (fs::exists(vault_path_)) {
             for (const auto& entry : fs::recursive_directory_iterator(vault_path_)) {
                 if (entry.is_regular_file()) {
-                    total_size += fs::file_size(entry.path());
+                    total_size += entry.file_size();
                 }
             }
         }
@@ -498,15 +750,28 @@ size_t ProfileVault::getVaultSize() const {
 
 // Private implementation methods
 
-VaultOperationResult ProfileVault::encryptAndStoreFolder(const std::string& folder_path, const std::string& master_key) {
+VaultOperationResult ProfileVault::encryptAndStoreFolder(const std::string& folder_path, const std::string& master_key,
+                                                        const phantomvault::OperationJournal::Operation& operation) {
     VaultOperationResult result;
     
     try {
         std::string vault_location = generateVaultLocation(folder_path);
         std::string vault_folder_path = getVaultFolderPath(vault_location);
         
-        // Create vault folder
+        // Create vault folder; small files are packed into its segment store,
+        // reopened as of its last checkpoint when resuming
         fs::create_directories(vault_folder_path);
+        phantomvault::SegmentStore pack;
+        bool opened = operation.completedFiles.empty() ? pack.create(vault_folder_path) : pack.resume(vault_folder_path);
+        if (!opened) {
+            result.error_details = "Failed to create vault pack: " + pack.getLastError();
+            return result;
+        }
+        
+        // The pack index goes first so the journal never lists an object it does not hold
+        auto checkpoint = [&pack, this]() {
+            return pack.checkpoint() && journal_->checkpoint();
+        };
         
         // Initialize folder info
         LockedFolderInfo folder_info;
@@ -514,42 +779,62 @@ VaultOperationResult ProfileVault::encryptAndStoreFolder(const std::string& fold
         folder_info.vault_location = vault_location;
         folder_info.lock_timestamp = std::chrono::system_clock::now();
         
-        // Recursively encrypt all files
-        size_t file_count = 0;
-        size_t total_size = 0;
+        // Recursively encrypt all files not stored by an earlier attempt
+        size_t file_count = operation.completedFiles.size();
+        size_t total_size = operation.completedBytes;
         
         for (const auto& entry : fs::recursive_directory_iterator(folder_path)) {
             if (entry.is_regular_file()) {
-                std::string relative_path = fs::relative(entry.path(), folder_path);
+                std::string relative_path = fs::relative(entry.path(), folder_path).generic_string();
+                if (operation.completedFiles.count(relative_path)) {
+                    continue;
+                }
                 std::string vault_file_path = vault_folder_path + "/" + relative_path + ".enc";
                 
-                // Create directory structure in vault
-                fs::create_directories(fs::path(vault_file_path).parent_path());
-                
-                if (encryptFile(entry.path().string(), vault_file_path, master_key)) {
+                if (encryptFile(entry.path().string(), vault_file_path, master_key, &pack, relative_path)) {
+                    size_t file_size = entry.file_size();
                     file_count++;
-                    total_size += fs::file_size(entry.path());
+                    total_size += file_size;
                     result.processed_files.push_back(entry.path().string());
+                    
+                    journal_->recordFile(relative_path, file_size, fs::exists(vault_file_path) ? vault_file_path : "");
+                    if (journal_->shouldCheckpoint() && !checkpoint()) {
+                        result.error_details = "Failed to checkpoint lock: " + journal_->getLastError();
+                        return result;
+                    }
                 } else {
+                    checkpoint();
                     result.error_details = "Failed to encrypt file: " + entry.path().string();
                     return result;
                 }
             }
         }
         
+        if (!pack.commit()) {
+            result.error_details = "Failed to commit vault pack: " + pack.getLastError();
+            return result;
+        }
+        
         folder_info.file_count = file_count;
         folder_info.total_size = total_size;
         
+        if (!buildFolderTree(vault_folder_path, folder_info)) {
+            result.error_details = "Failed to build integrity tree: " + last_error_;
+            return result;
+        }
+        
         // Save folder metadata
         if (!saveFolderMetadata(vault_location, folder_info)) {
             result.error_details = "Failed to save folder metadata";
             return result;
         }
         
-        // Update vault metadata
-        vault_metadata_.locked_folders.push_back(folder_path);
-        vault_metadata_.total_folders++;
-        vault_metadata_.total_files += file_count;
+        // Update vault metadata; a resumed lock may have got this far already
+        if (!isFolderLocked(folder_path)) {
+            vault_metadata_.locked_folders.push_back(folder_path);
+            vault_metadata_.total_folders++;
+            vault_metadata_.total_files += file_count;
+        }
         vault_metadata_.last_modified = std::chrono::system_clock::now();
         
         if (!saveVaultMetadata()) {
@@ -571,7 +856,8 @@ VaultOperationResult ProfileVault::encryptAndStoreFolder(const std::string& fold
 VaultOperationResult ProfileVault::decryptAndRestoreFolder(const std::string& vault_location, 
                                                           const std::string& original_path, 
                                                           const std::string& master_key,
-                                                          UnlockMode /* mode */) {
+                                                          UnlockMode /* mode */,
+                                                          const phantomvault::OperationJournal::Operation& operation) {
     VaultOperationResult result;
     
     try {
@@ -587,10 +873,52 @@ VaultOperationResult ProfileVault::decryptAndRestoreFolder(const std::string& va
             fs::create_directories(original_path);
         }
         
-        // Recursively decrypt all files
+        // Packed objects first, read sequentially from their segments
+        if (phantomvault::SegmentStore::exists(vault_folder_path)) {
+            phantomvault::SegmentStore pack;
+            if (!pack.open(vault_folder_path)) {
+                result.error_details = "Failed to open vault pack: " + pack.getLastError();
+                return result;
+            }
+            
+            std::vector<std::string> object_ids;
+            object_ids.reserve(pack.getObjectCount());
+            pack.forEachObject([&object_ids](const std::string& object_id, const phantomvault::SegmentStore::ObjectLocation&) {
+                object_ids.push_back(object_id);
+            });
+            
+            fs::path last_parent;
+            for (const auto& object_id : object_ids) {
+                if (operation.completedFiles.count(object_id)) {
+                    continue;
+                }
+                std::string output_path = original_path + "/" + object_id;
+                fs::path parent = fs::path(output_path).parent_path();
+                if (parent != last_parent) {
+                    fs::create_directories(parent);
+                    last_parent = parent;
+                }
+                
+                auto record = pack.read(object_id);
+                if (!record || !decryptRecord(*record, output_path, master_key)) {
+                    journal_->checkpoint();
+                    result.error_details = "Failed to decrypt packed file: " + object_id;
+                    return result;
+                }
+                result.processed_files.push_back(output_path);
+                
+                journal_->recordFile(object_id, record->size(), output_path);
+                if (journal_->shouldCheckpoint() && !journal_->checkpoint()) {
+                    result.error_details = "Failed to checkpoint unlock: " + journal_->getLastError();
+                    return result;
+                }
+            }
+        }
+        
+        // Then any large files stored standalone
         for (const auto& entry : fs::recursive_directory_iterator(vault_folder_path)) {
             if (entry.is_regular_file() && entry.path().extension() == ".enc") {
-                std::string relative_path = fs::relative(entry.path(), vault_folder_path);
+                std::string relative_path = fs::relative(entry.path(), vault_folder_path).generic_string();
                 
                 // Remove .enc extension
                 std::string relative_path_str = relative_path;
@@ -598,6 +926,9 @@ VaultOperationResult ProfileVault::decryptAndRestoreFolder(const std::string& va
                     relative_path_str.substr(relative_path_str.size() - 4) == ".enc") {
                     relative_path_str = relative_path_str.substr(0, relative_path_str.length() - 4);
                 }
+                if (operation.completedFiles.count(relative_path_str)) {
+                    continue;
+                }
                 
                 std::string output_path = original_path + "/" + relative_path_str;
                 
@@ -606,7 +937,14 @@ VaultOperationResult ProfileVault::decryptAndRestoreFolder(const std::string& va
                 
                 if (decryptFile(entry.path().string(), output_path, master_key)) {
                     result.processed_files.push_back(output_path);
+                    
+                    journal_->recordFile(relative_path_str, entry.file_size(), output_path);
+                    if (journal_->shouldCheckpoint() && !journal_->checkpoint()) {
+                        result.error_details = "Failed to checkpoint unlock: " + journal_->getLastError();
+                        return result;
+                    }
                 } else {
+                    journal_->checkpoint();
                     result.error_details = "Failed to decrypt file: " + entry.path().string();
                     return result;
                 }
@@ -624,13 +962,11 @@ VaultOperationResult ProfileVault::decryptAndRestoreFolder(const std::string& va
     }
 }
 
-bool ProfileVault::encryptFile(const std::string& file_path, const std::string& vault_file_path, const std::string& master_key) {
-    // Create backup of original file before encryption
-    std::string backup_path;
-    if (error_handler_) {
-        backup_path = error_handler_->createFileBackup(file_path);
-    }
-    
+bool ProfileVault::encryptFile(const std::string& file_path, const std::string& vault_file_path, const std::string& master_key,
+                               phantomvault::SegmentStore* pack, const std::string& object_id) {
+    phantomvault::TraceSpan span("encrypt_file");
+    // No pre-encryption copy: the original is left untouched until the whole
+    // folder is stored, and the operation journal covers an interrupted lock
     try {
         auto result = encryption_engine_->encryptFile(file_path, master_key);
         if (!result.success) {
@@ -639,7 +975,7 @@ bool ProfileVault::encryptFile(const std::string& file_path, const std::string&
             // Log encryption failure with backup information
             if (error_handler_) {
                 error_handler_->handleEncryptionError(profile_id_, file_path, 
-                                                    result.error_message, backup_path);
+                                                    result.error_message, "");
             }
             return false;
         }
@@ -650,9 +986,11 @@ bool ProfileVault::encryptFile(const std::string& file_path, const std::string&
         file_data["iv"] = result.iv;
         file_data["salt"] = result.salt;
         file_data["algorithm"] = result.algorithm;
+        file_data["compression_algorithm"] = result.compression_algorithm;
+        file_data["original_size"] = result.original_size;
         
-        // Add file metadata
-        auto metadata = encryption_engine_->getFileMetadata(file_path);
+        // Add file metadata; the checksum comes from the plaintext encryptFile already read
+        auto metadata = encryption_engine_->getFileMetadata(file_path, false);
         file_data["metadata"] = {
             {"original_path", metadata.original_path},
             {"original_permissions", metadata.original_permissions},
@@ -660,16 +998,29 @@ bool ProfileVault::encryptFile(const std::string& file_path, const std::string&
             {"created_timestamp", metadata.created_timestamp},
             {"modified_timestamp", metadata.modified_timestamp},
             {"accessed_timestamp", metadata.accessed_timestamp},
-            {"checksum_sha256", metadata.checksum_sha256}
+            {"checksum", result.checksum},
+            {"checksum_algorithm", result.checksum_algorithm}
         };
         
+        std::string record = file_data.dump();
+        throttleIO(result.original_size + record.size());
+        phantomvault::ScopedSpan write_span(phantomvault::Operation::WRITE);
+        if (pack && pack->accepts(record.size())) {
+            if (!pack->append(object_id, record)) {
+                setError("Failed to pack vault file: " + pack->getLastError());
+                return false;
+            }
+            return true;
+        }
+        
+        fs::create_directories(fs::path(vault_file_path).parent_path());
         std::ofstream file(vault_file_path, std::ios::binary);
         if (!file) {
             setError("Failed to create vault file: " + vault_file_path);
             return false;
         }
         
-        file << file_data.dump();
+        file << record;
         file.close();
         
         // Set secure permissions
@@ -684,38 +1035,78 @@ bool ProfileVault::encryptFile(const std::string& file_path, const std::string&
 }
 
 bool ProfileVault::decryptFile(const std::string& vault_file_path, const std::string& output_path, const std::string& master_key) {
-    try {
+    std::string record;
+    {
+        phantomvault::ScopedSpan span(phantomvault::Operation::READ);
         std::ifstream file(vault_file_path, std::ios::binary);
         if (!file) {
             setError("Failed to open vault file: " + vault_file_path);
             return false;
         }
-        
-        json file_data;
-        file >> file_data;
-        file.close();
+        record.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    
+    return decryptRecord(record, output_path, master_key);
+}
+
+bool ProfileVault::decryptRecord(const std::string& record, const std::string& output_path, const std::string& master_key) {
+    phantomvault::TraceSpan span("decrypt_file");
+    try {
+        throttleIO(record.size());
+        json file_data = json::parse(record);
         
         // Extract encryption data
         std::vector<uint8_t> encrypted_data = file_data["encrypted_data"];
         std::vector<uint8_t> iv = file_data["iv"];
         std::vector<uint8_t> salt = file_data["salt"];
         
-        // Decrypt the file
-        auto decrypted_data = encryption_engine_->decryptFile(encrypted_data, master_key, iv, salt);
-        if (decrypted_data.empty()) {
+        // Decrypt the file, decompressing when the record says how it was stored;
+        // the plaintext lives in the engine's secure arena until the scope ends
+        phantomvault::SecureArena& arena = encryption_engine_->scratchArena();
+        phantomvault::SecureArena::Scope scope(arena);
+        phantomvault::SecureBuffer decrypted_data(&arena);
+        std::string compression = file_data.value("compression_algorithm", "none");
+        size_t original_size = file_data.value("original_size", static_cast<size_t>(0));
+        if (!encryption_engine_->decryptFile(encrypted_data, master_key, iv, salt, compression,
+                                             original_size, decrypted_data) || decrypted_data.empty()) {
             setError("Decryption failed: " + encryption_engine_->getLastError());
             return false;
         }
         
-        // Write decrypted data
-        std::ofstream output_file(output_path, std::ios::binary);
-        if (!output_file) {
-            setError("Failed to create output file: " + output_path);
-            return false;
+        // Check the plaintext against the checksum recorded at lock time, under
+        // the algorithm it names; records without an algorithm id are SHA-256
+        if (file_data.contains("metadata")) {
+            const auto& metadata = file_data["metadata"];
+            std::string expected;
+            std::string algorithm;
+            if (metadata.contains("checksum")) {
+                expected = metadata["checksum"].get<std::string>();
+                algorithm = metadata.value("checksum_algorithm", "sha256");
+            } else if (metadata.contains("checksum_sha256")) {
+                expected = metadata["checksum_sha256"].get<std::string>();
+                algorithm = "sha256";
+            }
+            
+            phantomvault::TraceSpan verify_span("verify_checksum");
+            if (!expected.empty() &&
+                encryption_engine_->calculateChecksum(decrypted_data.data(), decrypted_data.size(), algorithm) != expected) {
+                setError("Checksum mismatch after decryption: " + output_path);
+                return false;
+            }
         }
         
-        output_file.write(reinterpret_cast<const char*>(decrypted_data.data()), decrypted_data.size());
-        output_file.close();
+        // Write decrypted data
+        throttleIO(decrypted_data.size());
+        {
+            phantomvault::ScopedSpan span(phantomvault::Operation::WRITE);
+            std::ofstream output_file(output_path, std::ios::binary);
+            if (!output_file) {
+                setError("Failed to create output file: " + output_path);
+                return false;
+            }
+            
+            output_file.write(reinterpret_cast<const char*>(decrypted_data.data()), decrypted_data.size());
+        }
         
         // Restore file metadata if available
         if (file_data.contains("metadata")) {
@@ -753,6 +1144,7 @@ bool ProfileVault::decryptFile(const std::string& vault_file_path, const std::st
 }
 
 bool ProfileVault::saveVaultMetadata() {
+    phantomvault::ScopedSpan span(phantomvault::Operation::METADATA_COMMIT);
     try {
         json metadata;
         metadata["profile_id"] = vault_metadata_.profile_id;
@@ -816,6 +1208,7 @@ bool ProfileVault::loadVaultMetadata() {
 }
 
 bool ProfileVault::saveFolderMetadata(const std::string& vault_location, const LockedFolderInfo& info) {
+    phantomvault::ScopedSpan span(phantomvault::Operation::METADATA_COMMIT);
     try {
         std::string metadata_path = getFolderMetadataPath(vault_location);
         
@@ -827,6 +1220,9 @@ bool ProfileVault::saveFolderMetadata(const std::string& vault_location, const L
         folder_metadata["file_count"] = info.file_count;
         folder_metadata["total_size"] = info.total_size;
         folder_metadata["is_temporarily_unlocked"] = info.is_temporarily_unlocked;
+        if (!info.integrity_root.empty()) {
+            folder_metadata["integrity_root"] = info.integrity_root;
+        }
         
         fs::create_directories(fs::path(metadata_path).parent_path());
         
@@ -872,6 +1268,7 @@ std::optional<LockedFolderInfo> ProfileVault::loadFolderMetadata(const std::stri
         info.file_count = folder_metadata["file_count"];
         info.total_size = folder_metadata["total_size"];
         info.is_temporarily_unlocked = folder_metadata["is_temporarily_unlocked"];
+        info.integrity_root = folder_metadata.value("integrity_root", "");
         
         return info;
         
@@ -991,8 +1388,20 @@ bool ProfileVault::verifyFolderIntegrity(const std::string& vault_location) cons
             return false;
         }
         
-        // Count files in vault folder
+        // Content hashes when the folder has a Merkle tree
+        if (!folder_info->integrity_root.empty()) {
+            return verifyFolderTree(*folder_info, phantomvault::MerkleTree::VerifyOptions{}).success;
+        }
+        
+        // Legacy entries: count packed objects from the segment index, then standalone files
         size_t actual_file_count = 0;
+        if (phantomvault::SegmentStore::exists(vault_folder_path)) {
+            phantomvault::SegmentStore pack;
+            if (!pack.open(vault_folder_path)) {
+                return false;
+            }
+            actual_file_count = pack.getObjectCount();
+        }
         for (const auto& entry : fs::recursive_directory_iterator(vault_folder_path)) {
             if (entry.is_regular_file() && entry.path().extension() == ".enc") {
                 actual_file_count++;
@@ -1011,6 +1420,41 @@ bool ProfileVault::verifyFolderIntegrity(const std::string& vault_location) cons
     }
 }
 
+phantomvault::MerkleTree::VerifyResult ProfileVault::verifyFolderTree(const LockedFolderInfo& info,
+                                                                      const phantomvault::MerkleTree::VerifyOptions& options) const {
+    std::string vault_folder_path = getVaultFolderPath(info.vault_location);
+    phantomvault::MerkleTree tree;
+    if (!tree.load(vault_folder_path + "/" + phantomvault::MerkleTree::kFileName)) {
+        setError(tree.getLastError());
+        return phantomvault::MerkleTree::VerifyResult{};
+    }
+    
+    auto result = tree.verify(vault_folder_path, options);
+    
+    // The tree file is only trusted as far as its root matches the folder metadata
+    if (tree.getRootHex() != info.integrity_root) {
+        result.rootMatches = false;
+        result.success = false;
+    }
+    return result;
+}
+
+bool ProfileVault::buildFolderTree(const std::string& vault_folder_path, LockedFolderInfo& info) {
+    std::string tree_path = vault_folder_path + "/" + phantomvault::MerkleTree::kFileName;
+    
+    // Leaves of objects that have not moved since an earlier build are reused
+    phantomvault::MerkleTree tree;
+    if (fs::exists(tree_path)) {
+        tree.load(tree_path);
+    }
+    if (!tree.build(vault_folder_path) || !tree.save(tree_path)) {
+        setError(tree.getLastError());
+        return false;
+    }
+    info.integrity_root = tree.getRootHex();
+    return true;
+}
+
 bool ProfileVault::hideOriginalFolder(const std::string& folder_path) {
     try {
         // Use advanced VaultHandler for platform-specific hiding with elevated privileges
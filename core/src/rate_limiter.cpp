@@ -0,0 +1,284 @@
+/**
+ * PhantomVault Rate Limiter Implementation
+ *
+ * Each shard owns a mutex, a hash table and an LRU list. Counting uses a
+ * sliding-window counter: the previous window's count is weighted by how much
+ * of it still overlaps the trailing window, which gives sliding-log accuracy
+ * with two integers per identifier.
+ */
+
+#include "rate_limiter.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace phantomvault {
+
+class RateLimiter::Implementation {
+public:
+    explicit Implementation(const Config& config)
+        : config_(config)
+        , shard_mask_(roundUpToPowerOfTwo(std::max<size_t>(1, config.shardCount)) - 1)
+        , shards_(shard_mask_ + 1)
+    {
+        if (config_.maxEntriesPerShard == 0) {
+            config_.maxEntriesPerShard = 1;
+        }
+    }
+
+    bool allow(const std::string& identifier, int maxAttempts, std::chrono::seconds window) {
+        auto now = Clock::now();
+        auto windowLength = std::max<Clock::duration>(window, std::chrono::seconds(1));
+        Shard& shard = shardFor(identifier);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto found = shard.index.find(identifier);
+        if (found == shard.index.end()) {
+            evictIfFull(shard, now);
+            shard.lru.emplace_front();
+            Entry& entry = shard.lru.front();
+            entry.identifier = identifier;
+            entry.window = windowLength;
+            entry.windowStart = now;
+            entry.firstAttempt = now;
+            entry.lastAttempt = now;
+            entry.currentCount = 1;
+            shard.index.emplace(entry.identifier, shard.lru.begin());
+            return maxAttempts >= 1;
+        }
+
+        // Most recently used entries live at the front
+        shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+        Entry& entry = *found->second;
+        entry.window = windowLength;
+
+        if (entry.blocked) {
+            if (now < entry.blockExpiry) {
+                entry.lastAttempt = now;
+                return false;
+            }
+            // Block served: start over with a fresh window
+            entry.blocked = false;
+            entry.previousCount = 0;
+            entry.currentCount = 0;
+            entry.windowStart = now;
+            entry.firstAttempt = now;
+        }
+
+        advanceWindow(entry, now);
+        entry.currentCount++;
+        entry.lastAttempt = now;
+
+        if (estimate(entry, now) > static_cast<double>(maxAttempts)) {
+            entry.blocked = true;
+            entry.blockExpiry = now + config_.blockDuration;
+            return false;
+        }
+        return true;
+    }
+
+    void reset(const std::string& identifier) {
+        Shard& shard = shardFor(identifier);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.index.find(identifier);
+        if (found != shard.index.end()) {
+            shard.lru.erase(found->second);
+            shard.index.erase(found);
+        }
+    }
+
+    RateLimitInfo getInfo(const std::string& identifier) const {
+        RateLimitInfo info{};
+        const Shard& shard = shardFor(identifier);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.index.find(identifier);
+        if (found == shard.index.end()) {
+            return info;
+        }
+
+        const Entry& entry = *found->second;
+        auto now = Clock::now();
+        Entry snapshot = entry;
+        advanceWindow(snapshot, now);
+
+        info.identifier = entry.identifier;
+        info.attemptCount = static_cast<int>(estimate(snapshot, now) + 0.5);
+        info.firstAttempt = entry.firstAttempt;
+        info.lastAttempt = entry.lastAttempt;
+        info.isBlocked = entry.blocked && now < entry.blockExpiry;
+        info.blockExpiry = entry.blockExpiry;
+        return info;
+    }
+
+    size_t sweepExpired() {
+        auto now = Clock::now();
+        size_t removed = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto it = shard.lru.begin(); it != shard.lru.end();) {
+                if (isExpired(*it, now)) {
+                    shard.index.erase(it->identifier);
+                    it = shard.lru.erase(it);
+                    ++removed;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        return removed;
+    }
+
+    void clear() {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.index.clear();
+            shard.lru.clear();
+        }
+    }
+
+    Stats getStats() const {
+        Stats stats;
+        auto now = Clock::now();
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            stats.trackedIdentifiers += shard.lru.size();
+            stats.evictions += shard.evictions;
+            for (const auto& entry : shard.lru) {
+                if (entry.blocked && now < entry.blockExpiry) {
+                    stats.blockedIdentifiers++;
+                }
+                // List node + hash node + the identifier stored in each
+                stats.approximateMemoryBytes += sizeof(Entry) + 2 * entry.identifier.capacity() + 64;
+            }
+        }
+        return stats;
+    }
+
+private:
+    using Clock = std::chrono::system_clock;
+
+    struct Entry {
+        std::string identifier;
+        Clock::duration window{};
+        Clock::time_point windowStart;
+        uint32_t previousCount = 0;
+        uint32_t currentCount = 0;
+        bool blocked = false;
+        Clock::time_point blockExpiry;
+        Clock::time_point firstAttempt;
+        Clock::time_point lastAttempt;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+        uint64_t evictions = 0;
+    };
+
+    Config config_;
+    size_t shard_mask_;
+    std::vector<Shard> shards_;
+
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    Shard& shardFor(const std::string& identifier) {
+        return shards_[std::hash<std::string>{}(identifier) & shard_mask_];
+    }
+
+    const Shard& shardFor(const std::string& identifier) const {
+        return shards_[std::hash<std::string>{}(identifier) & shard_mask_];
+    }
+
+    static void advanceWindow(Entry& entry, Clock::time_point now) {
+        auto elapsed = now - entry.windowStart;
+        if (elapsed >= 2 * entry.window) {
+            entry.previousCount = 0;
+            entry.currentCount = 0;
+            entry.windowStart = now;
+        } else if (elapsed >= entry.window) {
+            entry.previousCount = entry.currentCount;
+            entry.currentCount = 0;
+            entry.windowStart += entry.window;
+        }
+    }
+
+    static double estimate(const Entry& entry, Clock::time_point now) {
+        double intoWindow = std::chrono::duration<double>(now - entry.windowStart).count();
+        double windowSeconds = std::chrono::duration<double>(entry.window).count();
+        double previousWeight = std::max(0.0, 1.0 - intoWindow / windowSeconds);
+        return entry.previousCount * previousWeight + entry.currentCount;
+    }
+
+    static bool isExpired(const Entry& entry, Clock::time_point now) {
+        if (entry.blocked && now < entry.blockExpiry) {
+            return false;
+        }
+        return now - entry.lastAttempt >= 2 * entry.window;
+    }
+
+    /**
+     * Make room for a new identifier. Cold, unblocked entries go first;
+     * blocked identifiers get a second chance so an attacker cannot reset
+     * their own block by flooding the table with fresh identifiers.
+     */
+    void evictIfFull(Shard& shard, Clock::time_point now) {
+        if (shard.lru.size() < config_.maxEntriesPerShard) {
+            return;
+        }
+
+        constexpr int kMaxSecondChances = 8;
+        for (int i = 0; i < kMaxSecondChances; ++i) {
+            auto victim = std::prev(shard.lru.end());
+            if (!victim->blocked || now >= victim->blockExpiry) {
+                break;
+            }
+            shard.lru.splice(shard.lru.begin(), shard.lru, victim);
+        }
+
+        auto victim = std::prev(shard.lru.end());
+        shard.index.erase(victim->identifier);
+        shard.lru.erase(victim);
+        shard.evictions++;
+    }
+};
+
+RateLimiter::RateLimiter() : pimpl(std::make_unique<Implementation>(Config{})) {}
+RateLimiter::RateLimiter(const Config& config) : pimpl(std::make_unique<Implementation>(config)) {}
+RateLimiter::~RateLimiter() = default;
+
+bool RateLimiter::allow(const std::string& identifier, int maxAttempts, std::chrono::seconds window) {
+    return pimpl->allow(identifier, maxAttempts, window);
+}
+
+void RateLimiter::reset(const std::string& identifier) {
+    pimpl->reset(identifier);
+}
+
+RateLimitInfo RateLimiter::getInfo(const std::string& identifier) const {
+    return pimpl->getInfo(identifier);
+}
+
+size_t RateLimiter::sweepExpired() {
+    return pimpl->sweepExpired();
+}
+
+void RateLimiter::clear() {
+    pimpl->clear();
+}
+
+RateLimiter::Stats RateLimiter::getStats() const {
+    return pimpl->getStats();
+}
+
+} // namespace phantomvault
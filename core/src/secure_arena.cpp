@@ -0,0 +1,201 @@
+/**
+ * PhantomVault Secure Arena Implementation
+ */
+
+#include "secure_arena.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+#include <sys/mman.h>
+#include <unistd.h>
+#elif PLATFORM_WINDOWS
+#include <windows.h>
+#endif
+
+namespace phantomvault {
+
+namespace {
+
+size_t pageSize() {
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#elif PLATFORM_WINDOWS
+    static const size_t size = []() {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+    }();
+#else
+    static const size_t size = 4096;
+#endif
+    return size;
+}
+
+size_t roundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+} // anonymous namespace
+
+SecureArena::Region SecureArena::mapRegion(size_t size) {
+    Region region;
+    if (size == 0) {
+        return region;
+    }
+    const size_t page = pageSize();
+    const size_t data_size = roundUp(size, page);
+    const size_t mapped_size = data_size + 2 * page;
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    void* base = mmap(nullptr, mapped_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return region;
+    }
+    uint8_t* data = static_cast<uint8_t*>(base) + page;
+    if (mprotect(data, data_size, PROT_READ | PROT_WRITE) != 0) {
+        munmap(base, mapped_size);
+        return region;
+    }
+#ifdef MADV_DONTDUMP
+    madvise(data, data_size, MADV_DONTDUMP);
+#endif
+    region.locked = mlock(data, data_size) == 0;
+#elif PLATFORM_WINDOWS
+    void* base = VirtualAlloc(nullptr, mapped_size, MEM_RESERVE, PAGE_NOACCESS);
+    if (!base) {
+        return region;
+    }
+    uint8_t* data = static_cast<uint8_t*>(base) + page;
+    if (!VirtualAlloc(data, data_size, MEM_COMMIT, PAGE_READWRITE)) {
+        VirtualFree(base, 0, MEM_RELEASE);
+        return region;
+    }
+    region.locked = VirtualLock(data, data_size) != 0;
+#else
+    (void)mapped_size;
+    return region;
+#endif
+
+    region.base = static_cast<uint8_t*>(base);
+    region.mappedSize = mapped_size;
+    region.data = data;
+    region.size = data_size;
+    return region;
+}
+
+void SecureArena::unmapRegion(Region& region) {
+    if (!region.base) {
+        return;
+    }
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    if (region.locked) {
+        munlock(region.data, region.size);
+    }
+    munmap(region.base, region.mappedSize);
+#elif PLATFORM_WINDOWS
+    if (region.locked) {
+        VirtualUnlock(region.data, region.size);
+    }
+    VirtualFree(region.base, 0, MEM_RELEASE);
+#endif
+    region = Region();
+}
+
+SecureArena::SecureArena(size_t capacity) : arena_(mapRegion(capacity)) {
+    capacity_ = arena_.size;
+    locked_ = arena_.locked;
+}
+
+SecureArena::~SecureArena() {
+    reset();
+    unmapRegion(arena_);
+}
+
+SecureArena& SecureArena::forThread() {
+    thread_local std::unique_ptr<SecureArena> arena;
+    if (!arena) {
+        arena = std::make_unique<SecureArena>();
+    }
+    return *arena;
+}
+
+void SecureArena::reset() {
+    rewind(0, 0);
+    floor_ = 0;
+}
+
+void SecureArena::rewind(size_t mark, size_t overflowMark) {
+    if (used_ > mark) {
+        secureZero(arena_.data + mark, used_ - mark);
+        used_ = mark;
+    }
+    while (overflow_.size() > overflowMark) {
+        Region& region = overflow_.back();
+        if (region.base) {
+            secureZero(region.data, region.size);
+            overflow_bytes_ -= region.size;
+            unmapRegion(region);
+        }
+        overflow_.pop_back();
+    }
+}
+
+void* SecureArena::do_allocate(size_t bytes, size_t alignment) {
+    size_t offset = roundUp(used_, std::max<size_t>(alignment, 1));
+    if (offset <= capacity_ && bytes <= capacity_ - offset) {
+        used_ = offset + bytes;
+        return arena_.data + offset;
+    }
+
+    // Page alignment covers any alignment a buffer of bytes needs
+    Region region = mapRegion(std::max<size_t>(bytes, 1));
+    if (!region.base || alignment > pageSize()) {
+        unmapRegion(region);
+        throw std::bad_alloc();
+    }
+    overflow_bytes_ += region.size;
+    overflow_.push_back(region);
+    return region.data;
+}
+
+void SecureArena::do_deallocate(void* ptr, size_t bytes, size_t) {
+    uint8_t* address = static_cast<uint8_t*>(ptr);
+    if (address >= arena_.data && address < arena_.data + capacity_) {
+        // Only the newest allocation of the innermost scope can be handed
+        // back early, as when a vector regrows
+        if (address + bytes == arena_.data + used_ && address >= arena_.data + floor_) {
+            secureZero(address, bytes);
+            used_ = static_cast<size_t>(address - arena_.data);
+        }
+        return;
+    }
+
+    for (auto it = overflow_.rbegin(); it != overflow_.rend(); ++it) {
+        if (it->data == address) {
+            secureZero(it->data, it->size);
+            overflow_bytes_ -= it->size;
+            // The empty slot stays until its scope ends so marks stay valid
+            unmapRegion(*it);
+            return;
+        }
+    }
+}
+
+bool SecureArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+SecureArena::Scope::Scope(SecureArena& arena)
+    : arena_(arena), mark_(arena.used_), overflow_mark_(arena.overflow_.size()), outer_floor_(arena.floor_) {
+    arena_.floor_ = mark_;
+}
+
+SecureArena::Scope::~Scope() {
+    arena_.rewind(mark_, overflow_mark_);
+    arena_.floor_ = outer_floor_;
+}
+
+} // namespace phantomvault
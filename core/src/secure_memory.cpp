@@ -0,0 +1,367 @@
+/**
+ * PhantomVault Secure Memory Kernels Implementation
+ *
+ * Every kernel covers the tail with one overlapping full-width access
+ * instead of a byte loop. Wipes store one unaligned vector at each end and
+ * aligned vectors in between, since stores that split cache lines run at
+ * half speed; up to two vectors are just the two end stores. Sizes below
+ * one vector go to the next narrower kernel. Which accesses happen depends
+ * only on the size and address, never on the data.
+ */
+
+#include "secure_memory.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PHANTOMVAULT_SECURE_MEMORY_X86 1
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define PHANTOMVAULT_SECURE_MEMORY_NEON 1
+#endif
+
+#ifdef PLATFORM_WINDOWS
+#include <windows.h>
+#endif
+
+namespace phantomvault {
+
+namespace {
+
+// Hides a value from the optimizer so it cannot stop a loop early once the
+// accumulated difference is known to be nonzero
+inline void hideValue(uint64_t& value) {
+#ifdef __GNUC__
+    __asm__("" : "+r"(value));
+#else
+    volatile uint64_t hidden = value;
+    value = hidden;
+#endif
+}
+
+inline uint8_t* alignUp(uint8_t* p, size_t alignment) {
+    return reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(p) + alignment - 1) & ~(alignment - 1));
+}
+
+inline uint32_t foldDifference(uint64_t diff) {
+    return static_cast<uint32_t>(diff) | static_cast<uint32_t>(diff >> 32);
+}
+
+void zeroPortable(uint8_t* data, size_t size) {
+#ifdef PLATFORM_WINDOWS
+    SecureZeroMemory(data, size);
+#else
+    std::memset(data, 0, size);
+#endif
+}
+
+uint32_t diffPortable(const uint8_t* a, const uint8_t* b, size_t size) {
+    uint64_t diff = 0;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t x;
+        uint64_t y;
+        std::memcpy(&x, a + i, 8);
+        std::memcpy(&y, b + i, 8);
+        diff |= x ^ y;
+        hideValue(diff);
+    }
+    for (; i < size; ++i) {
+        diff |= static_cast<uint64_t>(a[i] ^ b[i]);
+        hideValue(diff);
+    }
+    return foldDifference(diff);
+}
+
+#ifdef PHANTOMVAULT_SECURE_MEMORY_X86
+
+#define PV_SSE2 __attribute__((target("sse2")))
+#define PV_AVX2 __attribute__((target("avx2")))
+
+PV_SSE2 void zeroSse2(uint8_t* data, size_t size) {
+    if (size < 16) {
+        zeroPortable(data, size);
+        return;
+    }
+    const __m128i zero = _mm_setzero_si128();
+    uint8_t* end = data + size;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data), zero);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(end - 16), zero);
+    if (size <= 32) {
+        return;
+    }
+    uint8_t* p = alignUp(data + 1, 16);
+    for (; p + 64 <= end; p += 64) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(p), zero);
+        _mm_store_si128(reinterpret_cast<__m128i*>(p + 16), zero);
+        _mm_store_si128(reinterpret_cast<__m128i*>(p + 32), zero);
+        _mm_store_si128(reinterpret_cast<__m128i*>(p + 48), zero);
+    }
+    for (; p + 16 <= end; p += 16) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(p), zero);
+    }
+}
+
+PV_SSE2 inline __m128i diff16(const uint8_t* a, const uint8_t* b) {
+    return _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a)),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+}
+
+PV_SSE2 inline uint32_t fold128(__m128i acc) {
+    acc = _mm_or_si128(acc, _mm_srli_si128(acc, 8));
+    acc = _mm_or_si128(acc, _mm_srli_si128(acc, 4));
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(acc));
+}
+
+PV_SSE2 uint32_t diffSse2(const uint8_t* a, const uint8_t* b, size_t size) {
+    if (size < 16) {
+        return diffPortable(a, b, size);
+    }
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        __m128i low = _mm_or_si128(diff16(a + i, b + i), diff16(a + i + 16, b + i + 16));
+        __m128i high = _mm_or_si128(diff16(a + i + 32, b + i + 32), diff16(a + i + 48, b + i + 48));
+        acc = _mm_or_si128(acc, _mm_or_si128(low, high));
+    }
+    for (; i + 16 <= size; i += 16) {
+        acc = _mm_or_si128(acc, diff16(a + i, b + i));
+    }
+    if (i < size) {
+        acc = _mm_or_si128(acc, diff16(a + size - 16, b + size - 16));
+    }
+    return fold128(acc);
+}
+
+PV_AVX2 void zeroAvx2(uint8_t* data, size_t size) {
+    if (size < 32) {
+        zeroSse2(data, size);
+        return;
+    }
+    const __m256i zero = _mm256_setzero_si256();
+    uint8_t* end = data + size;
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), zero);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(end - 32), zero);
+    if (size <= 64) {
+        return;
+    }
+    uint8_t* p = alignUp(data + 1, 32);
+    for (; p + 128 <= end; p += 128) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(p), zero);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(p + 32), zero);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(p + 64), zero);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(p + 96), zero);
+    }
+    for (; p + 32 <= end; p += 32) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(p), zero);
+    }
+}
+
+PV_AVX2 inline __m256i diff32(const uint8_t* a, const uint8_t* b) {
+    return _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)),
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)));
+}
+
+PV_AVX2 uint32_t diffAvx2(const uint8_t* a, const uint8_t* b, size_t size) {
+    if (size < 32) {
+        return diffSse2(a, b, size);
+    }
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 128 <= size; i += 128) {
+        __m256i low = _mm256_or_si256(diff32(a + i, b + i), diff32(a + i + 32, b + i + 32));
+        __m256i high = _mm256_or_si256(diff32(a + i + 64, b + i + 64), diff32(a + i + 96, b + i + 96));
+        acc = _mm256_or_si256(acc, _mm256_or_si256(low, high));
+    }
+    for (; i + 32 <= size; i += 32) {
+        acc = _mm256_or_si256(acc, diff32(a + i, b + i));
+    }
+    if (i < size) {
+        acc = _mm256_or_si256(acc, diff32(a + size - 32, b + size - 32));
+    }
+    __m128i folded = _mm_or_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    folded = _mm_or_si128(folded, _mm_srli_si128(folded, 8));
+    folded = _mm_or_si128(folded, _mm_srli_si128(folded, 4));
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(folded));
+}
+
+#undef PV_SSE2
+#undef PV_AVX2
+
+bool detectSse2() {
+#ifdef __x86_64__
+    return true;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+bool detectAvx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif // PHANTOMVAULT_SECURE_MEMORY_X86
+
+#ifdef PHANTOMVAULT_SECURE_MEMORY_NEON
+
+void zeroNeon(uint8_t* data, size_t size) {
+    if (size < 16) {
+        zeroPortable(data, size);
+        return;
+    }
+    const uint8x16_t zero = vdupq_n_u8(0);
+    uint8_t* end = data + size;
+    vst1q_u8(data, zero);
+    vst1q_u8(end - 16, zero);
+    if (size <= 32) {
+        return;
+    }
+    uint8_t* p = alignUp(data + 1, 16);
+    for (; p + 64 <= end; p += 64) {
+        vst1q_u8(p, zero);
+        vst1q_u8(p + 16, zero);
+        vst1q_u8(p + 32, zero);
+        vst1q_u8(p + 48, zero);
+    }
+    for (; p + 16 <= end; p += 16) {
+        vst1q_u8(p, zero);
+    }
+}
+
+inline uint8x16_t diff16(const uint8_t* a, const uint8_t* b) {
+    return veorq_u8(vld1q_u8(a), vld1q_u8(b));
+}
+
+uint32_t diffNeon(const uint8_t* a, const uint8_t* b, size_t size) {
+    if (size < 16) {
+        return diffPortable(a, b, size);
+    }
+    uint8x16_t acc = vdupq_n_u8(0);
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        uint8x16_t low = vorrq_u8(diff16(a + i, b + i), diff16(a + i + 16, b + i + 16));
+        uint8x16_t high = vorrq_u8(diff16(a + i + 32, b + i + 32), diff16(a + i + 48, b + i + 48));
+        acc = vorrq_u8(acc, vorrq_u8(low, high));
+    }
+    for (; i + 16 <= size; i += 16) {
+        acc = vorrq_u8(acc, diff16(a + i, b + i));
+    }
+    if (i < size) {
+        acc = vorrq_u8(acc, diff16(a + size - 16, b + size - 16));
+    }
+    uint64x2_t words = vreinterpretq_u64_u8(acc);
+    return foldDifference(vgetq_lane_u64(words, 0) | vgetq_lane_u64(words, 1));
+}
+
+#endif // PHANTOMVAULT_SECURE_MEMORY_NEON
+
+struct Kernels {
+    SecureMemoryKernel kernel;
+    void (*zero)(uint8_t* data, size_t size);
+    uint32_t (*diff)(const uint8_t* a, const uint8_t* b, size_t size);
+};
+
+const Kernels kPortable = {SecureMemoryKernel::PORTABLE, zeroPortable, diffPortable};
+#ifdef PHANTOMVAULT_SECURE_MEMORY_X86
+const Kernels kSse2 = {SecureMemoryKernel::SSE2, zeroSse2, diffSse2};
+const Kernels kAvx2 = {SecureMemoryKernel::AVX2, zeroAvx2, diffAvx2};
+#endif
+#ifdef PHANTOMVAULT_SECURE_MEMORY_NEON
+const Kernels kNeon = {SecureMemoryKernel::NEON, zeroNeon, diffNeon};
+#endif
+
+// Null when the kernel is not compiled in or the CPU lacks it
+const Kernels* findKernels(SecureMemoryKernel kernel) {
+    switch (kernel) {
+        case SecureMemoryKernel::PORTABLE:
+            return &kPortable;
+#ifdef PHANTOMVAULT_SECURE_MEMORY_X86
+        case SecureMemoryKernel::SSE2: {
+            static const bool available = detectSse2();
+            return available ? &kSse2 : nullptr;
+        }
+        case SecureMemoryKernel::AVX2: {
+            static const bool available = detectAvx2();
+            return available ? &kAvx2 : nullptr;
+        }
+#endif
+#ifdef PHANTOMVAULT_SECURE_MEMORY_NEON
+        case SecureMemoryKernel::NEON:
+            return &kNeon;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+const Kernels* bestKernels() {
+    for (SecureMemoryKernel kernel : {SecureMemoryKernel::AVX2, SecureMemoryKernel::NEON, SecureMemoryKernel::SSE2}) {
+        if (const Kernels* kernels = findKernels(kernel)) {
+            return kernels;
+        }
+    }
+    return &kPortable;
+}
+
+std::atomic<const Kernels*>& activeKernels() {
+    static std::atomic<const Kernels*> active{bestKernels()};
+    return active;
+}
+
+} // anonymous namespace
+
+const char* secureMemoryKernelName(SecureMemoryKernel kernel) {
+    switch (kernel) {
+        case SecureMemoryKernel::PORTABLE: return "portable";
+        case SecureMemoryKernel::SSE2: return "sse2";
+        case SecureMemoryKernel::AVX2: return "avx2";
+        case SecureMemoryKernel::NEON: return "neon";
+    }
+    return "unknown";
+}
+
+SecureMemoryKernel activeSecureMemoryKernel() {
+    return activeKernels().load(std::memory_order_relaxed)->kernel;
+}
+
+bool isSecureMemoryKernelSupported(SecureMemoryKernel kernel) {
+    return findKernels(kernel) != nullptr;
+}
+
+bool setSecureMemoryKernel(SecureMemoryKernel kernel) {
+    const Kernels* kernels = findKernels(kernel);
+    if (!kernels) {
+        return false;
+    }
+    activeKernels().store(kernels, std::memory_order_relaxed);
+    return true;
+}
+
+void secureZero(void* data, size_t size) {
+    if (!data || size == 0) {
+        return;
+    }
+    activeKernels().load(std::memory_order_relaxed)->zero(static_cast<uint8_t*>(data), size);
+    // The asm may read the buffer, so the stores are not dead even when the
+    // memory is freed right after
+#ifdef __GNUC__
+    __asm__ __volatile__("" : : "r"(data) : "memory");
+#elif defined(_MSC_VER)
+    _ReadWriteBarrier();
+#endif
+}
+
+bool constantTimeEqual(const void* a, const void* b, size_t size) {
+    uint32_t diff = activeKernels().load(std::memory_order_relaxed)->diff(
+        static_cast<const uint8_t*>(a), static_cast<const uint8_t*>(b), size);
+    // (diff - 1) borrows into bit 63 only when diff is zero: no branch on the data
+    return ((static_cast<uint64_t>(diff) - 1) >> 63) != 0;
+}
+
+} // namespace phantomvault
@@ -0,0 +1,441 @@
+/**
+ * PhantomVault Secure Wipe Engine Implementation
+ */
+
+#include "secure_wipe_engine.hpp"
+#include "performance_monitor.hpp"
+#include "instrumentation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef PLATFORM_LINUX
+#include <linux/falloc.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sysmacros.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace phantomvault {
+
+namespace {
+
+constexpr size_t kMaxWipeThreads = 8;
+
+/**
+ * AES-256-CTR keystream under a throwaway random key: as unpredictable as
+ * the system RNG but generated at memory bandwidth
+ */
+class KeystreamGenerator {
+public:
+    KeystreamGenerator() : ctx_(EVP_CIPHER_CTX_new()) {
+        unsigned char key[32];
+        unsigned char iv[16];
+        ok_ = ctx_ != nullptr &&
+              RAND_bytes(key, sizeof(key)) == 1 &&
+              RAND_bytes(iv, sizeof(iv)) == 1 &&
+              EVP_EncryptInit_ex(ctx_, EVP_aes_256_ctr(), nullptr, key, iv) == 1;
+        OPENSSL_cleanse(key, sizeof(key));
+        OPENSSL_cleanse(iv, sizeof(iv));
+    }
+
+    ~KeystreamGenerator() {
+        if (ctx_) {
+            EVP_CIPHER_CTX_free(ctx_);
+        }
+    }
+
+    KeystreamGenerator(const KeystreamGenerator&) = delete;
+    KeystreamGenerator& operator=(const KeystreamGenerator&) = delete;
+
+    bool fill(uint8_t* buffer, size_t length) {
+        if (!ok_) {
+            return false;
+        }
+        std::memset(buffer, 0, length);
+        int produced = 0;
+        return EVP_EncryptUpdate(ctx_, buffer, &produced, buffer, static_cast<int>(length)) == 1 &&
+               static_cast<size_t>(produced) == length;
+    }
+
+private:
+    EVP_CIPHER_CTX* ctx_;
+    bool ok_ = false;
+};
+
+} // namespace
+
+class SecureWipeEngine::Implementation {
+public:
+    explicit Implementation(const WipeConfig& config)
+        : config_(config)
+        , limiter_(std::make_unique<ResourceLimiter>())
+    {
+        limiter_->setIOLimit(config_.ioLimitBytesPerSecond);
+    }
+
+    void setConfig(const WipeConfig& config) {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        config_ = config;
+        limiter_->setIOLimit(config_.ioLimitBytesPerSecond);
+    }
+
+    WipeConfig getConfig() const {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        return config_;
+    }
+
+    void setIOLimit(size_t maxBytesPerSecond) {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        config_.ioLimitBytesPerSecond = maxBytesPerSecond;
+        limiter_->setIOLimit(maxBytesPerSecond);
+    }
+
+    WipeResult wipeFiles(const std::vector<std::string>& paths) {
+        auto start = std::chrono::steady_clock::now();
+        WipeConfig config = getConfig();
+        WipeResult result;
+
+        size_t threads = config.threads > 0 ? config.threads
+                                            : std::max<size_t>(1, std::thread::hardware_concurrency());
+        threads = std::min({threads, kMaxWipeThreads, std::max<size_t>(1, paths.size())});
+
+        std::atomic<size_t> next{0};
+        std::mutex result_mutex;
+        auto worker = [&]() {
+            KeystreamGenerator keystream;
+            std::vector<uint8_t> buffer(std::max<size_t>(config.blockSize, 4096));
+            WipeResult local;
+
+            for (size_t i = next++; i < paths.size(); i = next++) {
+                ScopedSpan span(Operation::WIPE);
+                if (wipeOne(paths[i], config, keystream, buffer, local)) {
+                    local.filesWiped++;
+                    if (config.removeAfterWipe) {
+                        std::error_code ec;
+                        fs::remove(paths[i], ec);
+                    }
+                } else {
+                    local.filesFailed++;
+                    local.failedPaths.push_back(paths[i]);
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(result_mutex);
+            result.filesWiped += local.filesWiped;
+            result.filesFailed += local.filesFailed;
+            result.bytesOverwritten += local.bytesOverwritten;
+            result.bytesDiscarded += local.bytesDiscarded;
+            result.failedPaths.insert(result.failedPaths.end(), local.failedPaths.begin(), local.failedPaths.end());
+        };
+
+        if (threads == 1) {
+            worker();
+        } else {
+            std::vector<std::thread> pool;
+            pool.reserve(threads);
+            for (size_t i = 0; i < threads; ++i) {
+                pool.emplace_back(worker);
+            }
+            for (auto& thread : pool) {
+                thread.join();
+            }
+        }
+
+        result.success = result.filesFailed == 0;
+        result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+        return result;
+    }
+
+    WipeResult wipeDirectory(const std::string& path) {
+        std::vector<std::string> files;
+        try {
+            for (const auto& entry : fs::recursive_directory_iterator(path)) {
+                // Never follow links out of the tree being wiped
+                if (entry.is_regular_file() && !entry.is_symlink()) {
+                    files.push_back(entry.path().string());
+                }
+            }
+        } catch (const std::exception& e) {
+            setError("Failed to enumerate " + path + ": " + e.what());
+            WipeResult result;
+            result.failedPaths.push_back(path);
+            result.filesFailed = 1;
+            return result;
+        }
+        return wipeFiles(files);
+    }
+
+    StorageInfo probeStorage(const std::string& path) const {
+#ifdef PLATFORM_LINUX
+        struct stat st;
+        if (::stat(path.c_str(), &st) != 0) {
+            return StorageInfo{};
+        }
+        return probeDevice(S_ISBLK(st.st_mode) ? st.st_rdev : st.st_dev);
+#else
+        (void)path;
+        return StorageInfo{};
+#endif
+    }
+
+    std::string getLastError() const {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        return last_error_;
+    }
+
+private:
+    WipeConfig config_;
+    mutable std::mutex config_mutex_;
+    std::unique_ptr<ResourceLimiter> limiter_;
+    mutable std::mutex storage_mutex_;
+    mutable std::map<uint64_t, StorageInfo> storage_cache_;
+    mutable std::mutex error_mutex_;
+    std::string last_error_;
+
+    void setError(const std::string& error) {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        last_error_ = error;
+    }
+
+    void throttle(size_t bytes) {
+        limiter_->recordIO(bytes);
+        limiter_->enforceIOLimit();
+    }
+
+#ifdef PLATFORM_LINUX
+    static bool readSysfsFlag(const fs::path& path, bool& value) {
+        std::ifstream file(path);
+        uint64_t number = 0;
+        if (!(file >> number)) {
+            return false;
+        }
+        value = number != 0;
+        return true;
+    }
+
+    StorageInfo probeDevice(dev_t device) const {
+        std::lock_guard<std::mutex> lock(storage_mutex_);
+        auto cached = storage_cache_.find(device);
+        if (cached != storage_cache_.end()) {
+            return cached->second;
+        }
+
+        // Partitions have no queue directory of their own; it lives on the parent disk
+        StorageInfo info;
+        fs::path node = "/sys/dev/block/" + std::to_string(major(device)) + ":" + std::to_string(minor(device));
+        for (const fs::path& queue : {node / "queue", node / ".." / "queue"}) {
+            bool rotational = true;
+            if (readSysfsFlag(queue / "rotational", rotational)) {
+                info.rotational = rotational;
+                bool discard = false;
+                info.supportsDiscard = readSysfsFlag(queue / "discard_max_bytes", discard) && discard;
+                break;
+            }
+        }
+
+        storage_cache_[device] = info;
+        return info;
+    }
+#endif
+
+    static int passesFor(WipePolicy policy, const StorageInfo& storage) {
+        switch (policy) {
+            case WipePolicy::SINGLE_PASS:
+                return 1;
+            case WipePolicy::THREE_PASS:
+                return 3;
+            case WipePolicy::DISCARD_ONLY:
+                return 0;
+            case WipePolicy::AUTO:
+            default:
+                return storage.rotational ? 3 : 1;
+        }
+    }
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    bool wipeOne(const std::string& path, const WipeConfig& config, KeystreamGenerator& keystream,
+                 std::vector<uint8_t>& buffer, WipeResult& result) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC | O_NOFOLLOW);
+        if (fd < 0) {
+            setError("Failed to open " + path + ": " + std::strerror(errno));
+            return false;
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            setError("Failed to stat " + path);
+            return false;
+        }
+
+        uint64_t size = static_cast<uint64_t>(st.st_size);
+        StorageInfo storage;
+        bool block_device = false;
+#ifdef PLATFORM_LINUX
+        block_device = S_ISBLK(st.st_mode);
+        if (block_device && ::ioctl(fd, BLKGETSIZE64, &size) != 0) {
+            ::close(fd);
+            setError("Failed to size block device " + path);
+            return false;
+        }
+        storage = probeDevice(block_device ? st.st_rdev : st.st_dev);
+#endif
+
+        bool discard = config.policy == WipePolicy::DISCARD_ONLY ||
+                       (config.policy == WipePolicy::AUTO && !storage.rotational);
+        int passes = passesFor(config.policy, storage);
+
+        bool ok = true;
+        bool discarded = false;
+        if (config.policy == WipePolicy::DISCARD_ONLY) {
+            discarded = discardRange(fd, size, block_device);
+            if (!discarded) {
+                // Nothing was released; fall back to overwriting once
+                passes = 1;
+            }
+        }
+
+        for (int pass = 0; ok && pass < passes; ++pass) {
+            uint64_t offset = 0;
+            while (ok && offset < size) {
+                size_t chunk = static_cast<size_t>(std::min<uint64_t>(buffer.size(), size - offset));
+                if (!keystream.fill(buffer.data(), chunk)) {
+                    setError("Failed to generate wipe keystream");
+                    ok = false;
+                    break;
+                }
+                size_t written = 0;
+                while (written < chunk) {
+                    ssize_t n = ::pwrite(fd, buffer.data() + written, chunk - written,
+                                         static_cast<off_t>(offset + written));
+                    if (n < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (n <= 0) {
+                        setError("Failed to overwrite " + path + ": " + std::strerror(errno));
+                        ok = false;
+                        break;
+                    }
+                    written += static_cast<size_t>(n);
+                }
+                offset += written;
+                result.bytesOverwritten += written;
+                throttle(written);
+            }
+            // Each pass must reach the device, not just replace the previous one in the page cache
+#ifdef PLATFORM_LINUX
+            ok = ok && ::fdatasync(fd) == 0;
+#else
+            ok = ok && ::fsync(fd) == 0;
+#endif
+        }
+
+        if (ok && discard && !discarded && size > 0) {
+            discarded = discardRange(fd, size, block_device);
+        }
+        if (discarded) {
+            result.bytesDiscarded += size;
+        }
+
+        ::close(fd);
+        std::memset(buffer.data(), 0, buffer.size());
+        return ok;
+    }
+
+    static bool discardRange(int fd, uint64_t size, bool block_device) {
+#ifdef PLATFORM_LINUX
+        if (size == 0) {
+            return true;
+        }
+        if (block_device) {
+            uint64_t range[2] = {0, size};
+            return ::ioctl(fd, BLKDISCARD, &range) == 0;
+        }
+        return ::fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size)) == 0;
+#else
+        (void)fd;
+        (void)size;
+        (void)block_device;
+        return false;
+#endif
+    }
+#else
+    bool wipeOne(const std::string& path, const WipeConfig& config, KeystreamGenerator& keystream,
+                 std::vector<uint8_t>& buffer, WipeResult& result) {
+        std::error_code ec;
+        uint64_t size = fs::file_size(path, ec);
+        if (ec) {
+            setError("Failed to stat " + path + ": " + ec.message());
+            return false;
+        }
+
+        // Opened read/write so the existing clusters are overwritten rather than truncated away
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!file) {
+            setError("Failed to open " + path);
+            return false;
+        }
+
+        int passes = std::max(1, passesFor(config.policy, StorageInfo{}));
+        for (int pass = 0; pass < passes; ++pass) {
+            file.seekp(0);
+            uint64_t offset = 0;
+            while (offset < size) {
+                size_t chunk = static_cast<size_t>(std::min<uint64_t>(buffer.size(), size - offset));
+                if (!keystream.fill(buffer.data(), chunk) ||
+                    !file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(chunk))) {
+                    setError("Failed to overwrite " + path);
+                    return false;
+                }
+                offset += chunk;
+                result.bytesOverwritten += chunk;
+                throttle(chunk);
+            }
+            file.flush();
+        }
+        std::memset(buffer.data(), 0, buffer.size());
+        return true;
+    }
+#endif
+};
+
+SecureWipeEngine::SecureWipeEngine() : pimpl(std::make_unique<Implementation>(WipeConfig{})) {}
+SecureWipeEngine::SecureWipeEngine(const WipeConfig& config) : pimpl(std::make_unique<Implementation>(config)) {}
+SecureWipeEngine::~SecureWipeEngine() = default;
+
+void SecureWipeEngine::setConfig(const WipeConfig& config) { pimpl->setConfig(config); }
+WipeConfig SecureWipeEngine::getConfig() const { return pimpl->getConfig(); }
+void SecureWipeEngine::setIOLimit(size_t maxBytesPerSecond) { pimpl->setIOLimit(maxBytesPerSecond); }
+
+WipeResult SecureWipeEngine::wipeFile(const std::string& path) { return pimpl->wipeFiles({path}); }
+WipeResult SecureWipeEngine::wipeFiles(const std::vector<std::string>& paths) { return pimpl->wipeFiles(paths); }
+WipeResult SecureWipeEngine::wipeDirectory(const std::string& path) { return pimpl->wipeDirectory(path); }
+
+SecureWipeEngine::StorageInfo SecureWipeEngine::probeStorage(const std::string& path) const {
+    return pimpl->probeStorage(path);
+}
+
+std::string SecureWipeEngine::getLastError() const { return pimpl->getLastError(); }
+
+} // namespace phantomvault
@@ -0,0 +1,177 @@
+/**
+ * PhantomVault Security Event Store Implementation
+ */
+
+#include "security_event_store.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace phantomvault {
+
+void SecurityEventStore::append(const std::vector<SecurityEvent>& events) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    for (const auto& event : events) {
+        if (chunks_.empty() || chunks_.back()->events.size() == kChunkCapacity) {
+            auto chunk = std::make_shared<Chunk>();
+            chunk->baseSequence = next_sequence_;
+            chunk->events.reserve(kChunkCapacity);
+            if (!chunks_.empty()) {
+                chunk->maxTimestampSoFar = chunks_.back()->maxTimestampSoFar;
+            }
+            chunks_.push_back(std::move(chunk));
+        }
+
+        uint64_t sequence = next_sequence_++;
+        Chunk& chunk = *chunks_.back();
+        chunk.events.push_back(event);
+        chunk.maxTimestamp = std::max(chunk.maxTimestamp, event.timestamp);
+        chunk.maxTimestampSoFar = std::max(chunk.maxTimestampSoFar, event.timestamp);
+
+        size_t typeIndex = static_cast<size_t>(event.type);
+        if (typeIndex < kEventTypeCount) {
+            type_index_[typeIndex].push_back(sequence);
+            profile_index_[event.profileId][typeIndex].push_back(sequence);
+            type_counts_[typeIndex]++;
+        }
+        size_++;
+    }
+}
+
+std::vector<SecurityEvent> SecurityEventStore::query(const std::string& profileId, SecurityEventType type,
+                                                     std::chrono::system_clock::time_point since,
+                                                     size_t maxResults) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    std::vector<SecurityEvent> results;
+    size_t typeIndex = static_cast<size_t>(type);
+    if (typeIndex >= kEventTypeCount) {
+        return results;
+    }
+
+    const SequenceIndex* index = &type_index_[typeIndex];
+    if (!profileId.empty()) {
+        auto it = profile_index_.find(profileId);
+        if (it == profile_index_.end()) {
+            return results;
+        }
+        index = &it->second[typeIndex];
+    }
+
+    // Sequences are in arrival order, which only roughly follows timestamps:
+    // filter each event, and stop once no earlier chunk can reach the range
+    for (auto it = index->rbegin(); it != index->rend() && results.size() < maxResults; ++it) {
+        if (chunkAt(*it).maxTimestampSoFar < since) {
+            break;
+        }
+        const SecurityEvent& event = eventAt(*it);
+        if (event.timestamp >= since) {
+            results.push_back(event);
+        }
+    }
+
+    std::reverse(results.begin(), results.end());
+    std::stable_sort(results.begin(), results.end(),
+        [](const SecurityEvent& a, const SecurityEvent& b) { return a.timestamp < b.timestamp; });
+    return results;
+}
+
+size_t SecurityEventStore::count(SecurityEventType type) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    size_t typeIndex = static_cast<size_t>(type);
+    return typeIndex < kEventTypeCount ? type_counts_[typeIndex] : 0;
+}
+
+std::map<SecurityEventType, size_t> SecurityEventStore::statistics() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::map<SecurityEventType, size_t> stats;
+    for (size_t i = 0; i < kEventTypeCount; ++i) {
+        if (type_counts_[i] > 0) {
+            stats[static_cast<SecurityEventType>(i)] = type_counts_[i];
+        }
+    }
+    return stats;
+}
+
+size_t SecurityEventStore::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return size_;
+}
+
+SecurityEventStore::Snapshot SecurityEventStore::snapshot() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    Snapshot snap;
+    snap.chunks_.assign(chunks_.begin(), chunks_.end());
+    snap.last_count_ = chunks_.empty() ? 0 : chunks_.back()->events.size();
+    snap.total_ = size_;
+    return snap;
+}
+
+size_t SecurityEventStore::pruneOlderThan(std::chrono::system_clock::time_point cutoff) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    size_t removed = 0;
+    while (!chunks_.empty()) {
+        const auto& chunk = chunks_.front();
+        if (chunk->events.empty() || chunk->maxTimestamp >= cutoff) {
+            break;
+        }
+        for (const auto& event : chunk->events) {
+            size_t typeIndex = static_cast<size_t>(event.type);
+            if (typeIndex < kEventTypeCount) {
+                type_counts_[typeIndex]--;
+            }
+        }
+        removed += chunk->events.size();
+        size_ -= chunk->events.size();
+        chunks_.pop_front();
+    }
+
+    if (removed > 0) {
+        trimIndexes(chunks_.empty() ? next_sequence_ : chunks_.front()->baseSequence);
+    }
+    return removed;
+}
+
+void SecurityEventStore::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    chunks_.clear();
+    for (auto& index : type_index_) {
+        index.clear();
+    }
+    profile_index_.clear();
+    type_counts_.fill(0);
+    size_ = 0;
+}
+
+const SecurityEventStore::Chunk& SecurityEventStore::chunkAt(uint64_t sequence) const {
+    uint64_t offset = sequence - chunks_.front()->baseSequence;
+    return *chunks_[offset / kChunkCapacity];
+}
+
+const SecurityEvent& SecurityEventStore::eventAt(uint64_t sequence) const {
+    return chunkAt(sequence).events[(sequence - chunks_.front()->baseSequence) % kChunkCapacity];
+}
+
+void SecurityEventStore::trimIndexes(uint64_t firstLiveSequence) {
+    auto trim = [firstLiveSequence](SequenceIndex& index) {
+        while (!index.empty() && index.front() < firstLiveSequence) {
+            index.pop_front();
+        }
+    };
+
+    for (auto& index : type_index_) {
+        trim(index);
+    }
+    for (auto it = profile_index_.begin(); it != profile_index_.end();) {
+        bool empty = true;
+        for (auto& index : it->second) {
+            trim(index);
+            empty = empty && index.empty();
+        }
+        it = empty ? profile_index_.erase(it) : std::next(it);
+    }
+}
+
+} // namespace phantomvault
@@ -0,0 +1,461 @@
+/**
+ * PhantomVault Segment Store Implementation
+ */
+
+#include "segment_store.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace phantomvault {
+
+namespace {
+
+constexpr char kIndexMagic[8] = {'P', 'V', 'S', 'E', 'G', 'I', 'X', '2'};
+constexpr char kIndexMagicV1[8] = {'P', 'V', 'S', 'E', 'G', 'I', 'X', '1'};   // no generation field
+constexpr const char* kIndexName = "objects.idx";
+constexpr size_t kWriteBufferSize = 1024 * 1024;
+
+std::string segmentName(uint32_t segment) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "segment_%05u.pack", segment);
+    return name;
+}
+
+// FNV-1a over the serialized index, stored as its trailer
+uint64_t checksum(const std::string& data) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+void putValue(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool getValue(const std::string& in, size_t& pos, T& value) {
+    if (pos + sizeof(value) > in.size()) {
+        return false;
+    }
+    std::memcpy(&value, in.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) {
+        return false;
+    }
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    return ::fsync(fileno(file)) == 0;
+#else
+    return true;
+#endif
+}
+
+} // namespace
+
+class SegmentStore::Implementation {
+public:
+    explicit Implementation(const Config& config) : config_(config) {}
+
+    ~Implementation() {
+        close();
+    }
+
+    bool create(const std::string& directory) {
+        close();
+        try {
+            fs::create_directories(directory);
+            for (const auto& entry : fs::directory_iterator(directory)) {
+                std::string name = entry.path().filename().string();
+                if (name == kIndexName || (name.rfind("segment_", 0) == 0 && entry.path().extension() == ".pack")) {
+                    fs::remove(entry.path());
+                }
+            }
+            directory_ = directory;
+            generation_ = newGeneration();
+            writable_ = true;
+            return true;
+        } catch (const std::exception& e) {
+            last_error_ = "Failed to create segment store: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    bool open(const std::string& directory) {
+        close();
+        std::string index;
+        {
+            std::ifstream file(directory + "/" + kIndexName, std::ios::binary);
+            if (!file) {
+                last_error_ = "Segment index not found in " + directory;
+                return false;
+            }
+            index.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        bool versioned = index.size() >= sizeof(kIndexMagic) + sizeof(uint64_t) &&
+                         std::memcmp(index.data(), kIndexMagic, sizeof(kIndexMagic)) == 0;
+        if (!versioned && (index.size() < sizeof(kIndexMagicV1) + sizeof(uint64_t) ||
+                           std::memcmp(index.data(), kIndexMagicV1, sizeof(kIndexMagicV1)) != 0)) {
+            last_error_ = "Segment index is not a PhantomVault index";
+            return false;
+        }
+        uint64_t stored = 0;
+        std::memcpy(&stored, index.data() + index.size() - sizeof(stored), sizeof(stored));
+        index.resize(index.size() - sizeof(stored));
+        if (checksum(index) != stored) {
+            last_error_ = "Segment index checksum mismatch";
+            return false;
+        }
+
+        size_t pos = sizeof(kIndexMagic);
+        uint64_t generation = 0;
+        uint32_t objectCount = 0;
+        uint32_t segmentCount = 0;
+        if ((versioned && !getValue(index, pos, generation)) ||
+            !getValue(index, pos, objectCount) || !getValue(index, pos, segmentCount)) {
+            last_error_ = "Segment index is truncated";
+            return false;
+        }
+
+        std::vector<uint64_t> segmentSizes(segmentCount, 0);
+        for (uint32_t i = 0; i < segmentCount; ++i) {
+            std::error_code ec;
+            segmentSizes[i] = fs::file_size(directory + "/" + segmentName(i), ec);
+            if (ec) {
+                last_error_ = "Missing segment " + segmentName(i);
+                return false;
+            }
+        }
+
+        objects_.reserve(objectCount);
+        lookup_.reserve(objectCount);
+        for (uint32_t i = 0; i < objectCount; ++i) {
+            ObjectLocation location;
+            uint32_t idLength = 0;
+            if (!getValue(index, pos, location.segment) || !getValue(index, pos, location.offset) ||
+                !getValue(index, pos, location.length) || !getValue(index, pos, idLength) ||
+                pos + idLength > index.size()) {
+                last_error_ = "Segment index is truncated";
+                objects_.clear();
+                lookup_.clear();
+                return false;
+            }
+            if (location.segment >= segmentCount ||
+                location.offset + location.length > segmentSizes[location.segment]) {
+                last_error_ = "Segment index points past the end of " + segmentName(location.segment);
+                objects_.clear();
+                lookup_.clear();
+                return false;
+            }
+            std::string id(index.data() + pos, idLength);
+            pos += idLength;
+            lookup_[id] = objects_.size();
+            objects_.emplace_back(std::move(id), location);
+            stored_bytes_ += location.length;
+        }
+
+        directory_ = directory;
+        generation_ = generation;
+        segment_count_ = segmentCount;
+        readers_.resize(segmentCount);
+        return true;
+    }
+
+    void close() {
+        if (writer_) {
+            std::fclose(writer_);
+            writer_ = nullptr;
+        }
+        std::lock_guard<std::mutex> lock(read_mutex_);
+        readers_.clear();
+        objects_.clear();
+        lookup_.clear();
+        directory_.clear();
+        generation_ = 0;
+        segment_count_ = 0;
+        writer_offset_ = 0;
+        stored_bytes_ = 0;
+        writable_ = false;
+    }
+
+    bool accepts(size_t size) const {
+        return size <= config_.maxObjectSize;
+    }
+
+    bool append(const std::string& objectId, const std::string& data) {
+        if (!writable_) {
+            last_error_ = "Segment store is not open for writing";
+            return false;
+        }
+        if (!writer_ || writer_offset_ >= config_.segmentSize) {
+            if (!rollSegment()) {
+                return false;
+            }
+        }
+        if (std::fwrite(data.data(), 1, data.size(), writer_) != data.size()) {
+            last_error_ = "Failed to write to " + segmentName(segment_count_ - 1);
+            return false;
+        }
+
+        ObjectLocation location;
+        location.segment = segment_count_ - 1;
+        location.offset = writer_offset_;
+        location.length = data.size();
+        writer_offset_ += data.size();
+        stored_bytes_ += data.size();
+
+        // A re-appended id supersedes the earlier copy, whose bytes are simply left unreferenced
+        auto it = lookup_.find(objectId);
+        if (it != lookup_.end()) {
+            stored_bytes_ -= objects_[it->second].second.length;
+            objects_[it->second].second = location;
+        } else {
+            lookup_[objectId] = objects_.size();
+            objects_.emplace_back(objectId, location);
+        }
+        return true;
+    }
+
+    bool resume(const std::string& directory) {
+        if (!fs::is_regular_file(directory + "/" + kIndexName)) {
+            return create(directory);
+        }
+        if (!open(directory)) {
+            return false;
+        }
+        // Appends go to a fresh segment; bytes past the last checkpoint are never referenced
+        writable_ = true;
+        return true;
+    }
+
+    bool checkpoint() {
+        if (!writable_) {
+            last_error_ = "Segment store is not open for writing";
+            return false;
+        }
+        if (writer_ && !syncFile(writer_)) {
+            last_error_ = "Failed to sync " + segmentName(segment_count_ - 1);
+            return false;
+        }
+        return publishIndex();
+    }
+
+    bool commit() {
+        if (!writable_) {
+            last_error_ = "Segment store is not open for writing";
+            return false;
+        }
+        if (writer_) {
+            bool synced = syncFile(writer_);
+            std::fclose(writer_);
+            writer_ = nullptr;
+            if (!synced) {
+                last_error_ = "Failed to sync " + segmentName(segment_count_ - 1);
+                return false;
+            }
+        }
+        if (!publishIndex()) {
+            return false;
+        }
+
+        writable_ = false;
+        readers_.resize(segment_count_);
+        return true;
+    }
+
+    bool publishIndex() {
+        std::string index(kIndexMagic, sizeof(kIndexMagic));
+        putValue(index, generation_);
+        putValue(index, static_cast<uint32_t>(objects_.size()));
+        putValue(index, segment_count_);
+        for (const auto& object : objects_) {
+            putValue(index, object.second.segment);
+            putValue(index, object.second.offset);
+            putValue(index, object.second.length);
+            putValue(index, static_cast<uint32_t>(object.first.size()));
+            index.append(object.first);
+        }
+        putValue(index, checksum(index));
+
+        std::string indexPath = directory_ + "/" + kIndexName;
+        std::string tempPath = indexPath + ".tmp";
+        std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+        if (!file) {
+            last_error_ = "Failed to create segment index";
+            return false;
+        }
+        bool written = std::fwrite(index.data(), 1, index.size(), file) == index.size() && syncFile(file);
+        std::fclose(file);
+        if (!written) {
+            last_error_ = "Failed to write segment index";
+            return false;
+        }
+
+        std::error_code ec;
+        fs::permissions(tempPath, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace, ec);
+        fs::rename(tempPath, indexPath, ec);
+        if (ec) {
+            last_error_ = "Failed to publish segment index: " + ec.message();
+            return false;
+        }
+        return true;
+    }
+
+    std::optional<std::string> read(const std::string& objectId) const {
+        auto it = lookup_.find(objectId);
+        if (it == lookup_.end()) {
+            return std::nullopt;
+        }
+        const ObjectLocation& location = objects_[it->second].second;
+
+        std::lock_guard<std::mutex> lock(read_mutex_);
+        if (location.segment >= readers_.size()) {
+            last_error_ = "Object is in a segment that has not been committed";
+            return std::nullopt;
+        }
+        auto& reader = readers_[location.segment];
+        if (!reader) {
+            reader = std::make_unique<std::ifstream>(directory_ + "/" + segmentName(location.segment), std::ios::binary);
+        }
+        if (!*reader) {
+            reader.reset();
+            last_error_ = "Failed to open " + segmentName(location.segment);
+            return std::nullopt;
+        }
+
+        std::string data(location.length, '\0');
+        reader->seekg(static_cast<std::streamoff>(location.offset));
+        if (!reader->read(&data[0], static_cast<std::streamsize>(location.length))) {
+            reader.reset();
+            last_error_ = "Short read from " + segmentName(location.segment);
+            return std::nullopt;
+        }
+        return data;
+    }
+
+    void forEachObject(const std::function<void(const std::string&, const ObjectLocation&)>& callback) const {
+        for (const auto& object : objects_) {
+            callback(object.first, object.second);
+        }
+    }
+
+    size_t getObjectCount() const {
+        return objects_.size();
+    }
+
+    uint64_t getStoredBytes() const {
+        return stored_bytes_;
+    }
+
+    uint64_t getGeneration() const {
+        return generation_;
+    }
+
+    std::string getLastError() const {
+        return last_error_;
+    }
+
+private:
+    Config config_;
+    std::string directory_;
+    bool writable_ = false;
+    uint64_t generation_ = 0;
+    std::FILE* writer_ = nullptr;
+    uint64_t writer_offset_ = 0;
+    uint32_t segment_count_ = 0;
+    uint64_t stored_bytes_ = 0;
+    std::vector<std::pair<std::string, ObjectLocation>> objects_;
+    std::unordered_map<std::string, size_t> lookup_;
+    mutable std::mutex read_mutex_;
+    mutable std::vector<std::unique_ptr<std::ifstream>> readers_;
+    mutable std::string last_error_;
+
+    static uint64_t newGeneration() {
+        std::random_device device;
+        uint64_t generation = 0;
+        while (generation == 0) {
+            generation = (static_cast<uint64_t>(device()) << 32) | device();
+        }
+        return generation;
+    }
+
+    bool rollSegment() {
+        if (writer_) {
+            bool synced = syncFile(writer_);
+            std::fclose(writer_);
+            writer_ = nullptr;
+            if (!synced) {
+                last_error_ = "Failed to sync " + segmentName(segment_count_ - 1);
+                return false;
+            }
+        }
+
+        std::string path = directory_ + "/" + segmentName(segment_count_);
+        writer_ = std::fopen(path.c_str(), "wb");
+        if (!writer_) {
+            last_error_ = "Failed to create " + segmentName(segment_count_);
+            return false;
+        }
+        std::setvbuf(writer_, nullptr, _IOFBF, kWriteBufferSize);
+
+        std::error_code ec;
+        fs::permissions(path, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace, ec);
+        segment_count_++;
+        writer_offset_ = 0;
+        return true;
+    }
+};
+
+SegmentStore::SegmentStore() : pimpl(std::make_unique<Implementation>(Config{})) {}
+SegmentStore::SegmentStore(const Config& config) : pimpl(std::make_unique<Implementation>(config)) {}
+SegmentStore::~SegmentStore() = default;
+
+bool SegmentStore::exists(const std::string& directory) {
+    std::error_code ec;
+    return fs::is_regular_file(directory + "/" + kIndexName, ec);
+}
+
+std::string SegmentStore::segmentPath(const std::string& directory, uint32_t segment) {
+    return directory + "/" + segmentName(segment);
+}
+
+bool SegmentStore::create(const std::string& directory) { return pimpl->create(directory); }
+bool SegmentStore::open(const std::string& directory) { return pimpl->open(directory); }
+void SegmentStore::close() { pimpl->close(); }
+bool SegmentStore::accepts(size_t size) const { return pimpl->accepts(size); }
+bool SegmentStore::append(const std::string& objectId, const std::string& data) { return pimpl->append(objectId, data); }
+bool SegmentStore::resume(const std::string& directory) { return pimpl->resume(directory); }
+bool SegmentStore::checkpoint() { return pimpl->checkpoint(); }
+bool SegmentStore::commit() { return pimpl->commit(); }
+std::optional<std::string> SegmentStore::read(const std::string& objectId) const { return pimpl->read(objectId); }
+
+void SegmentStore::forEachObject(const std::function<void(const std::string&, const ObjectLocation&)>& callback) const {
+    pimpl->forEachObject(callback);
+}
+
+size_t SegmentStore::getObjectCount() const { return pimpl->getObjectCount(); }
+uint64_t SegmentStore::getStoredBytes() const { return pimpl->getStoredBytes(); }
+uint64_t SegmentStore::getGeneration() const { return pimpl->getGeneration(); }
+std::string SegmentStore::getLastError() const { return pimpl->getLastError(); }
+
+} // namespace phantomvault
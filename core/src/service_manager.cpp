@@ -13,6 +13,7 @@
 #include "performance_monitor.hpp"
 #include "memory_manager.hpp"
 #include "privilege_manager.hpp"
+#include "instrumentation.hpp"
 
 #include <iostream>
 #include <memory>
@@ -26,13 +27,16 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
+#include <pwd.h>
 #include <signal.h>
 #elif PLATFORM_WINDOWS
 #include <windows.h>
 #include <psapi.h>
 #elif PLATFORM_MACOS
 #include <mach/mach.h>
+#include <pwd.h>
 #include <signal.h>
+#include <unistd.h>
 #endif
 
 namespace phantomvault {
@@ -54,6 +58,12 @@ public:
 
     ~Implementation() {
         stop();
+        
+        // Nothing scheduled may outlive the components it touches
+        if (protection_monitor_task_) {
+            AdaptiveScheduler::getInstance().cancelTask(protection_monitor_task_);
+        }
+        AdaptiveScheduler::getInstance().setPerformanceMonitor(nullptr);
     }
 
     bool initialize(const std::string& configFile, const std::string& logLevel, int ipcPort) {
@@ -151,8 +161,35 @@ public:
             performance_monitor_->setMemoryLimit(8192); // 8MB limit
             performance_monitor_->setCPULimit(5.0);     // 5% CPU limit
             
+            // Background tasks stretch their intervals on battery or under CPU pressure
+            AdaptiveScheduler::getInstance().setPerformanceMonitor(performance_monitor_.get());
+            ipc_server_->setPerformanceMonitor(performance_monitor_.get());
+            
             std::cout << "[ServiceManager] Performance monitor initialized" << std::endl;
             
+            // kill -USR2 <pid> toggles a Chrome trace of vault operations
+            #if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+            if (!TraceRecorder::installSignalHandler(getTraceDirectory())) {
+                std::cout << "[ServiceManager] Trace signal handler unavailable" << std::endl;
+            }
+            #endif
+            
+            // Kernel-enforced ceilings for the whole service, covering I/O the
+            // vault buckets never see. Needs the cgroup the unit delegates to
+            // us (Delegate=yes); elsewhere only the buckets apply.
+            #ifdef PLATFORM_LINUX
+            resource_limiter_ = std::make_unique<ResourceLimiter>();
+            if (resource_limiter_->attachToCgroup()) {
+                resource_limiter_->setCPULimit(kServiceCPULimitPercent);
+                if (!resource_limiter_->setDeviceIOLimit(getDataDirectory(), kServiceIOLimit, kServiceIOLimit)) {
+                    std::cout << "[ServiceManager] io.max unavailable: " << resource_limiter_->getLastError() << std::endl;
+                }
+                std::cout << "[ServiceManager] Running in cgroup " << resource_limiter_->getCgroupPath() << std::endl;
+            } else {
+                std::cout << "[ServiceManager] cgroup limits unavailable: " << resource_limiter_->getLastError() << std::endl;
+            }
+            #endif
+            
             // Initialize encryption service components
             if (!initializeEncryptionServices()) {
                 last_error_ = "Failed to initialize encryption services";
@@ -498,25 +535,22 @@ public:
             signal(SIGINT, &Implementation::signalHandler);
             signal(SIGHUP, &Implementation::signalHandler);
             
-            // Start protection monitoring thread
-            protection_monitoring_running_ = true;
-            protection_monitor_thread_ = std::thread(&Implementation::protectionMonitoringLoop, this);
+            // Check protection now and every 30 seconds
+            startProtectionMonitoring();
             
             #elif PLATFORM_WINDOWS
             // Set console control handler for Windows
             SetConsoleCtrlHandler(&Implementation::consoleHandler, TRUE);
             
-            // Start protection monitoring thread
-            protection_monitoring_running_ = true;
-            protection_monitor_thread_ = std::thread(&Implementation::protectionMonitoringLoop, this);
+            // Check protection now and every 30 seconds
+            startProtectionMonitoring();
             
             #elif PLATFORM_MACOS
             signal(SIGTERM, &Implementation::signalHandler);
             signal(SIGINT, &Implementation::signalHandler);
             
-            // Start protection monitoring thread
-            protection_monitoring_running_ = true;
-            protection_monitor_thread_ = std::thread(&Implementation::protectionMonitoringLoop, this);
+            // Check protection now and every 30 seconds
+            startProtectionMonitoring();
             #endif
             
             process_protected_ = true;
@@ -534,10 +568,11 @@ public:
             }
             
             // Stop protection monitoring
-            protection_monitoring_running_ = false;
-            if (protection_monitor_thread_.joinable()) {
-                protection_monitor_thread_.join();
+            if (protection_monitor_task_) {
+                AdaptiveScheduler::getInstance().cancelTask(protection_monitor_task_);
+                protection_monitor_task_ = 0;
             }
+            std::cout << "[ServiceManager] Process protection monitoring stopped" << std::endl;
             
             // Disable process protection through PrivilegeManager
             if (privilege_manager_) {
@@ -592,36 +627,49 @@ public:
     }
     #endif
     
-    void protectionMonitoringLoop() {
+    #if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    // Holds the profiles and vaults (ProfileManager and FolderSecurityManager defaults)
+    std::string getDataDirectory() const {
+        const char* home = getenv("HOME");
+        if (!home) {
+            struct passwd* pw = getpwuid(getuid());
+            home = pw ? pw->pw_dir : "/tmp";
+        }
+        return std::string(home) + "/.phantomvault";
+    }
+    
+    std::string getTraceDirectory() const {
+        return getDataDirectory() + "/traces";
+    }
+    #endif
+    
+    void startProtectionMonitoring() {
+        protection_monitor_task_ = AdaptiveScheduler::getInstance().scheduleTask(
+            [this]() { checkProcessProtection(); },
+            std::chrono::seconds(30), std::chrono::milliseconds(0), 1);
         std::cout << "[ServiceManager] Process protection monitoring started" << std::endl;
-        
-        while (protection_monitoring_running_) {
-            try {
-                // Check if process is still protected
-                if (privilege_manager_ && !privilege_manager_->isProcessProtected()) {
-                    std::cout << "[ServiceManager] Process protection lost, attempting to restore..." << std::endl;
-                    
-                    privilege_manager_->enableProcessProtection();
+    }
+    
+    void checkProcessProtection() {
+        try {
+            // Check if process is still protected
+            if (privilege_manager_ && !privilege_manager_->isProcessProtected()) {
+                std::cout << "[ServiceManager] Process protection lost, attempting to restore..." << std::endl;
+                
+                privilege_manager_->enableProcessProtection();
+                
+                if (!privilege_manager_->isProcessProtected()) {
+                    std::cout << "[ServiceManager] Failed to restore process protection" << std::endl;
                     
-                    if (!privilege_manager_->isProcessProtected()) {
-                        std::cout << "[ServiceManager] Failed to restore process protection" << std::endl;
-                        
-                        if (termination_callback_) {
-                            termination_callback_();
-                        }
+                    if (termination_callback_) {
+                        termination_callback_();
                     }
                 }
-                
-                // Sleep for monitoring interval
-                std::this_thread::sleep_for(std::chrono::seconds(30));
-                
-            } catch (const std::exception& e) {
-                last_error_ = "Process protection monitoring error: " + std::string(e.what());
-                std::this_thread::sleep_for(std::chrono::seconds(10));
             }
+            
+        } catch (const std::exception& e) {
+            last_error_ = "Process protection monitoring error: " + std::string(e.what());
         }
-        
-        std::cout << "[ServiceManager] Process protection monitoring stopped" << std::endl;
     }
 
 private:
@@ -634,6 +682,7 @@ private:
     std::unique_ptr<AnalyticsEngine> analytics_engine_;
     std::unique_ptr<IPCServer> ipc_server_;
     std::unique_ptr<PerformanceMonitor> performance_monitor_;
+    std::unique_ptr<ResourceLimiter> resource_limiter_;
     std::unique_ptr<PrivilegeManager> privilege_manager_;
     
     std::string last_error_;
@@ -641,8 +690,12 @@ private:
     // Process protection members
     bool process_protected_;
     std::function<void()> termination_callback_;
-    std::thread protection_monitor_thread_;
-    std::atomic<bool> protection_monitoring_running_{false};
+    AdaptiveScheduler::TaskId protection_monitor_task_{0};
+    
+    // cpu.max / io.max for the service's cgroup: headroom for an unlock the
+    // user is waiting on, while leaving cores and disk bandwidth to the desktop
+    static constexpr double kServiceCPULimitPercent = 200.0;       // two cores
+    static constexpr size_t kServiceIOLimit = 128 * 1024 * 1024;  // 128 MB/s each way
 };
 
 // ServiceManager public interface implementation
@@ -7,6 +7,10 @@
  */
 
 #include "vault_handler.hpp"
+#include "folder_index.hpp"
+#include "performance_monitor.hpp"
+#include "instrumentation.hpp"
+#include "secure_wipe_engine.hpp"
 #include "privilege_manager.hpp"
 #include "error_handler.hpp"
 #include <iostream>
@@ -18,6 +22,13 @@
 #include <chrono>
 #include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <cerrno>
+#include <cstring>
 #include <utime.h>
 #include <nlohmann/json.hpp>
 
@@ -28,6 +39,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/xattr.h>
+#include <fcntl.h>
 #include <utime.h>
 #include <dirent.h>
 #elif PLATFORM_WINDOWS
@@ -42,6 +54,7 @@
 #include <sys/stat.h>
 #include <sys/xattr.h>
 #include <sys/mount.h>
+#include <fcntl.h>
 #endif
 
 using json = nlohmann::json;
@@ -58,8 +71,25 @@ public:
         , last_error_()
         , operation_log_()
         , vault_structures_()
+        , hash_indexing_enabled_(true)
+        , io_limiter_(std::make_unique<ResourceLimiter>())
+        , compaction_io_limit_(kDefaultCompactionIOLimit)
+        , wipe_engine_(std::make_unique<SecureWipeEngine>())
+        , background_running_(false)
+        , background_busy_(false)
     {}
     
+    ~Implementation() {
+        {
+            std::lock_guard<std::mutex> lock(background_mutex_);
+            background_running_ = false;
+        }
+        background_cv_.notify_all();
+        if (background_thread_.joinable()) {
+            background_thread_.join();
+        }
+    }
+    
     bool initialize(const std::string& vault_root_path) {
         try {
             vault_root_path_ = vault_root_path;
@@ -103,6 +133,7 @@ public:
     }
     
     HidingResult hideFolder(const std::string& folder_path, const std::string& vault_id) {
+        TraceSpan span("hide_folder");
         HidingResult result;
         
         try {
@@ -135,31 +166,39 @@ public:
             // Generate completely obfuscated identifier
             std::string obfuscated_id = generateObfuscatedIdentifier(folder_path, vault_id);
             result.obfuscated_identifier = obfuscated_id;
+            result.preserved_metadata.obfuscated_identifier = obfuscated_id;
             
             // Create backup location using obfuscated identifier
             std::string backup_path = getVaultPath(vault_id) + "/hidden_folders/" + obfuscated_id;
             result.backup_location = backup_path;
-            
-            // Create obfuscated mapping for later resolution
-            if (!createObfuscatedMapping(vault_id, folder_path, obfuscated_id)) {
-                result.error_details = "Failed to create obfuscated mapping: " + last_error_;
-                return result;
-            }
-            
-            // Ensure backup directory exists
             fs::create_directories(fs::path(backup_path).parent_path());
             
-            // Platform-specific hiding with elevated privileges
-            if (!performPlatformSpecificHiding(folder_path, backup_path)) {
-                result.error_details = "Platform-specific hiding failed: " + last_error_;
-                return result;
+            // Mapping and metadata commit together as one journal record
+            json record;
+            record["op"] = "hide";
+            record["id"] = obfuscated_id;
+            record["mapping"] = buildMappingRecord(vault_id, folder_path, obfuscated_id);
+            record["metadata"] = metadataToJson(result.preserved_metadata, obfuscated_id, backup_path);
+            
+            {
+                // Held across the rename so a checkpoint never sees the record without its folder
+                std::lock_guard<std::recursive_mutex> lock(journal_mutex_);
+                if (!appendJournalRecord(vault_id, record)) {
+                    result.error_details = "Failed to journal hide operation: " + last_error_;
+                    return result;
+                }
+                
+                if (!performPlatformSpecificHiding(folder_path, backup_path)) {
+                    result.error_details = "Platform-specific hiding failed: " + last_error_;
+                    appendJournalRecord(vault_id, json{{"op", "abort"}, {"id", obfuscated_id}});
+                    return result;
+                }
             }
             
-            // Save metadata to vault
-            if (!saveMetadataToVault(vault_id, result.preserved_metadata, backup_path)) {
-                result.error_details = "Failed to save metadata to vault";
-                return result;
-            }
+            updateFolderIndex(vault_id, obfuscated_id, "", &result.preserved_metadata);
+            
+            // Decoys and the per-folder metadata files are written off the hide path
+            scheduleBackgroundTask(vault_id, obfuscated_id);
             
             result.success = true;
             result.message = "Folder successfully hidden using platform-specific mechanisms";
@@ -175,18 +214,19 @@ public:
     }
     
     RestorationResult restoreFolder(const std::string& vault_id, const std::string& folder_identifier) {
+        TraceSpan span("restore_folder");
         RestorationResult result;
         
         try {
             // Load metadata from vault
-            auto metadata = loadMetadataFromVault(vault_id, folder_identifier);
+            auto metadata = getFolderMetadataFast(vault_id, folder_identifier);
             if (!metadata) {
                 result.error_details = "Failed to load folder metadata from vault";
                 return result;
             }
             
             // Check if original location is available
-            if (fs::exists(metadata->original_path)) {
+            if (fs::exists(metadata->original_path) && !isHidingPlaceholder(metadata->original_path)) {
                 result.error_details = "Original location already exists: " + metadata->original_path;
                 return result;
             }
@@ -198,12 +238,22 @@ public:
                 return result;
             }
             
-            // Platform-specific restoration
-            if (!performPlatformSpecificRestoration(backup_path, metadata->original_path)) {
-                result.error_details = "Platform-specific restoration failed: " + last_error_;
-                return result;
+            {
+                std::lock_guard<std::recursive_mutex> lock(journal_mutex_);
+                
+                // Platform-specific restoration
+                if (!performPlatformSpecificRestoration(backup_path, metadata->original_path)) {
+                    result.error_details = "Platform-specific restoration failed: " + last_error_;
+                    return result;
+                }
+                
+                if (!appendJournalRecord(vault_id, json{{"op", "restore"}, {"id", folder_identifier}})) {
+                    logOperation("RESTORE_WARNING", "Failed to journal restore: " + last_error_);
+                }
             }
             
+            updateFolderIndex(vault_id, folder_identifier, "", nullptr);
+            
             // Restore metadata
             result.metadata_restored = restoreFolderMetadata(metadata->original_path, *metadata);
             
@@ -223,48 +273,60 @@ public:
     }
     
     bool preserveFolderMetadata(const std::string& folder_path, FolderMetadata& metadata) {
+        TraceSpan span("preserve_metadata");
         try {
             metadata.original_path = folder_path;
             
             #ifdef PLATFORM_LINUX
+            // One descriptor for every query, so the path is resolved once
+            int fd = open(folder_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd < 0) {
+                last_error_ = "Failed to open folder for metadata capture: " + std::string(strerror(errno));
+                return false;
+            }
+            
+            #ifdef STATX_BTIME
+            struct statx stx;
+            if (statx(fd, "", AT_EMPTY_PATH, STATX_BASIC_STATS | STATX_BTIME, &stx) != 0) {
+                last_error_ = "Failed to get folder stats";
+                close(fd);
+                return false;
+            }
+            uid_t uid = stx.stx_uid;
+            gid_t gid = stx.stx_gid;
+            metadata.permissions = stx.stx_mode & 0777;
+            
+            // Birth time where the filesystem records it, otherwise the inode change time
+            const auto& created = (stx.stx_mask & STATX_BTIME) ? stx.stx_btime : stx.stx_ctime;
+            metadata.created_time = toTimePoint(created.tv_sec, created.tv_nsec);
+            metadata.modified_time = toTimePoint(stx.stx_mtime.tv_sec, stx.stx_mtime.tv_nsec);
+            metadata.accessed_time = toTimePoint(stx.stx_atime.tv_sec, stx.stx_atime.tv_nsec);
+            #else
             struct stat st;
-            if (stat(folder_path.c_str(), &st) != 0) {
+            if (fstat(fd, &st) != 0) {
                 last_error_ = "Failed to get folder stats";
+                close(fd);
                 return false;
             }
-            
-            // Get owner and group
-            struct passwd* pw = getpwuid(st.st_uid);
-            struct group* gr = getgrgid(st.st_gid);
-            metadata.owner = pw ? pw->pw_name : std::to_string(st.st_uid);
-            metadata.group = gr ? gr->gr_name : std::to_string(st.st_gid);
-            
-            // Get permissions
+            uid_t uid = st.st_uid;
+            gid_t gid = st.st_gid;
             metadata.permissions = st.st_mode & 0777;
+            metadata.created_time = toTimePoint(st.st_ctim.tv_sec, st.st_ctim.tv_nsec);
+            metadata.modified_time = toTimePoint(st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+            metadata.accessed_time = toTimePoint(st.st_atim.tv_sec, st.st_atim.tv_nsec);
+            #endif
             
-            // Get timestamps
-            metadata.created_time = std::chrono::system_clock::from_time_t(st.st_ctime);
-            metadata.modified_time = std::chrono::system_clock::from_time_t(st.st_mtime);
-            metadata.accessed_time = std::chrono::system_clock::from_time_t(st.st_atime);
+            // Get owner and group
+            metadata.owner = lookupUserName(uid);
+            metadata.group = lookupGroupName(gid);
             
             // Get extended attributes
-            char* attr_list = nullptr;
-            ssize_t attr_size = listxattr(folder_path.c_str(), nullptr, 0);
-            if (attr_size > 0) {
-                attr_list = new char[attr_size];
-                if (listxattr(folder_path.c_str(), attr_list, attr_size) > 0) {
-                    char* attr_name = attr_list;
-                    while (attr_name < attr_list + attr_size) {
-                        char value[1024];
-                        ssize_t value_size = getxattr(folder_path.c_str(), attr_name, value, sizeof(value) - 1);
-                        if (value_size > 0) {
-                            value[value_size] = '\0';
-                            metadata.extended_attributes[attr_name] = value;
-                        }
-                        attr_name += strlen(attr_name) + 1;
-                    }
-                }
-                delete[] attr_list;
+            metadata.extended_attributes.clear();
+            bool attributes_read = readExtendedAttributes(fd, metadata.extended_attributes);
+            close(fd);
+            if (!attributes_read) {
+                last_error_ = "Failed to read extended attributes: " + std::string(strerror(errno));
+                return false;
             }
             
             // Check if folder was hidden (starts with .)
@@ -308,41 +370,35 @@ public:
             CloseHandle(hFile);
             
             #elif PLATFORM_MACOS
+            int fd = open(folder_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd < 0) {
+                last_error_ = "Failed to open folder for metadata capture: " + std::string(strerror(errno));
+                return false;
+            }
+            
             struct stat st;
-            if (stat(folder_path.c_str(), &st) != 0) {
+            if (fstat(fd, &st) != 0) {
                 last_error_ = "Failed to get folder stats";
+                close(fd);
                 return false;
             }
             
             // Similar to Linux implementation
-            struct passwd* pw = getpwuid(st.st_uid);
-            struct group* gr = getgrgid(st.st_gid);
-            metadata.owner = pw ? pw->pw_name : std::to_string(st.st_uid);
-            metadata.group = gr ? gr->gr_name : std::to_string(st.st_gid);
+            metadata.owner = lookupUserName(st.st_uid);
+            metadata.group = lookupGroupName(st.st_gid);
             metadata.permissions = st.st_mode & 0777;
             
-            metadata.created_time = std::chrono::system_clock::from_time_t(st.st_ctime);
-            metadata.modified_time = std::chrono::system_clock::from_time_t(st.st_mtime);
-            metadata.accessed_time = std::chrono::system_clock::from_time_t(st.st_atime);
+            metadata.created_time = toTimePoint(st.st_birthtimespec.tv_sec, st.st_birthtimespec.tv_nsec);
+            metadata.modified_time = toTimePoint(st.st_mtimespec.tv_sec, st.st_mtimespec.tv_nsec);
+            metadata.accessed_time = toTimePoint(st.st_atimespec.tv_sec, st.st_atimespec.tv_nsec);
             
             // Get extended attributes (macOS specific)
-            char* attr_list = nullptr;
-            ssize_t attr_size = listxattr(folder_path.c_str(), nullptr, 0, 0);
-            if (attr_size > 0) {
-                attr_list = new char[attr_size];
-                if (listxattr(folder_path.c_str(), attr_list, attr_size, 0) > 0) {
-                    char* attr_name = attr_list;
-                    while (attr_name < attr_list + attr_size) {
-                        char value[1024];
-                        ssize_t value_size = getxattr(folder_path.c_str(), attr_name, value, sizeof(value) - 1, 0, 0);
-                        if (value_size > 0) {
-                            value[value_size] = '\0';
-                            metadata.extended_attributes[attr_name] = value;
-                        }
-                        attr_name += strlen(attr_name) + 1;
-                    }
-                }
-                delete[] attr_list;
+            metadata.extended_attributes.clear();
+            bool attributes_read = readExtendedAttributes(fd, metadata.extended_attributes);
+            close(fd);
+            if (!attributes_read) {
+                last_error_ = "Failed to read extended attributes: " + std::string(strerror(errno));
+                return false;
             }
             
             fs::path path(folder_path);
@@ -492,12 +548,16 @@ public:
     }
     
     CleanupResult secureDeleteFromVault(const std::string& vault_id, const std::string& folder_identifier) {
+        TraceSpan span("secure_delete");
         CleanupResult result;
         
         try {
             std::string folder_path = getVaultPath(vault_id) + "/hidden_folders/" + folder_identifier;
             std::string metadata_path = getVaultPath(vault_id) + "/metadata/" + folder_identifier + ".json";
             
+            // A journaled record would otherwise be checkpointed after the delete
+            checkpointMetadataJournal(vault_id);
+            
             size_t folder_size = 0;
             if (fs::exists(folder_path)) {
                 folder_size = calculateDirectorySize(folder_path);
@@ -518,6 +578,7 @@ public:
                 }
                 fs::remove(metadata_path);
             }
+            updateFolderIndex(vault_id, folder_identifier, "", nullptr);
             
             result.success = true;
             result.folders_cleaned = 1;
@@ -533,6 +594,179 @@ public:
         }
     }
     
+    /**
+     * Online mark-and-sweep compaction. Live objects are marked from the vault
+     * metadata; unreferenced payloads, stale metadata, leftover backups and
+     * surplus decoys are reclaimed, and loose mapping files are repacked into
+     * a single pack file. Objects younger than the grace period are skipped so
+     * in-flight hide/lock operations are never collected, and all I/O is
+     * throttled through the resource limiter so this can run while the vault
+     * is in use.
+     */
+    CleanupResult cleanupVault(const std::string& vault_id) {
+        CleanupResult result;
+        auto start = std::chrono::steady_clock::now();
+        
+        try {
+            std::string vault_path = getVaultPath(vault_id);
+            if (vault_id.empty() || !fs::is_directory(vault_path)) {
+                result.error_details = "Vault not found: " + vault_id;
+                last_error_ = result.error_details;
+                return result;
+            }
+            
+            // Mark works from the per-folder files, so fold the journal into them first
+            if (!checkpointMetadataJournal(vault_id)) {
+                logOperation("COMPACT_WARNING", "Metadata journal checkpoint failed: " + last_error_);
+            }
+            
+            io_limiter_->setIOLimit(compaction_io_limit_);
+            auto cutoff = fs::file_time_type::clock::now() - kCompactionGracePeriod;
+            
+            LiveObjects live = markLiveObjects(vault_id);
+            
+            // Metadata whose payload is gone (restored folders, permanent unlocks)
+            for (const auto& identifier : live.stale_hidden_metadata) {
+                std::string metadata_file = vault_path + "/metadata/" + identifier + ".json";
+                if (!isOlderThan(metadata_file, cutoff)) {
+                    continue;
+                }
+                result.bytes_freed += reclaimFile(metadata_file, true);
+                result.bytes_freed += reclaimFile(vault_path + "/mappings/" + identifier + ".map", true);
+                updateFolderIndex(vault_id, identifier, "", nullptr);
+                result.objects_reclaimed++;
+            }
+            for (const auto& location : live.stale_locked_metadata) {
+                std::string metadata_file = vault_path + "/metadata/" + location + ".json";
+                if (isOlderThan(metadata_file, cutoff)) {
+                    result.bytes_freed += reclaimFile(metadata_file, true);
+                    result.objects_reclaimed++;
+                }
+            }
+            
+            // Hidden folders nothing refers to; ones with a mapping are left for recovery
+            std::string hidden_path = vault_path + "/hidden_folders";
+            for (const auto& entry : listDirectory(hidden_path)) {
+                std::string identifier = entry.filename().string();
+                if (live.hidden_ids.count(identifier) || !isOlderThan(entry.string(), cutoff)) {
+                    continue;
+                }
+                if (fs::exists(vault_path + "/mappings/" + identifier + ".map") || live.packed_mappings.count(identifier)) {
+                    logOperation("COMPACT_WARNING", "Unreferenced hidden folder has a mapping, keeping for recovery: " + identifier);
+                    continue;
+                }
+                result.bytes_freed += reclaimTree(entry.string(), true);
+                result.folders_cleaned++;
+                result.objects_reclaimed++;
+            }
+            
+            // Encrypted payloads of folders no longer locked; ciphertext needs no overwrite
+            for (const auto& entry : listDirectory(vault_path + "/folders")) {
+                std::string location = entry.filename().string();
+                if (live.locked_locations.count(location) || !isOlderThan(entry.string(), cutoff)) {
+                    continue;
+                }
+                result.bytes_freed += reclaimTree(entry.string(), false);
+                result.folders_cleaned++;
+                result.objects_reclaimed++;
+            }
+            
+            // Backup copies left behind by partial failures, and abandoned temp files
+            for (const auto& dir : {vault_path, vault_path + "/metadata"}) {
+                for (const auto& entry : listDirectory(dir)) {
+                    if (entry.filename().string().rfind(".backup_", 0) == 0 && isOlderThan(entry.string(), cutoff)) {
+                        result.bytes_freed += reclaimTree(entry.string(), true);
+                        result.objects_reclaimed++;
+                    }
+                }
+            }
+            for (const auto& dir : {vault_path + "/backup", vault_path + "/temp"}) {
+                for (const auto& entry : listDirectory(dir)) {
+                    if (isOlderThan(entry.string(), cutoff)) {
+                        result.bytes_freed += reclaimTree(entry.string(), true);
+                        result.objects_reclaimed++;
+                    }
+                }
+            }
+            
+            // Decoys accumulate on every hide; keep a bounded set
+            auto decoys = listDirectory(vault_path + "/decoys");
+            for (size_t i = kMaxDecoyFolders; i < decoys.size(); ++i) {
+                result.bytes_freed += reclaimTree(decoys[i].string(), false);
+                result.objects_reclaimed++;
+            }
+            
+            result.files_repacked = repackMappings(vault_id, live, cutoff, result);
+            
+            {
+                std::lock_guard<std::mutex> lock(index_mutex_);
+                auto it = folder_indexes_.find(vault_id);
+                if (it != folder_indexes_.end() && it->second->isOpen() && it->second->getDeadBytes() > 0) {
+                    it->second->compact();
+                }
+            }
+            
+            result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+            result.success = true;
+            result.message = "Vault compacted: " + std::to_string(result.objects_reclaimed) + " objects reclaimed, " +
+                             std::to_string(result.bytes_freed) + " bytes freed, " +
+                             std::to_string(result.files_repacked) + " files repacked";
+            
+            logOperation("VAULT_COMPACT", result.message + " in " + std::to_string(result.duration.count()) +
+                         " ms for vault " + vault_id);
+            return result;
+            
+        } catch (const std::exception& e) {
+            result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+            result.error_details = "Failed to compact vault: " + std::string(e.what());
+            last_error_ = result.error_details;
+            logOperation("COMPACT_ERROR", result.error_details);
+            return result;
+        }
+    }
+    
+    void setCompactionIOLimit(size_t max_bytes_per_second) {
+        compaction_io_limit_ = max_bytes_per_second;
+    }
+    
+    void waitForBackgroundTasks() {
+        std::unique_lock<std::mutex> lock(background_mutex_);
+        background_idle_cv_.wait(lock, [this] { return background_tasks_.empty() && !background_busy_; });
+    }
+    
+    bool secureWipeVaultData(const std::string& vault_path) {
+        try {
+            if (!fs::exists(vault_path)) {
+                return true;
+            }
+            
+            WipeResult result = wipe_engine_->wipeDirectory(vault_path);
+            if (!result.success) {
+                last_error_ = "Failed to wipe " + std::to_string(result.filesFailed) + " files: " +
+                              wipe_engine_->getLastError();
+                logOperation("WIPE_ERROR", last_error_);
+                return false;
+            }
+            fs::remove_all(vault_path);
+            
+            logOperation("WIPE_VAULT", "Wiped " + std::to_string(result.filesWiped) + " files (" +
+                         std::to_string(result.bytesOverwritten) + " bytes overwritten, " +
+                         std::to_string(result.bytesDiscarded) + " discarded) in " +
+                         std::to_string(result.duration.count()) + " ms");
+            return true;
+            
+        } catch (const std::exception& e) {
+            last_error_ = "Failed to wipe vault data: " + std::string(e.what());
+            return false;
+        }
+    }
+    
+    void setWipeConfig(const WipeConfig& config) {
+        wipe_engine_->setConfig(config);
+    }
+    
     std::string getLastError() const {
         return last_error_;
     }
@@ -540,6 +774,179 @@ public:
     std::vector<std::string> getOperationLog() const {
         return operation_log_;
     }
+    
+    std::vector<std::string> listVaultFolders(const std::string& vault_id) const {
+        std::vector<std::string> folders;
+        try {
+            if (hash_indexing_enabled_) {
+                std::lock_guard<std::mutex> lock(index_mutex_);
+                if (FolderIndex* index = ensureIndexLocked(vault_id)) {
+                    folders.reserve(index->size());
+                    index->forEachIdentifier([&folders](const std::string& identifier) {
+                        folders.push_back(identifier);
+                    });
+                    return folders;
+                }
+            }
+            
+            std::string hidden_path = getVaultPath(vault_id) + "/hidden_folders";
+            if (fs::exists(hidden_path)) {
+                for (const auto& entry : fs::directory_iterator(hidden_path)) {
+                    if (entry.is_directory()) {
+                        folders.push_back(entry.path().filename().string());
+                    }
+                }
+            }
+        } catch (const std::exception& e) {
+            last_error_ = "Failed to list vault folders: " + std::string(e.what());
+        }
+        return folders;
+    }
+    
+    std::string resolveObfuscatedPath(const std::string& vault_id, const std::string& obfuscated_id) {
+        try {
+            if (hash_indexing_enabled_) {
+                auto metadata = getFolderMetadataFast(vault_id, obfuscated_id);
+                if (metadata && !metadata->original_path.empty()) {
+                    return metadata->original_path;
+                }
+            }
+            
+            std::string mapping_file = getVaultPath(vault_id) + "/mappings/" + obfuscated_id + ".map";
+            std::lock_guard<std::recursive_mutex> lock(journal_mutex_);
+            
+            json mapping_data;
+            if (fs::exists(mapping_file)) {
+                std::ifstream file(mapping_file);
+                file >> mapping_data;
+                file.close();
+            } else {
+                auto packed = loadPackedMappings(vault_id);
+                auto it = packed.find(obfuscated_id);
+                if (it != packed.end()) {
+                    mapping_data = std::move(it->second);
+                } else {
+                    for (const auto& record : readPendingHides(vault_id)) {
+                        if (record["id"] == obfuscated_id) {
+                            mapping_data = record["mapping"];
+                        }
+                    }
+                    if (mapping_data.is_null()) {
+                        last_error_ = "Obfuscated mapping not found: " + obfuscated_id;
+                        return "";
+                    }
+                }
+            }
+            
+            // Generate decryption key
+            std::string key_material = vault_id + obfuscated_id + "mapping_key_salt_2024";
+            std::hash<std::string> hasher;
+            std::string decryption_key = std::to_string(hasher(key_material));
+            
+            // Decrypt and return original path
+            return decryptPathFromStorage(mapping_data["encrypted_path"], decryption_key);
+            
+        } catch (const std::exception& e) {
+            last_error_ = "Failed to resolve obfuscated path: " + std::string(e.what());
+            return "";
+        }
+    }
+    
+    // Hash-based folder index
+    void enableHashBasedIndexing() {
+        hash_indexing_enabled_ = true;
+    }
+    
+    void disableHashBasedIndexing() {
+        hash_indexing_enabled_ = false;
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        folder_indexes_.clear();
+    }
+    
+    bool isHashBasedIndexingEnabled() const {
+        return hash_indexing_enabled_;
+    }
+    
+    void buildFolderIndex(const std::string& vault_id, bool reuse_existing) {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        auto& index = folder_indexes_[vault_id];
+        if (!index) {
+            index = std::make_unique<FolderIndex>();
+        }
+        if (reuse_existing && !index->isOpen()) {
+            index->open(getIndexPath(vault_id));
+        }
+        
+        size_t reused = 0;
+        size_t parsed = 0;
+        if (!rebuildIndexLocked(vault_id, *index, reuse_existing, reused, parsed)) {
+            folder_indexes_.erase(vault_id);
+            logOperation("INDEX_ERROR", "Failed to build folder index for vault " + vault_id + ": " + last_error_);
+            return;
+        }
+        logOperation("INDEX_BUILD", "Indexed " + std::to_string(reused + parsed) + " folders for vault " + vault_id +
+                     " (" + std::to_string(parsed) + " read from metadata)");
+    }
+    
+    std::optional<FolderMetadata> getFolderMetadataFast(const std::string& vault_id, const std::string& folder_identifier) const {
+        if (!hash_indexing_enabled_) {
+            return loadMetadataFromVault(vault_id, folder_identifier);
+        }
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        FolderIndex* index = ensureIndexLocked(vault_id);
+        if (!index) {
+            return loadMetadataFromVault(vault_id, folder_identifier);
+        }
+        return index->lookup(folder_identifier);
+    }
+    
+    bool isFolderIndexed(const std::string& vault_id, const std::string& folder_identifier) const {
+        if (!hash_indexing_enabled_) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        FolderIndex* index = ensureIndexLocked(vault_id);
+        return index && index->contains(folder_identifier);
+    }
+    
+    void invalidateFolderIndex(const std::string& vault_id) {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        folder_indexes_.erase(vault_id);
+        std::error_code ec;
+        fs::remove(getIndexPath(vault_id), ec);
+    }
+    
+    size_t getIndexedFolderCount(const std::string& vault_id) const {
+        if (!hash_indexing_enabled_) {
+            return 0;
+        }
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        FolderIndex* index = ensureIndexLocked(vault_id);
+        return index ? index->size() : 0;
+    }
+    
+    size_t getIndexMemoryUsage() const {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        size_t total = 0;
+        for (const auto& pair : folder_indexes_) {
+            total += sizeof(FolderIndex) + pair.first.capacity() + pair.second->getMappedBytes();
+        }
+        return total;
+    }
+    
+    void compactIndexes() {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        for (auto& pair : folder_indexes_) {
+            if (pair.second->isOpen() && pair.second->getDeadBytes() > 0 && !pair.second->compact()) {
+                logOperation("INDEX_WARNING", "Failed to compact folder index: " + pair.second->getLastError());
+            }
+        }
+    }
+    
+    void optimizeMemoryUsage() {
+        compactIndexes();
+        operation_log_.shrink_to_fit();
+    }
 
 private:
     std::string vault_root_path_;
@@ -548,6 +955,48 @@ private:
     mutable std::string last_error_;
     std::vector<std::string> operation_log_;
     std::unordered_map<std::string, VaultStructure> vault_structures_;
+    bool hash_indexing_enabled_;
+    mutable std::mutex index_mutex_;
+    mutable std::unordered_map<std::string, std::unique_ptr<FolderIndex>> folder_indexes_;
+    std::unique_ptr<ResourceLimiter> io_limiter_;
+    size_t compaction_io_limit_;
+    std::unique_ptr<SecureWipeEngine> wipe_engine_;
+    
+    // Hide/restore journal; recursive because readers nest under index_mutex_ and each other
+    mutable std::recursive_mutex journal_mutex_;
+    mutable std::unordered_map<uint32_t, std::string> user_names_;
+    mutable std::unordered_map<uint32_t, std::string> group_names_;
+    
+    struct BackgroundTask {
+        std::string vault_id;
+        std::string obfuscated_id;
+    };
+    std::mutex background_mutex_;
+    std::condition_variable background_cv_;
+    std::condition_variable background_idle_cv_;
+    std::deque<BackgroundTask> background_tasks_;
+    std::thread background_thread_;
+    bool background_running_;
+    bool background_busy_;
+    
+    static constexpr size_t kDefaultCompactionIOLimit = 32 * 1024 * 1024;  // 32 MB/s
+    static constexpr size_t kMaxDecoyFolders = 24;
+    static constexpr size_t kMinIOCharge = 4096;  // unlink/rename cost charged to the limiter
+    static constexpr std::chrono::minutes kCompactionGracePeriod{10};
+    static constexpr size_t kXattrBufferSize = 4096;  // covers typical names/values in one call
+    
+    /**
+     * Result of the mark phase. Identifiers listed as stale have metadata but
+     * no longer reference a live payload.
+     */
+    struct LiveObjects {
+        std::unordered_set<std::string> hidden_ids;
+        std::unordered_set<std::string> locked_locations;
+        std::vector<std::string> stale_hidden_metadata;
+        std::vector<std::string> stale_locked_metadata;
+        std::unordered_map<std::string, json> packed_mappings;
+    };
+    
     
     std::string getVaultPath(const std::string& vault_id) const {
         return vault_root_path_ + "/" + vault_id;
@@ -626,27 +1075,9 @@ private:
             std::string mapping_dir = getVaultPath(vault_id) + "/mappings";
             fs::create_directories(mapping_dir);
             
-            // Generate encryption key from vault_id and obfuscated_id
-            std::string key_material = vault_id + obfuscated_id + "mapping_key_salt_2024";
-            std::hash<std::string> hasher;
-            std::string encryption_key = std::to_string(hasher(key_material));
-            
-            // Create mapping data
-            json mapping_data;
-            mapping_data["obfuscated_id"] = obfuscated_id;
-            mapping_data["encrypted_path"] = encryptPathForStorage(original_path, encryption_key);
-            mapping_data["created_timestamp"] = std::chrono::duration_cast<std::chrono::seconds>(
-                std::chrono::system_clock::now().time_since_epoch()).count();
-            mapping_data["access_count"] = 0;
-            
             // Save mapping with obfuscated filename
-            std::string mapping_file = mapping_dir + "/" + obfuscated_id + ".map";
-            std::ofstream file(mapping_file);
-            file << mapping_data.dump(4);
-            file.close();
-            
-            // Set restrictive permissions
-            fs::permissions(mapping_file, fs::perms::owner_read | fs::perms::owner_write);
+            json mapping_data = buildMappingRecord(vault_id, original_path, obfuscated_id);
+            writeRecordFile(mapping_dir + "/" + obfuscated_id + ".map", mapping_data.dump(4), false);
             
             return true;
             
@@ -656,32 +1087,20 @@ private:
         }
     }
     
-    std::string resolveObfuscatedPath(const std::string& vault_id, const std::string& obfuscated_id) {
-        try {
-            std::string mapping_file = getVaultPath(vault_id) + "/mappings/" + obfuscated_id + ".map";
-            
-            if (!fs::exists(mapping_file)) {
-                last_error_ = "Obfuscated mapping not found: " + obfuscated_id;
-                return "";
-            }
-            
-            std::ifstream file(mapping_file);
-            json mapping_data;
-            file >> mapping_data;
-            file.close();
-            
-            // Generate decryption key
-            std::string key_material = vault_id + obfuscated_id + "mapping_key_salt_2024";
-            std::hash<std::string> hasher;
-            std::string decryption_key = std::to_string(hasher(key_material));
-            
-            // Decrypt and return original path
-            return decryptPathFromStorage(mapping_data["encrypted_path"], decryption_key);
-            
-        } catch (const std::exception& e) {
-            last_error_ = "Failed to resolve obfuscated path: " + std::string(e.what());
-            return "";
-        }
+    json buildMappingRecord(const std::string& vault_id, const std::string& original_path, const std::string& obfuscated_id) {
+        // Generate encryption key from vault_id and obfuscated_id
+        std::string key_material = vault_id + obfuscated_id + "mapping_key_salt_2024";
+        std::hash<std::string> hasher;
+        std::string encryption_key = std::to_string(hasher(key_material));
+        
+        // Create mapping data
+        json mapping_data;
+        mapping_data["obfuscated_id"] = obfuscated_id;
+        mapping_data["encrypted_path"] = encryptPathForStorage(original_path, encryption_key);
+        mapping_data["created_timestamp"] = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        mapping_data["access_count"] = 0;
+        return mapping_data;
     }
     
     bool eliminatePathTraces(const std::string& original_path) {
@@ -726,31 +1145,11 @@ private:
         (void)obfuscated_id; // Suppress unused parameter warning
         try {
             // Create multiple decoy folders to confuse OSINT analysis
-            std::string decoy_base = getVaultPath(vault_id) + "/decoys";
-            fs::create_directories(decoy_base);
-            
             std::random_device rd;
             std::mt19937 gen(rd());
             std::uniform_int_distribution<int> count_dis(5, 12);  // 5-12 decoy folders
-            std::uniform_int_distribution<int> name_dis(8, 16);   // 8-16 character names
-            
-            int decoy_count = count_dis(gen);
-            
-            for (int i = 0; i < decoy_count; ++i) {
-                // Generate random decoy folder name
-                std::string decoy_name = generateRandomHexString(name_dis(gen));
-                std::string decoy_path = decoy_base + "/" + decoy_name;
-                
-                // Create decoy folder with random content
-                fs::create_directories(decoy_path);
-                
-                // Add random files to make it look legitimate
-                createDecoyFiles(decoy_path);
-                
-                // Set random timestamps to avoid temporal correlation
-                setRandomTimestamps(decoy_path);
-            }
             
+            createDecoyFolders(getVaultPath(vault_id) + "/decoys", count_dis(gen));
             return true;
             
         } catch (const std::exception& e) {
@@ -760,25 +1159,13 @@ private:
     }
     
     bool performPlatformSpecificHiding(const std::string& folder_path, const std::string& backup_path) {
+        TraceSpan span("platform_hide");
         try {
             #ifdef PLATFORM_LINUX
-            // On Linux with elevated privileges, we can:
-            // 1. Move folder to a system-protected location
-            // 2. Create a bind mount to hide the original location
-            // 3. Set special extended attributes
-            
-            // Move folder to backup location
+            // A same-filesystem rename is O(1) regardless of folder size. No
+            // placeholder is left behind: an empty, inaccessible directory at
+            // the original path is itself a trace of the hidden folder.
             fs::rename(folder_path, backup_path);
-            
-            // Create a placeholder directory with restricted access
-            fs::create_directory(folder_path);
-            fs::permissions(folder_path, fs::perms::none, fs::perm_options::replace);
-            
-            // Set extended attribute to mark as PhantomVault hidden
-            if (setxattr(folder_path.c_str(), "user.phantomvault.hidden", "true", 4, 0) != 0) {
-                logOperation("HIDE_WARNING", "Failed to set extended attribute");
-            }
-            
             return true;
             
             #elif PLATFORM_WINDOWS
@@ -808,23 +1195,8 @@ private:
             return true;
             
             #elif PLATFORM_MACOS
-            // On macOS with elevated privileges, we can:
-            // 1. Move folder to secure location
-            // 2. Set special flags and extended attributes
-            // 3. Use chflags for additional protection
-            
-            // Move folder to backup location
+            // Same as Linux: a single rename, no placeholder
             fs::rename(folder_path, backup_path);
-            
-            // Create placeholder with restricted access
-            fs::create_directory(folder_path);
-            fs::permissions(folder_path, fs::perms::none, fs::perm_options::replace);
-            
-            // Set extended attribute
-            if (setxattr(folder_path.c_str(), "com.phantomvault.hidden", "true", 4, 0, 0) != 0) {
-                logOperation("HIDE_WARNING", "Failed to set extended attribute");
-            }
-            
             return true;
             
             #else
@@ -842,9 +1214,9 @@ private:
     bool performPlatformSpecificRestoration(const std::string& backup_path, const std::string& original_path) {
         try {
             #ifdef PLATFORM_LINUX
-            // Remove placeholder if it exists
-            if (fs::exists(original_path)) {
-                fs::remove_all(original_path);
+            // Remove a placeholder left by older versions; never a populated folder
+            if (isHidingPlaceholder(original_path)) {
+                fs::remove(original_path);
             }
             
             // Move folder back from backup
@@ -869,9 +1241,8 @@ private:
             return true;
             
             #elif PLATFORM_MACOS
-            // Remove placeholder if it exists
-            if (fs::exists(original_path)) {
-                fs::remove_all(original_path);
+            if (isHidingPlaceholder(original_path)) {
+                fs::remove(original_path);
             }
             
             // Move folder back from backup
@@ -891,45 +1262,81 @@ private:
         }
     }
     
-    bool saveMetadataToVault(const std::string& vault_id, const FolderMetadata& metadata, const std::string& backup_path) {
-        try {
-            std::string metadata_file = getVaultPath(vault_id) + "/metadata/" + 
-                                      generateFolderIdentifier(metadata.original_path) + ".json";
-            
-            json metadata_json;
-            metadata_json["original_path"] = metadata.original_path;
-            metadata_json["owner"] = metadata.owner;
-            metadata_json["group"] = metadata.group;
-            metadata_json["permissions"] = metadata.permissions;
-            metadata_json["created_time"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-                metadata.created_time.time_since_epoch()).count();
-            metadata_json["modified_time"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-                metadata.modified_time.time_since_epoch()).count();
-            metadata_json["accessed_time"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-                metadata.accessed_time.time_since_epoch()).count();
-            metadata_json["extended_attributes"] = metadata.extended_attributes;
-            metadata_json["was_hidden"] = metadata.was_hidden;
-            metadata_json["backup_path"] = backup_path;
-            
-            std::ofstream file(metadata_file);
-            file << metadata_json.dump(2);
-            file.close();
-            
-            fs::permissions(metadata_file, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace);
-            
-            return true;
-            
-        } catch (const std::exception& e) {
-            last_error_ = "Failed to save metadata to vault: " + std::string(e.what());
-            return false;
+    json metadataToJson(const FolderMetadata& metadata, const std::string& folder_identifier,
+                        const std::string& backup_path) const {
+        json metadata_json;
+        metadata_json["obfuscated_identifier"] = folder_identifier;
+        metadata_json["original_path"] = metadata.original_path;
+        metadata_json["owner"] = metadata.owner;
+        metadata_json["group"] = metadata.group;
+        metadata_json["permissions"] = metadata.permissions;
+        metadata_json["created_time"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+            metadata.created_time.time_since_epoch()).count();
+        metadata_json["modified_time"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+            metadata.modified_time.time_since_epoch()).count();
+        metadata_json["accessed_time"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+            metadata.accessed_time.time_since_epoch()).count();
+        
+        // Attribute values are arbitrary bytes, which JSON strings cannot carry
+        json attributes = json::object();
+        for (const auto& attr : metadata.extended_attributes) {
+            attributes[attr.first] = toHex(attr.second);
         }
+        metadata_json["extended_attributes_hex"] = attributes;
+        metadata_json["was_hidden"] = metadata.was_hidden;
+        metadata_json["backup_path"] = backup_path;
+        return metadata_json;
     }
     
-    std::optional<FolderMetadata> loadMetadataFromVault(const std::string& vault_id, const std::string& folder_identifier) {
+    static FolderMetadata metadataFromJson(const json& metadata_json, const std::string& folder_identifier) {
+        FolderMetadata metadata;
+        metadata.original_path = metadata_json.value("original_path", "");
+        metadata.owner = metadata_json.value("owner", "");
+        metadata.group = metadata_json.value("group", "");
+        metadata.permissions = metadata_json.value("permissions", 0755);
+        
+        auto fromMillis = [&metadata_json](const char* key) {
+            return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::milliseconds(metadata_json[key].get<int64_t>())));
+        };
+        if (metadata_json.contains("created_time")) {
+            metadata.created_time = fromMillis("created_time");
+        }
+        if (metadata_json.contains("modified_time")) {
+            metadata.modified_time = fromMillis("modified_time");
+        }
+        if (metadata_json.contains("accessed_time")) {
+            metadata.accessed_time = fromMillis("accessed_time");
+        }
+        
+        if (metadata_json.contains("extended_attributes_hex")) {
+            for (const auto& attr : metadata_json["extended_attributes_hex"].items()) {
+                metadata.extended_attributes[attr.key()] = fromHex(attr.value().get<std::string>());
+            }
+        } else if (metadata_json.contains("extended_attributes")) {
+            metadata.extended_attributes = metadata_json["extended_attributes"];
+        }
+        
+        metadata.was_hidden = metadata_json.value("was_hidden", false);
+        metadata.obfuscated_identifier = folder_identifier;
+        return metadata;
+    }
+    
+    std::optional<FolderMetadata> loadMetadataFromVault(const std::string& vault_id, const std::string& folder_identifier) const {
         try {
+            // A checkpoint must not move the record between the two lookups
+            std::lock_guard<std::recursive_mutex> lock(journal_mutex_);
             std::string metadata_file = getVaultPath(vault_id) + "/metadata/" + folder_identifier + ".json";
             
             if (!fs::exists(metadata_file)) {
+                // Hidden since the last checkpoint
+                auto pending = readPendingHides(vault_id);
+                auto it = std::find_if(pending.begin(), pending.end(), [&](const json& record) {
+                    return record["id"] == folder_identifier;
+                });
+                if (it != pending.end()) {
+                    return metadataFromJson((*it)["metadata"], folder_identifier);
+                }
                 last_error_ = "Metadata file not found: " + metadata_file;
                 return std::nullopt;
             }
@@ -938,32 +1345,7 @@ private:
             json metadata_json;
             file >> metadata_json;
             
-            FolderMetadata metadata;
-            metadata.original_path = metadata_json.value("original_path", "");
-            metadata.owner = metadata_json.value("owner", "");
-            metadata.group = metadata_json.value("group", "");
-            metadata.permissions = metadata_json.value("permissions", 0755);
-            
-            if (metadata_json.contains("created_time")) {
-                metadata.created_time = std::chrono::system_clock::from_time_t(
-                    metadata_json["created_time"].get<int64_t>() / 1000);
-            }
-            if (metadata_json.contains("modified_time")) {
-                metadata.modified_time = std::chrono::system_clock::from_time_t(
-                    metadata_json["modified_time"].get<int64_t>() / 1000);
-            }
-            if (metadata_json.contains("accessed_time")) {
-                metadata.accessed_time = std::chrono::system_clock::from_time_t(
-                    metadata_json["accessed_time"].get<int64_t>() / 1000);
-            }
-            
-            if (metadata_json.contains("extended_attributes")) {
-                metadata.extended_attributes = metadata_json["extended_attributes"];
-            }
-            
-            metadata.was_hidden = metadata_json.value("was_hidden", false);
-            
-            return metadata;
+            return metadataFromJson(metadata_json, folder_identifier);
             
         } catch (const std::exception& e) {
             last_error_ = "Failed to load metadata from vault: " + std::string(e.what());
@@ -1004,70 +1386,744 @@ private:
         }
     }
     
-    size_t calculateDirectorySize(const std::string& dir_path) {
+    std::string getIndexPath(const std::string& vault_id) const {
+        return getVaultPath(vault_id) + "/metadata/folder_index.pvx";
+    }
+    
+    std::string getGenerationPath(const std::string& vault_id) const {
+        return getVaultPath(vault_id) + "/metadata/index.generation";
+    }
+    
+    uint64_t readGeneration(const std::string& vault_id) const {
+        std::ifstream file(getGenerationPath(vault_id));
+        uint64_t generation = 0;
+        if (file >> generation && generation > 0) {
+            return generation;
+        }
+        return 1;
+    }
+    
+    // Every metadata change bumps the vault generation; an index built for an older one is stale
+    uint64_t bumpGeneration(const std::string& vault_id) {
+        uint64_t generation = readGeneration(vault_id) + 1;
+        std::string path = getGenerationPath(vault_id);
+        {
+            std::ofstream file(path + ".tmp", std::ios::trunc);
+            file << generation;
+        }
+        fs::rename(path + ".tmp", path);
+        return generation;
+    }
+    
+    static FolderIndex::SourceStamp stampFor(const fs::path& path) {
+        FolderIndex::SourceStamp stamp;
+        stamp.modifiedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            fs::last_write_time(path).time_since_epoch()).count();
+        stamp.size = fs::file_size(path);
+        return stamp;
+    }
+    
+    // Caller holds index_mutex_. Opens the persisted index, rebuilding it if missing or stale.
+    FolderIndex* ensureIndexLocked(const std::string& vault_id) const {
+        auto& index = folder_indexes_[vault_id];
+        if (index && index->isOpen()) {
+            return index.get();
+        }
+        if (!index) {
+            index = std::make_unique<FolderIndex>();
+        }
+        
+        if (index->open(getIndexPath(vault_id)) && index->getGeneration() == readGeneration(vault_id)) {
+            return index.get();
+        }
+        
+        size_t reused = 0;
+        size_t parsed = 0;
+        if (!rebuildIndexLocked(vault_id, *index, true, reused, parsed)) {
+            folder_indexes_.erase(vault_id);
+            return nullptr;
+        }
+        return index.get();
+    }
+    
+    /**
+     * Rebuild from the metadata directory. With reuse_existing, records whose
+     * metadata file is unchanged (same mtime and size) are copied from the old
+     * index instead of re-parsing the JSON.
+     */
+    bool rebuildIndexLocked(const std::string& vault_id, FolderIndex& index, bool reuse_existing,
+                            size_t& reused, size_t& parsed) const {
         try {
-            size_t size = 0;
-            for (const auto& entry : fs::recursive_directory_iterator(dir_path)) {
-                if (entry.is_regular_file()) {
-                    size += entry.file_size();
+            std::string metadata_dir = getVaultPath(vault_id) + "/metadata";
+            if (!fs::exists(metadata_dir)) {
+                last_error_ = "Vault metadata directory not found: " + metadata_dir;
+                return false;
+            }
+            
+            bool can_reuse = reuse_existing && index.isOpen();
+            std::vector<FolderIndex::Entry> entries;
+            std::lock_guard<std::recursive_mutex> journal_lock(journal_mutex_);
+            
+            for (const auto& file : fs::directory_iterator(metadata_dir)) {
+                if (!file.is_regular_file() || file.path().extension() != ".json") {
+                    continue;
+                }
+                
+                FolderIndex::Entry entry;
+                entry.identifier = file.path().stem().string();
+                entry.stamp = stampFor(file.path());
+                
+                if (can_reuse) {
+                    auto stamp = index.lookupStamp(entry.identifier);
+                    if (stamp && *stamp == entry.stamp) {
+                        auto metadata = index.lookup(entry.identifier);
+                        if (metadata) {
+                            entry.metadata = std::move(*metadata);
+                            entries.push_back(std::move(entry));
+                            reused++;
+                            continue;
+                        }
+                    }
+                }
+                
+                auto metadata = loadMetadataFromVault(vault_id, entry.identifier);
+                if (metadata) {
+                    entry.metadata = std::move(*metadata);
+                    entries.push_back(std::move(entry));
+                    parsed++;
                 }
             }
-            return size;
+            
+            // Folders hidden since the last checkpoint exist only in the journal
+            for (const auto& record : readPendingHides(vault_id)) {
+                FolderIndex::Entry entry;
+                entry.identifier = record["id"].get<std::string>();
+                if (fs::exists(metadata_dir + "/" + entry.identifier + ".json")) {
+                    continue;
+                }
+                entry.metadata = metadataFromJson(record["metadata"], entry.identifier);
+                entries.push_back(std::move(entry));
+                parsed++;
+            }
+            
+            if (!index.rewrite(getIndexPath(vault_id), entries, readGeneration(vault_id))) {
+                last_error_ = index.getLastError();
+                return false;
+            }
+            return true;
+            
         } catch (const std::exception& e) {
-            return 0;
+            last_error_ = "Failed to rebuild folder index: " + std::string(e.what());
+            return false;
         }
     }
     
-    bool secureWipeDirectory(const std::string& dir_path) {
+    /**
+     * Apply a metadata write (or removal when metadata is null) to the index
+     * in place and advance the generation
+     */
+    void updateFolderIndex(const std::string& vault_id, const std::string& identifier,
+                           const std::string& metadata_file, const FolderMetadata* metadata) {
         try {
-            for (const auto& entry : fs::recursive_directory_iterator(dir_path)) {
-                if (entry.is_regular_file()) {
-                    if (!secureWipeFile(entry.path().string())) {
-                        logOperation("WIPE_WARNING", "Failed to securely wipe file: " + entry.path().string());
-                    }
+            std::lock_guard<std::mutex> lock(index_mutex_);
+            
+            // Resolve against the current generation before advancing it
+            FolderIndex* index = hash_indexing_enabled_ ? ensureIndexLocked(vault_id) : nullptr;
+            uint64_t generation = bumpGeneration(vault_id);
+            if (!index) {
+                return;
+            }
+            
+            // Journaled metadata has no file yet; an empty stamp forces a re-read once it does
+            FolderIndex::SourceStamp stamp = metadata_file.empty() ? FolderIndex::SourceStamp{} : stampFor(metadata_file);
+            bool updated = metadata ? index->put(identifier, *metadata, stamp, generation)
+                                    : index->erase(identifier, generation);
+            if (!updated) {
+                // Left stale on disk; the next lookup rebuilds it
+                folder_indexes_.erase(vault_id);
+            }
+            
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(index_mutex_);
+            folder_indexes_.erase(vault_id);
+        }
+    }
+    
+    LiveObjects markLiveObjects(const std::string& vault_id) {
+        LiveObjects live;
+        std::string vault_path = getVaultPath(vault_id);
+        
+        // Locked folders tracked by ProfileVault; without its metadata every location counts as live
+        std::unordered_set<std::string> locked_folders;
+        bool have_locked_folders = false;
+        std::string vault_metadata_file = vault_path + "/vault_metadata.json";
+        if (fs::exists(vault_metadata_file)) {
+            throttleIO(fs::file_size(vault_metadata_file));
+            std::ifstream file(vault_metadata_file);
+            json vault_metadata = json::parse(file, nullptr, false);
+            if (!vault_metadata.is_discarded() && vault_metadata.contains("locked_folders")) {
+                for (const auto& folder : vault_metadata["locked_folders"]) {
+                    locked_folders.insert(folder.get<std::string>());
                 }
+                have_locked_folders = true;
+            }
+        }
+        
+        for (const auto& entry : listDirectory(vault_path + "/metadata")) {
+            if (entry.extension() != ".json" || !fs::is_regular_file(entry)) {
+                continue;
+            }
+            std::string identifier = entry.stem().string();
+            throttleIO(fs::file_size(entry));
+            
+            std::ifstream file(entry);
+            json metadata = json::parse(file, nullptr, false);
+            if (metadata.is_discarded() || !metadata.is_object()) {
+                // Never collect what we cannot interpret
+                live.hidden_ids.insert(identifier);
+                continue;
+            }
+            
+            if (metadata.contains("vault_location")) {
+                std::string original_path = metadata.value("original_path", "");
+                if (!have_locked_folders || locked_folders.count(original_path)) {
+                    live.locked_locations.insert(identifier);
+                } else {
+                    live.stale_locked_metadata.push_back(identifier);
+                }
+            } else if (fs::exists(vault_path + "/hidden_folders/" + identifier)) {
+                live.hidden_ids.insert(identifier);
+            } else {
+                live.stale_hidden_metadata.push_back(identifier);
+            }
+        }
+        
+        // Payloads of lock/unlock operations ProfileVault has yet to resume
+        for (const auto& entry : listDirectory(vault_path + "/journal")) {
+            if (entry.extension() == ".wal") {
+                live.locked_locations.insert(entry.stem().string());
+            }
+        }
+        
+        live.packed_mappings = loadPackedMappings(vault_id);
+        return live;
+    }
+    
+    /**
+     * Fold loose per-folder mapping files into mappings/mappings.pack, dropping
+     * mappings whose folder is gone. Returns the number of loose files removed.
+     */
+    size_t repackMappings(const std::string& vault_id, LiveObjects& live,
+                          fs::file_time_type cutoff, CleanupResult& result) {
+        std::string mapping_dir = getVaultPath(vault_id) + "/mappings";
+        std::string hidden_path = getVaultPath(vault_id) + "/hidden_folders/";
+        
+        auto referenced = [&](const std::string& identifier) {
+            return live.hidden_ids.count(identifier) > 0 || fs::exists(hidden_path + identifier);
+        };
+        
+        std::unordered_map<std::string, json> packed;
+        bool pack_changed = false;
+        for (auto& pair : live.packed_mappings) {
+            if (referenced(pair.first)) {
+                packed.emplace(pair.first, std::move(pair.second));
+            } else {
+                result.objects_reclaimed++;
+                pack_changed = true;
+            }
+        }
+        
+        std::vector<fs::path> loose;
+        for (const auto& entry : listDirectory(mapping_dir)) {
+            if (entry.extension() != ".map" || !isOlderThan(entry.string(), cutoff)) {
+                continue;
+            }
+            std::string identifier = entry.stem().string();
+            if (!referenced(identifier)) {
+                result.bytes_freed += reclaimFile(entry.string(), true);
+                result.objects_reclaimed++;
+                continue;
             }
+            throttleIO(fs::file_size(entry));
+            std::ifstream file(entry);
+            json mapping = json::parse(file, nullptr, false);
+            if (mapping.is_discarded()) {
+                continue;
+            }
+            packed[identifier] = std::move(mapping);
+            loose.push_back(entry);
+            pack_changed = true;
+        }
+        
+        if (!pack_changed) {
+            return 0;
+        }
+        
+        // One record per line; written aside and renamed so readers never see a partial pack
+        std::string pack_file = mapping_dir + "/mappings.pack";
+        std::string pack_tmp = pack_file + ".tmp";
+        size_t pack_bytes = 0;
+        {
+            std::ofstream file(pack_tmp, std::ios::trunc);
+            for (const auto& pair : packed) {
+                std::string line = pair.second.dump();
+                file << line << '\n';
+                pack_bytes += line.size() + 1;
+            }
+            if (!file) {
+                throw std::runtime_error("Failed to write mapping pack");
+            }
+        }
+        fs::permissions(pack_tmp, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace);
+        throttleIO(pack_bytes);
+        fs::rename(pack_tmp, pack_file);
+        
+        for (const auto& path : loose) {
+            throttleIO(kMinIOCharge);
+            fs::remove(path);
+        }
+        return loose.size();
+    }
+    
+    std::unordered_map<std::string, json> loadPackedMappings(const std::string& vault_id) const {
+        std::unordered_map<std::string, json> mappings;
+        std::ifstream file(getVaultPath(vault_id) + "/mappings/mappings.pack");
+        std::string line;
+        while (std::getline(file, line)) {
+            json mapping = json::parse(line, nullptr, false);
+            if (!mapping.is_discarded() && mapping.contains("obfuscated_id")) {
+                std::string identifier = mapping["obfuscated_id"].get<std::string>();
+                mappings[identifier] = std::move(mapping);
+            }
+        }
+        return mappings;
+    }
+    
+    /**
+     * Metadata journal. A hide commits as a single appended record holding the
+     * folder metadata and its mapping; the per-folder metadata/mapping files
+     * are written later by checkpointMetadataJournal(). Readers consult the
+     * journal for folders hidden since the last checkpoint.
+     */
+    std::string getJournalPath(const std::string& vault_id) const {
+        return getVaultPath(vault_id) + "/metadata/hide.journal";
+    }
+    
+    // Caller holds journal_mutex_. The record is durable when this returns.
+    bool appendJournalRecord(const std::string& vault_id, const json& record) {
+        ScopedSpan span(Operation::METADATA_COMMIT);
+        try {
+            fs::create_directories(getVaultPath(vault_id) + "/metadata");
+            // Leading newline keeps this record off the line of a torn earlier append
+            writeRecordFile(getJournalPath(vault_id), "\n" + record.dump() + "\n", true);
             return true;
         } catch (const std::exception& e) {
-            last_error_ = "Failed to securely wipe directory: " + std::string(e.what());
+            last_error_ = "Failed to append journal record: " + std::string(e.what());
             return false;
         }
     }
     
-    bool secureWipeFile(const std::string& file_path) {
+    // Hide records not yet checkpointed and not undone by a later restore/abort, in journal order
+    std::vector<json> readPendingHides(const std::string& vault_id) const {
+        std::lock_guard<std::recursive_mutex> lock(journal_mutex_);
+        std::vector<json> pending;
+        std::ifstream file(getJournalPath(vault_id));
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            json record = json::parse(line, nullptr, false);
+            if (record.is_discarded() || !record.contains("id")) {
+                continue;  // torn by a crash mid-append; never acknowledged to the caller
+            }
+            auto existing = std::find_if(pending.begin(), pending.end(), [&record](const json& hide) {
+                return hide["id"] == record["id"];
+            });
+            if (existing != pending.end()) {
+                pending.erase(existing);
+            }
+            if (record.value("op", "") == "hide") {
+                pending.push_back(std::move(record));
+            }
+        }
+        return pending;
+    }
+    
+    bool checkpointMetadataJournal(const std::string& vault_id) {
+        ScopedSpan span(Operation::METADATA_COMMIT);
         try {
-            if (!fs::exists(file_path)) {
-                return true;
+            std::lock_guard<std::recursive_mutex> lock(journal_mutex_);
+            checkpointJournalLocked(vault_id);
+            return true;
+        } catch (const std::exception& e) {
+            last_error_ = "Failed to checkpoint metadata journal: " + std::string(e.what());
+            return false;
+        }
+    }
+    
+    // Caller holds journal_mutex_. Throws on I/O failure, leaving the journal in place.
+    size_t checkpointJournalLocked(const std::string& vault_id) {
+        std::string journal_path = getJournalPath(vault_id);
+        if (!fs::exists(journal_path)) {
+            return 0;
+        }
+        
+        std::string vault_path = getVaultPath(vault_id);
+        size_t written = 0;
+        for (const auto& record : readPendingHides(vault_id)) {
+            std::string identifier = record["id"].get<std::string>();
+            std::string original_path = record["metadata"].value("original_path", "");
+            
+            // Committed but the rename never happened (crash between the two)
+            if (!fs::exists(vault_path + "/hidden_folders/" + identifier) && fs::exists(original_path)) {
+                continue;
             }
             
-            size_t file_size = fs::file_size(file_path);
+            fs::create_directories(vault_path + "/mappings");
+            writeRecordFile(vault_path + "/mappings/" + identifier + ".map", record["mapping"].dump(4), false);
+            writeRecordFile(vault_path + "/metadata/" + identifier + ".json", record["metadata"].dump(2), false);
+            written++;
+        }
+        
+        fs::remove(journal_path);
+        return written;
+    }
+    
+    // Write (or append) and sync in one go; new files are created owner-only
+    static void writeRecordFile(const std::string& path, const std::string& data, bool append) {
+        #if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+        int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC);
+        int fd = open(path.c_str(), flags, 0600);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open " + path + ": " + strerror(errno));
+        }
+        
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = write(fd, data.data() + written, data.size() - written);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                std::string error = strerror(errno);
+                close(fd);
+                throw std::runtime_error("Failed to write " + path + ": " + error);
+            }
+            written += static_cast<size_t>(n);
+        }
+        
+        #ifdef PLATFORM_MACOS
+        int synced = fsync(fd);
+        #else
+        int synced = fdatasync(fd);
+        #endif
+        close(fd);
+        if (synced != 0) {
+            throw std::runtime_error("Failed to sync " + path);
+        }
+        #else
+        std::ofstream file(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+        file << data;
+        file.flush();
+        if (!file) {
+            throw std::runtime_error("Failed to write " + path);
+        }
+        fs::permissions(path, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace);
+        #endif
+    }
+    
+    /**
+     * Deferred hide work: decoys and journal checkpoints. Tasks queued while
+     * the worker is busy are handled as one batch, so a burst of hides costs
+     * one checkpoint per vault.
+     */
+    void scheduleBackgroundTask(const std::string& vault_id, const std::string& obfuscated_id) {
+        std::lock_guard<std::mutex> lock(background_mutex_);
+        background_tasks_.push_back({vault_id, obfuscated_id});
+        if (!background_thread_.joinable()) {
+            background_running_ = true;
+            background_thread_ = std::thread(&Implementation::backgroundLoop, this);
+        }
+        background_cv_.notify_one();
+    }
+    
+    void backgroundLoop() {
+        ResourceLimiter::demoteCurrentThread();
+        std::unique_lock<std::mutex> lock(background_mutex_);
+        while (true) {
+            background_cv_.wait(lock, [this] { return !background_running_ || !background_tasks_.empty(); });
+            if (!background_running_) {
+                break;  // anything left is still in the journal and checkpointed on next use
+            }
             
-            // Overwrite file with random data multiple times
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> dis(0, 255);
+            std::vector<BackgroundTask> batch(background_tasks_.begin(), background_tasks_.end());
+            background_tasks_.clear();
+            background_busy_ = true;
+            lock.unlock();
             
-            std::ofstream file(file_path, std::ios::binary);
-            if (!file.is_open()) {
-                return false;
-            }
+            runBackgroundTasks(batch);
             
-            // Three-pass secure wipe
-            for (int pass = 0; pass < 3; ++pass) {
-                file.seekp(0);
-                for (size_t i = 0; i < file_size; ++i) {
-                    file.put(static_cast<char>(dis(gen)));
+            lock.lock();
+            background_busy_ = false;
+            background_idle_cv_.notify_all();
+        }
+    }
+    
+    // Runs on the worker thread; reports through std::cerr rather than last_error_
+    void runBackgroundTasks(const std::vector<BackgroundTask>& batch) {
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_int_distribution<int> count_dis(5, 12);
+        
+        std::unordered_set<std::string> vaults;
+        for (const auto& task : batch) {
+            vaults.insert(task.vault_id);
+            try {
+                std::string decoy_base = getVaultPath(task.vault_id) + "/decoys";
+                size_t existing = listDirectory(decoy_base).size();
+                if (existing < kMaxDecoyFolders) {
+                    createDecoyFolders(decoy_base, std::min<size_t>(count_dis(gen), kMaxDecoyFolders - existing));
                 }
-                file.flush();
+            } catch (const std::exception& e) {
+                std::cerr << "[VaultHandler] Decoy generation failed for " << task.obfuscated_id << ": " << e.what() << std::endl;
             }
+        }
+        
+        for (const auto& vault_id : vaults) {
+            try {
+                std::lock_guard<std::recursive_mutex> lock(journal_mutex_);
+                checkpointJournalLocked(vault_id);
+            } catch (const std::exception& e) {
+                std::cerr << "[VaultHandler] Journal checkpoint failed for vault " << vault_id << ": " << e.what() << std::endl;
+            }
+        }
+    }
+    
+    void createDecoyFolders(const std::string& decoy_base, size_t count) {
+        fs::create_directories(decoy_base);
+        
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_int_distribution<int> name_dis(8, 16);   // 8-16 character names
+        
+        for (size_t i = 0; i < count; ++i) {
+            // Generate random decoy folder name
+            std::string decoy_path = decoy_base + "/" + generateRandomHexString(name_dis(gen));
             
-            file.close();
-            return true;
+            // Create decoy folder with random content
+            fs::create_directories(decoy_path);
             
+            // Add random files to make it look legitimate
+            createDecoyFiles(decoy_path);
+            
+            // Set random timestamps to avoid temporal correlation
+            setRandomTimestamps(decoy_path);
+        }
+    }
+    
+    // Empty directory at a hidden folder's original path, or an inaccessible one as older versions created
+    static bool isHidingPlaceholder(const std::string& path) {
+        std::error_code ec;
+        auto status = fs::symlink_status(path, ec);
+        if (ec || !fs::is_directory(status)) {
+            return false;
+        }
+        if (status.permissions() == fs::perms::none) {
+            return true;  // removal still fails if it is not empty
+        }
+        return fs::is_empty(path, ec) && !ec;
+    }
+    
+    static std::chrono::system_clock::time_point toTimePoint(int64_t seconds, int64_t nanoseconds) {
+        return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::seconds(seconds) + std::chrono::nanoseconds(nanoseconds)));
+    }
+    
+    static std::string toHex(const std::string& bytes) {
+        static const char digits[] = "0123456789abcdef";
+        std::string hex;
+        hex.reserve(bytes.size() * 2);
+        for (unsigned char c : bytes) {
+            hex += digits[c >> 4];
+            hex += digits[c & 0x0f];
+        }
+        return hex;
+    }
+    
+    static std::string fromHex(const std::string& hex) {
+        std::string bytes;
+        bytes.reserve(hex.size() / 2);
+        for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+            bytes += static_cast<char>(std::stoi(hex.substr(i, 2), nullptr, 16));
+        }
+        return bytes;
+    }
+    
+    #if defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    // getpwuid/getgrgid may go through NSS on every call; ids rarely change names
+    std::string lookupUserName(uid_t uid) const {
+        auto it = user_names_.find(uid);
+        if (it == user_names_.end()) {
+            struct passwd* pw = getpwuid(uid);
+            it = user_names_.emplace(uid, pw ? pw->pw_name : std::to_string(uid)).first;
+        }
+        return it->second;
+    }
+    
+    std::string lookupGroupName(gid_t gid) const {
+        auto it = group_names_.find(gid);
+        if (it == group_names_.end()) {
+            struct group* gr = getgrgid(gid);
+            it = group_names_.emplace(gid, gr ? gr->gr_name : std::to_string(gid)).first;
+        }
+        return it->second;
+    }
+    
+    static ssize_t listAttributeNames(int fd, char* buffer, size_t size) {
+        #ifdef PLATFORM_MACOS
+        return flistxattr(fd, buffer, size, 0);
+        #else
+        return flistxattr(fd, buffer, size);
+        #endif
+    }
+    
+    static ssize_t readAttributeValue(int fd, const char* name, char* buffer, size_t size) {
+        #ifdef PLATFORM_MACOS
+        return fgetxattr(fd, name, buffer, size, 0, 0);
+        #else
+        return fgetxattr(fd, name, buffer, size);
+        #endif
+    }
+    
+    /**
+     * All attributes through one descriptor: one list call and one read per
+     * attribute into shared buffers that grow on ERANGE, so values of any
+     * size are captured whole, binary content included.
+     */
+    static bool readExtendedAttributes(int fd, std::unordered_map<std::string, std::string>& attributes) {
+        std::vector<char> names(kXattrBufferSize);
+        ssize_t names_size;
+        while ((names_size = listAttributeNames(fd, names.data(), names.size())) < 0) {
+            if (errno == ENOTSUP) {
+                return true;  // filesystem without extended attributes
+            }
+            ssize_t needed = errno == ERANGE ? listAttributeNames(fd, nullptr, 0) : -1;
+            if (needed < 0) {
+                return false;
+            }
+            names.resize(std::max(static_cast<size_t>(needed), names.size() * 2));
+        }
+        
+        std::vector<char> value(kXattrBufferSize);
+        for (const char* name = names.data(); name < names.data() + names_size; name += strlen(name) + 1) {
+            ssize_t value_size;
+            while ((value_size = readAttributeValue(fd, name, value.data(), value.size())) < 0 && errno == ERANGE) {
+                ssize_t needed = readAttributeValue(fd, name, nullptr, 0);
+                if (needed < 0) {
+                    break;
+                }
+                value.resize(std::max(static_cast<size_t>(needed), value.size() * 2));
+            }
+            // Attributes removed since the listing are skipped
+            if (value_size >= 0) {
+                attributes[name].assign(value.data(), static_cast<size_t>(value_size));
+            }
+        }
+        return true;
+    }
+    #endif
+    
+    static std::vector<fs::path> listDirectory(const std::string& dir_path) {
+        std::vector<fs::path> entries;
+        std::error_code ec;
+        for (fs::directory_iterator it(dir_path, ec), end; !ec && it != end; it.increment(ec)) {
+            entries.push_back(it->path());
+        }
+        return entries;
+    }
+    
+    static bool isOlderThan(const std::string& path, fs::file_time_type cutoff) {
+        std::error_code ec;
+        auto modified = fs::last_write_time(path, ec);
+        return !ec && modified < cutoff;
+    }
+    
+    void throttleIO(size_t bytes) {
+        io_limiter_->recordIO(std::max(bytes, kMinIOCharge));
+        io_limiter_->enforceIOLimit();
+    }
+    
+    // Remove a file, overwriting it first when it may hold plaintext. Returns bytes freed.
+    size_t reclaimFile(const std::string& file_path, bool wipe) {
+        std::error_code ec;
+        if (!fs::is_regular_file(file_path, ec)) {
+            return 0;
+        }
+        size_t size = fs::file_size(file_path, ec);
+        if (wipe) {
+            throttleIO(size * 3);
+            if (!secureWipeFile(file_path)) {
+                logOperation("COMPACT_WARNING", "Failed to securely wipe file: " + file_path);
+            }
+        }
+        throttleIO(kMinIOCharge);
+        fs::remove(file_path);
+        return size;
+    }
+    
+    size_t reclaimTree(const std::string& path, bool wipe) {
+        if (!fs::is_directory(path)) {
+            return reclaimFile(path, wipe);
+        }
+        size_t freed = 0;
+        for (const auto& entry : fs::recursive_directory_iterator(path)) {
+            if (entry.is_regular_file()) {
+                freed += reclaimFile(entry.path().string(), wipe);
+            }
+        }
+        fs::remove_all(path);
+        return freed;
+    }
+    
+    size_t calculateDirectorySize(const std::string& dir_path) {
+        try {
+            size_t size = 0;
+            for (const auto& entry : fs::recursive_directory_iterator(dir_path)) {
+                if (entry.is_regular_file()) {
+                    size += entry.file_size();
+                }
+            }
+            return size;
         } catch (const std::exception& e) {
-            last_error_ = "Failed to securely wipe file: " + std::string(e.what());
+            return 0;
+        }
+    }
+    
+    bool secureWipeDirectory(const std::string& dir_path) {
+        TraceSpan span("wipe_directory");
+        WipeResult result = wipe_engine_->wipeDirectory(dir_path);
+        for (const auto& failed : result.failedPaths) {
+            logOperation("WIPE_WARNING", "Failed to securely wipe file: " + failed);
+        }
+        if (result.filesWiped == 0 && result.filesFailed > 0) {
+            last_error_ = "Failed to securely wipe directory: " + wipe_engine_->getLastError();
             return false;
         }
+        return true;
+    }
+    
+    bool secureWipeFile(const std::string& file_path) {
+        TraceSpan span("wipe_file");
+        std::error_code ec;
+        if (!fs::exists(file_path, ec)) {
+            return true;
+        }
+        WipeResult result = wipe_engine_->wipeFile(file_path);
+        if (!result.success) {
+            last_error_ = "Failed to securely wipe file: " + wipe_engine_->getLastError();
+        }
+        return result.success;
     }
     
     #ifdef PLATFORM_WINDOWS
@@ -1293,6 +2349,30 @@ CleanupResult VaultHandler::secureDeleteFromVault(const std::string& vault_id, c
     return pimpl->secureDeleteFromVault(vault_id, folder_identifier);
 }
 
+CleanupResult VaultHandler::cleanupVault(const std::string& vault_id) {
+    return pimpl->cleanupVault(vault_id);
+}
+
+bool VaultHandler::compactVault(const std::string& vault_id) {
+    return pimpl->cleanupVault(vault_id).success;
+}
+
+void VaultHandler::setCompactionIOLimit(size_t max_bytes_per_second) {
+    pimpl->setCompactionIOLimit(max_bytes_per_second);
+}
+
+void VaultHandler::waitForBackgroundTasks() {
+    pimpl->waitForBackgroundTasks();
+}
+
+bool VaultHandler::secureWipeVaultData(const std::string& vault_path) {
+    return pimpl->secureWipeVaultData(vault_path);
+}
+
+void VaultHandler::setWipeConfig(const WipeConfig& config) {
+    pimpl->setWipeConfig(config);
+}
+
 std::string VaultHandler::getLastError() const {
     return pimpl->getLastError();
 }
@@ -1301,4 +2381,60 @@ std::vector<std::string> VaultHandler::getOperationLog() const {
     return pimpl->getOperationLog();
 }
 
+std::vector<std::string> VaultHandler::listVaultFolders(const std::string& vault_id) const {
+    return pimpl->listVaultFolders(vault_id);
+}
+
+std::string VaultHandler::resolveObfuscatedPath(const std::string& vault_id, const std::string& obfuscated_id) {
+    return pimpl->resolveObfuscatedPath(vault_id, obfuscated_id);
+}
+
+void VaultHandler::enableHashBasedIndexing() {
+    pimpl->enableHashBasedIndexing();
+}
+
+void VaultHandler::disableHashBasedIndexing() {
+    pimpl->disableHashBasedIndexing();
+}
+
+bool VaultHandler::isHashBasedIndexingEnabled() const {
+    return pimpl->isHashBasedIndexingEnabled();
+}
+
+void VaultHandler::buildFolderIndex(const std::string& vault_id) {
+    pimpl->buildFolderIndex(vault_id, true);
+}
+
+void VaultHandler::rebuildFolderIndex(const std::string& vault_id) {
+    pimpl->buildFolderIndex(vault_id, false);
+}
+
+std::optional<FolderMetadata> VaultHandler::getFolderMetadataFast(const std::string& vault_id, const std::string& folder_identifier) const {
+    return pimpl->getFolderMetadataFast(vault_id, folder_identifier);
+}
+
+bool VaultHandler::isFolderIndexed(const std::string& vault_id, const std::string& folder_identifier) const {
+    return pimpl->isFolderIndexed(vault_id, folder_identifier);
+}
+
+void VaultHandler::invalidateFolderIndex(const std::string& vault_id) {
+    pimpl->invalidateFolderIndex(vault_id);
+}
+
+size_t VaultHandler::getIndexedFolderCount(const std::string& vault_id) const {
+    return pimpl->getIndexedFolderCount(vault_id);
+}
+
+void VaultHandler::optimizeMemoryUsage() {
+    pimpl->optimizeMemoryUsage();
+}
+
+size_t VaultHandler::getIndexMemoryUsage() const {
+    return pimpl->getIndexMemoryUsage();
+}
+
+void VaultHandler::compactIndexes() {
+    pimpl->compactIndexes();
+}
+
 } // namespace phantomvault
\ No newline at end of file
@@ -137,10 +137,18 @@ private:
         // Hide then restore
         auto hide_result = handler.hideFolder(test_folder, "restore_vault");
         ASSERT_TRUE(hide_result.success);
+        ASSERT_FALSE(fs::exists(test_folder));  // a rename, no placeholder left behind
+        ASSERT_EQ(handler.resolveObfuscatedPath("restore_vault", hide_result.obfuscated_identifier), test_folder);
+        
+        // Journaled metadata is checkpointed into per-folder files in the background
+        std::string metadata_dir = vault_path + "/restore_vault/metadata";
+        handler.waitForBackgroundTasks();
+        ASSERT_FALSE(fs::exists(metadata_dir + "/hide.journal"));
+        ASSERT_TRUE(fs::exists(metadata_dir + "/" + hide_result.obfuscated_identifier + ".json"));
         
         auto restore_result = handler.restoreFolder("restore_vault", hide_result.obfuscated_identifier);
         ASSERT_TRUE(restore_result.success);
-        ASSERT_TRUE(fs::exists(test_folder));
+        ASSERT_TRUE(fs::exists(test_folder + "/restore_test.txt"));
         
         // Cleanup
         fs::remove_all(vault_path);
@@ -177,6 +185,24 @@ private:
         // Test vault compaction
         ASSERT_TRUE(handler.compactVault("compact_test"));
         
+        // Encrypted payload with no folder metadata, older than the grace period
+        std::string orphan_dir = vault_path + "/compact_test/folders/orphan";
+        fs::create_directories(orphan_dir);
+        {
+            std::ofstream orphan(orphan_dir + "/data.enc");
+            orphan << std::string(4096, 'x');
+        }
+        auto old_time = fs::file_time_type::clock::now() - std::chrono::hours(1);
+        fs::last_write_time(orphan_dir + "/data.enc", old_time);
+        fs::last_write_time(orphan_dir, old_time);
+        
+        handler.setCompactionIOLimit(0);
+        auto result = handler.cleanupVault("compact_test");
+        ASSERT_TRUE(result.success);
+        ASSERT_FALSE(fs::exists(orphan_dir));
+        ASSERT_EQ(result.folders_cleaned, 1);
+        ASSERT_TRUE(result.bytes_freed >= 4096);
+        
         fs::remove_all(vault_path);
     }
     
@@ -7,6 +7,7 @@
 
 #include "test_framework.hpp"
 #include "../include/encryption_engine.hpp"
+#include "../include/checksum_engine.hpp"
 #include <filesystem>
 #include <fstream>
 #include <random>
@@ -24,6 +25,7 @@ public:
         REGISTER_TEST(framework, "EncryptionEngine", "initialization", testInitialization);
         REGISTER_TEST(framework, "EncryptionEngine", "self_test", testSelfTest);
         REGISTER_TEST(framework, "EncryptionEngine", "key_derivation", testKeyDerivation);
+        REGISTER_TEST(framework, "EncryptionEngine", "file_checksums", testFileChecksums);
         
         // Encryption/Decryption tests
         REGISTER_TEST(framework, "EncryptionEngine", "basic_encryption", testBasicEncryption);
@@ -411,6 +413,61 @@ private:
         ASSERT_VECTOR_EQ(decrypted_result.decrypted_data, empty_data);
     }
     
+    static void testFileChecksums() {
+        phantomvault::ChecksumEngine checksums(4);
+        
+        // Published test vectors
+        ASSERT_EQ(checksums.hashBuffer("", 0, phantomvault::ChecksumAlgorithm::BLAKE3),
+                  std::string("af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262"));
+        ASSERT_EQ(checksums.hashBuffer("abc", 3, phantomvault::ChecksumAlgorithm::BLAKE3),
+                  std::string("6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85"));
+        ASSERT_EQ(checksums.hashBuffer("abc", 3, phantomvault::ChecksumAlgorithm::SHA256),
+                  std::string("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+        
+        // Mapped, multithreaded and incremental hashing agree across chunk and subtree boundaries
+        std::vector<uint8_t> data(5 * 1024 * 1024 + 3);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<uint8_t>(i % 251);
+        }
+        std::string test_file = "test_checksum_file.bin";
+        {
+            std::ofstream file(test_file, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        }
+        
+        std::string expected = checksums.hashBuffer(data.data(), data.size());
+        ASSERT_EQ(checksums.hashFile(test_file), expected);
+        
+        auto hasher = phantomvault::ChecksumEngine::createHasher(phantomvault::ChecksumAlgorithm::BLAKE3);
+        for (size_t offset = 0, step = 1; offset < data.size(); offset += step, step = step * 3 + 7) {
+            hasher->update(data.data() + offset, std::min(step, data.size() - offset));
+        }
+        std::string incremental;
+        for (uint8_t byte : hasher->finish()) {
+            const char* digits = "0123456789abcdef";
+            incremental += digits[byte >> 4];
+            incremental += digits[byte & 0x0f];
+        }
+        ASSERT_EQ(incremental, expected);
+        
+        auto batch = checksums.hashFiles({test_file, "missing_checksum_file.bin", test_file});
+        ASSERT_EQ(batch.size(), static_cast<size_t>(3));
+        ASSERT_EQ(batch[0], expected);
+        ASSERT_TRUE(batch[1].empty());
+        ASSERT_EQ(batch[2], expected);
+        
+        // EncryptionEngine records which algorithm produced a checksum
+        EncryptionEngine engine;
+        auto metadata = engine.getFileMetadata(test_file);
+        ASSERT_EQ(metadata.checksum_algorithm, std::string("blake3"));
+        ASSERT_EQ(metadata.checksum, expected);
+        ASSERT_EQ(engine.calculateFileChecksum(test_file, "sha256"),
+                  checksums.hashBuffer(data.data(), data.size(), phantomvault::ChecksumAlgorithm::SHA256));
+        ASSERT_TRUE(engine.calculateFileChecksum(test_file, "md5").empty());
+        
+        fs::remove(test_file);
+    }
+    
     static void testEncryptionPerformance() {
         EncryptionEngine engine;
         
@@ -94,7 +94,7 @@ bool TestFramework::runTest(const std::string& category, const std::string& name
             TestResult result = runSingleTest(test);
             results_.push_back(result);
             logTest(result);
-            return result.status == TestStatus::PASSED;
+            return result.status == TestStatus::PASSED || result.status == TestStatus::SKIPPED;
         }
     }
     
@@ -117,6 +117,10 @@ TestResult TestFramework::runSingleTest(const TestInfo& test) {
         result.status = TestStatus::FAILED;
         result.message = "Assertion failed";
         result.error_details = e.what();
+    } catch (const TestSkippedException& e) {
+        result.status = TestStatus::SKIPPED;
+        result.message = "Skipped";
+        result.error_details = e.what();
     } catch (const std::exception& e) {
         result.status = TestStatus::ERROR;
         result.message = "Test error";
@@ -80,6 +80,18 @@ private:
     std::string message_;
 };
 
+/**
+ * @brief Thrown by SKIP_TEST when a test cannot run meaningfully here
+ */
+class TestSkippedException : public std::exception {
+public:
+    explicit TestSkippedException(const std::string& reason) : reason_(reason) {}
+    const char* what() const noexcept override { return reason_.c_str(); }
+    
+private:
+    std::string reason_;
+};
+
 /**
  * @brief Main test framework class
  */
@@ -186,6 +198,9 @@ private:
         } \
     } while(0)
 
+#define SKIP_TEST(reason) \
+    throw phantomvault::testing::TestSkippedException(reason)
+
 #define ASSERT_NO_THROW(expression) \
     do { \
         try { \
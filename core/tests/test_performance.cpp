@@ -9,6 +9,24 @@
 #include "../include/encryption_engine.hpp"
 #include "../include/profile_vault.hpp"
 #include "../include/folder_security_manager.hpp"
+#include "../include/rate_limiter.hpp"
+#include "../include/folder_index.hpp"
+#include "../include/segment_store.hpp"
+#include "../include/merkle_tree.hpp"
+#include "../include/secure_wipe_engine.hpp"
+#include "../include/checksum_engine.hpp"
+#include "../include/password_pattern_matcher.hpp"
+#include "../include/keyboard_sequence_detector.hpp"
+#include "../include/performance_monitor.hpp"
+#include "../include/metrics_history.hpp"
+#include "../include/instrumentation.hpp"
+#include "../include/memory_manager.hpp"
+#include "../include/secure_arena.hpp"
+#include "../include/event_rollups.hpp"
+#include "../include/event_queue.hpp"
+#include "../include/analytics_engine.hpp"
+#include "../include/error_handler.hpp"
+#include "../include/security_event_store.hpp"
 #include <filesystem>
 #include <fstream>
 #include <random>
@@ -16,6 +34,13 @@
 #include <chrono>
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <ctime>
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <mutex>
+#include <condition_variable>
 
 using namespace phantomvault;
 using namespace phantomvault::testing;
@@ -46,6 +71,32 @@ public:
         REGISTER_TEST(framework, "Performance", "cpu_usage_impact", testCPUUsageImpact);
         REGISTER_TEST(framework, "Performance", "disk_io_performance", testDiskIOPerformance);
         REGISTER_TEST(framework, "Performance", "startup_performance", testStartupPerformance);
+        
+        // Contention tests
+        REGISTER_TEST(framework, "Performance", "rate_limiter_concurrent_identifiers", testRateLimiterConcurrentIdentifiers);
+        REGISTER_TEST(framework, "Performance", "memory_manager_thread_caches", testMemoryManagerThreadCaches);
+        REGISTER_TEST(framework, "Performance", "secure_arena_scopes", testSecureArenaScopes);
+        REGISTER_TEST(framework, "Performance", "folder_index_lookup", testFolderIndexLookup);
+        REGISTER_TEST(framework, "Performance", "segment_store_small_files", testSegmentStoreSmallFiles);
+        REGISTER_TEST(framework, "Performance", "merkle_tree_recreated_pack", testMerkleTreeRecreatedPack);
+        REGISTER_TEST(framework, "Performance", "secure_wipe_throughput", testSecureWipeThroughput);
+        REGISTER_TEST(framework, "Performance", "checksum_throughput", testChecksumThroughput);
+        REGISTER_TEST(framework, "Performance", "password_matcher_keys_per_second", testPasswordMatcherThroughput);
+        REGISTER_TEST(framework, "Performance", "scheduler_idle_wakeups", testSchedulerIdleWakeups);
+        REGISTER_TEST(framework, "Performance", "resource_limiter_buckets", testResourceLimiterBuckets);
+        REGISTER_TEST(framework, "Performance", "metrics_history_ring", testMetricsHistoryRing);
+        REGISTER_TEST(framework, "Performance", "instrumentation_span_overhead", testInstrumentationOverhead);
+        REGISTER_TEST(framework, "Performance", "trace_recorder_export", testTraceRecorderExport);
+        REGISTER_TEST(framework, "Performance", "analytics_rollup_boundaries", testAnalyticsRollupBoundaries);
+        REGISTER_TEST(framework, "Performance", "analytics_rollup_retention", testAnalyticsRollupRetention);
+        REGISTER_TEST(framework, "Performance", "event_queue_overflow_policies", testEventQueueOverflowPolicies);
+        REGISTER_TEST(framework, "Performance", "event_queue_concurrent_producers", testEventQueueConcurrentProducers);
+        REGISTER_TEST(framework, "Performance", "analytics_concurrent_ingestion", testAnalyticsConcurrentIngestion);
+        REGISTER_TEST(framework, "Performance", "security_event_ingestion_blocks", testSecurityEventIngestionBlocks);
+        REGISTER_TEST(framework, "Performance", "security_event_store_out_of_order", testSecurityEventStoreOutOfOrder);
+        REGISTER_TEST(framework, "Performance", "keyboard_loop_stop_latency", testKeyboardLoopStopLatency);
+        REGISTER_TEST(framework, "Performance", "keyboard_sequence_timeout", testKeyboardSequenceTimeout);
+        REGISTER_TEST(framework, "Performance", "keyboard_idle_wakeups", testKeyboardIdleWakeups);
     }
 
 private:
@@ -610,6 +661,1262 @@ private:
         fs::remove_all(vault_root);
     }
     
+    static void testRateLimiterConcurrentIdentifiers() {
+        RateLimiter::Config config;
+        config.maxEntriesPerShard = 512;
+        RateLimiter limiter(config);
+        
+        const int num_threads = 8;
+        const int attempts_per_thread = 50000;
+        std::atomic<int> denied_hot{0};
+        
+        // Every thread hammers one shared brute-force identifier between
+        // bursts of one-off identifiers, as a distributed attack would
+        PerformanceTimer timer;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&limiter, &denied_hot, t]() {
+                for (int i = 0; i < attempts_per_thread; ++i) {
+                    if (i % 16 == 0) {
+                        if (!limiter.allow("auth_victim_ipc", 5, std::chrono::minutes(15))) {
+                            denied_hot++;
+                        }
+                    } else {
+                        limiter.allow("auth_" + std::to_string(t) + "_" + std::to_string(i), 5, std::chrono::minutes(15));
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto elapsed = timer.elapsedNanos();
+        
+        double total_attempts = static_cast<double>(num_threads) * attempts_per_thread;
+        double ns_per_attempt = elapsed.count() / total_attempts;
+        std::cout << "    rate limiter: " << ns_per_attempt << " ns/attempt across "
+                  << num_threads << " threads" << std::endl;
+        
+        auto stats = limiter.getStats();
+        
+        // The shared identifier stays blocked despite the identifier flood
+        ASSERT_TRUE(limiter.getInfo("auth_victim_ipc").isBlocked);
+        ASSERT_TRUE(denied_hot.load() >= num_threads * attempts_per_thread / 16 - 5);
+        
+        // Memory stays bounded by the per-shard LRU
+        ASSERT_TRUE(stats.trackedIdentifiers <= config.shardCount * config.maxEntriesPerShard);
+        ASSERT_TRUE(stats.evictions > 0);
+        
+        ASSERT_TRUE(ns_per_attempt < 20000); // Well under 20 us per attempt
+    }
+    
+    static void testMemoryManagerThreadCaches() {
+        auto& manager = MemoryManager::getInstance();
+        manager.resetStats();
+        
+        const int num_threads = 8;
+        const int operations_per_thread = 200000;
+        const size_t window = 64;
+        std::atomic<int> corrupted{0};
+        std::atomic<int> failed{0};
+        
+        // Each thread keeps a window of live blocks of mixed sizes, pooled
+        // and not, and checks its fill pattern survived before freeing
+        PerformanceTimer timer;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&manager, &corrupted, &failed, t]() {
+                std::vector<std::pair<uint8_t*, size_t>> live(window, {nullptr, 0});
+                for (int i = 0; i < operations_per_thread; ++i) {
+                    auto& slot = live[i % window];
+                    if (slot.first) {
+                        if (slot.first[0] != static_cast<uint8_t>(t) || slot.first[slot.second - 1] != static_cast<uint8_t>(t)) {
+                            corrupted++;
+                        }
+                        manager.deallocate(slot.first, slot.second);
+                    }
+                    size_t size = (static_cast<size_t>(i) * 37 + t) % 3000 + 1;
+                    slot.first = static_cast<uint8_t*>(manager.allocate(size));
+                    slot.second = size;
+                    if (!slot.first) {
+                        failed++;
+                        continue;
+                    }
+                    std::memset(slot.first, t, size);
+                }
+                for (auto& slot : live) {
+                    manager.deallocate(slot.first, slot.second);
+                }
+                
+                // Containers routed through the pools behave like std ones
+                PoolVector<int> numbers;
+                for (int i = 0; i < 1000; ++i) {
+                    numbers.push_back(i);
+                }
+                if (numbers[999] != 999) {
+                    corrupted++;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto elapsed = timer.elapsedNanos();
+        
+        double ns_per_operation = elapsed.count() / (static_cast<double>(num_threads) * operations_per_thread);
+        std::cout << "    memory manager: " << ns_per_operation << " ns per allocate/free pair across "
+                  << num_threads << " threads" << std::endl;
+        
+        ASSERT_EQ(corrupted.load(), 0);
+        ASSERT_EQ(failed.load(), 0);
+        
+        // Exited threads' counters are folded in; everything was freed
+        auto stats = manager.getStats();
+        ASSERT_EQ(stats.currentUsage, 0);
+        ASSERT_EQ(stats.poolUsage, 0);
+        ASSERT_TRUE(stats.totalAllocated >= static_cast<size_t>(num_threads) * operations_per_thread);
+        ASSERT_TRUE(stats.peakUsage > 0);
+        
+        ASSERT_TRUE(ns_per_operation < 5000); // Well under 5 us per pair
+    }
+    
+    static void testSecureArenaScopes() {
+        phantomvault::SecureArena arena(64 * 1024);
+        ASSERT_TRUE(arena.capacity() >= 64 * 1024);
+        
+        // Nested scopes zero and reclaim exactly what they allocated
+        const uint8_t* outer_bytes = nullptr;
+        const uint8_t* inner_bytes = nullptr;
+        {
+            phantomvault::SecureArena::Scope outer(arena);
+            phantomvault::SecureBuffer key(32, 0xAA, &arena);
+            outer_bytes = key.data();
+            size_t outer_used = arena.used();
+            {
+                phantomvault::SecureArena::Scope inner(arena);
+                phantomvault::SecureBuffer plaintext(4096, 0x55, &arena);
+                inner_bytes = plaintext.data();
+            }
+            ASSERT_EQ(arena.used(), outer_used);
+            ASSERT_EQ(inner_bytes[0], 0);
+            ASSERT_EQ(inner_bytes[4095], 0);
+            ASSERT_EQ(key[31], 0xAA);
+            
+            // A growing vector's outgrown buffers stay until the scope ends;
+            // geometric growth keeps them under its final capacity
+            std::pmr::vector<int> numbers(&arena);
+            for (int i = 0; i < 4000; ++i) {
+                numbers.push_back(i);
+            }
+            ASSERT_EQ(numbers[3999], 3999);
+            ASSERT_TRUE(arena.used() <= outer_used + 2 * numbers.capacity() * sizeof(int) + 64);
+            
+            // Requests beyond the arena get their own mapping
+            phantomvault::SecureBuffer large(256 * 1024, 0x11, &arena);
+            ASSERT_TRUE(arena.overflowBytes() >= 256 * 1024);
+            ASSERT_EQ(large[256 * 1024 - 1], 0x11);
+        }
+        ASSERT_EQ(arena.used(), 0);
+        ASSERT_EQ(arena.overflowBytes(), 0);
+        ASSERT_EQ(outer_bytes[0], 0);
+        ASSERT_EQ(outer_bytes[31], 0);
+        
+        // Engine round trip through the calling thread's arena
+        EncryptionEngine engine;
+        std::string test_file = "./test_secure_arena_file.bin";
+        std::vector<uint8_t> original(200 * 1024);
+        for (size_t i = 0; i < original.size(); ++i) {
+            original[i] = static_cast<uint8_t>(i * 31 / 7);
+        }
+        {
+            std::ofstream file(test_file, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(original.data()), original.size());
+        }
+        
+        EncryptionEngine::KeyDerivationConfig config(8192, 1, 1, 32, 64);
+        auto& thread_arena = phantomvault::SecureArena::forThread();
+        size_t used_before = thread_arena.used();
+        auto result = engine.encryptFile(test_file, "arena password", config);
+        fs::remove(test_file);
+        ASSERT_TRUE(result.success);
+        ASSERT_EQ(thread_arena.used(), used_before);
+        
+        {
+            phantomvault::SecureArena::Scope scope(thread_arena);
+            phantomvault::SecureBuffer plaintext(&thread_arena);
+            ASSERT_TRUE(engine.decryptFile(result.encrypted_data, "arena password", result.iv, result.salt,
+                                           result.compression_algorithm, result.original_size, plaintext, config));
+            ASSERT_EQ(plaintext.size(), original.size());
+            ASSERT_TRUE(std::equal(plaintext.begin(), plaintext.end(), original.begin()));
+            ASSERT_EQ(engine.calculateChecksum(plaintext.data(), plaintext.size(), result.checksum_algorithm),
+                      result.checksum);
+        }
+        ASSERT_EQ(thread_arena.used(), used_before);
+        
+        // A wrong password garbles the compressed stream, so decryption fails cleanly
+        ASSERT_EQ(result.compression_algorithm, std::string("zstd"));
+        {
+            phantomvault::SecureArena::Scope scope(thread_arena);
+            phantomvault::SecureBuffer plaintext(&thread_arena);
+            bool ok = engine.decryptFile(result.encrypted_data, "wrong password", result.iv, result.salt,
+                                         result.compression_algorithm, result.original_size, plaintext, config);
+            ASSERT_FALSE(ok);
+            ASSERT_TRUE(plaintext.empty());
+        }
+        
+        // A pooled engine holds a file at the size limit without overflow mappings
+        EncryptionEngine pooled;
+        pooled.enableMemoryPooling();
+        ASSERT_TRUE(pooled.getMemoryPoolSize() >= 2 * EncryptionEngine::MAX_FILE_SIZE);
+        std::vector<uint8_t> largest(EncryptionEngine::MAX_FILE_SIZE);
+        std::mt19937 rng(49);
+        for (auto& byte : largest) {
+            byte = static_cast<uint8_t>(rng() % 64);  // compressed copy still fits one XTS data unit
+        }
+        {
+            std::ofstream file(test_file, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(largest.data()), largest.size());
+        }
+        auto large_result = pooled.encryptFile(test_file, "arena password", config);
+        fs::remove(test_file);
+        ASSERT_TRUE(large_result.success);
+        {
+            phantomvault::SecureArena& pool = pooled.scratchArena();
+            phantomvault::SecureArena::Scope scope(pool);
+            phantomvault::SecureBuffer plaintext(&pool);
+            ASSERT_TRUE(pooled.decryptFile(large_result.encrypted_data, "arena password", large_result.iv,
+                                           large_result.salt, large_result.compression_algorithm,
+                                           large_result.original_size, plaintext, config));
+            ASSERT_EQ(pool.overflowBytes(), static_cast<size_t>(0));
+            ASSERT_TRUE(plaintext.size() == largest.size() && std::equal(plaintext.begin(), plaintext.end(), largest.begin()));
+        }
+        ASSERT_EQ(pooled.scratchArena().used(), static_cast<size_t>(0));
+    }
+    
+    static void testFolderIndexLookup() {
+        std::string index_path = "./test_folder_index.pvx";
+        fs::remove(index_path);
+        
+        const int num_folders = 5000;
+        std::vector<FolderIndex::Entry> entries;
+        for (int i = 0; i < num_folders; ++i) {
+            FolderIndex::Entry entry;
+            entry.identifier = "obf_" + std::to_string(i);
+            entry.metadata.original_path = "/home/user/folder_" + std::to_string(i);
+            entry.metadata.permissions = 0755;
+            entry.stamp.size = static_cast<uint64_t>(i);
+            entries.push_back(std::move(entry));
+        }
+        
+        FolderIndex index;
+        ASSERT_TRUE(index.rewrite(index_path, entries, 1));
+        ASSERT_EQ(index.size(), static_cast<size_t>(num_folders));
+        
+        // In-place updates survive a reopen and carry the new generation
+        FolderMetadata moved;
+        moved.original_path = "/home/user/moved";
+        moved.permissions = 0700;
+        ASSERT_TRUE(index.put("obf_42", moved, FolderIndex::SourceStamp{}, 2));
+        ASSERT_TRUE(index.erase("obf_43", 3));
+        
+        FolderIndex reopened;
+        ASSERT_TRUE(reopened.open(index_path));
+        ASSERT_EQ(reopened.getGeneration(), 3);
+        ASSERT_EQ(reopened.lookup("obf_42")->original_path, "/home/user/moved");
+        ASSERT_FALSE(reopened.contains("obf_43"));
+        
+        PerformanceTimer timer;
+        size_t found = 0;
+        for (int i = 0; i < num_folders; ++i) {
+            if (reopened.lookup("obf_" + std::to_string(i))) {
+                found++;
+            }
+        }
+        double us_per_lookup = timer.elapsedNanos().count() / 1000.0 / num_folders;
+        std::cout << "    folder index: " << us_per_lookup << " us/lookup over "
+                  << num_folders << " folders" << std::endl;
+        
+        ASSERT_EQ(found, static_cast<size_t>(num_folders - 1));
+        ASSERT_TRUE(us_per_lookup < 50.0);
+        
+        ASSERT_TRUE(reopened.compact());
+        ASSERT_EQ(reopened.getDeadBytes(), 0);
+        
+        reopened.close();
+        index.close();
+        fs::remove(index_path);
+    }
+    
+    static void testSegmentStoreSmallFiles() {
+        std::string loose_dir = "./test_segment_loose";
+        std::string pack_dir = "./test_segment_pack";
+        fs::remove_all(loose_dir);
+        fs::remove_all(pack_dir);
+        
+        const int num_files = 5000;
+        std::string record(256, 'e');
+        
+        // Baseline: one file per encrypted object
+        PerformanceTimer loose_timer;
+        for (int i = 0; i < num_files; ++i) {
+            std::string path = loose_dir + "/d" + std::to_string(i % 50) + "/f" + std::to_string(i) + ".enc";
+            fs::create_directories(fs::path(path).parent_path());
+            std::ofstream file(path, std::ios::binary);
+            file << record;
+            file.close();
+            fs::permissions(path, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace);
+        }
+        double loose_ms = loose_timer.elapsedMicros().count() / 1000.0;
+        
+        PerformanceTimer pack_timer;
+        SegmentStore pack;
+        ASSERT_TRUE(pack.create(pack_dir));
+        for (int i = 0; i < num_files; ++i) {
+            ASSERT_TRUE(pack.append("d" + std::to_string(i % 50) + "/f" + std::to_string(i), record));
+        }
+        ASSERT_TRUE(pack.commit());
+        double pack_ms = pack_timer.elapsedMicros().count() / 1000.0;
+        
+        std::cout << "    " << num_files << " small files: loose " << loose_ms << " ms, packed "
+                  << pack_ms << " ms" << std::endl;
+        
+        SegmentStore reader;
+        ASSERT_TRUE(reader.open(pack_dir));
+        ASSERT_EQ(reader.getObjectCount(), static_cast<size_t>(num_files));
+        ASSERT_EQ(*reader.read("d7/f4057"), record);
+        ASSERT_FALSE(reader.read("missing").has_value());
+        ASSERT_TRUE(pack_ms < loose_ms);
+        
+        fs::remove_all(loose_dir);
+        fs::remove_all(pack_dir);
+    }
+    
+    static void testMerkleTreeRecreatedPack() {
+        std::string pack_dir = "./test_merkle_recreated";
+        fs::remove_all(pack_dir);
+        std::string tree_path = pack_dir + "/" + MerkleTree::kFileName;
+        
+        auto writePack = [&](char fill) {
+            SegmentStore pack;
+            ASSERT_TRUE(pack.create(pack_dir));
+            for (int i = 0; i < 64; ++i) {
+                ASSERT_TRUE(pack.append("f" + std::to_string(i), std::string(512, fill)));
+            }
+            ASSERT_TRUE(pack.commit());
+        };
+        
+        writePack('a');
+        MerkleTree first;
+        ASSERT_TRUE(first.build(pack_dir));
+        ASSERT_TRUE(first.save(tree_path));
+        
+        // A later lock recreates the pack with every object at the same offset
+        // and length; the leaves loaded from the old tree must not be reused
+        writePack('b');
+        MerkleTree second;
+        ASSERT_TRUE(second.load(tree_path));
+        ASSERT_TRUE(second.build(pack_dir));
+        ASSERT_NE(second.getRootHex(), first.getRootHex());
+        ASSERT_TRUE(second.verify(pack_dir).success);
+        
+        // Reopening the same store keeps its generation, so an unchanged rebuild matches
+        ASSERT_TRUE(second.save(tree_path));
+        MerkleTree third;
+        ASSERT_TRUE(third.load(tree_path));
+        ASSERT_TRUE(third.build(pack_dir));
+        ASSERT_EQ(third.getRootHex(), second.getRootHex());
+        
+        fs::remove_all(pack_dir);
+    }
+    
+    static void testSecureWipeThroughput() {
+        std::string wipe_dir = "./test_secure_wipe";
+        fs::remove_all(wipe_dir);
+        fs::create_directories(wipe_dir);
+        
+        const int num_files = 64;
+        const size_t file_size = 256 * 1024;
+        std::string plaintext(file_size, 'P');
+        for (int i = 0; i < num_files; ++i) {
+            std::ofstream file(wipe_dir + "/file_" + std::to_string(i), std::ios::binary);
+            file << plaintext;
+        }
+        
+        for (size_t threads : {size_t(1), size_t(4)}) {
+            WipeConfig config;
+            config.policy = WipePolicy::THREE_PASS;
+            config.threads = threads;
+            SecureWipeEngine engine(config);
+            
+            PerformanceTimer timer;
+            WipeResult result = engine.wipeDirectory(wipe_dir);
+            double seconds = timer.elapsedMicros().count() / 1e6;
+            double mb_per_second = (result.bytesOverwritten / (1024.0 * 1024.0)) / seconds;
+            std::cout << "    secure wipe (" << threads << " threads, 3 passes): "
+                      << mb_per_second << " MB/s" << std::endl;
+            
+            ASSERT_TRUE(result.success);
+            ASSERT_EQ(result.filesWiped, static_cast<size_t>(num_files));
+            ASSERT_EQ(result.bytesOverwritten, static_cast<uint64_t>(num_files) * file_size * 3);
+        }
+        
+        // Overwritten in place: same size, none of the original bytes left
+        std::ifstream wiped(wipe_dir + "/file_7", std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(wiped)), std::istreambuf_iterator<char>());
+        ASSERT_EQ(contents.size(), file_size);
+        ASSERT_TRUE(contents.find(std::string(64, 'P')) == std::string::npos);
+        
+        fs::remove_all(wipe_dir);
+    }
+    
+    static void testChecksumThroughput() {
+        std::string checksum_dir = "./test_checksums";
+        fs::remove_all(checksum_dir);
+        fs::create_directories(checksum_dir);
+        
+        // One large file, hashed as a whole
+        const size_t large_size = 64 * 1024 * 1024;
+        auto large_data = generateTestData(large_size);
+        std::string large_file = checksum_dir + "/large.bin";
+        {
+            std::ofstream file(large_file, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(large_data.data()), large_data.size());
+        }
+        
+        ChecksumEngine engine;
+        for (auto algorithm : {ChecksumAlgorithm::SHA256, ChecksumAlgorithm::BLAKE3}) {
+            PerformanceTimer timer;
+            std::string checksum = engine.hashFile(large_file, algorithm);
+            double seconds = timer.elapsedMicros().count() / 1e6;
+            std::cout << "    " << checksumAlgorithmName(algorithm) << " large file: "
+                      << (large_size / (1024.0 * 1024.0)) / seconds << " MB/s" << std::endl;
+            ASSERT_EQ(checksum, engine.hashBuffer(large_data.data(), large_data.size(), algorithm));
+        }
+        
+        // Many small files, hashed as a batch
+        const int num_files = 2000;
+        const size_t small_size = 8 * 1024;
+        std::vector<std::string> small_files;
+        for (int i = 0; i < num_files; ++i) {
+            small_files.push_back(checksum_dir + "/small_" + std::to_string(i));
+            std::ofstream file(small_files.back(), std::ios::binary);
+            file.write(reinterpret_cast<const char*>(large_data.data() + i * small_size), small_size);
+        }
+        
+        for (auto algorithm : {ChecksumAlgorithm::SHA256, ChecksumAlgorithm::BLAKE3}) {
+            PerformanceTimer timer;
+            auto checksums = engine.hashFiles(small_files, algorithm);
+            double seconds = timer.elapsedMicros().count() / 1e6;
+            std::cout << "    " << checksumAlgorithmName(algorithm) << " small files: "
+                      << num_files / seconds << " files/s" << std::endl;
+            ASSERT_EQ(checksums.size(), small_files.size());
+            ASSERT_EQ(checksums[17], engine.hashFile(small_files[17], algorithm));
+        }
+        
+        fs::remove_all(checksum_dir);
+    }
+    
+    static void testPasswordMatcherThroughput() {
+        PasswordPatternMatcher matcher;
+        PatternMatch match;
+        
+        // Tokens end on whitespace; backspace steps back one character
+        std::vector<PatternMatch> found;
+        std::string typed = "T+Secret1 P+ab\bc ok Passw0rd plain words ab+cdef1";
+        for (char c : typed) {
+            if (c == '\b') {
+                matcher.backspace();
+            } else if (matcher.feed(c, match)) {
+                found.push_back(match);
+                ASSERT_TRUE(found.size() != 1 || match.password == "Secret1");
+                ASSERT_TRUE(found.size() != 2 || match.password == "ac");
+            }
+        }
+        ASSERT_TRUE(matcher.finish(match) == false);
+        ASSERT_EQ(found.size(), static_cast<size_t>(3));
+        ASSERT_TRUE(found[0].kind == PatternKind::TEMPORARY);
+        ASSERT_TRUE(found[1].kind == PatternKind::PERMANENT);
+        ASSERT_TRUE(found[2].kind == PatternKind::DEFAULT);
+        
+        // Streaming keys per second over a typical unlock session
+        const std::string session = "hello T+Secret1 world P+Passw0rd x9 ";
+        const size_t rounds = 200000;
+        size_t matches = 0;
+        
+        PerformanceTimer timer;
+        for (size_t round = 0; round < rounds; ++round) {
+            for (char c : session) {
+                matches += matcher.feed(c, match) ? 1 : 0;
+            }
+        }
+        double seconds = timer.elapsedMicros().count() / 1e6;
+        double keys = static_cast<double>(rounds * session.size());
+        
+        std::cout << "    Password matcher: " << keys / seconds / 1e6 << " M keys/s" << std::endl;
+        ASSERT_EQ(matches, rounds * 2);
+    }
+    
+    static void testSchedulerIdleWakeups() {
+        AdaptiveScheduler scheduler(nullptr);
+        
+        // Periodic and one-shot tasks fire on time
+        std::atomic<int> periodic_runs{0};
+        std::atomic<int> delayed_runs{0};
+        auto periodic = scheduler.scheduleTask([&]() { periodic_runs++; }, std::chrono::milliseconds(50));
+        scheduler.scheduleDelayedTask([&]() { delayed_runs++; }, std::chrono::milliseconds(120));
+        std::this_thread::sleep_for(std::chrono::milliseconds(530));
+        ASSERT_TRUE(periodic_runs >= 8 && periodic_runs <= 10);
+        ASSERT_EQ(delayed_runs.load(), 1);
+        
+        // Cancelled tasks never run again
+        ASSERT_TRUE(scheduler.cancelTask(periodic));
+        int runs_at_cancel = periodic_runs;
+        std::this_thread::sleep_for(std::chrono::milliseconds(120));
+        ASSERT_EQ(periodic_runs.load(), runs_at_cancel);
+        
+        // Long-interval tasks, like the hourly cleanups, cost no idle wakeups
+        scheduler.scheduleTask([]() {}, std::chrono::hours(1), -1);
+        scheduler.scheduleTask([]() {}, std::chrono::minutes(5), -1);
+        scheduler.scheduleTask([]() {}, std::chrono::seconds(30));
+        size_t wakeups_before = scheduler.getWakeupCount();
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+        size_t idle_wakeups = scheduler.getWakeupCount() - wakeups_before;
+        std::cout << "    Idle wakeups over 2 s: " << idle_wakeups << std::endl;
+        ASSERT_TRUE(idle_wakeups <= 3);
+        
+        // Shutdown does not wait for the next deadline
+        PerformanceTimer timer;
+        scheduler.shutdown();
+        auto shutdown_micros = timer.elapsedMicros().count();
+        std::cout << "    Scheduler shutdown: " << shutdown_micros << " us" << std::endl;
+        ASSERT_TRUE(shutdown_micros < 100000);
+    }
+    
+    static void testResourceLimiterBuckets() {
+        ResourceLimiter limiter;
+        
+        // 4 MB/s with a 1 MB burst: 3 MB takes about half a second
+        limiter.setIOLimit(4 * 1024 * 1024);
+        PerformanceTimer io_timer;
+        for (int i = 0; i < 48; ++i) {
+            limiter.recordIO(64 * 1024);
+            limiter.enforceIOLimit();
+        }
+        auto io_millis = io_timer.elapsedMicros().count() / 1000;
+        std::cout << "    3 MB at 4 MB/s: " << io_millis << " ms" << std::endl;
+        ASSERT_TRUE(io_millis >= 400 && io_millis < 900);
+        ASSERT_FALSE(limiter.checkIOLimit(2 * 1024 * 1024));
+        
+        // 25% of a core with a 125 ms burst: 200 ms of CPU needs at least 300 ms
+        limiter.setCPULimit(25.0);
+        PerformanceTimer cpu_timer;
+        auto cpu_start = std::clock();
+        volatile uint64_t sink = 0;
+        while (std::clock() - cpu_start < CLOCKS_PER_SEC / 5) {
+            for (int i = 0; i < 100000; ++i) {
+                sink = sink + i;
+            }
+            limiter.enforceCPULimit();
+        }
+        auto cpu_millis = cpu_timer.elapsedMicros().count() / 1000;
+        std::cout << "    200 ms CPU at 25%: " << cpu_millis << " ms" << std::endl;
+        ASSERT_TRUE(cpu_millis >= 250);
+        
+        // Unlimited again
+        limiter.setIOLimit(0);
+        limiter.setCPULimit(0.0);
+        ASSERT_TRUE(limiter.checkIOLimit(SIZE_MAX));
+        ASSERT_TRUE(limiter.checkCPULimit());
+    }
+    
+    static void testMetricsHistoryRing() {
+        // Records carry their index in every field, so a torn read shows up
+        auto makeSample = [](uint64_t index) {
+            MetricsSample sample;
+            sample.timestampMs = 1000000 + index;
+            sample.cpuAverage = static_cast<uint16_t>(index);
+            sample.memoryKB = static_cast<uint32_t>(index);
+            return sample;
+        };
+        
+        MetricsHistory history(1000);
+        const uint64_t total = 200000;
+        std::atomic<bool> done{false};
+        std::atomic<int> bad_snapshots{0};
+        std::thread reader([&]() {
+            while (!done) {
+                auto samples = history.snapshot();
+                for (size_t i = 0; i < samples.size(); ++i) {
+                    uint64_t index = samples[i].timestampMs - 1000000;
+                    bool consistent = samples[i].cpuAverage == static_cast<uint16_t>(index) &&
+                                      samples[i].memoryKB == static_cast<uint32_t>(index);
+                    bool ordered = i == 0 || samples[i].timestampMs > samples[i - 1].timestampMs;
+                    if (!consistent || !ordered) {
+                        bad_snapshots++;
+                        break;
+                    }
+                }
+            }
+        });
+        
+        PerformanceTimer timer;
+        for (uint64_t i = 0; i < total; ++i) {
+            history.append(makeSample(i));
+        }
+        auto append_micros = timer.elapsedMicros().count();
+        done = true;
+        reader.join();
+        
+        std::cout << "    Append: " << (append_micros * 1000.0 / total) << " ns per record" << std::endl;
+        ASSERT_EQ(bad_snapshots.load(), 0);
+        ASSERT_EQ(history.size(), static_cast<size_t>(1000));
+        auto last = history.snapshot();
+        ASSERT_EQ(last.size(), static_cast<size_t>(1000));
+        ASSERT_EQ(last.back().timestampMs, 1000000 + total - 1);
+        
+        // A file-backed ring keeps its records across reopen
+        std::string path = (fs::temp_directory_path() / "phantomvault_metrics_history_test.bin").string();
+        fs::remove(path);
+        {
+            MetricsHistory persistent(64);
+            ASSERT_TRUE(persistent.open(path));
+            for (uint64_t i = 0; i < 100; ++i) {
+                persistent.append(makeSample(i));
+            }
+            ASSERT_TRUE(persistent.flush());
+        }
+        MetricsHistory reopened(64);
+        ASSERT_TRUE(reopened.open(path));
+        auto restored = reopened.snapshot();
+        ASSERT_EQ(restored.size(), static_cast<size_t>(64));
+        ASSERT_EQ(restored.front().timestampMs, static_cast<uint64_t>(1000000 + 36));
+        
+        // Only records newer than the cutoff
+        auto recent = reopened.snapshot(std::chrono::system_clock::time_point(std::chrono::milliseconds(1000000 + 89)));
+        ASSERT_EQ(recent.size(), static_cast<size_t>(10));
+        fs::remove(path);
+    }
+    
+    static void testInstrumentationOverhead() {
+        // Every value lands in a bucket that contains it, within 6.25%
+        std::mt19937_64 rng(42);
+        for (int i = 0; i < 100000; ++i) {
+            uint64_t value = rng() >> (rng() % 64);
+            size_t bucket = LatencyHistogram::bucketFor(value);
+            ASSERT_TRUE(bucket < LatencyHistogram::kBucketCount);
+            if (value < (1ULL << LatencyHistogram::kMaxExponent)) {
+                ASSERT_TRUE(LatencyHistogram::bucketLowerBound(bucket) <= value);
+                ASSERT_TRUE(value < LatencyHistogram::bucketUpperBound(bucket));
+            }
+        }
+        
+        LatencyHistogram histogram;
+        for (uint64_t nanos = 1; nanos <= 100000; ++nanos) {
+            histogram.record(nanos);
+        }
+        ASSERT_TRUE(histogram.percentile(0.5) >= 50000 && histogram.percentile(0.5) <= 53125);
+        ASSERT_TRUE(histogram.percentile(0.99) >= 99000 && histogram.percentile(0.99) <= 105188);
+        
+        // Shards of exited threads are kept
+        Instrumentation::reset();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([]() {
+                for (int i = 0; i < 1000; ++i) {
+                    ScopedSpan span(Operation::WRITE);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        ASSERT_EQ(Instrumentation::snapshot(Operation::WRITE).count(), static_cast<uint64_t>(4000));
+        
+        // Sums are exported to the nanosecond, however long they grow
+        Instrumentation::record(Operation::KDF, std::chrono::nanoseconds(123456789012345LL));
+        std::string text = Instrumentation::prometheusText();
+        ASSERT_TRUE(text.find("phantomvault_operation_duration_seconds_count{operation=\"write\"} 4000") != std::string::npos);
+        ASSERT_TRUE(text.find("phantomvault_operation_duration_seconds_sum{operation=\"kdf\"} 123456.789012345\n") != std::string::npos);
+        
+        // Cheap enough to leave on
+        const int spans = 1000000;
+        PerformanceTimer timer;
+        for (int i = 0; i < spans; ++i) {
+            ScopedSpan span(Operation::READ);
+        }
+        double span_nanos = timer.elapsedMicros().count() * 1000.0 / spans;
+        std::cout << "    ScopedSpan: " << span_nanos << " ns" << std::endl;
+        ASSERT_EQ(Instrumentation::snapshot(Operation::READ).count(), static_cast<uint64_t>(spans));
+        ASSERT_TRUE(span_nanos < 250.0);
+        Instrumentation::reset();
+    }
+    
+    static void testTraceRecorderExport() {
+        // Nothing is kept while not recording
+        TraceRecorder::start(256);
+        TraceRecorder::stop();
+        {
+            TraceSpan span("idle");
+        }
+        ASSERT_EQ(TraceRecorder::eventCount(), static_cast<size_t>(0));
+        
+        // One complete event per span per thread; a full buffer drops and counts
+        TraceRecorder::start(256);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([]() {
+                for (int i = 0; i < 100; ++i) {
+                    TraceSpan stage("stage");
+                    ScopedSpan span(Operation::ENCRYPT);
+                }
+            });
+        }
+        for (int i = 0; i < 300; ++i) {
+            TraceSpan stage("main");
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        TraceRecorder::stop();
+        ASSERT_EQ(TraceRecorder::eventCount(), static_cast<size_t>(4 * 200 + 256));
+        ASSERT_EQ(TraceRecorder::droppedCount(), static_cast<uint64_t>(44));
+        
+        std::string json = TraceRecorder::chromeTraceJson();
+        ASSERT_TRUE(json.find("\"traceEvents\":[") != std::string::npos);
+        ASSERT_TRUE(json.find("{\"name\":\"encrypt\",\"cat\":\"operation\",\"ph\":\"X\"") != std::string::npos);
+        ASSERT_TRUE(json.find("\"droppedEvents\":44") != std::string::npos);
+        size_t complete_events = 0;
+        for (size_t at = json.find("\"ph\":\"X\""); at != std::string::npos; at = json.find("\"ph\":\"X\"", at + 1)) {
+            ++complete_events;
+        }
+        ASSERT_EQ(complete_events, static_cast<size_t>(4 * 200 + 256));
+        
+        // Recording costs a fraction of even the smallest vault operation
+        const int spans = 200000;
+        TraceRecorder::start(spans);
+        PerformanceTimer timer;
+        for (int i = 0; i < spans; ++i) {
+            TraceSpan span("bench");
+        }
+        double span_nanos = timer.elapsedMicros().count() * 1000.0 / spans;
+        TraceRecorder::stop();
+        std::cout << "    TraceSpan: " << span_nanos << " ns" << std::endl;
+        ASSERT_EQ(TraceRecorder::eventCount(), static_cast<size_t>(spans));
+        ASSERT_TRUE(span_nanos < 500.0);
+        TraceRecorder::start(1);
+        TraceRecorder::stop();
+    }
+    
+    static uint64_t rollupTotal(const EventRollups& rollups, int64_t start, int64_t end, int64_t now,
+                                const std::string& profileId = "alice") {
+        auto perProfile = rollups.aggregate(start, end, now);
+        auto it = perProfile.find(profileId);
+        if (it == perProfile.end()) {
+            return 0;
+        }
+        uint64_t total = 0;
+        for (auto count : it->second) {
+            total += count;
+        }
+        return total;
+    }
+    
+    static void testAnalyticsRollupBoundaries() {
+        using std::chrono::seconds;
+        using std::chrono::system_clock;
+        const int64_t day = 20000LL * 86400;
+        const int64_t now = day + 12 * 3600;
+        auto at = [](int64_t t) { return system_clock::time_point(seconds(t)); };
+        
+        // First and last second of the first minute and the first hour
+        EventRollups rollups;
+        for (int64_t offset : {0, 59, 60, 3599, 3600}) {
+            rollups.record(EventType::FOLDER_LOCKED, "alice", at(day + offset));
+        }
+        rollups.record(EventType::FOLDER_LOCKED, "bob", at(day + 30));
+        rollups.record(EventType::FOLDER_LOCKED, "alice", at(day - 1));
+        
+        // End is exclusive at every tier
+        ASSERT_EQ(rollupTotal(rollups, day, day + 60, now), static_cast<uint64_t>(2));
+        ASSERT_EQ(rollupTotal(rollups, day, day + 3600, now), static_cast<uint64_t>(4));
+        ASSERT_EQ(rollupTotal(rollups, day, day + 3601, now), static_cast<uint64_t>(5));
+        ASSERT_EQ(rollupTotal(rollups, day, day + 86400, now), static_cast<uint64_t>(5));
+        
+        // Unaligned starts fall back to minute buckets
+        ASSERT_EQ(rollupTotal(rollups, day + 60, day + 3600, now), static_cast<uint64_t>(2));
+        ASSERT_EQ(rollupTotal(rollups, day - 60, day + 60, now), static_cast<uint64_t>(3));
+        ASSERT_EQ(rollupTotal(rollups, day - 86400, day + 86400, now), static_cast<uint64_t>(6));
+        
+        // Profiles are counted separately
+        ASSERT_EQ(rollupTotal(rollups, day, day + 86400, now, "bob"), static_cast<uint64_t>(1));
+        rollups.removeProfile("bob");
+        ASSERT_EQ(rollupTotal(rollups, day, day + 86400, now, "bob"), static_cast<uint64_t>(0));
+        
+        // Persisted rollups answer the same ranges
+        EventRollups restored;
+        restored.fromJson(rollups.toJson());
+        ASSERT_EQ(rollupTotal(restored, day, day + 3600, now), static_cast<uint64_t>(4));
+        ASSERT_EQ(rollupTotal(restored, day + 60, day + 3600, now), static_cast<uint64_t>(2));
+    }
+    
+    static void testAnalyticsRollupRetention() {
+        using std::chrono::seconds;
+        using std::chrono::system_clock;
+        const int64_t now = 20000LL * 86400 + 12 * 3600;
+        auto at = [](int64_t t) { return system_clock::time_point(seconds(t)); };
+        const int64_t threeDaysAgo = now - 3 * 86400;
+        const int64_t hundredDaysAgo = now - 100 * 86400;
+        const int64_t eightHundredDaysAgo = now - 800 * 86400;
+        
+        EventRollups rollups;
+        rollups.record(EventType::PROFILE_AUTH_FAILED, "alice", at(now - 60));
+        rollups.record(EventType::PROFILE_AUTH_FAILED, "alice", at(threeDaysAgo));
+        rollups.record(EventType::PROFILE_AUTH_FAILED, "alice", at(hundredDaysAgo));
+        rollups.record(EventType::PROFILE_AUTH_FAILED, "alice", at(eightHundredDaysAgo));
+        rollups.prune(now);
+        
+        // Each tier keeps buckets only as far back as its retention
+        const auto& tiers = rollups.tiers();
+        auto holds = [](const EventRollups::Tier& tier, int64_t t) {
+            return tier.buckets.count(EventRollups::floorTo(t, tier.width)) != 0;
+        };
+        const auto& dayTier = tiers[0];
+        const auto& hourTier = tiers[1];
+        const auto& minuteTier = tiers[2];
+        ASSERT_TRUE(holds(minuteTier, now - 60));
+        ASSERT_FALSE(holds(minuteTier, threeDaysAgo));
+        ASSERT_TRUE(holds(hourTier, threeDaysAgo));
+        ASSERT_FALSE(holds(hourTier, hundredDaysAgo));
+        ASSERT_TRUE(holds(dayTier, hundredDaysAgo));
+        ASSERT_FALSE(holds(dayTier, eightHundredDaysAgo));
+        
+        // Older points are still answered, at the resolution that survived
+        int64_t oldDay = EventRollups::floorTo(hundredDaysAgo, 86400);
+        ASSERT_EQ(rollupTotal(rollups, oldDay, oldDay + 86400, now), static_cast<uint64_t>(1));
+        ASSERT_EQ(rollupTotal(rollups, hundredDaysAgo - 10, hundredDaysAgo + 10, now), static_cast<uint64_t>(1));
+        int64_t oldHour = EventRollups::floorTo(threeDaysAgo, 3600);
+        ASSERT_EQ(rollupTotal(rollups, oldHour, oldHour + 60, now), static_cast<uint64_t>(1));
+        ASSERT_EQ(rollupTotal(rollups, eightHundredDaysAgo - 86400, eightHundredDaysAgo + 86400, now), static_cast<uint64_t>(0));
+        ASSERT_EQ(rollupTotal(rollups, eightHundredDaysAgo, now + 1, now), static_cast<uint64_t>(3));
+        
+        // Pruning twice is a no-op
+        rollups.prune(now);
+        ASSERT_EQ(rollupTotal(rollups, eightHundredDaysAgo, now + 1, now), static_cast<uint64_t>(3));
+    }
+    
+    static void testEventQueueOverflowPolicies() {
+        // DROP_OLDEST: a full queue keeps the newest events, in order
+        BoundedEventQueue<int> dropOldest(8, OverflowPolicy::DROP_OLDEST);
+        for (int i = 0; i < 20; ++i) {
+            ASSERT_TRUE(dropOldest.push(int(i)));
+        }
+        std::vector<int> kept;
+        dropOldest.drain(kept);
+        ASSERT_EQ(kept.size(), static_cast<size_t>(8));
+        for (size_t i = 0; i < kept.size(); ++i) {
+            ASSERT_EQ(kept[i], static_cast<int>(12 + i));
+        }
+        ASSERT_EQ(dropOldest.getStats().droppedOldest, static_cast<uint64_t>(12));
+        
+        // SAMPLE: past three quarters full only 1 in N gets in, and a full queue drops
+        BoundedEventQueue<int> sample(16, OverflowPolicy::SAMPLE);
+        sample.setSampleRate(4);
+        size_t accepted = 0;
+        for (int i = 0; i < 100; ++i) {
+            accepted += sample.push(int(i)) ? 1 : 0;
+        }
+        auto sampleStats = sample.getStats();
+        ASSERT_EQ(accepted, static_cast<size_t>(16));
+        ASSERT_EQ(sampleStats.enqueued, static_cast<uint64_t>(16));
+        ASSERT_TRUE(sampleStats.sampledOut > 0);
+        ASSERT_EQ(sampleStats.sampledOut + sampleStats.droppedNewest, static_cast<uint64_t>(100 - 16));
+        std::vector<int> sampled;
+        sample.drain(sampled);
+        ASSERT_TRUE(std::is_sorted(sampled.begin(), sampled.end()));
+        
+        // BLOCK without a consumer gives up after the timeout
+        BoundedEventQueue<int> block(4, OverflowPolicy::BLOCK);
+        block.setBlockTimeout(std::chrono::milliseconds(20));
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(block.push(int(i)));
+        }
+        PerformanceTimer timer;
+        ASSERT_FALSE(block.push(4));
+        auto waited_millis = timer.elapsedMicros().count() / 1000;
+        ASSERT_TRUE(waited_millis >= 15 && waited_millis < 1000);
+        ASSERT_EQ(block.getStats().droppedNewest, static_cast<uint64_t>(1));
+        
+        // BLOCK with a consumer loses nothing
+        block.setBlockTimeout(std::chrono::milliseconds(5000));
+        std::vector<int> received;
+        block.drain(received);
+        std::atomic<bool> producing{true};
+        std::thread consumer([&]() {
+            while (producing || block.sizeApprox() > 0) {
+                block.waitForItems(std::chrono::milliseconds(10));
+                block.drain(received);
+            }
+        });
+        for (int i = 4; i < 2000; ++i) {
+            ASSERT_TRUE(block.push(int(i)));
+        }
+        producing = false;
+        block.wake();
+        consumer.join();
+        ASSERT_EQ(received.size(), static_cast<size_t>(2000));
+        for (size_t i = 0; i < received.size(); ++i) {
+            ASSERT_EQ(received[i], static_cast<int>(i));
+        }
+        ASSERT_TRUE(block.getStats().blockedWaits > 0);
+    }
+    
+    static void testEventQueueConcurrentProducers() {
+        // Each value encodes producer and sequence; per-producer order must survive
+        const int producers = 4;
+        const int per_producer = 20000;
+        BoundedEventQueue<uint64_t> queue(256, OverflowPolicy::BLOCK);
+        queue.setBlockTimeout(std::chrono::milliseconds(5000));
+        
+        std::atomic<bool> running{true};
+        std::vector<uint64_t> applied;
+        std::thread writer([&]() {
+            while (running) {
+                queue.waitForItems();
+                uint64_t ticket = queue.beginConsumerPass();
+                queue.drain(applied);
+                queue.endConsumerPass(ticket);
+            }
+        });
+        
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p]() {
+                for (int i = 0; i < per_producer; ++i) {
+                    queue.push((static_cast<uint64_t>(p) << 32) | static_cast<uint64_t>(i));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        
+        // The barrier returns only after a pass that began after the call
+        ASSERT_TRUE(queue.waitForConsumer(std::chrono::milliseconds(5000)));
+        ASSERT_EQ(queue.sizeApprox(), static_cast<size_t>(0));
+        running = false;
+        queue.wake();
+        writer.join();
+        
+        ASSERT_EQ(applied.size(), static_cast<size_t>(producers * per_producer));
+        std::vector<int64_t> last(producers, -1);
+        for (uint64_t value : applied) {
+            int p = static_cast<int>(value >> 32);
+            int64_t seq = static_cast<int64_t>(value & 0xffffffffULL);
+            ASSERT_EQ(seq, last[p] + 1);
+            last[p] = seq;
+        }
+        auto stats = queue.getStats();
+        ASSERT_EQ(stats.enqueued, static_cast<uint64_t>(producers * per_producer));
+        ASSERT_EQ(stats.droppedNewest, static_cast<uint64_t>(0));
+        
+        // No consumer: the barrier times out instead of hanging
+        BoundedEventQueue<int> idle(8);
+        ASSERT_FALSE(idle.waitForConsumer(std::chrono::milliseconds(10)));
+        
+        // An untimed wait on an empty queue sleeps until wake()
+        BoundedEventQueue<int> empty(8);
+        std::atomic<bool> released{false};
+        std::thread sleeper([&]() {
+            empty.waitForItems();
+            released = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        bool released_early = released;
+        empty.wake();
+        sleeper.join();
+        ASSERT_FALSE(released_early);
+        ASSERT_TRUE(released);
+    }
+    
+    static void testAnalyticsConcurrentIngestion() {
+        std::string dataPath = (fs::temp_directory_path() / "phantomvault_analytics_ingest_test").string();
+        fs::remove_all(dataPath);
+        
+        AnalyticsEngine engine;
+        ASSERT_TRUE(engine.initialize(dataPath));
+        ASSERT_TRUE(engine.start());
+        
+        // Callbacks only ever run on the engine's writer thread
+        std::mutex callback_mutex;
+        std::set<std::thread::id> callback_threads;
+        engine.setEventCallback([&](const AnalyticsEvent&) {
+            std::lock_guard<std::mutex> lock(callback_mutex);
+            callback_threads.insert(std::this_thread::get_id());
+        });
+        
+        const int producers = 4;
+        const int per_producer = 500;
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&engine, p]() {
+                for (int i = 0; i < per_producer; ++i) {
+                    engine.logUsageEvent(EventType::FOLDER_LOCKED, "producer_" + std::to_string(p));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        
+        // A query after logging observes every event, sorted by timestamp
+        AnalyticsQuery query;
+        query.eventTypes = {EventType::FOLDER_LOCKED};
+        query.maxResults = SIZE_MAX;
+        auto events = engine.queryEvents(query);
+        ASSERT_EQ(events.size(), static_cast<size_t>(producers * per_producer));
+        ASSERT_TRUE(std::is_sorted(events.begin(), events.end(),
+            [](const AnalyticsEvent& a, const AnalyticsEvent& b) { return a.timestamp < b.timestamp; }));
+        
+        // Bisection from a middle timestamp returns exactly the later events
+        query.startTime = events[events.size() / 2].timestamp;
+        auto later = engine.queryEvents(query);
+        size_t expected = static_cast<size_t>(std::count_if(events.begin(), events.end(),
+            [&](const AnalyticsEvent& e) { return e.timestamp >= query.startTime; }));
+        ASSERT_EQ(later.size(), expected);
+        
+        auto stats = engine.getUsageStatistics();
+        ASSERT_EQ(stats.totalFolders, static_cast<size_t>(producers * per_producer));
+        
+        {
+            std::lock_guard<std::mutex> lock(callback_mutex);
+            ASSERT_EQ(callback_threads.size(), static_cast<size_t>(1));
+            ASSERT_EQ(callback_threads.count(std::this_thread::get_id()), static_cast<size_t>(0));
+        }
+        
+        engine.stop();
+        fs::remove_all(dataPath);
+    }
+    
+    static void testSecurityEventIngestionBlocks() {
+        std::string logDir = (fs::temp_directory_path() / "phantomvault_security_ingest_test").string();
+        fs::remove_all(logDir);
+        
+        const int producers = 4;
+        const int per_producer = 1500;
+        {
+            ErrorHandler handler;
+            ASSERT_TRUE(handler.initialize((fs::path(logDir) / "security.log").string()));
+            handler.setOverflowBlockTimeout(std::chrono::milliseconds(10000));
+            uint64_t before = handler.getIngestionStats().enqueued;
+            
+            // More events than the queue holds: producers wait instead of evicting
+            std::vector<std::thread> threads;
+            for (int p = 0; p < producers; ++p) {
+                threads.emplace_back([&handler, p]() {
+                    for (int i = 0; i < per_producer; ++i) {
+                        handler.logSecurityEvent(SecurityEventType::AUTHENTICATION_FAILURE, ErrorSeverity::WARNING,
+                                                 "producer_" + std::to_string(p), "ingest " + std::to_string(i));
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            
+            auto stats = handler.getIngestionStats();
+            ASSERT_EQ(stats.enqueued - before, static_cast<uint64_t>(producers * per_producer));
+            ASSERT_EQ(stats.droppedOldest, static_cast<uint64_t>(0));
+            ASSERT_EQ(stats.droppedNewest, static_cast<uint64_t>(0));
+        }
+        fs::remove_all(logDir);
+    }
+    
+    static void testSecurityEventStoreOutOfOrder() {
+        // Arrival order swaps neighbours, and one event arrives two chunks late
+        using std::chrono::seconds;
+        const auto base = std::chrono::system_clock::time_point(seconds(1700000000));
+        const size_t total = SecurityEventStore::kChunkCapacity * 3;
+        const size_t straggler = SecurityEventStore::kChunkCapacity * 2;
+        std::vector<SecurityEvent> events(total);
+        for (size_t i = 0; i < total; ++i) {
+            events[i].type = (i % 2 == 0) ? SecurityEventType::AUTHENTICATION_FAILURE : SecurityEventType::RATE_LIMIT_EXCEEDED;
+            events[i].profileId = "profile_" + std::to_string(i % 3);
+            events[i].description = std::to_string(i);
+            events[i].timestamp = base + seconds(i == straggler ? 10 : static_cast<int64_t>(i ^ 1));
+        }
+        SecurityEventStore store;
+        store.append(events);
+        
+        auto expected = [&](const std::string& profileId, SecurityEventType type, std::chrono::system_clock::time_point since) {
+            std::vector<SecurityEvent> matching;
+            for (const auto& event : events) {
+                if (event.type == type && event.timestamp >= since &&
+                    (profileId.empty() || event.profileId == profileId)) {
+                    matching.push_back(event);
+                }
+            }
+            std::stable_sort(matching.begin(), matching.end(),
+                [](const SecurityEvent& a, const SecurityEvent& b) { return a.timestamp < b.timestamp; });
+            std::vector<std::string> ids;
+            for (const auto& event : matching) {
+                ids.push_back(event.description);
+            }
+            return ids;
+        };
+        auto actual = [&](const std::string& profileId, SecurityEventType type, std::chrono::system_clock::time_point since) {
+            std::vector<std::string> ids;
+            auto results = store.query(profileId, type, since);
+            ASSERT_TRUE(std::is_sorted(results.begin(), results.end(),
+                [](const SecurityEvent& a, const SecurityEvent& b) { return a.timestamp < b.timestamp; }));
+            for (const auto& event : results) {
+                ids.push_back(event.description);
+            }
+            return ids;
+        };
+        
+        for (int64_t since : {0, 5, 10, 11, 4095, 4096, 8191, 8193, 12000, 12287, 20000}) {
+            for (auto type : {SecurityEventType::AUTHENTICATION_FAILURE, SecurityEventType::RATE_LIMIT_EXCEEDED}) {
+                for (const std::string profileId : {"", "profile_1"}) {
+                    auto want = expected(profileId, type, base + seconds(since));
+                    auto got = actual(profileId, type, base + seconds(since));
+                    ASSERT_VECTOR_EQ(want, got);
+                }
+            }
+        }
+        
+        // The late event is found even though everything around it is newer
+        auto late = store.query("", SecurityEventType::AUTHENTICATION_FAILURE, base + seconds(10));
+        ASSERT_FALSE(late.empty());
+        ASSERT_EQ(late.front().description, std::to_string(straggler));
+        
+        // The first chunk's last arrival is older than its newest event; it stays
+        ASSERT_EQ(store.pruneOlderThan(base + seconds(SecurityEventStore::kChunkCapacity - 1)), static_cast<size_t>(0));
+        ASSERT_EQ(store.query("", SecurityEventType::AUTHENTICATION_FAILURE, base + seconds(SecurityEventStore::kChunkCapacity - 1)).front().description,
+                  std::to_string(SecurityEventStore::kChunkCapacity - 2));
+        ASSERT_EQ(store.pruneOlderThan(base + seconds(SecurityEventStore::kChunkCapacity)), SecurityEventStore::kChunkCapacity);
+        ASSERT_EQ(store.size(), total - SecurityEventStore::kChunkCapacity);
+        
+        // The straggler's chunk holds newer events, so it survives a cutoff past the straggler
+        ASSERT_EQ(store.pruneOlderThan(base + seconds(2 * SecurityEventStore::kChunkCapacity)), SecurityEventStore::kChunkCapacity);
+        ASSERT_EQ(store.query("", SecurityEventType::AUTHENTICATION_FAILURE, base).front().description, std::to_string(straggler));
+        ASSERT_EQ(store.count(SecurityEventType::AUTHENTICATION_FAILURE), SecurityEventStore::kChunkCapacity / 2);
+    }
+    
+    static void testKeyboardLoopStopLatency() {
+        KeyboardSequenceDetector detector;
+        ASSERT_TRUE(detector.initialize());
+        
+        // The loop blocks with no timeout; stop() has to wake it, every time
+        for (int round = 0; round < 3; ++round) {
+            ASSERT_TRUE(detector.start());
+            ASSERT_TRUE(detector.isRunning());
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            
+            PerformanceTimer timer;
+            detector.stop();
+            auto stop_micros = timer.elapsedMicros().count();
+            std::cout << "    Keyboard loop stop: " << stop_micros << " us" << std::endl;
+            ASSERT_TRUE(stop_micros < 100000);
+            ASSERT_FALSE(detector.isRunning());
+        }
+    }
+    
+    static void testKeyboardSequenceTimeout() {
+        KeyboardSequenceDetector detector;
+        ASSERT_TRUE(detector.initialize());
+        
+        std::mutex mutex;
+        std::condition_variable fired;
+        int timeouts = 0;
+        detector.setOnSequenceTimeout([&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++timeouts;
+            fired.notify_all();
+        });
+        ASSERT_TRUE(detector.start());
+        
+        auto waitForTimeouts = [&](int count, std::chrono::milliseconds limit) {
+            std::unique_lock<std::mutex> lock(mutex);
+            return fired.wait_for(lock, limit, [&]() { return timeouts >= count; });
+        };
+        
+        // The timer fires once, close to the deadline, and ends the sequence
+        PerformanceTimer timer;
+        detector.activateSequenceDetection(1);
+        ASSERT_TRUE(detector.isSequenceDetectionActive());
+        ASSERT_TRUE(waitForTimeouts(1, std::chrono::milliseconds(3000)));
+        auto elapsed_ms = timer.elapsed().count();
+        std::cout << "    Sequence timeout after " << elapsed_ms << " ms" << std::endl;
+        ASSERT_TRUE(elapsed_ms >= 900 && elapsed_ms < 1500);
+        ASSERT_FALSE(detector.isSequenceDetectionActive());
+        
+        // Deactivating disarms the timer
+        detector.activateSequenceDetection(1);
+        detector.deactivateSequenceDetection();
+        ASSERT_FALSE(waitForTimeouts(2, std::chrono::milliseconds(1500)));
+        
+        // Reactivating re-arms it from the new start
+        detector.activateSequenceDetection(1);
+        ASSERT_TRUE(waitForTimeouts(2, std::chrono::milliseconds(3000)));
+        
+        detector.stop();
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(timeouts, 2);
+    }
+    
+    static void testKeyboardIdleWakeups() {
+        if (!fs::exists("/proc/self/task")) {
+            SKIP_TEST("needs /proc/self/task to count context switches");
+        }
+        
+        auto threadIds = []() {
+            std::set<std::string> ids;
+            for (const auto& entry : fs::directory_iterator("/proc/self/task")) {
+                ids.insert(entry.path().filename().string());
+            }
+            return ids;
+        };
+        auto voluntarySwitches = [](const std::set<std::string>& ids) {
+            uint64_t total = 0;
+            for (const auto& id : ids) {
+                std::ifstream status("/proc/self/task/" + id + "/status");
+                std::string line;
+                while (std::getline(status, line)) {
+                    if (line.rfind("voluntary_ctxt_switches:", 0) == 0) {
+                        total += std::stoull(line.substr(line.find(':') + 1));
+                    }
+                }
+            }
+            return total;
+        };
+        
+        KeyboardSequenceDetector detector;
+        ASSERT_TRUE(detector.initialize());
+        auto before = threadIds();
+        ASSERT_TRUE(detector.start());
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        
+        // Threads the detector started are the ones not present before
+        std::set<std::string> detector_threads;
+        for (const auto& id : threadIds()) {
+            if (!before.count(id)) {
+                detector_threads.insert(id);
+            }
+        }
+        ASSERT_FALSE(detector_threads.empty());
+        
+        // Idle, and with an active sequence, the loop sleeps until its deadline
+        uint64_t switches_before = voluntarySwitches(detector_threads);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        detector.activateSequenceDetection(10);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        uint64_t idle_switches = voluntarySwitches(detector_threads) - switches_before;
+        std::cout << "    Keyboard loop wakeups over 2 s: " << idle_switches << std::endl;
+        ASSERT_TRUE(idle_switches <= 2);
+        
+        detector.stop();
+    }
+    
     // Helper function to get current memory usage (simplified implementation)
     static size_t getCurrentMemoryUsage() {
         // This is a simplified implementation
@@ -11,6 +11,7 @@
 #include "../include/folder_security_manager.hpp"
 #include <filesystem>
 #include <fstream>
+#include <random>
 #include <thread>
 #include <chrono>
 
@@ -36,11 +37,15 @@ public:
         REGISTER_TEST(framework, "ProfileVault", "vault_creation_cleanup", testVaultCreationCleanup);
         REGISTER_TEST(framework, "ProfileVault", "concurrent_vault_access", testConcurrentVaultAccess);
         REGISTER_TEST(framework, "ProfileVault", "vault_integrity_checks", testVaultIntegrityChecks);
+        REGISTER_TEST(framework, "ProfileVault", "relock_changed_contents", testRelockChangedContents);
         
         // Folder operations tests
         REGISTER_TEST(framework, "ProfileVault", "folder_encryption_isolation", testFolderEncryptionIsolation);
         REGISTER_TEST(framework, "ProfileVault", "temporary_unlock_isolation", testTemporaryUnlockIsolation);
         REGISTER_TEST(framework, "ProfileVault", "permanent_unlock_cleanup", testPermanentUnlockCleanup);
+        REGISTER_TEST(framework, "ProfileVault", "interrupted_unlock_resume", testInterruptedUnlockResume);
+        REGISTER_TEST(framework, "ProfileVault", "interrupted_lock_resume", testInterruptedLockResume);
+        REGISTER_TEST(framework, "ProfileVault", "background_io_limit", testBackgroundIOLimit);
         
         // Security tests
         REGISTER_TEST(framework, "ProfileVault", "vault_metadata_protection", testVaultMetadataProtection);
@@ -405,6 +410,26 @@ private:
         // Get folder info to find vault location
         auto folder_info = vault.getFolderInfo(test_folder);
         ASSERT_TRUE(folder_info.has_value());
+        ASSERT_FALSE(folder_info->integrity_root.empty());
+        
+        // Encrypted contents check out against the Merkle tree, in full and sampled
+        ASSERT_TRUE(vault.verifyFolderContents(test_folder).success);
+        ASSERT_TRUE(vault.verifyFolderContents(test_folder, 0.5).success);
+        
+        // Flip one ciphertext byte; the scrub pins it to a single object
+        std::string segment_file = vault_root + "/integrity_test/folders/" + folder_info->vault_location + "/segment_00000.pack";
+        ASSERT_TRUE(fs::exists(segment_file));
+        {
+            std::fstream segment(segment_file, std::ios::in | std::ios::out | std::ios::binary);
+            segment.seekg(10);
+            char byte = 0;
+            segment.get(byte);
+            segment.seekp(10);
+            segment.put(static_cast<char>(byte ^ 0x01));
+        }
+        auto scrub_result = vault.verifyFolderContents(test_folder);
+        ASSERT_FALSE(scrub_result.success);
+        ASSERT_EQ(scrub_result.processed_files.size(), 1);
         
         // Corrupt vault metadata (simulate corruption)
         std::string metadata_file = vault_root + "/integrity_test/vault_metadata.json";
@@ -422,6 +447,50 @@ private:
         fs::remove_all(vault_root);
     }
     
+    static void testRelockChangedContents() {
+        std::string vault_root = "./test_relock_changed";
+        
+        if (fs::exists(vault_root)) {
+            fs::remove_all(vault_root);
+        }
+        
+        ProfileVault vault("relock_test", vault_root);
+        ASSERT_TRUE(vault.initialize());
+        
+        std::string test_folder = createTestFolder("relock", "Original relock content");
+        std::string master_key = "relock_master_key";
+        
+        ASSERT_TRUE(vault.lockFolder(test_folder, master_key).success);
+        ASSERT_TRUE(vault.verifyFolderContents(test_folder).success);
+        auto first_info = vault.getFolderInfo(test_folder);
+        ASSERT_TRUE(first_info.has_value());
+        
+        ASSERT_TRUE(vault.unlockFolder(test_folder, master_key, UnlockMode::PERMANENT).success);
+        
+        // Same sizes, so every object lands at the offset its predecessor had
+        {
+            std::ofstream file(test_folder + "/test_file.txt", std::ios::trunc);
+            file << "Changed relock content!";
+        }
+        {
+            std::ofstream file(test_folder + "/test_file2.txt", std::ios::trunc);
+            file << "Changed relock content! - file 2";
+        }
+        
+        ASSERT_TRUE(vault.lockFolder(test_folder, master_key).success);
+        auto second_info = vault.getFolderInfo(test_folder);
+        ASSERT_TRUE(second_info.has_value());
+        ASSERT_NE(first_info->integrity_root, second_info->integrity_root);
+        
+        auto scrub_result = vault.verifyFolderContents(test_folder);
+        ASSERT_TRUE(scrub_result.success);
+        ASSERT_TRUE(vault.validateVaultIntegrity());
+        
+        // Cleanup
+        cleanupTestFolder(test_folder);
+        fs::remove_all(vault_root);
+    }
+    
     static void testFolderEncryptionIsolation() {
         std::string vault_root = "./test_encryption_isolation";
         
@@ -567,6 +636,193 @@ private:
         fs::remove_all(vault_root);
     }
     
+    static void testInterruptedUnlockResume() {
+        std::string vault_root = "./test_interrupted_unlock";
+        
+        if (fs::exists(vault_root)) {
+            fs::remove_all(vault_root);
+        }
+        
+        ProfileVault vault("resume_test", vault_root);
+        ASSERT_TRUE(vault.initialize());
+        
+        std::string test_folder = createTestFolder("resume", "Interrupted unlock test");
+        std::string master_key = "resume_master_key";
+        
+        auto lock_result = vault.lockFolder(test_folder, master_key);
+        ASSERT_TRUE(lock_result.success);
+        ASSERT_TRUE(vault.getInterruptedOperations().empty());
+        
+        // Simulate a crash after the first file of an unlock was restored; the
+        // torn last line is a record that never finished its write
+        auto folder_info = vault.getFolderInfo(test_folder);
+        ASSERT_TRUE(folder_info.has_value());
+        {
+            std::ofstream journal(vault.getVaultPath() + "/journal/" + folder_info->vault_location + ".wal");
+            journal << "\n{\"type\":\"begin\",\"op\":\"unlock\",\"folder\":\"" << test_folder
+                    << "\",\"vault_location\":\"" << folder_info->vault_location
+                    << "\",\"mode\":\"temporary\",\"started\":0}\n";
+            journal << "\n{\"type\":\"files\",\"paths\":[\"test_file.txt\"],\"bytes\":1}\n";
+            journal << "\n{\"type\":\"fil";
+        }
+        ASSERT_EQ(vault.getInterruptedOperations().size(), 1);
+        
+        // A lock cannot start while the unlock is outstanding
+        auto relock_result = vault.lockFolder(test_folder, master_key);
+        ASSERT_FALSE(relock_result.success);
+        
+        // Unlocking again resumes, restoring only what was not yet done
+        auto unlock_result = vault.unlockFolder(test_folder, master_key, UnlockMode::TEMPORARY);
+        ASSERT_TRUE(unlock_result.success);
+        ASSERT_EQ(unlock_result.processed_files.size(), 1);
+        ASSERT_TRUE(fs::exists(test_folder + "/test_file2.txt"));
+        ASSERT_TRUE(vault.isFolderTemporarilyUnlocked(test_folder));
+        ASSERT_TRUE(vault.getInterruptedOperations().empty());
+        
+        // Locking leaves no per-file backup copies next to the originals
+        for (const auto& entry : fs::directory_iterator(test_folder)) {
+            ASSERT_TRUE(entry.path().filename().string().find(".backup_") == std::string::npos);
+        }
+        
+        // Cleanup
+        cleanupTestFolder(test_folder);
+        fs::remove_all(vault_root);
+    }
+    
+    static void testInterruptedLockResume() {
+        std::string vault_root = "./test_interrupted_lock";
+        
+        if (fs::exists(vault_root)) {
+            fs::remove_all(vault_root);
+        }
+        
+        ProfileVault vault("lock_resume_test", vault_root);
+        ASSERT_TRUE(vault.initialize());
+        
+        // Small files go into the pack; the incompressible one is too big for
+        // it and is written standalone as large.bin.enc
+        std::string test_folder = "./test_lock_resume_folder";
+        cleanupTestFolder(test_folder);
+        fs::create_directories(test_folder);
+        for (int i = 0; i < 8; ++i) {
+            std::ofstream file(test_folder + "/small_" + std::to_string(i) + ".txt");
+            file << "Interrupted lock test " << i;
+        }
+        std::string large_content(128 * 1024, '\0');
+        std::mt19937 rng(36);
+        for (auto& c : large_content) {
+            c = static_cast<char>(rng());
+        }
+        {
+            std::ofstream file(test_folder + "/large.bin", std::ios::binary);
+            file << large_content;
+        }
+        const size_t total_files = 9;
+        std::string master_key = "lock_resume_master_key";
+        
+        // Learn where the folder is stored, then release it again
+        ASSERT_TRUE(vault.lockFolder(test_folder, master_key).success);
+        auto folder_info = vault.getFolderInfo(test_folder);
+        ASSERT_TRUE(folder_info.has_value());
+        ASSERT_TRUE(vault.unlockFolder(test_folder, master_key, UnlockMode::PERMANENT).success);
+        
+        // A directory where large.bin.enc has to go makes the next lock fail
+        // at that file, after whatever was stored before it
+        std::string blocker = vault.getVaultPath() + "/folders/" + folder_info->vault_location + "/large.bin.enc";
+        fs::remove_all(blocker);
+        fs::create_directories(blocker);
+        
+        auto failed_lock = vault.lockFolder(test_folder, master_key);
+        ASSERT_FALSE(failed_lock.success);
+        ASSERT_EQ(vault.getInterruptedOperations().size(), 1);
+        ASSERT_FALSE(vault.isFolderLocked(test_folder));
+        ASSERT_TRUE(fs::exists(test_folder + "/large.bin"));
+        
+        // Locking again resumes, storing only what the first attempt did not
+        fs::remove_all(blocker);
+        auto resumed_lock = vault.lockFolder(test_folder, master_key);
+        ASSERT_TRUE(resumed_lock.success);
+        ASSERT_EQ(failed_lock.processed_files.size() + resumed_lock.processed_files.size(), total_files);
+        ASSERT_TRUE(vault.getInterruptedOperations().empty());
+        ASSERT_TRUE(vault.isFolderLocked(test_folder));
+        ASSERT_TRUE(vault.verifyFolderContents(test_folder).success);
+        
+        // Files from both attempts come back intact
+        ASSERT_TRUE(vault.unlockFolder(test_folder, master_key, UnlockMode::TEMPORARY).success);
+        for (int i = 0; i < 8; ++i) {
+            std::ifstream file(test_folder + "/small_" + std::to_string(i) + ".txt");
+            std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            ASSERT_EQ(content, "Interrupted lock test " + std::to_string(i));
+        }
+        std::ifstream large(test_folder + "/large.bin", std::ios::binary);
+        std::string restored((std::istreambuf_iterator<char>(large)), std::istreambuf_iterator<char>());
+        ASSERT_TRUE(restored == large_content);
+        
+        // Cleanup
+        cleanupTestFolder(test_folder);
+        fs::remove_all(vault_root);
+    }
+    
+    static void testBackgroundIOLimit() {
+        std::string vault_root = "./test_background_io_limit";
+        
+        if (fs::exists(vault_root)) {
+            fs::remove_all(vault_root);
+        }
+        
+        std::string test_folder = "./test_background_io_folder";
+        cleanupTestFolder(test_folder);
+        
+        // Scoped so the vault's log writers have stopped before the cleanup
+        {
+            ProfileVault vault("background_io_test", vault_root);
+            ASSERT_TRUE(vault.initialize());
+            vault.setBackgroundIOLimit(256 * 1024);
+            
+            fs::create_directories(test_folder);
+            std::string large_content(256 * 1024, '\0');
+            std::mt19937 rng(42);
+            for (auto& c : large_content) {
+                c = static_cast<char>(rng());
+            }
+            {
+                std::ofstream file(test_folder + "/large.bin", std::ios::binary);
+                file << large_content;
+            }
+            std::string master_key = "background_io_master_key";
+            
+            // A lock the user asked for is not paced by the background limit
+            auto start = std::chrono::steady_clock::now();
+            ASSERT_TRUE(vault.lockFolder(test_folder, master_key).success);
+            auto foreground = std::chrono::steady_clock::now() - start;
+            ASSERT_TRUE(foreground < std::chrono::seconds(1));
+            
+            auto folder_info = vault.getFolderInfo(test_folder);
+            ASSERT_TRUE(folder_info.has_value());
+            ASSERT_TRUE(vault.unlockFolder(test_folder, master_key, UnlockMode::PERMANENT).success);
+            
+            // Interrupt a lock at large.bin.enc, as in interrupted_lock_resume
+            std::string blocker = vault.getVaultPath() + "/folders/" + folder_info->vault_location + "/large.bin.enc";
+            fs::remove_all(blocker);
+            fs::create_directories(blocker);
+            ASSERT_FALSE(vault.lockFolder(test_folder, master_key).success);
+            ASSERT_EQ(vault.getInterruptedOperations().size(), 1);
+            fs::remove_all(blocker);
+            
+            // Resuming is background work: reading 256 KB and writing its record
+            // is over 512 KB charged at 256 KB/s, less the quarter second of burst
+            start = std::chrono::steady_clock::now();
+            ASSERT_TRUE(vault.resumeInterruptedOperations(master_key).success);
+            auto background = std::chrono::steady_clock::now() - start;
+            ASSERT_TRUE(background >= std::chrono::milliseconds(1500));
+            ASSERT_TRUE(vault.isFolderLocked(test_folder));
+        }
+        
+        // Cleanup
+        cleanupTestFolder(test_folder);
+        fs::remove_all(vault_root);
+    }
+    
     static void testVaultMetadataProtection() {
         std::string vault_root = "./test_metadata_protection";
         
@@ -439,9 +439,14 @@ PrivateTmp=true
 ProtectSystem=false
 ProtectHome=false
 
-# Resource limits
+# Resource limits. The weights only rank us against other system services;
+# the desktop is in user.slice. The service writes cpu.max/io.max into the
+# cgroup delegated here, and those caps are what protect the desktop.
 LimitNOFILE=65536
 MemoryMax=50M
+CPUWeight=50
+IOWeight=50
+Delegate=yes
 
 [Install]
 WantedBy=multi-user.target